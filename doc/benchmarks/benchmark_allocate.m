@@ -0,0 +1,60 @@
+function benchmark_allocate (num_free_list)
+% Benchmark of the MPFR variable memory management (`mpfr_t.allocate` and
+% `mpfr_t.mark_free`) with a growing number of free index ranges.
+%
+% For each value `num_free` in `num_free_list`, every other index range of
+% `2 * num_free` allocated ones is marked free.  Thus neighboring free ranges
+% cannot be merged and the pool contains `num_free` free ranges.  Then index
+% ranges of random size are allocated from this pool and marked free again.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_allocate
+
+if (nargin < 1)
+  num_free_list = [10, 100, 1000, 10000, 100000];
+end
+
+if (mpfr_t.get_data_size () || mpfr_t.get_data_capacity ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_allocate');
+end
+
+num_repeats = 1000;
+max_count = 64;
+
+fprintf ('%12s  %12s  %18s  %18s\n', 'free ranges', 'data size', ...
+  'allocate [us/op]', 'mark_free [us/op]');
+for num_free = num_free_list
+  % Create `num_free` free index ranges separated by used ones.
+  idx = cell (1, 2 * num_free);
+  for i = 1:numel (idx)
+    idx{i} = mpfr_t.allocate (randi (max_count));
+  end
+  for i = 1:2:numel (idx)
+    mpfr_t.mark_free (idx{i});
+  end
+  data_size = mpfr_t.get_data_size ();
+
+  counts = randi (max_count, 1, num_repeats);
+  tmp = cell (1, num_repeats);
+  tic ();
+  for i = 1:num_repeats
+    tmp{i} = mpfr_t.allocate (counts(i));
+  end
+  t_allocate = toc ();
+  tic ();
+  for i = num_repeats:-1:1
+    mpfr_t.mark_free (tmp{i});
+  end
+  t_mark_free = toc ();
+
+  fprintf ('%12d  %12d  %18.2f  %18.2f\n', num_free, data_size, ...
+    t_allocate / num_repeats * 1e6, t_mark_free / num_repeats * 1e6);
+
+  for i = 2:2:numel (idx)
+    mpfr_t.mark_free (idx{i});
+  end
+end
+
+end
@@ -0,0 +1,46 @@
+function benchmark_compact (N, num_vars)
+% Benchmark of `mpfr_t.compact` after fragmenting the MPFR variables.
+%
+% Creates `num_vars` N x N @mpfr_t variables and keeps only every tenth of
+% them.  Without compaction, the capacity remains at its high-water mark.
+% `mpfr_t.compact` relocates the remaining variables and releases the unused
+% memory.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_compact
+
+if (nargin < 1)
+  N = 10;
+end
+if (nargin < 2)
+  num_vars = 10000;
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_compact');
+end
+
+vars = cell (1, num_vars);
+for i = 1:num_vars
+  vars{i} = mpfr_t (rand (N), 128);
+end
+vars(mod (1:num_vars, 10) ~= 0) = {[]};
+
+capacity_before = mpfr_t.get_data_capacity ();
+size_before = mpfr_t.get_data_size ();
+tic ();
+mpfr_t.compact ();
+t_compact = toc ();
+capacity_after = mpfr_t.get_data_capacity ();
+size_after = mpfr_t.get_data_size ();
+
+fprintf ('%d of %d variables (%d x %d) kept\n\n', ...
+  sum (~cellfun (@isempty, vars)), num_vars, N, N);
+fprintf ('%12s  %12s  %12s\n', '', 'data size', 'capacity');
+fprintf ('%12s  %12d  %12d\n', 'before', size_before, capacity_before);
+fprintf ('%12s  %12d  %12d\n', 'after', size_after, capacity_after);
+fprintf ('\nmpfr_t.compact: %.2f ms\n', t_compact * 1e3);
+
+end
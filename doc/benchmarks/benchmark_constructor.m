@@ -0,0 +1,45 @@
+function benchmark_constructor (N, prec)
+% Benchmark of the @mpfr_t constructor, comparing the construction from a
+% double matrix, e.g. `mpfr_t (eye (N), prec)`, with the fill values, e.g.
+% `mpfr_t ([N, N], prec, [], 'eye')`, which need no double matrix.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_constructor
+
+if (nargin < 1)
+  N = 2000;
+end
+if (nargin < 2)
+  prec = 256;
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_constructor');
+end
+
+num_repeats = 3;
+fills = {'zeros', 'ones', 'eye', 'nan'};
+fcns = {@zeros, @ones, @eye, @nan};
+
+fprintf ('mpfr_t constructor, %d x %d elements (prec = %d), time per call [s]\n\n', ...
+         N, N, prec);
+fprintf ('%10s  %12s  %12s\n', 'fill', 'double', 'fill value');
+for i = 1:numel (fills)
+  tic ();
+  for k = 1:num_repeats
+    A = mpfr_t (fcns{i}(N), prec);
+    clear A;
+  end
+  t_double = toc () / num_repeats;
+  tic ();
+  for k = 1:num_repeats
+    A = mpfr_t ([N, N], prec, [], fills{i});
+    clear A;
+  end
+  t_fill = toc () / num_repeats;
+  fprintf ('%10s  %12.4f  %12.4f\n', fills{i}, t_double, t_fill);
+end
+
+end
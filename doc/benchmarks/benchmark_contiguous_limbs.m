@@ -0,0 +1,59 @@
+function benchmark_contiguous_limbs (N, precs)
+% Benchmark of dense linear algebra kernels with separately allocated MPFR
+% significands (`apa ('contiguous_limbs', 0)`) and with one contiguous limb
+% block per matrix (`apa ('contiguous_limbs', 1)`).
+%
+% For each precision in `precs`, the matrix-matrix multiplication `A * A` and
+% the LU factorization `lu (A)` of an N x N matrix are timed.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_contiguous_limbs
+
+if (nargin < 1)
+  N = 200;
+end
+if (nargin < 2)
+  precs = [53, 128, 256, 1024];
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    ['Existing @mpfr_t variables detected.  Run:  clear all; ', ...
+     'benchmark_contiguous_limbs']);
+end
+
+num_repeats = 3;
+modes = {'separate', 'contiguous'};
+default_contiguous_limbs = apa ('contiguous_limbs');
+A = rand (N) + N * eye (N);
+
+fprintf ('%d x %d matrices, time per call [s]\n\n', N, N);
+fprintf ('%10s', 'prec');
+fprintf ('  %12s', ['mmm ', modes{1}], ['mmm ', modes{2}], ...
+                   ['lu ', modes{1}], ['lu ', modes{2}]);
+fprintf ('\n');
+for i = 1:numel (precs)
+  t = zeros (2, numel (modes));
+  for j = 1:numel (modes)
+    apa ('contiguous_limbs', j - 1);
+    Ampfr = mpfr_t (A, precs(i));
+    tic ();
+    for k = 1:num_repeats
+      C = Ampfr * Ampfr;
+    end
+    t(1,j) = toc () / num_repeats;
+    tic ();
+    for k = 1:num_repeats
+      [L, U] = lu (Ampfr);
+    end
+    t(2,j) = toc () / num_repeats;
+    clear Ampfr C L U;
+  end
+  fprintf ('%10d', precs(i));
+  fprintf ('  %12.4f', t(1,:), t(2,:));
+  fprintf ('\n');
+end
+apa ('contiguous_limbs', default_contiguous_limbs);
+
+end
@@ -0,0 +1,49 @@
+function benchmark_exact (num_iter)
+% Benchmark of the exact GMP integer accumulation (`mtimes` strategy 11)
+% against the conventional strategy 8.
+%
+% Strategy 11 scales the rows of A and columns of B to integers and
+% accumulates the inner products exactly by `mpz_addmul`, which avoids the
+% rounding and normalization of each `mpfr_fma`.  The results are correctly
+% rounded.  The speedup is largest for moderate precision and vanishes for
+% very high precision, where the integer products dominate.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_exact
+
+if (nargin < 1)
+  num_iter = 3;
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_exact');
+end
+
+rnd = mpfr_get_default_rounding_mode ();
+strategies = [8, 11];
+
+fprintf ('Time per call [s]\n\n');
+fprintf ('%6s  %6s  %12s  %12s  %12s\n', 'prec', 'N', 'strategy 8', ...
+  'strategy 11', 'speedup');
+
+for prec = [128, 256, 512, 1024, 4096]
+  for N = [64, 128, 256]
+    A = mpfr_t (rand (N) - 0.5, prec);
+    B = mpfr_t (rand (N) - 0.5, prec);
+    t = zeros (1, length (strategies));
+    for j = 1:length (strategies)
+      for i = 1:num_iter
+        tic ();
+        mtimes (A, B, rnd, prec, strategies(j));
+        t(j) = t(j) + toc ();
+      end
+    end
+    t = t / num_iter;
+    fprintf ('%6d  %6d  %12.4f  %12.4f  %12.2f\n', prec, N, t, t(1) / t(2));
+    clear A B;
+  end
+end
+
+end
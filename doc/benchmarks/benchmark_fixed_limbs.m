@@ -0,0 +1,69 @@
+function benchmark_fixed_limbs (num_iter)
+% Benchmark of the fixed-limb kernels for `mpfr_mul`, `mpfr_div`, and
+% `mpfr_fma` (see `apa ('fixed_limbs')`).
+%
+% Compares the plain MPFR functions (`apa ('fixed_limbs', 0)`) with the
+% kernels specialized on the number of limbs for precisions of 64 to 512
+% bits.  Both add the same MEX overhead.  Where MPFR has special code
+% itself, e.g. `mpfr_add` or `mpfr_mul` of less than 128 bits, the kernels
+% are not used and the speedup is about 1.  `mtimes` uses `mpfr_fma` for
+% each inner product.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_fixed_limbs
+
+if (nargin < 1)
+  num_iter = 10;
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_fixed_limbs');
+end
+
+default_fixed_limbs = apa ('fixed_limbs');
+rnd = mpfr_get_default_rounding_mode ();
+N = 100000;
+
+fprintf ('Time per call [ms]\n\n');
+fprintf ('%-24s  %12s  %12s  %12s\n', 'operation', 'mpfr', 'fixed', ...
+  'speedup');
+
+for p = [64, 113, 128, 192, 256, 384, 512]
+  a = mpfr_t (rand (N, 1) - 0.5, p);
+  b = mpfr_t (rand (N, 1) + 0.5, p);
+  c = mpfr_t (zeros (N, 1), p);
+  A = mpfr_t (rand (100), p);
+  ops = {'mpfr_add', 'mpfr_mul', 'mpfr_div', 'mpfr_fma', 'mtimes'};
+  for k = 1:length (ops)
+    t = zeros (1, 2);
+    fixed_limbs = [0, default_fixed_limbs];
+    for j = 1:2
+      apa ('fixed_limbs', fixed_limbs(j));
+      tic ();
+      for i = 1:num_iter
+        switch (ops{k})
+          case 'mpfr_add'
+            mpfr_add (c, a, b, rnd);
+          case 'mpfr_mul'
+            mpfr_mul (c, a, b, rnd);
+          case 'mpfr_div'
+            mpfr_div (c, a, b, rnd);
+          case 'mpfr_fma'
+            mpfr_fma (c, a, b, c, rnd);
+          case 'mtimes'
+            A * A;
+        end
+      end
+      t(j) = toc () / num_iter;
+    end
+    fprintf ('%-24s  %12.4f  %12.4f  %12.1f\n', ...
+      sprintf ('%s, prec = %d', ops{k}, p), t * 1e3, t(1) / t(2));
+  end
+  clear a b c A;
+end
+
+apa ('fixed_limbs', default_fixed_limbs);
+
+end
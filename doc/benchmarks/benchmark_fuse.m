@@ -0,0 +1,52 @@
+function benchmark_fuse (N, num_iter)
+% Benchmark of fused element-wise expressions.
+%
+% Computes `x = a.*b + c.*d - e` for N x N matrices with the element-wise
+% operators, which create four temporary @mpfr_t variables and make four
+% passes over the data, and with `mpfr_t.fuse`, which makes a single pass
+% using `mpfr_fmma`.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_fuse
+
+if (nargin < 1)
+  N = 500;
+end
+if (nargin < 2)
+  num_iter = 10;
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_fuse');
+end
+
+S = warning ('off', 'mpfr_t:inexactOperation');
+a = mpfr_t (rand (N), 256);
+b = mpfr_t (rand (N), 256);
+c = mpfr_t (rand (N), 256);
+d = mpfr_t (rand (N), 256);
+e = mpfr_t (rand (N), 256);
+
+tic ();
+for i = 1:num_iter
+  x = a.*b + c.*d - e;
+end
+t_operators = toc () / num_iter;
+
+f = @(a, b, c, d, e) a.*b + c.*d - e;
+tic ();
+for i = 1:num_iter
+  x = mpfr_t.fuse (f, a, b, c, d, e);
+end
+t_fuse = toc () / num_iter;
+warning (S);
+
+fprintf ('x = a.*b + c.*d - e, %d x %d matrices (prec = 256), time [ms]\n\n', ...
+  N, N);
+fprintf ('%12s  %12s  %12s\n', 'operators', 'fuse', 'speedup');
+fprintf ('%12.2f  %12.2f  %12.1f\n', t_operators * 1e3, t_fuse * 1e3, ...
+  t_operators / t_fuse);
+
+end
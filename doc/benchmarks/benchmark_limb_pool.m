@@ -0,0 +1,54 @@
+function benchmark_limb_pool (N, precs)
+% Benchmark of bulk (re-)initialization of MPFR variables, comparing the
+% system allocator (`apa ('limb_pool', 0)`) with the per-thread memory pool
+% (`apa ('limb_pool', 1)`) and the pool backed by huge pages
+% (`apa ('limb_pool', 2)`).
+%
+% For each precision in `precs`, `mpfr_init2` (clear and init of all
+% elements) is applied to an N x N matrix.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_limb_pool
+
+if (nargin < 1)
+  N = 1000;
+end
+if (nargin < 2)
+  precs = [53, 128, 256, 1024, 4096];
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_limb_pool');
+end
+
+num_repeats = 5;
+modes = {'malloc', 'pool', 'huge pages'};
+default_limb_pool = apa ('limb_pool');
+
+fprintf ('mpfr_init2 of %d x %d elements, time per call [s]\n\n', N, N);
+fprintf ('%10s', 'prec');
+fprintf ('  %12s', modes{:});
+fprintf ('\n');
+t = zeros (numel (precs), numel (modes));
+for j = 1:numel (modes)
+  apa ('limb_pool', j - 1);  % Releases all MPFR memory.
+  A = mpfr_t (zeros (N));
+  for i = 1:numel (precs)
+    tic ();
+    for k = 1:num_repeats
+      mpfr_init2 (A, precs(i));
+    end
+    t(i,j) = toc () / num_repeats;
+  end
+  clear A;
+end
+for i = 1:numel (precs)
+  fprintf ('%10d', precs(i));
+  fprintf ('  %12.4f', t(i,:));
+  fprintf ('\n');
+end
+apa ('limb_pool', default_limb_pool);
+
+end
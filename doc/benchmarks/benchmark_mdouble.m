@@ -0,0 +1,61 @@
+function benchmark_mdouble (num_iter)
+% Benchmark of the double-double (@ddouble) and quad-double (@qdouble)
+% types against @mpfr_t of the same precision.
+%
+% Compares matrix multiplication (`mpfr_apa_mmm`, see `mtimes`), LU
+% factorization, and element-wise multiplication of @mpfr_t variables of
+% 106 and 212 bits precision with the multi-double kernels.  Conversions
+% are not included.  The multi-double kernels are vectorized with AVX2 if
+% the MEX file was compiled with `-mavx2 -mfma`.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_mdouble
+
+if (nargin < 1)
+  num_iter = 3;
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_mdouble');
+end
+
+fprintf ('Time per call [ms]\n\n');
+fprintf ('%-24s  %12s  %12s  %12s\n', 'operation', 'mpfr', 'mdouble', ...
+  'speedup');
+
+types = {'ddouble', 'qdouble'};
+for k = 1:2
+  prec = 106 * k;
+  for N = [50, 100, 200]
+    A = mpfr_t (rand (N) - 0.5, prec);
+    B = mpfr_t (rand (N) - 0.5, prec);
+    Am = feval (types{k}, A);
+    Bm = feval (types{k}, B);
+    ops = {'mtimes', 'lu', 'times'};
+    for j = 1:length (ops)
+      t = zeros (1, 2);
+      for i = 1:num_iter
+        switch (ops{j})
+          case 'mtimes'
+            tic (); A * B;   t(1) = t(1) + toc ();
+            tic (); Am * Bm; t(2) = t(2) + toc ();
+          case 'lu'
+            tic (); [L, U, P] = lu (A);  t(1) = t(1) + toc ();
+            tic (); [L, U, P] = lu (Am); t(2) = t(2) + toc ();
+          case 'times'
+            tic (); A .* B;   t(1) = t(1) + toc ();
+            tic (); Am .* Bm; t(2) = t(2) + toc ();
+        end
+      end
+      t = t / num_iter;
+      fprintf ('%-24s  %12.4f  %12.4f  %12.1f\n', ...
+        sprintf ('%s, %s, N = %d', types{k}, ops{j}, N), t * 1e3, ...
+        t(1) / t(2));
+    end
+    clear A B L U;
+  end
+end
+
+end
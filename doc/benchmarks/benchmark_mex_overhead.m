@@ -0,0 +1,59 @@
+function benchmark_mex_overhead (num_iter)
+% Benchmark of the per-call overhead of scalar MPFR functions.
+%
+% Calls `mpfr_add` for scalar @mpfr_t variables with the objects themselves,
+% which requires a copy of their `idx` property in the MEX interface, with
+% their handles `x.idx`, and directly via `mex_apa_interface`.  The time per
+% addition within a command tape (see `mpfr_t.tape_run`) is the cost of
+% `mpfr_add` itself.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_mex_overhead
+
+if (nargin < 1)
+  num_iter = 100000;
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_mex_overhead');
+end
+
+a = mpfr_t (1, 128);
+b = mpfr_t (2, 128);
+c = mpfr_t (0, 128);
+rnd = mpfr_get_default_rounding_mode ();
+
+tic ();
+for i = 1:num_iter
+  mpfr_add (c, a, b, rnd);
+end
+t_objects = toc () / num_iter;
+
+ai = a.idx;
+bi = b.idx;
+ci = c.idx;
+tic ();
+for i = 1:num_iter
+  mpfr_add (ci, ai, bi, rnd);
+end
+t_handles = toc () / num_iter;
+
+tic ();
+for i = 1:num_iter
+  mex_apa_interface (1031, ci, ai, bi, rnd);
+end
+t_direct = toc () / num_iter;
+
+tape = {{1031, ci, ai, bi, rnd}};
+tic ();
+mpfr_t.tape_run (tape, num_iter);
+t_tape = toc () / num_iter;
+
+fprintf ('c = a + b, scalar mpfr_add (prec = 128), time per call [us]\n\n');
+fprintf ('%12s  %12s  %12s  %12s\n', 'objects', 'handles', 'direct', 'tape');
+fprintf ('%12.2f  %12.2f  %12.2f  %12.2f\n', t_objects * 1e6, ...
+  t_handles * 1e6, t_direct * 1e6, t_tape * 1e6);
+
+end
@@ -0,0 +1,47 @@
+function benchmark_mtimes (num_iter)
+% Benchmark of the matrix multiplication strategies of `mpfr_apa_mmm`.
+%
+% Compares strategy 7 (one row of A at a time, nested parallel dot products)
+% with strategy 8 (cache-blocked tiles of packed panels in one parallel
+% region) for square matrices of 256 bits precision.  Both compute the
+% inner products by `mpfr_fma`, thus the speedup is due to memory locality
+% and less fork/join overhead and grows with the number of threads.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_mtimes
+
+if (nargin < 1)
+  num_iter = 3;
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_mtimes');
+end
+
+rnd = mpfr_get_default_rounding_mode ();
+prec = 256;
+strategies = [7, 8];
+
+fprintf ('Time per call [s]\n\n');
+fprintf ('%-12s  %12s  %12s  %12s\n', 'N', 'strategy 7', 'strategy 8', ...
+  'speedup');
+
+for N = [100, 200, 500, 1000, 2000]
+  A = mpfr_t (rand (N) - 0.5, prec);
+  B = mpfr_t (rand (N) - 0.5, prec);
+  t = zeros (1, length (strategies));
+  for j = 1:length (strategies)
+    for i = 1:num_iter
+      tic ();
+      mtimes (A, B, rnd, prec, strategies(j));
+      t(j) = t(j) + toc ();
+    end
+  end
+  t = t / num_iter;
+  fprintf ('%-12d  %12.4f  %12.4f  %12.1f\n', N, t, t(1) / t(2));
+  clear A B;
+end
+
+end
@@ -0,0 +1,65 @@
+function benchmark_omp_schedule (num_iter)
+% Benchmark of the OpenMP scheduling of element-wise operations.
+%
+% Compares the cost-aware schedule (see `apa ('omp')`) with all threads and
+% a static schedule for every operation, which was used before.  Small
+% additions should not pay for a thread team, `mpfr_gamma_inc` for
+% arguments of mixed magnitude should not suffer from load imbalance.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_omp_schedule
+
+if (nargin < 1)
+  num_iter = 10;
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_omp_schedule');
+end
+
+default_omp = apa ('omp');
+static_omp = struct ('min_cost', 0, 'chunk_cost', 0, 'schedule', 'static');
+rnd = mpfr_get_default_rounding_mode ();
+
+fprintf ('Time per call [ms]\n\n');
+fprintf ('%-24s  %12s  %12s  %12s\n', 'operation', 'static', 'cost', ...
+  'speedup');
+
+for N = [3, 100, 10000, 1000000]
+  a = mpfr_t (rand (N, 1), 128);
+  c = mpfr_t (zeros (N, 1), 128);
+  t = zeros (1, 2);
+  omp = {static_omp, default_omp};
+  for j = 1:2
+    apa ('omp', omp{j});
+    iter = max (num_iter, ceil (1e5 / N));
+    tic ();
+    for i = 1:iter
+      mpfr_add (c, a, a, rnd);
+    end
+    t(j) = toc () / iter;
+  end
+  fprintf ('%-24s  %12.4f  %12.4f  %12.1f\n', ...
+    sprintf ('mpfr_add, N = %d', N), t * 1e3, t(1) / t(2));
+end
+
+N = 1000;
+x = mpfr_t (logspace (-2, 3, N), 128);
+y = mpfr_t (logspace (3, -2, N), 128);
+c = mpfr_t (zeros (1, N), 128);
+t = zeros (1, 2);
+omp = {static_omp, default_omp};
+for j = 1:2
+  apa ('omp', omp{j});
+  tic ();
+  mpfr_gamma_inc (c, x, y, rnd);
+  t(j) = toc ();
+end
+fprintf ('%-24s  %12.4f  %12.4f  %12.1f\n', ...
+  sprintf ('mpfr_gamma_inc, N = %d', N), t * 1e3, t(1) / t(2));
+
+apa ('omp', default_omp);
+
+end
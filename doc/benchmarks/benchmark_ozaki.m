@@ -0,0 +1,65 @@
+function benchmark_ozaki (num_iter)
+% Benchmark of the Ozaki scheme (`mtimes` strategy 12) against strategy 8.
+%
+% Strategy 12 splits the rows of A and columns of B into slices of double
+% precision integers, whose products are computed exactly by the optimized
+% DGEMM of the BLAS linked to Octave/Matlab.  The number of slices grows
+% linearly and the number of double products quadratically with the
+% precision, thus the speedup is largest for moderate precision.  The
+% table lists the number of slices of the precision-to-slice-count policy
+% for K = N, see `mpfr_apa_ozaki_slices` in mex_mpfr_algorithms_ozaki.c.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_ozaki
+
+if (nargin < 1)
+  num_iter = 3;
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_ozaki');
+end
+
+rnd = mpfr_get_default_rounding_mode ();
+strategies = [8, 12];
+
+fprintf ('Time per call [s]\n\n');
+fprintf ('%6s  %6s  %6s  %12s  %12s  %12s\n', 'prec', 'N', 'slices', ...
+  'strategy 8', 'strategy 12', 'speedup');
+
+for prec = [113, 200, 256, 400]
+  for N = [100, 200, 500, 1000]
+    A = mpfr_t (rand (N) - 0.5, prec);
+    B = mpfr_t (rand (N) - 0.5, prec);
+    t = zeros (1, length (strategies));
+    for j = 1:length (strategies)
+      for i = 1:num_iter
+        tic ();
+        mtimes (A, B, rnd, prec, strategies(j));
+        t(j) = t(j) + toc ();
+      end
+    end
+    t = t / num_iter;
+    fprintf ('%6d  %6d  %6d  %12.4f  %12.4f  %12.1f\n', prec, N, ...
+      ozaki_slices (prec, N), t, t(1) / t(2));
+    clear A B;
+  end
+end
+
+end
+
+
+function S = ozaki_slices (prec, K)
+% Number of slices of `mpfr_apa_ozaki_slices`, `0` if not applicable.
+  for S = 1:32
+    beta = floor ((53 - ceil (log2 (S * K))) / 2);
+    if (beta < 1)
+      break;
+    elseif (S * beta >= prec + 8)
+      return;
+    end
+  end
+  S = 0;
+end
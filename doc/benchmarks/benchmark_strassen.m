@@ -0,0 +1,61 @@
+function benchmark_strassen (num_iter)
+% Benchmark of Strassen-Winograd matrix multiplication (`mtimes` strategy 9)
+% against the conventional strategy 8.
+%
+% For each precision the time of both strategies is measured for square
+% matrices of growing size N and different `apa ('strassen_cutoff')` values.
+% A speedup greater than 1 indicates that the recursion pays off.  As
+% `mpfr_mul` gets more expensive compared to `mpfr_add` with growing
+% precision, the crossover moves to smaller N and cutoffs.  Each recursion
+% level adds 5 guard bits, which is noticeable if they exceed a limb.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_strassen
+
+if (nargin < 1)
+  num_iter = 3;
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_strassen');
+end
+
+default_strassen_cutoff = apa ('strassen_cutoff');
+rnd = mpfr_get_default_rounding_mode ();
+
+fprintf ('Time per call [s]\n\n');
+fprintf ('%6s  %6s  %6s  %12s  %12s  %12s\n', 'prec', 'N', 'cutoff', ...
+  'strategy 8', 'strategy 9', 'speedup');
+
+for prec = [128, 256, 1024, 4096]
+  for N = [64, 128, 256, 512]
+    A = mpfr_t (rand (N) - 0.5, prec);
+    B = mpfr_t (rand (N) - 0.5, prec);
+    t8 = 0;
+    for i = 1:num_iter
+      tic ();
+      mtimes (A, B, rnd, prec, 8);
+      t8 = t8 + toc ();
+    end
+    t8 = t8 / num_iter;
+    for cutoff = [16, 32, 64]
+      apa ('strassen_cutoff', cutoff);
+      t9 = 0;
+      for i = 1:num_iter
+        tic ();
+        mtimes (A, B, rnd, prec, 9);
+        t9 = t9 + toc ();
+      end
+      t9 = t9 / num_iter;
+      fprintf ('%6d  %6d  %6d  %12.4f  %12.4f  %12.2f\n', prec, N, ...
+        cutoff, t8, t9, t8 / t9);
+    end
+    clear A B;
+  end
+end
+
+apa ('strassen_cutoff', default_strassen_cutoff);
+
+end
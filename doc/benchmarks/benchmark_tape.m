@@ -0,0 +1,58 @@
+function benchmark_tape (num_iter)
+% Benchmark of command tapes for scalar recurrences.
+%
+% The recurrence of doc/examples/listing_14_1.m needs six MPFR function calls
+% per iteration.  They are called from an Octave/Matlab loop and replayed
+% from a recorded tape by `mpfr_t.tape_run` within a single MEX call.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_tape
+
+if (nargin < 1)
+  num_iter = 10000;
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_tape');
+end
+
+u = mpfr_t (2, 600);
+v = mpfr_t (-4, 600);
+x = mpfr_t (nan, 600);
+y = mpfr_t (nan, 600);
+z = mpfr_t (nan, 600);
+
+tic ();
+for k = 1:num_iter
+  mpfr_ui_div (x, 1130, v, MPFR_RNDN);
+  mpfr_ui_sub (y, 111, x, MPFR_RNDN);
+  mpfr_mul (z, v, u, MPFR_RNDN);
+  mpfr_ui_div (x, 3000, z, MPFR_RNDN);
+  mpfr_set (u, v, MPFR_RNDN);
+  mpfr_add (v, y, x, MPFR_RNDN);
+end
+t_loop = toc () / num_iter;
+
+mpfr_set_si (u, 2, MPFR_RNDN);
+mpfr_set_si (v, -4, MPFR_RNDN);
+mpfr_t.tape_begin ();
+mpfr_ui_div (x, 1130, v, MPFR_RNDN);
+mpfr_ui_sub (y, 111, x, MPFR_RNDN);
+mpfr_mul (z, v, u, MPFR_RNDN);
+mpfr_ui_div (x, 3000, z, MPFR_RNDN);
+mpfr_set (u, v, MPFR_RNDN);
+mpfr_add (v, y, x, MPFR_RNDN);
+tape = mpfr_t.tape_end ();
+
+tic ();
+mpfr_t.tape_run (tape, num_iter);
+t_tape = toc () / num_iter;
+
+fprintf ('listing_14_1 recurrence (prec = 600), time per iteration [us]\n\n');
+fprintf ('%12s  %12s  %12s\n', 'loop', 'tape', 'speedup');
+fprintf ('%12.2f  %12.2f  %12.1f\n', t_loop * 1e6, t_tape * 1e6, ...
+  t_loop / t_tape);
+
+end
@@ -0,0 +1,45 @@
+function benchmark_temporaries (N, num_iter)
+% Benchmark of loops creating and dropping temporary @mpfr_t variables.
+%
+% Each iteration computes `c = a + b` for N x N matrices, thus the previous
+% `c` is released.  The deferred release of MPFR variables reuses its index
+% range directly.  For comparison, `mpfr_t.flush_free` after each iteration
+% forces the immediate release.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_temporaries
+
+if (nargin < 1)
+  N = 10;
+end
+if (nargin < 2)
+  num_iter = 10000;
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_temporaries');
+end
+
+a = mpfr_t (rand (N), 128);
+b = mpfr_t (rand (N), 128);
+
+tic ();
+for i = 1:num_iter
+  c = a + b;
+end
+t_deferred = toc () / num_iter;
+
+tic ();
+for i = 1:num_iter
+  c = a + b;
+  mpfr_t.flush_free ();
+end
+t_immediate = toc () / num_iter;
+
+fprintf ('c = a + b, %d x %d matrices, time per iteration [us]\n\n', N, N);
+fprintf ('%12s  %12s\n', 'deferred', 'immediate');
+fprintf ('%12.2f  %12.2f\n', t_deferred * 1e6, t_immediate * 1e6);
+
+end
@@ -0,0 +1,49 @@
+function benchmark_winograd (num_iter)
+% Benchmark of Winograd's inner product algorithm (`mtimes` strategy 10)
+% against the conventional strategy 8.
+%
+% Strategy 10 halves the number of multiplications per inner product at the
+% cost of two additions per pair of elements.  Thus the speedup grows with
+% the precision, as the costs of `mpfr_mul` grow faster than those of
+% `mpfr_add`.  The crossover is the default of `apa ('winograd_prec')`, from
+% which `mtimes` uses strategy 10 by default.
+%
+% Run in a clean Octave/Matlab session:
+%
+%   clear all; benchmark_winograd
+
+if (nargin < 1)
+  num_iter = 3;
+end
+
+if (mpfr_t.get_data_size ())
+  error ('apa:benchmark:dirtyEnvironment', ...
+    'Existing @mpfr_t variables detected.  Run:  clear all; benchmark_winograd');
+end
+
+rnd = mpfr_get_default_rounding_mode ();
+strategies = [8, 10];
+
+fprintf ('Time per call [s]\n\n');
+fprintf ('%6s  %6s  %12s  %12s  %12s\n', 'prec', 'N', 'strategy 8', ...
+  'strategy 10', 'speedup');
+
+for prec = [256, 512, 768, 1024, 2048, 4096]
+  for N = [64, 128, 256]
+    A = mpfr_t (rand (N) - 0.5, prec);
+    B = mpfr_t (rand (N) - 0.5, prec);
+    t = zeros (1, length (strategies));
+    for j = 1:length (strategies)
+      for i = 1:num_iter
+        tic ();
+        mtimes (A, B, rnd, prec, strategies(j));
+        t(j) = t(j) + toc ();
+      end
+    end
+    t = t / num_iter;
+    fprintf ('%6d  %6d  %12.4f  %12.4f  %12.2f\n', prec, N, t, t(1) / t(2));
+    clear A B;
+  end
+end
+
+end
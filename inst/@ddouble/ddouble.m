@@ -0,0 +1,18 @@
+classdef ddouble < mdouble
+  % Double-double numbers of about 106 bits precision, see @mdouble.
+  %
+  %   a = ddouble (mpfr_t ('0.1', 106));
+  %   b = mpfr_t (a * a);
+
+  methods
+    function obj = ddouble (x)
+      % Construct a double-double variable from `x`, see `mdouble`.
+
+      if (nargin < 1)
+        error ('ddouble:ddouble', 'At least one argument must be provided.');
+      end
+      obj = obj@mdouble (x, 2);
+    end
+  end
+
+end
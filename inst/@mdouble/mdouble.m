@@ -0,0 +1,263 @@
+classdef mdouble
+  % Base class of the multi-double types `ddouble` and `qdouble`.
+  %
+  % A multi-double number is the unevaluated sum of k doubles, k = 2 for
+  % double-double (about 106 bits precision) and k = 4 for quad-double (about
+  % 212 bits precision).  The arithmetic is done in double precision without
+  % MPFR, see mex_mdouble_interface.c.  Conversions from @mpfr_t are exact up
+  % to k doubles, conversions to @mpfr_t are correctly rounded.
+  %
+  %   A = ddouble (mpfr_t (rand (100), 106));
+  %   [L, U, P] = lu (A * A);
+  %   x = mpfr_t (U, 106);
+
+  properties (SetAccess = protected)
+    dims  % Object dimensions.
+    data  % Components, [numel x k] double matrix.
+  end
+
+
+  methods (Static, Access = private)
+    function [a, b] = promote (a, b, name)
+      % [internal] Convert numeric operands to the multi-double type of the
+      % other operand.
+
+      if (isnumeric (a))
+        a = feval (class (b), a);
+      elseif (isnumeric (b))
+        b = feval (class (a), b);
+      elseif (~strcmp (class (a), class (b)))
+        error (['mdouble:', name], 'Operands must be of the same type.');
+      end
+    end
+
+
+    function c = elementwise_op (op, name, a, b, w)
+      % [internal] Element-wise operation `op`, see MDOUBLE_OP_* in
+      % mex_mdouble_interface.h.
+
+      [a, b] = mdouble.promote (a, b, name);
+      ops = {a, b};
+      if (nargin > 4)
+        [a, w] = mdouble.promote (a, w, name);
+        ops{3} = w;
+      end
+      dims = [1 1];
+      for i = 1:numel (ops)
+        if (isequal (dims, [1 1]))
+          dims = ops{i}.dims;
+        elseif (~ (isequal (ops{i}.dims, dims) ...
+                   || isequal (ops{i}.dims, [1 1])))
+          error (['mdouble:', name], 'Incompatible dimensions of operands.');
+        end
+      end
+      data = cellfun (@(x) x.data, ops, 'UniformOutput', false);
+      c = a;
+      c.dims = dims;
+      c.data = mex_apa_interface (4002, op, data{:});  % mdouble.elementwise
+    end
+  end
+
+
+  methods
+    function obj = mdouble (x, k)
+      % Construct a multi-double variable of `k` components from `x`.
+      %
+      % `x` can be a real numeric matrix, an @mpfr_t variable, or another
+      % multi-double variable.  The latter is extended by zeros or truncated
+      % to `k` components.
+
+      if (nargin < 2)
+        error ('mdouble:mdouble', 'At least two arguments must be provided.');
+      end
+      if (~ (isequal (k, 2) || isequal (k, 4)))
+        error ('mdouble:mdouble', 'Number of components k must be 2 or 4.');
+      end
+
+      if (isa (x, 'mdouble'))
+        obj.dims = x.dims;
+        kx = size (x.data, 2);
+        obj.data = [x.data(:,1:min (k, kx)), ...
+                    zeros(prod (x.dims), max (k - kx, 0))];
+      elseif (isa (x, 'mpfr_t'))
+        obj.dims = x.dims;
+        obj.data = mex_apa_interface (4000, x.idx, k);  % mdouble.from_mpfr
+      elseif (isnumeric (x) && isreal (x) && ismatrix (x))
+        obj.dims = size (x);
+        obj.data = [double(x(:)), zeros(numel (x), k - 1)];
+      else
+        error ('mdouble:mdouble', 'Invalid operand x.');
+      end
+    end
+
+
+    function d = double (obj)
+      % Return a double approximation of `obj`.
+
+      d = reshape (obj.data(:,1), obj.dims);
+    end
+
+
+    function varargout = size (obj, varargin)
+      % Object dimensions.
+
+      [varargout{1:max (nargout, 1)}] = size (zeros (obj.dims), varargin{:});
+    end
+
+
+    function disp (obj)
+      % Object display.
+
+      fprintf (1, '  %dx%d %s\n', obj.dims(1), obj.dims(2), class (obj));
+      if (~isempty (obj.data))
+        disp (double (obj));
+      end
+    end
+
+
+    function c = plus (a, b)
+      % Element-wise addition `c = a + b`.
+
+      c = mdouble.elementwise_op (0, 'plus', a, b);  % MDOUBLE_OP_ADD
+    end
+
+
+    function c = minus (a, b)
+      % Element-wise subtraction `c = a - b`.
+
+      c = mdouble.elementwise_op (1, 'minus', a, b);  % MDOUBLE_OP_SUB
+    end
+
+
+    function c = times (a, b)
+      % Element-wise multiplication `c = a .* b`.
+
+      c = mdouble.elementwise_op (2, 'times', a, b);  % MDOUBLE_OP_MUL
+    end
+
+
+    function c = rdivide (a, b)
+      % Right element-wise division `c = a ./ b`.
+
+      c = mdouble.elementwise_op (3, 'rdivide', a, b);  % MDOUBLE_OP_DIV
+    end
+
+
+    function d = fma (a, b, c)
+      % Element-wise fused multiply-add `d = a .* b + c`.
+
+      d = mdouble.elementwise_op (4, 'fma', a, b, c);  % MDOUBLE_OP_FMA
+    end
+
+
+    function c = uminus (a)
+      % Unary minus `c = -a`.
+
+      c = a;
+      c.data = -a.data;
+    end
+
+
+    function c = uplus (a)
+      % Unary plus `c = +a`.
+
+      c = a;
+    end
+
+
+    function b = transpose (a)
+      % Matrix transpose `b = a.'`.
+
+      idx = reshape (1:prod (a.dims), a.dims)';
+      b = a;
+      b.dims = fliplr (a.dims);
+      b.data = a.data(idx(:),:);
+    end
+
+
+    function b = ctranspose (a)
+      % Complex conjugate matrix transpose `b = a'`.
+
+      b = transpose (a);
+    end
+
+
+    function c = mtimes (a, b)
+      % Matrix multiplication `c = a * b`.
+
+      [a, b] = mdouble.promote (a, b, 'mtimes');
+      if (isequal (a.dims, [1 1]) || isequal (b.dims, [1 1]))
+        c = times (a, b);
+        return;
+      end
+      if (a.dims(2) ~= b.dims(1))
+        error ('mdouble:mtimes', 'Incompatible dimensions of a and b.');
+      end
+      c = a;
+      c.dims = [a.dims(1), b.dims(2)];
+      c.data = mex_apa_interface (4004, a.data, b.data, ...
+                                  a.dims(1));  % mdouble.mtimes
+    end
+
+
+    function c = dot (a, b)
+      % Dot product `c = a(:)' * b(:)` of vectors of equal length.
+
+      [a, b] = mdouble.promote (a, b, 'dot');
+      if (prod (a.dims) ~= prod (b.dims))
+        error ('mdouble:dot', 'Vectors a and b must have equal length.');
+      end
+      c = a;
+      c.dims = [1 1];
+      c.data = mex_apa_interface (4003, a.data, b.data);  % mdouble.dot
+    end
+
+
+    function [L, U, P] = lu (A)
+      % LU matrix factorization with partial pivoting.
+      %
+      %   [L,U]   = lu (A)
+      %   [L,U,P] = lu (A)
+      %
+
+      M = A.dims(1);
+      N = A.dims(2);
+      K = min (M, N);
+      [LU, ipiv, INFO] = mex_apa_interface (4005, A.data, M);  % mdouble.lu
+      if (INFO > 0)
+        warning ('mdouble:lu:zeroPivot', ...
+                 'LU factorization reported zero pivot in step %d.', INFO);
+      end
+
+      % Unpack factors from LU.
+      idx = reshape (1:M*N, M, N);
+      L = A;
+      L.dims = [M, K];
+      L.data = zeros (M * K, size (LU, 2));
+      is_lower = tril (true (M, K), -1);
+      L.data(is_lower(:),:) = LU(idx(is_lower),:);
+      L.data(logical (eye (M, K)),1) = 1;
+      U = A;
+      U.dims = [K, N];
+      U.data = zeros (K * N, size (LU, 2));
+      is_upper = triu (true (K, N));
+      U.data(is_upper(:),:) = LU(idx(is_upper),:);
+
+      % Translate pivot vector.
+      p = 1:M;
+      for i = 1:K
+        p([i, ipiv(i)]) = p([ipiv(i), i]);
+      end
+      if (nargout < 3)  % Apply P' to L, such that A = L * U.
+        q(p) = 1:M;
+        idx = reshape (1:M*K, M, K);
+        idx = idx(q,:);
+        L.data = L.data(idx(:),:);
+      else
+        P = eye (M);
+        P = P(p,:);
+      end
+    end
+  end
+
+end
@@ -0,0 +1,203 @@
+classdef mpfr_expr
+  % Deferred element-wise expression of @mpfr_t variables.
+  %
+  % Element-wise operators on mpfr_expr objects do not compute anything, but
+  % record a program.  `evaluate` runs this program in a single pass over all
+  % elements, without temporary @mpfr_t variables.  Multiplications followed
+  % by an addition or subtraction are rounded only once (`mpfr_fma`,
+  % `mpfr_fms`, `mpfr_fmma`, `mpfr_fmms`).  See also `mpfr_t.fuse`.
+  %
+  %   e = mpfr_expr (a) .* b + mpfr_expr (c) .* d - e;
+  %   x = evaluate (e);
+
+  properties (SetAccess = protected)
+    dims      % Expression dimensions.
+    prog      % Program, 2 x K instructions `[opcode; arg]` in postfix order.
+    operands  % Cell array of @mpfr_t variables and double column vectors.
+  end
+
+
+  methods (Static, Access = private)
+    function c = binary_op (a, b, opcode, name)
+      % [internal] Append the programs of `a` and `b` and the instruction
+      % `opcode`.  See MPFR_EXPR_* in mex_mpfr_algorithms.h.
+
+      a = mpfr_expr (a);
+      b = mpfr_expr (b);
+      if (isequal (a.dims, b.dims) || isequal (b.dims, [1 1]))
+        dims = a.dims;
+      elseif (isequal (a.dims, [1 1]))
+        dims = b.dims;
+      else
+        error (['mpfr_expr:', name], 'Incompatible dimensions of a and b.');
+      end
+
+      % Operands of `b` follow those of `a`.
+      b_prog = b.prog;
+      leaves = (b_prog(1,:) <= 1);
+      b_prog(2,leaves) = b_prog(2,leaves) + numel (a.operands);
+
+      c = a;
+      c.dims = dims;
+      c.prog = [a.prog, b_prog, [opcode; 0]];
+      c.operands = [a.operands, b.operands];
+    end
+  end
+
+
+  methods
+    function obj = mpfr_expr (x)
+      % Construct an expression from an @mpfr_t variable or a numeric matrix
+      % `x`.
+
+      if (nargin < 1)
+        error ('mpfr_expr:mpfr_expr', ...
+          'At least one argument must be provided.');
+      end
+
+      if (isa (x, 'mpfr_expr'))
+        obj.dims = x.dims;
+        obj.prog = x.prog;
+        obj.operands = x.operands;
+      elseif (isa (x, 'mpfr_t'))
+        obj.dims = x.dims;
+        obj.prog = [0; 1];  % MPFR_EXPR_MPFR
+        obj.operands = {x};
+      elseif (isnumeric (x) && ismatrix (x))
+        obj.dims = size (x);
+        obj.prog = [1; 1];  % MPFR_EXPR_DOUBLE
+        obj.operands = {double(x(:))};
+      else
+        error ('mpfr_expr:mpfr_expr', 'Invalid operand x.');
+      end
+    end
+
+
+    function c = evaluate (obj, rnd, prec)
+      % Evaluate the expression `c = obj` using rounding mode `rnd`.
+      %
+      % If no rounding mode `rnd` is given, the default rounding mode is used.
+      %
+      % If no precision `prec` is given for `c` and all intermediate results,
+      % the maximum precision of all @mpfr_t operands is used.
+
+      if (nargin < 2)
+        rnd = [];
+      end
+      if (nargin < 3)
+        prec = [];
+      end
+      c = mpfr_t.evaluate_expr (obj, rnd, prec);
+    end
+
+
+    function d = double (obj)
+      % Evaluate the expression and convert it to double precision.
+
+      d = double (evaluate (obj));
+    end
+
+
+    function disp (obj)
+      % Display the deferred expression.
+
+      fprintf (1, '  %dx%d mpfr_expr of %d instructions and %d operands\n', ...
+               obj.dims(1), obj.dims(2), size (obj.prog, 2), ...
+               numel (obj.operands));
+    end
+
+
+    function c = plus (a, b)
+      % Deferred element-wise addition `c = a + b`.
+
+      c = mpfr_expr.binary_op (a, b, 2, 'plus');  % MPFR_EXPR_ADD
+    end
+
+
+    function c = minus (a, b)
+      % Deferred element-wise subtraction `c = a - b`.
+
+      c = mpfr_expr.binary_op (a, b, 3, 'minus');  % MPFR_EXPR_SUB
+    end
+
+
+    function c = times (a, b)
+      % Deferred element-wise multiplication `c = a .* b`.
+
+      c = mpfr_expr.binary_op (a, b, 4, 'times');  % MPFR_EXPR_MUL
+    end
+
+
+    function c = rdivide (a, b)
+      % Deferred right element-wise division `c = a ./ b`.
+
+      c = mpfr_expr.binary_op (a, b, 5, 'rdivide');  % MPFR_EXPR_DIV
+    end
+
+
+    function c = ldivide (a, b)
+      % Deferred left element-wise division `c = a .\ b`.
+
+      c = mpfr_expr.binary_op (b, a, 5, 'ldivide');  % MPFR_EXPR_DIV
+    end
+
+
+    function c = mtimes (a, b)
+      % Deferred multiplication `c = a * b`, if at least one input is scalar.
+
+      a = mpfr_expr (a);
+      b = mpfr_expr (b);
+      if ((prod (a.dims) ~= 1) && (prod (b.dims) ~= 1))
+        error ('mpfr_expr:mtimes', ...
+          'Only element-wise operations are supported.');
+      end
+      c = times (a, b);
+    end
+
+
+    function c = mrdivide (a, b)
+      % Deferred division `c = a / b`, if `b` is scalar.
+
+      b = mpfr_expr (b);
+      if (prod (b.dims) ~= 1)
+        error ('mpfr_expr:mrdivide', ...
+          'Only element-wise operations are supported.');
+      end
+      c = rdivide (a, b);
+    end
+
+
+    function c = uminus (a)
+      % Deferred unary minus `c = -a`.
+
+      c = a;
+      c.prog(:,end+1) = [6; 0];  % MPFR_EXPR_NEG
+    end
+
+
+    function c = uplus (a)
+      % Unary plus `c = +a`.
+
+      c = a;
+    end
+
+
+    function c = power (a, b)
+      % Deferred element-wise power `c = a.^b` with integer scalar `b`.
+
+      if (~ (isa (a, 'mpfr_expr') && isnumeric (b) && isscalar (b) ...
+             && (b == fix (b))))
+        error ('mpfr_expr:power', ...
+          'Only integer scalar exponents b are supported.');
+      end
+      c = a;
+      if (b == 2)
+        c.prog(:,end+1) = [8; 0];  % MPFR_EXPR_SQR
+      else
+        c.prog(:,end+1) = [7; double(b)];  % MPFR_EXPR_POW_SI
+      end
+    end
+
+  end
+
+end
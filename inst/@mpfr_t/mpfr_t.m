@@ -2,7 +2,7 @@ classdef mpfr_t
 
   properties (SetAccess = protected)
     dims  % Object dimensions.
-    idx   % Internal MPFR variable indices.
+    idx   % Internal MPFR variable handles.
     cleanupObj  % Destructor object.
   end
 
@@ -22,11 +22,16 @@ classdef mpfr_t
     end
 
 
-    function idx = allocate (count)
-      % [internal] Return the start and end index of a newly created MPFR
-      % variable for `count` elements.
+    function idx = allocate (count, prec)
+      % [internal] Return the start and end handle of a newly created MPFR
+      % variable for `count` elements.  Free MPFR variables of precision
+      % `prec` are preferred, if given.
 
-      idx = mex_apa_interface (1902, count);
+      if (nargin < 2)
+        idx = mex_apa_interface (1902, count);
+      else
+        idx = mex_apa_interface (1902, count, prec);
+      end
     end
 
 
@@ -41,6 +46,116 @@ classdef mpfr_t
 
       mex_apa_interface (1903, idx);
     end
+
+
+    function flush_free ()
+      % [internal] Release all MPFR variables marked as free.  Releasing is
+      % deferred and done in batches, this method forces a batch.
+
+      mex_apa_interface (1905);
+    end
+
+
+    function compact ()
+      % [internal] Relocate all used MPFR variables to close the gaps between
+      % them and release the memory of unused ones.  Handles of existing
+      % @mpfr_t variables remain valid.
+
+      mex_apa_interface (1906);
+    end
+
+
+    function stats = get_memory_stats ()
+      % [internal] Return a struct with memory statistics of all MPFR
+      % variables, e.g. the number and sizes of free index ranges,
+      % significand bytes by precision, high-water marks, and the number of
+      % allocations since startup.
+
+      stats = mex_apa_interface (1907);
+    end
+
+
+    function tape_begin ()
+      % [internal] Start recording all calls of MPFR functions (e.g.
+      % `mpfr_add`).  The calls are still executed as usual.
+
+      mex_apa_interface (1908);
+    end
+
+
+    function tape = tape_end ()
+      % [internal] Stop recording and return the recorded calls as tape, see
+      % `mpfr_t.tape_run`.
+
+      tape = mex_apa_interface (1909);
+    end
+
+
+    function tape_run (tape, count)
+      % [internal] Execute all calls of a tape `count` times (default 1)
+      % within a single MEX call.  A tape is a cell array of calls, each a
+      % cell array `{cmd_code, args...}` of the arguments to
+      % `mex_apa_interface`.  Return values (e.g. ternary values) are
+      % discarded.
+
+      if (nargin < 2)
+        count = 1;
+      end
+      mex_apa_interface (1910, tape, count);
+    end
+
+
+    function ret = summary (cmd_code, varargin)
+      % [internal] Call the MPFR function with command code `cmd_code` (e.g.
+      % 1031 for `mpfr_add`) and arguments `varargin`.  Instead of a ternary
+      % value for each element, return the numbers `[up, down, exact]` of
+      % results greater than, lower than, and equal to the exact result.
+
+      ret = mex_apa_interface (1911, cmd_code, varargin{:});
+    end
+
+
+    function c = fuse (fcn, varargin)
+      % Evaluate the element-wise expression `c = fcn (varargin{:})` of
+      % @mpfr_t variables and numeric matrices in a single pass, e.g.
+      %
+      %   c = mpfr_t.fuse (@(a, b, c, d, e) a.*b + c.*d - e, a, b, c, d, e);
+      %
+      % No temporary @mpfr_t variables are created and multiplications
+      % followed by an addition or subtraction are rounded only once.  `fcn`
+      % may use `+`, `-`, `.*`, `./`, and `.^` with integer scalar exponents,
+      % see @mpfr_expr.
+
+      args = cellfun (@mpfr_expr, varargin, 'UniformOutput', false);
+      c = evaluate (mpfr_expr (fcn (args{:})));
+    end
+
+
+    function c = evaluate_expr (expr, rnd, prec)
+      % [internal] Evaluate a deferred expression `expr` (@mpfr_expr) using
+      % rounding mode `rnd` and precision `prec` in a single MEX call.
+
+      if ((nargin < 2) || isempty (rnd))
+        rnd = mpfr_get_default_rounding_mode ();
+      end
+      ops = expr.operands;
+      is_mpfr = cellfun (@(x) isa (x, 'mpfr_t'), ops);
+      if ((nargin < 3) || isempty (prec))
+        if (any (is_mpfr))
+          prec = max (cellfun (@(x) max (mpfr_get_prec (x.idx)), ...
+                               ops(is_mpfr)));
+        else
+          prec = mpfr_get_default_prec ();
+        end
+      end
+      ops(is_mpfr) = cellfun (@(x) x.idx, ops(is_mpfr), ...
+                              'UniformOutput', false);
+
+      cc = mpfr_t (expr.dims, prec, [], 'zeros');
+      ret = mex_apa_interface (2005, cc.idx, expr.prog, prec, rnd, ops{:});
+      cc.warnInexactOperation (ret);
+      c = cc;  % Do not assign c before calculation succeeded!
+    end
   end
 
 
@@ -58,6 +173,9 @@ classdef mpfr_t
       % overflow, and exact otherwise.  A NaN result (Not-a-Number) always
       % corresponds to an exact return value.  The opposite of a returned
       % ternary value is guaranteed to be representable in an int.
+      %
+      % Callers using `mpfr_t.summary` pass the numbers `[up, down]` of
+      % results greater and lower than the exact result instead.
 
       if (any (ret(:)))
         fcn = dbstack ();
@@ -70,6 +188,64 @@ classdef mpfr_t
                   '\twarning (''off'', ''mpfr_t:inexactOperation'')\n'], fcn);
       end
     end
+
+
+    function [b, i] = reduce (a, kind, dim, rnd, prec, M)
+      % [internal] Reduce `a` along dimension `dim` using kind `kind`, see
+      % MPFR_REDUCE_* in mex_mpfr_algorithms.h.  If the number of rows `M` is
+      % given, `a` is reduced as `[M x numel(a)/M]` matrix.
+
+      if (isempty (dim))
+        dim = find (a.dims ~= 1, 1);
+        if (isempty (dim))
+          dim = 1;
+        end
+      end
+      if (~isequal (dim, 1) && ~isequal (dim, 2))
+        error ('mpfr_t:reduce', 'Dimension dim must be 1 or 2.');
+      end
+      if (nargin < 6)
+        M = a.dims(1);
+      end
+      dims = [M, prod(a.dims) / M];
+      dims(dim) = 1;
+
+      bb = mpfr_t (dims, prec, [], 'zeros');
+      if (nargout > 1)
+        [ret, i] = mex_apa_interface (2006, bb.idx, a.idx, M, dim, kind, ...
+                                      prec, rnd);  % mpfr_t.reduce
+        i = reshape (i, dims);
+      else
+        ret = mex_apa_interface (2006, bb.idx, a.idx, M, dim, kind, ...
+                                 prec, rnd);  % mpfr_t.reduce
+      end
+      a.warnInexactOperation (ret);
+      b = bb;  % Do not assign b before calculation succeeded!
+    end
+
+
+    function [b, nan_count] = select (a, ranks, dim, rnd, prec)
+      % [internal] The `ranks`-th smallest elements along dimension `dim`,
+      % see `nth_element`.  `ranks` must be ascending.  `nan_count` are the
+      % numbers of NaN elements of each column (or row).
+
+      dims = a.dims;
+      dims(dim) = numel (ranks);
+      bb = mpfr_t (dims, prec, [], 'zeros');
+      [ret, nan_count] = mex_apa_interface (2009, bb.idx, a.idx, a.dims(1), ...
+                                            dim, ranks, rnd);  % mpfr_t.select
+      a.warnInexactOperation (ret);
+      b = bb;  % Do not assign b before calculation succeeded!
+    end
+
+
+    function s = dim_subs (~, dim, j)
+      % [internal] Subscripts `(j,:)` for dim = 1 or `(:,j)` for dim = 2.
+
+      subs = {':', ':'};
+      subs{dim} = j;
+      s = struct ('type', '()', 'subs', {subs});
+    end
   end
 
 
@@ -103,9 +279,16 @@ classdef mpfr_t
     obj = subsasgn (obj, s, b, rnd)
 
 
-    function obj = mpfr_t (x, prec, rnd)
+    function obj = mpfr_t (x, prec, rnd, fill)
       % Construct a mpfr_t variable of precision `prec` from `x` using rounding
       % mode `rnd`.
+      %
+      % A @ddouble or @qdouble `x` is rounded once to the default precision of
+      % 106 or 212 bits, respectively.
+      %
+      % If `fill` is given, `x` are the dimensions `[m, n]` of the variable and
+      % all elements are set to 'zeros', 'ones', 'eye', or 'nan', without
+      % creating a double matrix first.
 
       if (nargin < 1)
         error ('mpfr_t:mpfr_t', 'At least one argument must be provided.');
@@ -119,33 +302,64 @@ classdef mpfr_t
       if (nargin < 2)
         prec = mex_apa_interface (1002);  % mpfr_get_default_prec
       end
-      if (nargin < 3)
+      if ((nargin < 3) || isempty (rnd))
         rnd = mex_apa_interface (1162);  % mpfr_get_default_rounding_mode
       end
 
-      if (ischar (x))
-        x = {x};
-      end
-      if (isa (x, 'mpfr_t'))
-        obj.dims = x.dims;
-        prec = max (mex_apa_interface (1004, x.idx));  % mpfr_get_prec
+      % Fill values, see MPFR_FILL_* in mex_mpfr_interface.h.
+      if (nargin > 3)
+        if (~ (isnumeric (x) && (numel (x) == 2)))
+          error ('mpfr_t:mpfr_t', 'Dimensions must be given as [m, n].');
+        end
+        fill = find (strcmp (fill, {'zeros', 'ones', 'eye', 'nan'})) + 1;
+        if (isempty (fill))
+          error ('mpfr_t:mpfr_t', ...
+            'Fill value must be ''zeros'', ''ones'', ''eye'', or ''nan''.');
+        end
+        obj.dims = x(:)';
+        src = {};
       else
-        obj.dims = size (x);
+        if (ischar (x))
+          x = {x};
+        end
+        if (isa (x, 'mpfr_t'))
+          obj.dims = x.dims;
+          prec = max (mex_apa_interface (1004, x.idx));  % mpfr_get_prec
+          fill = 1;
+          src = {x.idx};
+        elseif (isa (x, 'mdouble'))
+          obj.dims = x.dims;
+          if (nargin < 2)
+            prec = 53 * size (x.data, 2);
+          end
+          fill = 2;  % Zeros, set below.
+          src = {};
+        elseif (isnumeric (x))
+          obj.dims = size (x);
+          fill = 0;
+          src = {x(:)};
+        else
+          obj.dims = size (x);
+          fill = 5;
+          src = {};
+        end
       end
-      num_elems = prod (obj.dims);
-      obj.idx = mex_apa_interface (1902, num_elems)';  % mpfr_t.allocate
+
+      % Allocate, set precision, and fill in a single call.
+      [idx, ret] = mex_apa_interface (1904, obj.dims, prec, rnd, fill, ...
+                                      src{:});  % mpfr_t.allocate_init
+      obj.idx = idx';
 
       % Register destructor
       obj.cleanupObj = onCleanup(@() mex_apa_interface (1903, obj.idx));
 
-      mex_apa_interface (1003, obj.idx, prec);  % mpfr_set_prec
-
-      if (isa (x, 'mpfr_t'))
-        ret = mpfr_set (obj.idx, x.idx, rnd);
-      elseif (isnumeric (x))
-        ret = mex_apa_interface (1300, obj.idx, x(:), rnd);  % mpfr_set_d
-      elseif (iscellstr (x))
+      if (isa (x, 'mdouble'))
+        ret = mex_apa_interface (4001, obj.idx, x.data, rnd);  % mdouble.to_mpfr
+        ret = [sum(ret > 0), sum(ret < 0)];  % Summary as `mpfr_t.summary`.
+      end
+      if (iscellstr (x))
         [ret, strpos] = mpfr_strtofr (obj.idx, x(:), 0, rnd);
+        ret = [sum(ret > 0), sum(ret < 0)];  % Summary as `mpfr_t.summary`.
         bad_strs = (cellfun (@numel, x(:)) >= strpos);
         if (any (bad_strs))
           % Assign x to mpfr variable using slower subsasgn function.
@@ -160,10 +374,8 @@ classdef mpfr_t
           s = struct ('type', '()', 'subs', {{':'}});
           obj.subsasgn (s, x(:), rnd);
         end
-      else
-        ret = 0;
       end
-      obj.warnInexactOperation (ret);
+      obj.warnInexactOperation (ret(1:2));
     end
 
 
@@ -371,28 +583,30 @@ classdef mpfr_t
       elseif (isa (a, 'mpfr_t') && isnumeric (b))
         if (isscalar (b) || isequal (a.dims, size (b)))
           if (isempty (prec))
-            prec = max (mpfr_get_prec (a));
+            prec = max (mpfr_get_prec (a.idx));
           end
-          cc = mpfr_t (zeros (a.dims), prec);
+          cc = mpfr_t (a.dims, prec, [], 'zeros');
         else
           error ('mpfr_t:plus', 'Incompatible dimensions of a and b.');
         end
-        ret = mpfr_add_d (cc, a, double (b(:)), rnd);
-        cc.warnInexactOperation (ret);
+        ret = mex_apa_interface (1911, 1330, cc.idx, a.idx, double (b(:)), ...
+                                 rnd);  % mpfr_add_d
+        cc.warnInexactOperation (ret(1:2));
         c = cc;  % Do not assign c before calculation succeeded!
       elseif (isa (a, 'mpfr_t') && isa (b, 'mpfr_t'))
         if (isempty (prec))
-          prec = max (max (mpfr_get_prec (a)), max (mpfr_get_prec (b)));
+          prec = max (max (mpfr_get_prec (a.idx)), max (mpfr_get_prec (b.idx)));
         end
         if (isequal (a.dims, b.dims) || isequal (b.dims, [1 1]))
-          cc = mpfr_t (zeros (a.dims), prec);
+          cc = mpfr_t (a.dims, prec, [], 'zeros');
         elseif (isequal (a.dims, [1 1]))
-          cc = mpfr_t (zeros (b.dims), prec);
+          cc = mpfr_t (b.dims, prec, [], 'zeros');
         else
           error ('mpfr_t:plus', 'Incompatible dimensions of a and b.');
         end
-        ret = mpfr_add (cc, a, b, rnd);
-        cc.warnInexactOperation (ret);
+        ret = mex_apa_interface (1911, 1031, cc.idx, a.idx, b.idx, ...
+                                 rnd);  % mpfr_add
+        cc.warnInexactOperation (ret(1:2));
         c = cc;  % Do not assign c before calculation succeeded!
       else
         error ('mpfr_t:plus', 'Invalid operands a and b.');
@@ -417,42 +631,45 @@ classdef mpfr_t
       if (isnumeric (a) && isa (b, 'mpfr_t'))
         if (isscalar (a) || isequal (size (a), b.dims))
           if (isempty (prec))
-            prec = max (mpfr_get_prec (b));
+            prec = max (mpfr_get_prec (b.idx));
           end
-          cc = mpfr_t (zeros (b.dims), prec);
+          cc = mpfr_t (b.dims, prec, [], 'zeros');
         else
           error ('mpfr_t:minus', 'Incompatible dimensions of a and b.');
         end
-        ret = mpfr_d_sub (cc, double (a(:)), b, rnd);
+        ret = mex_apa_interface (1911, 1343, cc.idx, double (a(:)), b.idx, ...
+                                 rnd);  % mpfr_d_sub
         c = cc;  % Do not assign c before calculation succeeded!
       elseif (isa (a, 'mpfr_t') && isnumeric (b))
         if (isscalar (b) || isequal (a.dims, size (b)))
           if (isempty (prec))
-            prec = max (mpfr_get_prec (a));
+            prec = max (mpfr_get_prec (a.idx));
           end
-          cc = mpfr_t (zeros (a.dims), prec);
+          cc = mpfr_t (a.dims, prec, [], 'zeros');
         else
           error ('mpfr_t:minus', 'Incompatible dimensions of a and b.');
         end
-        ret = mpfr_sub_d (cc, a, double (b(:)), rnd);
+        ret = mex_apa_interface (1911, 1340, cc.idx, a.idx, double (b(:)), ...
+                                 rnd);  % mpfr_sub_d
         c = cc;  % Do not assign c before calculation succeeded!
       elseif (isa (a, 'mpfr_t') && isa (b, 'mpfr_t'))
         if (isempty (prec))
-          prec = max (max (mpfr_get_prec (a)), max (mpfr_get_prec (b)));
+          prec = max (max (mpfr_get_prec (a.idx)), max (mpfr_get_prec (b.idx)));
         end
         if (isequal (a.dims, b.dims) || isequal (b.dims, [1 1]))
-          cc = mpfr_t (zeros (a.dims), prec);
+          cc = mpfr_t (a.dims, prec, [], 'zeros');
         elseif (isequal (a.dims, [1 1]))
-          cc = mpfr_t (zeros (b.dims), prec);
+          cc = mpfr_t (b.dims, prec, [], 'zeros');
         else
           error ('mpfr_t:minus', 'Incompatible dimensions of a and b.');
         end
-        ret = mpfr_sub (cc, a, b, rnd);
+        ret = mex_apa_interface (1911, 1033, cc.idx, a.idx, b.idx, ...
+                                 rnd);  % mpfr_sub
         c = cc;  % Do not assign c before calculation succeeded!
       else
         error ('mpfr_t:minus', 'Invalid operands a and b.');
       end
-      c.warnInexactOperation (ret);
+      c.warnInexactOperation (ret(1:2));
     end
 
 
@@ -489,28 +706,30 @@ classdef mpfr_t
       elseif (isa (a, 'mpfr_t') && isnumeric (b))
         if (isscalar (b) || isequal (a.dims, size (b)))
           if (isempty (prec))
-            prec = max (mpfr_get_prec (a));
+            prec = max (mpfr_get_prec (a.idx));
           end
-          cc = mpfr_t (zeros (a.dims), prec);
+          cc = mpfr_t (a.dims, prec, [], 'zeros');
         else
           error ('mpfr_t:times', 'Incompatible dimensions of a and b.');
         end
-        ret = mpfr_mul_d (cc, a, double (b(:)), rnd);
-        cc.warnInexactOperation (ret);
+        ret = mex_apa_interface (1911, 1350, cc.idx, a.idx, double (b(:)), ...
+                                 rnd);  % mpfr_mul_d
+        cc.warnInexactOperation (ret(1:2));
         c = cc;  % Do not assign c before calculation succeeded!
       elseif (isa (a, 'mpfr_t') && isa (b, 'mpfr_t'))
         if (isempty (prec))
-          prec = max (max (mpfr_get_prec (a)), max (mpfr_get_prec (b)));
+          prec = max (max (mpfr_get_prec (a.idx)), max (mpfr_get_prec (b.idx)));
         end
         if (isequal (a.dims, b.dims) || isequal (b.dims, [1 1]))
-          cc = mpfr_t (zeros (a.dims), prec);
+          cc = mpfr_t (a.dims, prec, [], 'zeros');
         elseif (isequal (a.dims, [1 1]))
-          cc = mpfr_t (zeros (b.dims), prec);
+          cc = mpfr_t (b.dims, prec, [], 'zeros');
         else
           error ('mpfr_t:times', 'Incompatible dimensions of a and b.');
         end
-        ret = mpfr_mul (cc, a, b, rnd);
-        cc.warnInexactOperation (ret);
+        ret = mex_apa_interface (1911, 1036, cc.idx, a.idx, b.idx, ...
+                                 rnd);  % mpfr_mul
+        cc.warnInexactOperation (ret(1:2));
         c = cc;  % Do not assign c before calculation succeeded!
       else
         error ('mpfr_t:times', 'Invalid operands a and b.');
@@ -528,6 +747,26 @@ classdef mpfr_t
       %
       % If no precision `prec` is given for `c` the maximum precision of a and
       % is used b.
+      %
+      % `strategy` selects the implementation in `mpfr_apa_mmm`.  Strategy 8
+      % multiplies cache-blocked tiles of packed panels in a single parallel
+      % region.  Strategy 9 is Strassen-Winograd's algorithm with guard bits,
+      % which is faster for large matrices of high precision, but has only a
+      % normwise error bound (see `apa ('strassen_cutoff')`).  Strategy 10 is
+      % Winograd's inner product algorithm, which halves the number of
+      % multiplications and has only a normwise error bound as well.
+      % Strategy 11 accumulates the inner products exactly in GMP integers,
+      % which gives correctly rounded results and is faster for moderate
+      % precision, if the exponent spread of each row of a and column of b
+      % is bounded.  Otherwise it falls back to strategy 8.  Strategy 12 is
+      % the Ozaki scheme, which splits a and b into slices of double
+      % precision integers and multiplies them exactly by the BLAS of
+      % Octave/Matlab.  It is much faster for precisions up to a few hundred
+      % bits and has a normwise error bound.  It falls back to strategy 8 for
+      % NaN or Inf elements, more than 32 slices or 1 GiB of slices, or if
+      % the integer type of the BLAS is unknown.  The default strategy 0
+      % selects strategy 10 from the precision `apa ('winograd_prec')` on,
+      % otherwise strategy 8.
 
       if (nargin < 3)
         rnd = mpfr_get_default_rounding_mode ();
@@ -536,7 +775,7 @@ classdef mpfr_t
         prec = [];
       end
       if (nargin < 5)
-        strategy = 7;
+        strategy = 0;
       end
 
       % TODO: mpfr_t * double
@@ -554,8 +793,8 @@ classdef mpfr_t
       end
 
       if (isempty (prec))
-        precA = mpfr_get_prec (a);
-        precB = mpfr_get_prec (b);
+        precA = mpfr_get_prec (a.idx);
+        precB = mpfr_get_prec (b.idx);
         prec = max ([precA(:); precB(:)]);
       end
 
@@ -565,7 +804,7 @@ classdef mpfr_t
         error ('mpfr_t:mtimes', 'Incompatible dimensions of a and b.');
       end
 
-      c = mpfr_t (zeros (sizeA(1), sizeB(2)), prec, rnd);
+      c = mpfr_t ([sizeA(1), sizeB(2)], prec, rnd, 'zeros');
       ret = mex_apa_interface (2001, c.idx, a.idx, b.idx, prec, rnd, ...
                                sizeA(1), strategy);
       c.warnInexactOperation (ret);
@@ -589,42 +828,45 @@ classdef mpfr_t
       if (isnumeric (a) && isa (b, 'mpfr_t'))
         if (isscalar (a) || isequal (size (a), b.dims))
           if (isempty (prec))
-            prec = max (mpfr_get_prec (b));
+            prec = max (mpfr_get_prec (b.idx));
           end
-          cc = mpfr_t (zeros (b.dims), prec);
+          cc = mpfr_t (b.dims, prec, [], 'zeros');
         else
           error ('mpfr_t:rdivide', 'Incompatible dimensions of a and b.');
         end
-        ret = mpfr_d_div (cc, double (a(:)), b, rnd);
+        ret = mex_apa_interface (1911, 1363, cc.idx, double (a(:)), b.idx, ...
+                                 rnd);  % mpfr_d_div
         c = cc;  % Do not assign c before calculation succeeded!
       elseif (isa (a, 'mpfr_t') && isnumeric (b))
         if (isscalar (b) || isequal (a.dims, size (b)))
           if (isempty (prec))
-            prec = max (mpfr_get_prec (a));
+            prec = max (mpfr_get_prec (a.idx));
           end
-          cc = mpfr_t (zeros (a.dims), prec);
+          cc = mpfr_t (a.dims, prec, [], 'zeros');
         else
           error ('mpfr_t:rdivide', 'Incompatible dimensions of a and b.');
         end
-        ret = mpfr_div_d (cc, a, double (b(:)), rnd);
+        ret = mex_apa_interface (1911, 1360, cc.idx, a.idx, double (b(:)), ...
+                                 rnd);  % mpfr_div_d
         c = cc;  % Do not assign c before calculation succeeded!
       elseif (isa (a, 'mpfr_t') && isa (b, 'mpfr_t'))
         if (isempty (prec))
-          prec = max (max (mpfr_get_prec (a)), max (mpfr_get_prec (b)));
+          prec = max (max (mpfr_get_prec (a.idx)), max (mpfr_get_prec (b.idx)));
         end
         if (isequal (a.dims, b.dims) || isequal (b.dims, [1 1]))
-          cc = mpfr_t (zeros (a.dims), prec);
+          cc = mpfr_t (a.dims, prec, [], 'zeros');
         elseif (isequal (a.dims, [1 1]))
-          cc = mpfr_t (zeros (b.dims), prec);
+          cc = mpfr_t (b.dims, prec, [], 'zeros');
         else
           error ('mpfr_t:rdivide', 'Incompatible dimensions of a and b.');
         end
-        ret = mpfr_div (cc, a, b, rnd);
+        ret = mex_apa_interface (1911, 1039, cc.idx, a.idx, b.idx, ...
+                                 rnd);  % mpfr_div
         c = cc;  % Do not assign c before calculation succeeded!
       else
         error ('mpfr_t:rdivide', 'Invalid operands a and b.');
       end
-      c.warnInexactOperation (ret);
+      c.warnInexactOperation (ret(1:2));
     end
 
 
@@ -728,31 +970,33 @@ classdef mpfr_t
       if (isa (a, 'mpfr_t') && isnumeric (b))
         if (isscalar (b) || isequal (a.dims, size (b)))
           if (isempty (prec))
-            prec = max (mpfr_get_prec (a));
+            prec = max (mpfr_get_prec (a.idx));
           end
-          cc = mpfr_t (zeros (a.dims), prec);
+          cc = mpfr_t (a.dims, prec, [], 'zeros');
         else
           error ('mpfr_t:power', 'Incompatible dimensions of a and b.');
         end
-        ret = mpfr_pow_si (cc, a, double (b(:)), rnd);
+        ret = mex_apa_interface (1911, 1094, cc.idx, a.idx, double (b(:)), ...
+                                 rnd);  % mpfr_pow_si
         c = cc;  % Do not assign c before calculation succeeded!
       elseif (isa (a, 'mpfr_t') && isa (b, 'mpfr_t'))
         if (isempty (prec))
-          prec = max (max (mpfr_get_prec (a)), max (mpfr_get_prec (b)));
+          prec = max (max (mpfr_get_prec (a.idx)), max (mpfr_get_prec (b.idx)));
         end
         if (isequal (a.dims, b.dims) || isequal (b.dims, [1 1]))
-          cc = mpfr_t (zeros (a.dims), prec);
+          cc = mpfr_t (a.dims, prec, [], 'zeros');
         elseif (isequal (a.dims, [1 1]))
-          cc = mpfr_t (zeros (b.dims), prec);
+          cc = mpfr_t (b.dims, prec, [], 'zeros');
         else
           error ('mpfr_t:power', 'Incompatible dimensions of a and b.');
         end
-        ret = mpfr_pow (cc, a, b, rnd);
+        ret = mex_apa_interface (1911, 1092, cc.idx, a.idx, b.idx, ...
+                                 rnd);  % mpfr_pow
         c = cc;  % Do not assign c before calculation succeeded!
       else
         error ('mpfr_t:power', 'Invalid operands a and b.');
       end
-      c.warnInexactOperation (ret);
+      c.warnInexactOperation (ret(1:2));
     end
 
 
@@ -868,7 +1112,7 @@ classdef mpfr_t
       end
 
       % Allocate memory for b.
-      b = mpfr_t (nan (fliplr (a.dims)), max (mpfr_get_prec (a)), rnd);
+      b = mpfr_t (fliplr (a.dims), max (mpfr_get_prec (a.idx)), rnd, 'nan');
 
       ret = mex_apa_interface (2000, b.idx, a.idx, rnd, b.dims(1));
       a.warnInexactOperation (ret);
@@ -915,7 +1159,7 @@ classdef mpfr_t
       all_dims(dim) = ii(end);
 
       % Create output variable.
-      c = mpfr_t (zeros (all_dims(:)'), prec);
+      c = mpfr_t (all_dims(:)', prec, [], 'zeros');
 
       % Copy elements to concatenate.
       s.type = '()';
@@ -981,12 +1225,12 @@ classdef mpfr_t
         rnd = mpfr_get_default_rounding_mode ();
       end
       if (nargin < 3)
-        prec = max (mpfr_get_prec (a));
+        prec = max (mpfr_get_prec (a.idx));
       end
 
-      bb = mpfr_t (zeros (a.dims), prec);
-      ret = mpfr_sqrt (bb, a, rnd);
-      a.warnInexactOperation (ret);
+      bb = mpfr_t (a.dims, prec, [], 'zeros');
+      ret = mex_apa_interface (1911, 1042, bb.idx, a.idx, rnd);  % mpfr_sqrt
+      a.warnInexactOperation (ret(1:2));
       b = bb;  % Do not assign b before calculation succeeded!
     end
 
@@ -1002,44 +1246,589 @@ classdef mpfr_t
         rnd = mpfr_get_default_rounding_mode ();
       end
       if (nargin < 3)
-        prec = max (mpfr_get_prec (a));
+        prec = max (mpfr_get_prec (a.idx));
       end
 
-      bb = mpfr_t (zeros (a.dims), prec);
-      ret = mpfr_abs (bb, a, rnd);
-      a.warnInexactOperation (ret);
+      bb = mpfr_t (a.dims, prec, [], 'zeros');
+      ret = mex_apa_interface (1911, 1049, bb.idx, a.idx, rnd);  % mpfr_abs
+      a.warnInexactOperation (ret(1:2));
       b = bb;  % Do not assign b before calculation succeeded!
     end
 
 
-    function b = min (a, rnd, prec)
-      % Minimum elements of an array `b = min(a)` using rounding mode `rnd`.
+    function b = sum (a, dim, rnd, prec)
+      % Sum of elements `b = sum(a, dim)` using rounding mode `rnd`.
+      %
+      % The sums are correctly rounded, independent of the order of the
+      % elements.  If no dimension `dim` is given, the first non-singleton
+      % dimension of `a` is used.
       %
       % If no rounding mode `rnd` is given, the default rounding mode is used.
       %
       % If no precision `prec` is given for `b` the maximum precision of a.
+
+      if (nargin < 2)
+        dim = [];
+      end
+      if (nargin < 3)
+        rnd = mpfr_get_default_rounding_mode ();
+      end
+      if (nargin < 4)
+        prec = max (mpfr_get_prec (a.idx));
+      end
+      b = a.reduce (0, dim, rnd, prec);  % MPFR_REDUCE_SUM
+    end
+
+
+    function b = prod (a, dim, rnd, prec)
+      % Product of elements `b = prod(a, dim)` using rounding mode `rnd`.
+      %
+      % If no dimension `dim` is given, the first non-singleton dimension of
+      % `a` is used.
       %
-      % If `a` is a matrix, then `min(a)` is a row vector containing the
-      % minimum value of each matrix column.
+      % If no rounding mode `rnd` is given, the default rounding mode is used.
+      %
+      % If no precision `prec` is given for `b` the maximum precision of a.
 
       if (nargin < 2)
+        dim = [];
+      end
+      if (nargin < 3)
         rnd = mpfr_get_default_rounding_mode ();
       end
+      if (nargin < 4)
+        prec = max (mpfr_get_prec (a.idx));
+      end
+      b = a.reduce (1, dim, rnd, prec);  % MPFR_REDUCE_PROD
+    end
+
+
+    function b = mean (a, dim, rnd, prec)
+      % Mean of elements `b = mean(a, dim)` using rounding mode `rnd`.
+      %
+      % If no dimension `dim` is given, the first non-singleton dimension of
+      % `a` is used.
+      %
+      % If no rounding mode `rnd` is given, the default rounding mode is used.
+      %
+      % If no precision `prec` is given for `b` the maximum precision of a.
+
+      if ((nargin < 2) || isempty (dim))
+        dim = find (a.dims ~= 1, 1);
+        if (isempty (dim))
+          dim = 1;
+        end
+      end
       if (nargin < 3)
-        prec = max (mpfr_get_prec (a));
+        rnd = mpfr_get_default_rounding_mode ();
       end
+      if (nargin < 4)
+        prec = max (mpfr_get_prec (a.idx));
+      end
+      b = rdivide (sum (a, dim, rnd, prec), a.dims(dim), rnd, prec);
+    end
+
 
-      N = a.dims(2);
-      if (a.dims(1) == 1)
-        N = 1;
+    function [b, i] = max (a, c, dim, rnd, prec)
+      % Maximum elements of an array `[b, i] = max(a, [], dim)` using rounding
+      % mode `rnd`.
+      %
+      % If no dimension `dim` is given, the first non-singleton dimension of
+      % `a` is used.  `i` are the indices of the first maximum elements along
+      % `dim`.  NaN elements are ignored, unless all elements are NaN.
+      %
+      % If no rounding mode `rnd` is given, the default rounding mode is used.
+      %
+      % If no precision `prec` is given for `b` the maximum precision of a.
+      %
+      % The short form `b = max(a, rnd, prec)` reduces along the first
+      % non-singleton dimension.
+
+      if ((nargin == 2) && isnumeric (c) && isscalar (c))
+        [b, i] = max (a, [], [], c);  % b = max (a, rnd)
+        return;
+      elseif ((nargin == 3) && isnumeric (c) && isscalar (c))
+        [b, i] = max (a, [], [], c, dim);  % b = max (a, rnd, prec)
+        return;
+      end
+      if ((nargin > 1) && ~isempty (c))
+        error ('mpfr_t:max', 'Only `max (a, [], dim)` is supported.');
+      end
+      if (nargin < 3)
+        dim = [];
       end
-      bb = mpfr_t (zeros (1, N), prec);
-      ret = mex_apa_interface (2004, bb.idx, a.idx, rnd);
+      if (nargin < 4)
+        rnd = mpfr_get_default_rounding_mode ();
+      end
+      if (nargin < 5)
+        prec = max (mpfr_get_prec (a.idx));
+      end
+      [b, i] = a.reduce (2, dim, rnd, prec);  % MPFR_REDUCE_MAX
+    end
+
+
+    function [b, i] = min (a, c, dim, rnd, prec)
+      % Minimum elements of an array `[b, i] = min(a, [], dim)` using rounding
+      % mode `rnd`.
+      %
+      % If no dimension `dim` is given, the first non-singleton dimension of
+      % `a` is used.  `i` are the indices of the first minimum elements along
+      % `dim`.  NaN elements are ignored, unless all elements are NaN.
+      %
+      % If no rounding mode `rnd` is given, the default rounding mode is used.
+      %
+      % If no precision `prec` is given for `b` the maximum precision of a.
+      %
+      % The short form `b = min(a, rnd, prec)` reduces along the first
+      % non-singleton dimension.
+
+      if ((nargin == 2) && isnumeric (c) && isscalar (c))
+        [b, i] = min (a, [], [], c);  % b = min (a, rnd)
+        return;
+      elseif ((nargin == 3) && isnumeric (c) && isscalar (c))
+        [b, i] = min (a, [], [], c, dim);  % b = min (a, rnd, prec)
+        return;
+      end
+      if ((nargin > 1) && ~isempty (c))
+        error ('mpfr_t:min', 'Only `min (a, [], dim)` is supported.');
+      end
+      if (nargin < 3)
+        dim = [];
+      end
+      if (nargin < 4)
+        rnd = mpfr_get_default_rounding_mode ();
+      end
+      if (nargin < 5)
+        prec = max (mpfr_get_prec (a.idx));
+      end
+      [b, i] = a.reduce (3, dim, rnd, prec);  % MPFR_REDUCE_MIN
+    end
+
+
+    function b = norm (a, p, rnd, prec)
+      % Vector and matrix norms `b = norm(a, p)` using rounding mode `rnd`.
+      %
+      % For vectors `p` can be 1, 2 (default), Inf, or 'fro'.  For matrices
+      % `p` can be 1, Inf, or 'fro' (default).  Vector 1-norms are correctly
+      % rounded.
+      %
+      % If no rounding mode `rnd` is given, the default rounding mode is used.
+      %
+      % If no precision `prec` is given for `b` the maximum precision of a.
+
+      is_vector = any (a.dims == 1);
+      if ((nargin < 2) || isempty (p))
+        if (is_vector)
+          p = 2;
+        else
+          p = 'fro';
+        end
+      end
+      if (nargin < 3)
+        rnd = mpfr_get_default_rounding_mode ();
+      end
+      if (nargin < 4)
+        prec = max (mpfr_get_prec (a.idx));
+      end
+
+      % Reduce all elements `a(:)` of a vector or for the Frobenius norm.
+      N = prod (a.dims);
+      if (ischar (p) && strcmpi (p, 'fro'))
+        b = a.reduce (5, 1, rnd, prec, N);  % MPFR_REDUCE_NORM2
+      elseif (~isnumeric (p) || ~isscalar (p))
+        error ('mpfr_t:norm', 'Invalid norm p.');
+      elseif (is_vector && (p == 1))
+        b = a.reduce (4, 1, rnd, prec, N);  % MPFR_REDUCE_NORM1
+      elseif (is_vector && (p == 2))
+        b = a.reduce (5, 1, rnd, prec, N);  % MPFR_REDUCE_NORM2
+      elseif (is_vector && (p == Inf))
+        b = a.reduce (6, 1, rnd, prec, N);  % MPFR_REDUCE_NORMINF
+      elseif (p == 1)  % Maximum column sum.
+        b = max (a.reduce (4, 1, rnd, prec), [], 2, rnd, prec);
+      elseif (p == Inf)  % Maximum row sum.
+        b = max (a.reduce (4, 2, rnd, prec), [], 1, rnd, prec);
+      else
+        error ('mpfr_t:norm', 'Matrix norm p = %g is not supported.', p);
+      end
+    end
+
+
+    function b = scan (a, op, dim, type, rnd, prec)
+      % Prefix scan `b = scan(a, op, dim, type)` using rounding mode `rnd`.
+      %
+      % `op` is one of 'plus', 'times', 'max', or 'min'.  If `type` is
+      % 'inclusive' (default), `b(k)` combines the elements `a(1:k)` along
+      % dimension `dim`, if `type` is 'exclusive', the elements `a(1:k-1)`.
+      % The first element of an exclusive scan is 0, 1, -Inf, or Inf,
+      % respectively.  If no dimension `dim` is given, the first non-singleton
+      % dimension of `a` is used.
+      %
+      % Long vectors are scanned in parallel blocks of fixed length, see
+      % mex_mpfr_algorithms_scan.c.
+      %
+      % If no rounding mode `rnd` is given, the default rounding mode is used.
+      %
+      % If no precision `prec` is given for `b` the maximum precision of a.
+
+      kind = find (strcmp (op, {'plus', 'times', 'max', 'min'})) - 1;
+      if (isempty (kind))
+        error ('mpfr_t:scan', 'Invalid scan operation op.');
+      end
+      if ((nargin < 3) || isempty (dim))
+        dim = find (a.dims ~= 1, 1);
+        if (isempty (dim))
+          dim = 1;
+        end
+      end
+      if (~isequal (dim, 1) && ~isequal (dim, 2))
+        error ('mpfr_t:scan', 'Dimension dim must be 1 or 2.');
+      end
+      if ((nargin < 4) || isempty (type))
+        type = 'inclusive';
+      end
+      exclusive = find (strcmp (type, {'inclusive', 'exclusive'})) - 1;
+      if (isempty (exclusive))
+        error ('mpfr_t:scan', ...
+               'Scan type must be ''inclusive'' or ''exclusive''.');
+      end
+      if (nargin < 5)
+        rnd = mpfr_get_default_rounding_mode ();
+      end
+      if (nargin < 6)
+        prec = max (mpfr_get_prec (a.idx));
+      end
+
+      bb = mpfr_t (a.dims, prec, [], 'zeros');
+      ret = mex_apa_interface (2007, bb.idx, a.idx, a.dims(1), dim, kind, ...
+                               exclusive, prec, rnd);  % mpfr_t.scan
       a.warnInexactOperation (ret);
       b = bb;  % Do not assign b before calculation succeeded!
     end
 
 
+    function b = cumsum (a, dim, rnd, prec)
+      % Cumulative sum `b = cumsum(a, dim)` using rounding mode `rnd`.
+      %
+      % See `scan` for details.
+
+      if (nargin < 2)
+        dim = [];
+      end
+      if (nargin < 3)
+        rnd = mpfr_get_default_rounding_mode ();
+      end
+      if (nargin < 4)
+        prec = max (mpfr_get_prec (a.idx));
+      end
+      b = scan (a, 'plus', dim, 'inclusive', rnd, prec);
+    end
+
+
+    function b = cumprod (a, dim, rnd, prec)
+      % Cumulative product `b = cumprod(a, dim)` using rounding mode `rnd`.
+      %
+      % See `scan` for details.
+
+      if (nargin < 2)
+        dim = [];
+      end
+      if (nargin < 3)
+        rnd = mpfr_get_default_rounding_mode ();
+      end
+      if (nargin < 4)
+        prec = max (mpfr_get_prec (a.idx));
+      end
+      b = scan (a, 'times', dim, 'inclusive', rnd, prec);
+    end
+
+
+    function b = cummax (a, dim, rnd, prec)
+      % Cumulative maximum `b = cummax(a, dim)` using rounding mode `rnd`.
+      %
+      % NaN elements are ignored.  See `scan` for details.
+
+      if (nargin < 2)
+        dim = [];
+      end
+      if (nargin < 3)
+        rnd = mpfr_get_default_rounding_mode ();
+      end
+      if (nargin < 4)
+        prec = max (mpfr_get_prec (a.idx));
+      end
+      b = scan (a, 'max', dim, 'inclusive', rnd, prec);
+    end
+
+
+    function b = cummin (a, dim, rnd, prec)
+      % Cumulative minimum `b = cummin(a, dim)` using rounding mode `rnd`.
+      %
+      % NaN elements are ignored.  See `scan` for details.
+
+      if (nargin < 2)
+        dim = [];
+      end
+      if (nargin < 3)
+        rnd = mpfr_get_default_rounding_mode ();
+      end
+      if (nargin < 4)
+        prec = max (mpfr_get_prec (a.idx));
+      end
+      b = scan (a, 'min', dim, 'inclusive', rnd, prec);
+    end
+
+
+    function [b, i] = sort (a, varargin)
+      % Stable sort `[b, i] = sort(a, dim, mode)` along dimension `dim`.
+      %
+      % `mode` is 'ascend' (default) or 'descend'.  `i` are the indices along
+      % `dim` of the sorted elements in `a`.  If no dimension `dim` is given,
+      % the first non-singleton dimension of `a` is used.
+      %
+      % NaN elements are sorted last for 'ascend' and first for 'descend',
+      % unless the option 'MissingPlacement' is 'first' or 'last', e.g.
+      %
+      %   b = sort (a, 'descend', 'MissingPlacement', 'last');
+      %
+      % The elements of `b` are exchanged by `mpfr_swap`, thus only the copy
+      % of `a` copies significands.
+
+      dim = [];
+      mode = 'ascend';
+      nan_placement = 'auto';
+      k = 1;
+      while (k <= numel (varargin))
+        if (isnumeric (varargin{k}))
+          dim = varargin{k};
+        elseif (any (strcmpi (varargin{k}, {'ascend', 'descend'})))
+          mode = lower (varargin{k});
+        elseif (strcmpi (varargin{k}, 'MissingPlacement') ...
+                && (k < numel (varargin)))
+          k = k + 1;
+          nan_placement = lower (varargin{k});
+        else
+          error ('mpfr_t:sort', 'Invalid argument %d.', k + 1);
+        end
+        k = k + 1;
+      end
+      if (isempty (dim))
+        dim = find (a.dims ~= 1, 1);
+        if (isempty (dim))
+          dim = 1;
+        end
+      end
+      if (~isequal (dim, 1) && ~isequal (dim, 2))
+        error ('mpfr_t:sort', 'Dimension dim must be 1 or 2.');
+      end
+      descend = strcmp (mode, 'descend');
+      switch (nan_placement)
+        case 'auto'
+          nan_first = descend;
+        case 'first'
+          nan_first = 1;
+        case 'last'
+          nan_first = 0;
+        otherwise
+          error ('mpfr_t:sort', ...
+                 'MissingPlacement must be ''auto'', ''first'', or ''last''.');
+      end
+
+      bb = mpfr_t (a);
+      if (nargout > 1)
+        i = mex_apa_interface (2008, bb.idx, a.dims(1), dim, descend, ...
+                               nan_first);  % mpfr_t.sort
+      else
+        mex_apa_interface (2008, bb.idx, a.dims(1), dim, descend, ...
+                           nan_first);  % mpfr_t.sort
+      end
+      b = bb;  % Do not assign b before calculation succeeded!
+    end
+
+
+    function [b, i] = sortrows (a, c)
+      % Stable sort of the rows `[b, i] = sortrows(a, c)`.
+      %
+      % The rows are sorted by the columns `c` in order of precedence,
+      % negative for descending order.  By default all columns are used in
+      % ascending order.  NaN is greater than all numbers.  `i` are the
+      % indices of the sorted rows in `a`.
+
+      if ((nargin < 2) || isempty (c))
+        c = 1:a.dims(2);
+      end
+      if (~isnumeric (c) || any (c(:) == 0) || any (fix (c(:)) ~= c(:)) ...
+          || any (abs (c(:)) > a.dims(2)))
+        error ('mpfr_t:sortrows', 'Columns c must be non-zero column indices.');
+      end
+
+      bb = mpfr_t (a);
+      if (nargout > 1)
+        i = mex_apa_interface (2010, bb.idx, a.dims(1), ...
+                               double (c(:)));  % mpfr_t.sortrows
+      else
+        mex_apa_interface (2010, bb.idx, a.dims(1), ...
+                           double (c(:)));  % mpfr_t.sortrows
+      end
+      b = bb;  % Do not assign b before calculation succeeded!
+    end
+
+
+    function b = nth_element (a, n, dim, rnd, prec)
+      % The `n`-th smallest elements `b = nth_element(a, n, dim)` along
+      % dimension `dim`, as if `a` was sorted.
+      %
+      % `n` is a vector of indices.  If no dimension `dim` is given, the first
+      % non-singleton dimension of `a` is used.  NaN elements are greater than
+      % all numbers.  Each column (or row) is partially sorted by quickselect
+      % without copying `a`, see mex_mpfr_algorithms_sort.c.
+      %
+      % If no rounding mode `rnd` is given, the default rounding mode is used.
+      %
+      % If no precision `prec` is given for `b` the maximum precision of a.
+
+      if ((nargin < 3) || isempty (dim))
+        dim = find (a.dims ~= 1, 1);
+        if (isempty (dim))
+          dim = 1;
+        end
+      end
+      if (~isequal (dim, 1) && ~isequal (dim, 2))
+        error ('mpfr_t:nth_element', 'Dimension dim must be 1 or 2.');
+      end
+      if (~isnumeric (n) || isempty (n) || any (fix (n(:)) ~= n(:)) ...
+          || any (n(:) < 1) || any (n(:) > a.dims(dim)))
+        error ('mpfr_t:nth_element', ...
+               'n must be indices between 1 and %d.', a.dims(dim));
+      end
+      if (nargin < 4)
+        rnd = mpfr_get_default_rounding_mode ();
+      end
+      if (nargin < 5)
+        prec = max (mpfr_get_prec (a.idx));
+      end
+
+      [ranks, ~, j] = unique (n(:));
+      b = a.select (ranks, dim, rnd, prec);
+      if (~isequal (ranks, n(:)))
+        b = subsref (b, a.dim_subs (dim, j));
+      end
+    end
+
+
+    function b = median (a, dim, rnd, prec)
+      % Median `b = median(a, dim)` using rounding mode `rnd`.
+      %
+      % If no dimension `dim` is given, the first non-singleton dimension of
+      % `a` is used.  The median of a column (or row) containing NaN is NaN.
+      % The mean of the two middle elements is correctly rounded.
+      %
+      % If no rounding mode `rnd` is given, the default rounding mode is used.
+      %
+      % If no precision `prec` is given for `b` the maximum precision of a.
+
+      if ((nargin < 2) || isempty (dim))
+        dim = find (a.dims ~= 1, 1);
+        if (isempty (dim))
+          dim = 1;
+        end
+      end
+      if (~isequal (dim, 1) && ~isequal (dim, 2))
+        error ('mpfr_t:median', 'Dimension dim must be 1 or 2.');
+      end
+      if (nargin < 3)
+        rnd = mpfr_get_default_rounding_mode ();
+      end
+      if (nargin < 4)
+        prec = max (mpfr_get_prec (a.idx));
+      end
+
+      L = a.dims(dim);
+      if (mod (L, 2) == 1)
+        [b, nan_count] = a.select ((L + 1) / 2, dim, rnd, prec);
+      else
+        % The division of the rounded sum by 2 is exact.
+        [b, nan_count] = a.select ([L/2, L/2 + 1], dim, rnd, prec);
+        b = rdivide (plus (subsref (b, a.dim_subs (dim, 1)), ...
+                           subsref (b, a.dim_subs (dim, 2)), rnd, prec), ...
+                     2, rnd, prec);
+      end
+      if (any (nan_count))
+        j = find (nan_count);
+        b = subsasgn (b, struct ('type', '()', 'subs', {{j}}), ...
+                      NaN (numel (j), 1));
+      end
+    end
+
+
+    function q = quantile (a, p, dim, rnd, prec)
+      % Quantiles `q = quantile(a, p, dim)` using rounding mode `rnd`.
+      %
+      % Piecewise linear interpolation of the sorted elements, where `p(k)`
+      % corresponds to `(k - 0.5) / n`, as the default method 5 of Octave's
+      % `quantile`.  NaN elements are ignored.  If no dimension `dim` is
+      % given, the first non-singleton dimension of `a` is used.
+      %
+      % If no rounding mode `rnd` is given, the default rounding mode is used.
+      %
+      % If no precision `prec` is given for `q` the maximum precision of a.
+
+      if ((nargin < 2) || isempty (p))
+        p = [0.00, 0.25, 0.50, 0.75, 1.00];
+      end
+      if (~isnumeric (p) || any (p(:) < 0) || any (p(:) > 1))
+        error ('mpfr_t:quantile', 'Probabilities p must be in [0, 1].');
+      end
+      if ((nargin < 3) || isempty (dim))
+        dim = find (a.dims ~= 1, 1);
+        if (isempty (dim))
+          dim = 1;
+        end
+      end
+      if (~isequal (dim, 1) && ~isequal (dim, 2))
+        error ('mpfr_t:quantile', 'Dimension dim must be 1 or 2.');
+      end
+      if (nargin < 4)
+        rnd = mpfr_get_default_rounding_mode ();
+      end
+      if (nargin < 5)
+        prec = max (mpfr_get_prec (a.idx));
+      end
+
+      p = p(:);
+      dims = a.dims;
+      dims(dim) = numel (p);
+      q = mpfr_t (dims, prec, [], 'nan');
+      [~, nan_count] = a.select (1, dim, rnd, prec);
+      num = a.dims(dim) - nan_count;  % Numbers per column (or row).
+
+      % Columns with an equal number of NaN elements share the ranks.
+      for n = unique (num(num > 0))'
+        pos  = n * p + 0.5;
+        lo   = max (min (floor (pos), n - 1), 1);
+        frac = max (min (pos - lo, 1), 0);
+        if (n == 1)
+          lo(:)   = 1;
+          frac(:) = 0;
+        end
+        hi = min (lo + 1, n);
+        [ranks, ~, j] = unique ([lo; hi]);
+        x  = a.select (ranks, dim, rnd, prec);
+        xl = subsref (x, a.dim_subs (dim, j(1:numel (p))));
+        xh = subsref (x, a.dim_subs (dim, j(numel (p)+1:end)));
+        if (dim == 1)
+          frac = repmat (frac, 1, dims(2));
+        else
+          frac = repmat (frac', dims(1), 1);
+        end
+        qn = plus (xl, times (minus (xh, xl, rnd, prec), frac, rnd, prec), ...
+                   rnd, prec);
+        cols = find (num == n);
+        q = subsasgn (q, a.dim_subs (3 - dim, cols), ...
+                      subsref (qn, a.dim_subs (3 - dim, cols)));
+      end
+    end
+
+
     function [L, U, P] = lu (a, outputForm, prec, rnd)
       % LU matrix factorization.
       %
@@ -1062,8 +1851,8 @@ classdef mpfr_t
       end
 
       sizeA = A.dims;
-      L = mpfr_t (zeros (sizeA(1), min (sizeA)), prec, rnd);
-      U = mpfr_t (zeros (min (sizeA), sizeA(2)), prec, rnd);
+      L = mpfr_t ([sizeA(1), min (sizeA)], prec, rnd, 'zeros');
+      U = mpfr_t ([min (sizeA), sizeA(2)], prec, rnd, 'zeros');
 
       % A is overwritten after the function call!
       if (nargout == 2)
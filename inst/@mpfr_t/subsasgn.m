@@ -88,11 +88,11 @@ function obj = subsasgn (obj, s, b, rnd)
     % Shortcut ':' magic colon indexing.
     if (all (cellfun (@ischar, s.subs)) && all (strcmp (s.subs, ':')))
       if (isa (b, 'mpfr_t'))
-        ret = mpfr_set (obj, b, rnd);
+        ret = mpfr_set (obj.idx, b.idx, rnd);
       elseif (isnumeric (b))
-        ret = mpfr_set_d (obj, b(:), rnd);
+        ret = mpfr_set_d (obj.idx, b(:), rnd);
       elseif (iscellstr (b))
-        [ret, strpos] = mpfr_strtofr (obj, b(:), 0, rnd);
+        [ret, strpos] = mpfr_strtofr (obj.idx, b(:), 0, rnd);
         bad_strs = (cellfun (@numel, b(:)) >= strpos);
         if (any (bad_strs))
           bad_strs = try_eval (obj.idx, b, rnd, bad_strs);
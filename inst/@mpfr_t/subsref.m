@@ -54,12 +54,13 @@ function varargout = subsref (obj, s, rnd)
 
     % Shortcut ':' magic colon indexing.
     elseif (all (cellfun (@ischar, s.subs)) && all (strcmp (s.subs, ':')))
-      c = mpfr_t (zeros (s_dims), max (obj.prec));
-      ret = mpfr_set (c, obj, rnd);
+      c = mpfr_t (s_dims, max (obj.prec), [], 'zeros');
+      ret = mpfr_set (c.idx, obj.idx, rnd);
 
     % 1D or 2D index, e.g. `obj(1:end)` or `obj(1:end,1:end)`.
     else
-      c = mpfr_t (zeros (length (subs), length (columns)), max (obj.prec));
+      c = mpfr_t ([length(subs), length(columns)], max (obj.prec), [], ...
+                  'zeros');
       k = 1;
       for j = columns  % Iterate over all columns.
         c_col_offset = (k - 1) * c.dims(1);
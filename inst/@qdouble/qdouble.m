@@ -0,0 +1,18 @@
+classdef qdouble < mdouble
+  % Quad-double numbers of about 212 bits precision, see @mdouble.
+  %
+  %   a = qdouble (mpfr_t ('0.1', 212));
+  %   b = mpfr_t (a * a);
+
+  methods
+    function obj = qdouble (x)
+      % Construct a quad-double variable from `x`, see `mdouble`.
+
+      if (nargin < 1)
+        error ('qdouble:qdouble', 'At least one argument must be provided.');
+      end
+      obj = obj@mdouble (x, 4);
+    end
+  end
+
+end
@@ -8,6 +8,55 @@ function settings = apa (key, val)
   %  [2]: show error messages and precision warnings [default]
   %   3 : very verbose debug output.
   %
+  % 'limb_pool' (integer scalar):
+  %
+  %   0 : allocate MPFR significands with the system allocator
+  %  [1]: per-thread memory pool for MPFR significands [default]
+  %   2 : like 1, backed by transparent huge pages (Linux only)
+  %
+  %   Can only be changed, while no @mpfr_t variables exist.
+  %
+  % 'contiguous_limbs' (integer scalar):
+  %
+  %  [0]: each MPFR significand is allocated separately [default]
+  %   n : setting the precision of at least n elements at once (e.g. by the
+  %       @mpfr_t constructor) stores all significands in one contiguous
+  %       block, neighboring matrix elements share cache lines.
+  %
+  % 'fixed_limbs' (integer scalar):
+  %
+  %   0 : always call MPFR functions
+  %   n : use kernels specialized on the number of limbs for mul, div, fma,
+  %       and fms of operands with the same precision of at most n limbs
+  %       (64 bits each), where they are faster than MPFR [8, i.e. 512 bits]
+  %
+  % 'strassen_cutoff' (integer scalar):
+  %
+  %   n : matrix multiplication strategy 9 (Strassen-Winograd, see `mtimes`)
+  %       multiplies matrices with a dimension of at most n conventionally
+  %       [32], see benchmark_strassen.m for the crossover.  The workspace
+  %       of strategy 9 has about 2/3 of the size of the product.  With
+  %       OpenMP the seven products of the first one or two recursion levels
+  %       run in parallel, which needs about 4 or 10 times the size of the
+  %       product, unless this exceeds 256 MiB
+  %
+  % 'winograd_prec' (integer scalar):
+  %
+  %   0 : `mtimes` never uses Winograd's inner product algorithm by default
+  %   p : `mtimes` uses Winograd's inner product algorithm (strategy 10) by
+  %       default from precision p on [1024], see benchmark_winograd.m
+  %
+  % 'omp.min_cost'   (scalar): minimal estimated cost per thread of an
+  %                            element-wise operation, smaller operations run
+  %                            serially [32768, about a copy of 32768 limbs]
+  % 'omp.chunk_cost' (scalar): estimated cost of a chunk of elements
+  %                            scheduled at once [65536], 0 for the OpenMP
+  %                            default chunk size
+  % 'omp.schedule'   (string): ['cost'] static for cheap operations, guided
+  %                            for elementary and dynamic for special
+  %                            functions, or 'static', 'dynamic', 'guided'
+  %                            for all operations
+  %
   %  'format.fmt' (string): ['fixed-point'], 'scientific'
   %  'format.base'          (integer scalar): 2 ... [10] ... 62
   %  'format.inner_padding' (integer scalar): positive
@@ -24,6 +73,12 @@ function settings = apa (key, val)
 
   % Update settings which could be altered outside this function.
   m_settings.verbose = mex_apa_interface (9001);
+  m_settings.limb_pool = mex_apa_interface (9003);
+  m_settings.contiguous_limbs = mex_apa_interface (9005);
+  m_settings.fixed_limbs = mex_apa_interface (9009);
+  m_settings.strassen_cutoff = mex_apa_interface (9011);
+  m_settings.winograd_prec = mex_apa_interface (9013);
+  m_settings.omp = get_omp_settings ();
 
   switch (nargin) 
     case 0  % Get all mode.
@@ -71,6 +126,12 @@ function settings = apa_defaults ()
   % Get default APA settings.
 
   settings.verbose = mex_apa_interface (9001);
+  settings.limb_pool = mex_apa_interface (9003);
+  settings.contiguous_limbs = mex_apa_interface (9005);
+  settings.fixed_limbs = mex_apa_interface (9009);
+  settings.strassen_cutoff = mex_apa_interface (9011);
+  settings.winograd_prec = mex_apa_interface (9013);
+  settings.omp = get_omp_settings ();
 
   settings.format.fmt = 'fixed-point';
   settings.format.base = 10;
@@ -83,16 +144,24 @@ function bool = validate_apa_struct (s)
   fnames = fieldnames (s);
 
   % Check for missing fields.
-  if (length (fnames) > 2)
+  if (length (fnames) > 8)
     error ('apa:badInput', 'apa: struct has too many fields');
   end
 
-  for f = {'verbose', 'format'}
+  for f = {'verbose', 'limb_pool', 'contiguous_limbs', 'fixed_limbs', ...
+           'strassen_cutoff', 'winograd_prec', 'omp', 'format'}
     if (~ any (strcmp (fnames, f{1})))
       error ('apa:badInput', 'apa: setting "%s" is missing', f{1});
     end
   end
 
+  fnames = fieldnames (s.omp);
+  for f = {'min_cost', 'chunk_cost', 'schedule'}
+    if (~ any (strcmp (fnames, f{1})))
+      error ('apa:badInput', 'apa: setting "omp.%s" is missing', f{1});
+    end
+  end
+
   fnames = fieldnames (s.format);
   for f = {'fmt', 'base', 'inner_padding', 'break_at_col'}
     if (~ any (strcmp (fnames, f{1})))
@@ -106,6 +175,51 @@ function bool = validate_apa_struct (s)
     error ('apa:badInput', 'apa: "verbose" invalid value {0,1,2,3}');
   end
 
+  fval = s.limb_pool;
+  if (~ (isnumeric (fval) && isscalar (fval) && any (fval == [0, 1, 2])))
+    error ('apa:badInput', 'apa: "limb_pool" invalid value {0,1,2}');
+  end
+
+  fval = s.contiguous_limbs;
+  if (~ (isnumeric (fval) && isscalar (fval) && (0 <= fval) ...
+         && (fval == fix (fval))))
+    error ('apa:badInput', ['apa: "contiguous_limbs" must be a ', ...
+      'non-negative integer']);
+  end
+
+  fval = s.fixed_limbs;
+  if (~ (isnumeric (fval) && isscalar (fval) && any (fval == (0:8))))
+    error ('apa:badInput', 'apa: "fixed_limbs" invalid value {0,1,...,8}');
+  end
+
+  fval = s.strassen_cutoff;
+  if (~ (isnumeric (fval) && isscalar (fval) && (1 <= fval) ...
+         && (fval == fix (fval))))
+    error ('apa:badInput', ['apa: "strassen_cutoff" must be a positive ', ...
+      'integer']);
+  end
+
+  fval = s.winograd_prec;
+  if (~ (isnumeric (fval) && isscalar (fval) && (0 <= fval) ...
+         && (fval == fix (fval))))
+    error ('apa:badInput', ['apa: "winograd_prec" must be a non-negative ', ...
+      'integer']);
+  end
+
+  for f = {'min_cost', 'chunk_cost'}
+    fval = s.omp.(f{1});
+    if (~ (isnumeric (fval) && isscalar (fval) && (0 <= fval)))
+      error ('apa:badInput', ['apa: "omp.%s" must be a non-negative ', ...
+        'scalar'], f{1});
+    end
+  end
+
+  fval = s.omp.schedule;
+  if (~ (ischar (fval) && any (strcmp (fval, omp_schedules ()))))
+    error ('apa:badInput', ['apa: "omp.schedule" must be "cost", ', ...
+      '"static", "dynamic", or "guided"']);
+  end
+
   fval = s.format.fmt;
   if (~ (ischar (fval) && any (strcmp (fval, {'fixed-point', 'scientific'}))))
     error ('apa:badInput', ['apa: "format.fmt" must be "fixed-point" or ', ...
@@ -139,5 +253,35 @@ function bool = apply_apa_struct (s)
   catch
     error ('apa:badInput', 'apa: "verbose" invalid value {0,1,2,3}');
   end
+  try
+    mex_apa_interface (9002, s.limb_pool);
+  catch
+    error ('apa:badInput', ['apa: "limb_pool" cannot be changed while ', ...
+      '@mpfr_t variables exist']);
+  end
+  mex_apa_interface (9004, s.contiguous_limbs);
+  mex_apa_interface (9008, s.fixed_limbs);
+  mex_apa_interface (9010, s.strassen_cutoff);
+  mex_apa_interface (9012, s.winograd_prec);
+  mex_apa_interface (9006, s.omp.min_cost, s.omp.chunk_cost, ...
+    find (strcmp (s.omp.schedule, omp_schedules ())) - 1);
   bool = true;
 end
+
+
+function omp = get_omp_settings ()
+  % Get OpenMP scheduling settings of the MEX interface.
+
+  val = mex_apa_interface (9007);
+  schedules = omp_schedules ();
+  omp.min_cost = val(1);
+  omp.chunk_cost = val(2);
+  omp.schedule = schedules{val(3) + 1};
+end
+
+
+function schedules = omp_schedules ()
+  % Names of the OpenMP schedule kinds (0-based) of the MEX interface.
+
+  schedules = {'cost', 'static', 'dynamic', 'guided'};
+end
@@ -21,12 +21,25 @@ function install_apa (cmd)
     static_libs = {'libmpfr.a', 'libgmp.a'};
     cfiles = {'mex_apa_interface.c', ...
               'mex_gmp_interface.c', ...
+              'mex_gmp_interface_memory_pool.c', ...
+              'mex_mdouble_interface.c', ...
               'mex_mpfr_interface.c', ...
               'mex_mpfr_interface_extractors.c', ...
+              'mex_mpfr_interface_fixed.c', ...
+              'mex_mpfr_interface_limb_blocks.c', ...
               'mex_mpfr_interface_memory_managment.c', ...
+              'mex_mpfr_interface_schedule.c', ...
+              'mex_mpfr_interface_tape.c', ...
               'mex_mpfr_algorithms.c', ...
               'mex_mpfr_algorithms_dot.c', ...
+              'mex_mpfr_algorithms_exact.c', ...
+              'mex_mpfr_algorithms_fused.c', ...
               'mex_mpfr_algorithms_mmm.c', ...
+              'mex_mpfr_algorithms_ozaki.c', ...
+              'mex_mpfr_algorithms_reduce.c', ...
+              'mex_mpfr_algorithms_scan.c', ...
+              'mex_mpfr_algorithms_sort.c', ...
+              'mex_mpfr_algorithms_strassen.c', ...
               'mex_mpfr_algorithms_gauss.c'};
 
     % Set cflags and ldflags according to OS and Octave/Matlab.
@@ -59,6 +72,25 @@ function install_apa (cmd)
       error ('install_apa: Could not detect operating system.');
     end
 
+    % Link the BLAS of Octave/Matlab for the Ozaki scheme (`mtimes` strategy
+    % 12).  Matlab's BLAS uses 64-bit integers, Octave's BLAS the Fortran
+    % integer type of "octave-config.h".  If the integer type is unknown,
+    % strategy 12 falls back to strategy 8.
+    if (exist ('OCTAVE_VERSION', 'builtin') == 5)
+      blas_libs = strsplit (strtrim (mkoctfile ('-p', 'BLAS_LIBS')));
+      ldflags = [ldflags, blas_libs(~ cellfun (@isempty, blas_libs))];
+      blas_int = octave_f77_int_type ();
+      if (~ isempty (blas_int))
+        cflags{end+1} = ['-DAPA_BLAS_INT=', blas_int];
+      end
+    else
+      cflags{end+1} = '-DAPA_BLAS_INT=ptrdiff_t';
+      if (ispc ())
+        cflags{end+1} = '-DAPA_BLAS_NO_UNDERSCORE';
+      end
+      ldflags{end+1} = '-lmwblas';
+    end
+
     % Download pre-compiled static GMP and MPFR library.
     if (exist (static_libs_dir, 'dir') ~= 7)
       static_libs_url = 'https://github.com/gnu-octave/pkg-apa/releases/download/';
@@ -121,6 +153,22 @@ end
 
 
 
+function type = octave_f77_int_type ()
+% Fortran integer type of Octave, e.g. 'int32_t', or '' if unknown.
+  type = '';
+  config_h = fullfile (strtrim (mkoctfile ('-p', 'OCTINCLUDEDIR')), ...
+                       'octave-config.h');
+  if (exist (config_h, 'file') == 2)
+    t = regexp (fileread (config_h), ...
+                '#\s*define\s+OCTAVE_F77_INT_TYPE\s+(\w+)', 'tokens', 'once');
+    if (~ isempty (t))
+      type = t{1};
+    end
+  end
+end
+
+
+
 function add_to_path_if_not_exists (p)
 
   pc = regexp (path, pathsep, 'split');
@@ -17,6 +17,7 @@
 
 #include "mex_apa_interface.h"
 #include "mex_gmp_interface.h"
+#include "mex_mdouble_interface.h"
 #include "mex_mpfr_interface.h"
 
 
@@ -26,6 +27,7 @@
 // - level = 2: show error messages and precision warnings [default]
 // - level = 3: very verbose debug output.
 int VERBOSE = 2;
+int MEX_FCN_FAILED = 0;
 
 
 /**
@@ -47,6 +49,14 @@ mexFunction (int nlhs, mxArray *plhs[],
   DBG_PRINTF ("Command: code = %d, nlhs = %d, nrhs = %d\n", (int) cmd_code,
               nlhs, nrhs);
 
+  // Must be installed before any GMP or MPFR memory is allocated.
+  mex_gmp_memory_pool_install ();
+
+  // Reset after a failed `mpfr_t.summary` or `mpfr_t.tape_run` call.
+  mpfr_ternary_summary = 0;
+  mpfr_tape_replaying  = 0;
+  MEX_FCN_FAILED       = 0;
+
   /**
    * Branch to specialized interface.
    */
@@ -60,6 +70,9 @@ mexFunction (int nlhs, mxArray *plhs[],
   else if ((3000 <= cmd_code) && (cmd_code < 4000))
     mex_gmp_interface (nlhs, plhs, nrhs, prhs, cmd_code);
 
+  else if ((4000 <= cmd_code) && (cmd_code < 5000))
+    mex_mdouble_interface (nlhs, plhs, nrhs, prhs, cmd_code);
+
   else if (cmd_code == 9000)  // void mpfr_t.set_verbose (int level)
     {
       MEX_NARGINCHK (2);
@@ -77,6 +90,126 @@ mexFunction (int nlhs, mxArray *plhs[],
       plhs[0] = mxCreateDoubleScalar ((double) VERBOSE);
     }
 
+  else if (cmd_code == 9002)  // void mpfr_t.set_limb_pool (int mode)
+    {
+      MEX_NARGINCHK (2);
+      int64_t mode = LIMB_POOL_DEFAULT_MODE;
+      if (! extract_si (1, nrhs, prhs, &mode) || (mode < LIMB_POOL_MALLOC)
+          || (mode > LIMB_POOL_HUGE_PAGES))
+        MEX_FCN_ERR ("cmd[%s]: Mode must be 0, 1, or 2.\n",
+                     "mpfr_t.set_limb_pool");
+      if ((int) mode != mex_gmp_memory_pool_get_mode ())
+        {
+          // Limb memory must not be in use when changing allocators.
+          if (! mex_mpfr_release ())
+            MEX_FCN_ERR ("cmd[%s]: Mode cannot be changed while MPFR "
+                         "variables are in use.\n", "mpfr_t.set_limb_pool");
+          mex_gmp_memory_pool_set_mode ((int) mode);
+        }
+    }
+
+  else if (cmd_code == 9003)  // int mpfr_t.get_limb_pool (void)
+    {
+      MEX_NARGINCHK (1);
+      plhs[0] = mxCreateDoubleScalar ((double) mex_gmp_memory_pool_get_mode ());
+    }
+
+  else if (cmd_code == 9004)  // void mpfr_t.set_contiguous_limbs (size_t n)
+    {
+      MEX_NARGINCHK (2);
+      int64_t n = 0;
+      if (! extract_si (1, nrhs, prhs, &n) || (n < 0))
+        MEX_FCN_ERR ("cmd[%s]: Threshold must be a non-negative integer.\n",
+                     "mpfr_t.set_contiguous_limbs");
+      mpfr_limb_blocks_threshold = (size_t) n;
+    }
+
+  else if (cmd_code == 9005)  // size_t mpfr_t.get_contiguous_limbs (void)
+    {
+      MEX_NARGINCHK (1);
+      plhs[0] = mxCreateDoubleScalar ((double) mpfr_limb_blocks_threshold);
+    }
+
+  else if (cmd_code == 9006)  // void mpfr_t.set_omp_schedule (double min_cost, double chunk_cost, int kind)
+    {
+      MEX_NARGINCHK (4);
+      double  min_cost   = 0.0;
+      double  chunk_cost = 0.0;
+      int64_t kind       = MPFR_OMP_SCHED_COST;
+      if (! extract_d (1, nrhs, prhs, &min_cost) || ! (min_cost >= 0.0)
+          || ! extract_d (2, nrhs, prhs, &chunk_cost) || ! (chunk_cost >= 0.0))
+        MEX_FCN_ERR ("cmd[%s]: Costs must be non-negative numbers.\n",
+                     "mpfr_t.set_omp_schedule");
+      if (! extract_si (3, nrhs, prhs, &kind) || (kind < MPFR_OMP_SCHED_COST)
+          || (kind > omp_sched_guided))
+        MEX_FCN_ERR ("cmd[%s]: Kind must be 0, 1, 2, or 3.\n",
+                     "mpfr_t.set_omp_schedule");
+      mpfr_omp_min_cost   = min_cost;
+      mpfr_omp_chunk_cost = chunk_cost;
+      mpfr_omp_sched_kind = (int) kind;
+    }
+
+  else if (cmd_code == 9007)  // double[3] mpfr_t.get_omp_schedule (void)
+    {
+      MEX_NARGINCHK (1);
+      plhs[0] = mxCreateNumericMatrix (1, 3, mxDOUBLE_CLASS, mxREAL);
+      double *ptr = mxGetPr (plhs[0]);
+      ptr[0] = mpfr_omp_min_cost;
+      ptr[1] = mpfr_omp_chunk_cost;
+      ptr[2] = (double) mpfr_omp_sched_kind;
+    }
+
+  else if (cmd_code == 9008)  // void mpfr_t.set_fixed_limbs (size_t n)
+    {
+      MEX_NARGINCHK (2);
+      int64_t n = 0;
+      if (! extract_si (1, nrhs, prhs, &n) || (n < 0)
+          || (n > MPFR_FIXED_MAX_LIMBS))
+        MEX_FCN_ERR ("cmd[%s]: Number of limbs must be an integer between 0 "
+                     "and %d.\n", "mpfr_t.set_fixed_limbs",
+                     MPFR_FIXED_MAX_LIMBS);
+      mpfr_fixed_max_limbs = (size_t) n;
+    }
+
+  else if (cmd_code == 9009)  // size_t mpfr_t.get_fixed_limbs (void)
+    {
+      MEX_NARGINCHK (1);
+      plhs[0] = mxCreateDoubleScalar ((double) mpfr_fixed_max_limbs);
+    }
+
+  else if (cmd_code == 9010)  // void mpfr_t.set_strassen_cutoff (size_t n)
+    {
+      MEX_NARGINCHK (2);
+      int64_t n = 0;
+      if (! extract_si (1, nrhs, prhs, &n) || (n < 1))
+        MEX_FCN_ERR ("cmd[%s]: Cutoff must be a positive integer.\n",
+                     "mpfr_t.set_strassen_cutoff");
+      mpfr_strassen_cutoff = (size_t) n;
+    }
+
+  else if (cmd_code == 9011)  // size_t mpfr_t.get_strassen_cutoff (void)
+    {
+      MEX_NARGINCHK (1);
+      plhs[0] = mxCreateDoubleScalar ((double) mpfr_strassen_cutoff);
+    }
+
+  else if (cmd_code == 9012)  // void mpfr_t.set_winograd_prec (mpfr_prec_t prec)
+    {
+      MEX_NARGINCHK (2);
+      int64_t prec = 0;
+      if (! extract_si (1, nrhs, prhs, &prec) || (prec < 0)
+          || (prec > MPFR_PREC_MAX))
+        MEX_FCN_ERR ("cmd[%s]: Precision must be a non-negative integer.\n",
+                     "mpfr_t.set_winograd_prec");
+      mpfr_winograd_min_prec = (mpfr_prec_t) prec;
+    }
+
+  else if (cmd_code == 9013)  // mpfr_prec_t mpfr_t.get_winograd_prec (void)
+    {
+      MEX_NARGINCHK (1);
+      plhs[0] = mxCreateDoubleScalar ((double) mpfr_winograd_min_prec);
+    }
+
   else
     MEX_FCN_ERR ("Unknown command code '%d'\n", cmd_code);
 }
@@ -186,7 +319,7 @@ extract_ui_vector (int idx, int nrhs, const mxArray *prhs[], uint64_t **ui,
       int good = 1;
       for (size_t i = 0; i < len; i++)
         {
-          if ((vec[i] >= 0.0) && mxIsFinite (vec[i])
+          if ((vec[i] >= 0.0) && (vec[i] < 18446744073709551616.0)  // 2^64
               && (floor (vec[i]) == vec[i]))
             (*ui)[i] = (uint64_t) vec[i];
           else
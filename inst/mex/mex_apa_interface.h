@@ -39,11 +39,17 @@
 extern int VERBOSE;
 
 
+// Set by `MEX_FCN_ERR`.  Without error messages (`VERBOSE = 0`) a failed
+// call returns like a successful one, this flag tells them apart.
+extern int MEX_FCN_FAILED;
+
+
 // Macro to immediately return from current function.
 // Depending on `VERBOSE` variable an error message is printed.
 
 #define MEX_FCN_ERR(fmt, ...)                                   \
-  { if (VERBOSE > 0)                                            \
+  { MEX_FCN_FAILED = 1;                                         \
+    if (VERBOSE > 0)                                            \
       mexErrMsgIdAndTxt ("apa:mexFunction",                     \
                          "%s:%d:%s():" fmt, __FILE__, __LINE__, \
                          __func__, __VA_ARGS__);                \
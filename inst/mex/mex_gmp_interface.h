@@ -36,5 +36,79 @@ mex_gmp_interface (int nlhs, mxArray *plhs[],
                    int nrhs, const mxArray *prhs[],
                    uint64_t cmd_code);
 
+
+// GMP/MPFR limb memory pool
+// =========================
+//
+// mex_gmp_interface_memory_pool.c
+//
+// Modes:
+// - LIMB_POOL_MALLOC:     use the system allocator.
+// - LIMB_POOL_SLABS:      per-thread free lists of slab memory [default].
+// - LIMB_POOL_HUGE_PAGES: like LIMB_POOL_SLABS, slabs are backed by
+//                         transparent huge pages (Linux only).
+
+#define LIMB_POOL_MALLOC     0
+#define LIMB_POOL_SLABS      1
+#define LIMB_POOL_HUGE_PAGES 2
+
+#ifndef LIMB_POOL_DEFAULT_MODE
+# define LIMB_POOL_DEFAULT_MODE LIMB_POOL_SLABS
+#endif
+
+
+/**
+ * Install the limb memory pool as GMP memory functions.
+ *
+ * Must be called before any GMP or MPFR memory is allocated, thus at the
+ * beginning of each MEX call.  Subsequent calls do nothing.
+ */
+void
+mex_gmp_memory_pool_install (void);
+
+
+/**
+ * Release all memory of the limb memory pool.
+ *
+ * The caller must ensure, that no GMP or MPFR memory is in use anymore.
+ */
+void
+mex_gmp_memory_pool_release (void);
+
+
+/**
+ * Set the mode of the limb memory pool.
+ *
+ * The caller must ensure, that no GMP or MPFR memory is in use anymore.
+ *
+ * @param mode One of `LIMB_POOL_MALLOC`, `LIMB_POOL_SLABS`, or
+ *             `LIMB_POOL_HUGE_PAGES`.
+ */
+void
+mex_gmp_memory_pool_set_mode (int mode);
+
+
+/**
+ * Get the mode of the limb memory pool.
+ *
+ * @returns One of `LIMB_POOL_MALLOC`, `LIMB_POOL_SLABS`, or
+ *          `LIMB_POOL_HUGE_PAGES`.
+ */
+int
+mex_gmp_memory_pool_get_mode (void);
+
+
+/**
+ * Get the size of all slabs of the limb memory pool.
+ *
+ * Blocks passed to the system allocator are not included.
+ *
+ * @param[out] max If not NULL, the largest size since startup.
+ *
+ * @returns current size of all slabs in bytes.
+ */
+size_t
+mex_gmp_memory_pool_get_bytes (size_t *max);
+
 #endif  // MEX_GMP_INTERFACE_H_
 
@@ -0,0 +1,379 @@
+/*
+ * This file is part of APA.
+ *
+ *  APA is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  APA is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if defined(__linux__)
+# define _DEFAULT_SOURCE  // posix_memalign, madvise
+# include <sys/mman.h>
+#endif
+#include <stdlib.h>
+
+#include "mex_gmp_interface.h"
+
+// GMP/MPFR limb memory pool
+// =========================
+//
+// All limb memory of GMP and MPFR (e.g. significands allocated by
+// `mpfr_init2` and released by `mpfr_clear`) is requested through the
+// functions installed by `mp_set_memory_functions`.  Blocks up to
+// `LIMB_POOL_MAX_SIZE` bytes are served from per-thread free lists, one for
+// each size class of `LIMB_POOL_CLASS_SIZE` bytes.  Empty free lists are
+// refilled from slabs of `LIMB_POOL_SLAB_SIZE` bytes.  Thus in OpenMP regions
+// threads do not contend for the system allocator.
+//
+// Blocks are often freed by another thread than the one that allocated them,
+// e.g. temporaries initialized by OpenMP workers and cleared by the main
+// thread.  Thus a free list of more than `2 * LIMB_POOL_BATCH` blocks spills
+// `LIMB_POOL_BATCH` blocks into a shared depot, from which empty free lists
+// are refilled before new slabs are carved.
+//
+// GMP passes the block size to the free and realloc functions, thus blocks
+// need no header.  Larger blocks and all blocks in mode `LIMB_POOL_MALLOC`
+// are passed to the system allocator.  Pool memory is released only at once
+// by `mex_gmp_memory_pool_release`.
+
+#define LIMB_POOL_CLASS_SIZE 8    // Size of `mp_limb_t` on 64-bit systems.
+#define LIMB_POOL_CLASSES    128  // Up to 1024 bytes (prec <= 8128 bits).
+#define LIMB_POOL_MAX_SIZE   (LIMB_POOL_CLASS_SIZE * LIMB_POOL_CLASSES)
+#define LIMB_POOL_SLAB_SIZE  (2 * 1024 * 1024)  // Size of a huge page.
+#define LIMB_POOL_BATCH      128  // Blocks moved to or from the depot at once.
+
+typedef struct
+{
+  void  *free_list[LIMB_POOL_CLASSES];  // Singly linked free blocks.
+  size_t free_size[LIMB_POOL_CLASSES];  // Number of blocks in `free_list`.
+  char  *slab_pos;                      // Unused part of the current slab.
+  char  *slab_end;
+  size_t generation;                    // See `limb_pool_generation`.
+} limb_pool_cache_t;
+
+static _Thread_local limb_pool_cache_t limb_pool_cache;
+
+// Depot of free blocks shared by all threads.
+static void  *limb_pool_depot[LIMB_POOL_CLASSES];
+static size_t limb_pool_depot_size[LIMB_POOL_CLASSES];
+
+// Thread caches of older generations refer to released slabs.
+static size_t limb_pool_generation = 1;
+
+static int limb_pool_mode      = LIMB_POOL_DEFAULT_MODE;
+static int limb_pool_installed = 0;
+
+static void  **limb_pool_slabs          = NULL;
+static size_t  limb_pool_slabs_capacity = 0;
+static size_t  limb_pool_slabs_size     = 0;
+static size_t  limb_pool_slabs_max      = 0;  // High-water mark.
+
+
+/**
+ * Abort like GMP, if the system allocator fails.
+ *
+ * @param ptr Pointer returned by the system allocator.
+ *
+ * @returns `ptr` if not NULL.
+ */
+static inline void *
+limb_pool_check (void *ptr)
+{
+  if (ptr == NULL)
+    abort ();
+  return (ptr);
+}
+
+
+/**
+ * Get the thread cache and reset it, if it refers to released slabs.
+ *
+ * @returns pointer to the cache of the calling thread.
+ */
+static inline limb_pool_cache_t *
+limb_pool_get_cache (void)
+{
+  limb_pool_cache_t *cache = &limb_pool_cache;
+
+  if (cache->generation != limb_pool_generation)
+    {
+      memset (cache, 0, sizeof(limb_pool_cache_t));
+      cache->generation = limb_pool_generation;
+    }
+  return (cache);
+}
+
+
+/**
+ * Allocate a new slab for the calling thread.
+ *
+ * @param cache Pointer to the cache of the calling thread.
+ */
+static void
+limb_pool_new_slab (limb_pool_cache_t *cache)
+{
+  void *slab = NULL;
+
+  #if defined(__linux__)
+  if (limb_pool_mode == LIMB_POOL_HUGE_PAGES)
+    {
+      if (posix_memalign (&slab, LIMB_POOL_SLAB_SIZE, LIMB_POOL_SLAB_SIZE) != 0)
+        abort ();
+      madvise (slab, LIMB_POOL_SLAB_SIZE, MADV_HUGEPAGE);
+    }
+  else
+  #endif
+  slab = limb_pool_check (malloc (LIMB_POOL_SLAB_SIZE));
+
+  #pragma omp critical (limb_pool_slabs)
+  {
+    if (limb_pool_slabs_size == limb_pool_slabs_capacity)
+      {
+        limb_pool_slabs_capacity = (limb_pool_slabs_capacity == 0)
+                                   ? 64 : 2 * limb_pool_slabs_capacity;
+        limb_pool_slabs = (void **) limb_pool_check (realloc (
+          limb_pool_slabs, limb_pool_slabs_capacity * sizeof(void *)));
+      }
+    limb_pool_slabs[limb_pool_slabs_size++] = slab;
+    if (limb_pool_slabs_size > limb_pool_slabs_max)
+      limb_pool_slabs_max = limb_pool_slabs_size;
+  }
+
+  cache->slab_pos = (char *) slab;
+  cache->slab_end = (char *) slab + LIMB_POOL_SLAB_SIZE;
+}
+
+
+/**
+ * Move up to `LIMB_POOL_BATCH` blocks from the free list `src` of size
+ * `*src_size` to the front of the free list `dst` of size `*dst_size`.
+ */
+static void
+limb_pool_move_batch (void **src, size_t *src_size, void **dst,
+                      size_t *dst_size)
+{
+  size_t n = (*src_size < LIMB_POOL_BATCH) ? *src_size : LIMB_POOL_BATCH;
+  if (n == 0)
+    return;
+  void *first = *src;
+  void *last  = first;
+  for (size_t i = 1; i < n; i++)
+    last = *((void **) last);
+  *src              = *((void **) last);
+  *((void **) last) = *dst;
+  *dst              = first;
+  *src_size        -= n;
+  *dst_size        += n;
+}
+
+
+/**
+ * Allocate a block (GMP allocate function).
+ *
+ * @param size Size of the block in bytes.
+ *
+ * @returns pointer to the block.
+ */
+static void *
+limb_pool_alloc (size_t size)
+{
+  if ((limb_pool_mode == LIMB_POOL_MALLOC) || (size > LIMB_POOL_MAX_SIZE)
+      || (size == 0))
+    return (limb_pool_check (malloc (size)));
+
+  limb_pool_cache_t *cache = limb_pool_get_cache ();
+  size_t             c     = (size - 1) / LIMB_POOL_CLASS_SIZE;
+  if (cache->free_list[c] == NULL)
+    {
+      size_t depot_size = 0;
+      #pragma omp atomic read
+      depot_size = limb_pool_depot_size[c];
+      if (depot_size > 0)
+        {
+          #pragma omp critical (limb_pool_depot)
+          limb_pool_move_batch (&limb_pool_depot[c], &limb_pool_depot_size[c],
+                                &cache->free_list[c], &cache->free_size[c]);
+        }
+    }
+  void *block = cache->free_list[c];
+  if (block != NULL)
+    {
+      cache->free_list[c] = *((void **) block);
+      cache->free_size[c]--;
+      return (block);
+    }
+
+  size_t class_size = (c + 1) * LIMB_POOL_CLASS_SIZE;
+  if ((size_t) (cache->slab_end - cache->slab_pos) < class_size)
+    {
+      // Keep the rest of the old slab in the free list of its size.
+      size_t rest = (size_t) (cache->slab_end - cache->slab_pos);
+      if (rest >= LIMB_POOL_CLASS_SIZE)
+        {
+          size_t r = rest / LIMB_POOL_CLASS_SIZE - 1;
+          *((void **) cache->slab_pos) = cache->free_list[r];
+          cache->free_list[r]          = cache->slab_pos;
+          cache->free_size[r]++;
+        }
+      limb_pool_new_slab (cache);
+    }
+  block            = cache->slab_pos;
+  cache->slab_pos += class_size;
+  return (block);
+}
+
+
+/**
+ * Free a block (GMP free function).
+ *
+ * @param ptr Pointer to the block.
+ * @param size Size of the block in bytes.
+ */
+static void
+limb_pool_free (void *ptr, size_t size)
+{
+  if ((limb_pool_mode == LIMB_POOL_MALLOC) || (size > LIMB_POOL_MAX_SIZE)
+      || (size == 0))
+    {
+      free (ptr);
+      return;
+    }
+
+  limb_pool_cache_t *cache = limb_pool_get_cache ();
+  size_t             c     = (size - 1) / LIMB_POOL_CLASS_SIZE;
+  *((void **) ptr)    = cache->free_list[c];
+  cache->free_list[c] = ptr;
+  if (++cache->free_size[c] > 2 * LIMB_POOL_BATCH)
+    {
+      #pragma omp critical (limb_pool_depot)
+      limb_pool_move_batch (&cache->free_list[c], &cache->free_size[c],
+                            &limb_pool_depot[c], &limb_pool_depot_size[c]);
+    }
+}
+
+
+/**
+ * Reallocate a block (GMP reallocate function).
+ *
+ * @param ptr Pointer to the block.
+ * @param old_size Size of the block in bytes.
+ * @param new_size Desired size of the block in bytes.
+ *
+ * @returns pointer to the reallocated block.
+ */
+static void *
+limb_pool_realloc (void *ptr, size_t old_size, size_t new_size)
+{
+  int old_pooled = (limb_pool_mode != LIMB_POOL_MALLOC) && (old_size > 0)
+                   && (old_size <= LIMB_POOL_MAX_SIZE);
+  int new_pooled = (limb_pool_mode != LIMB_POOL_MALLOC) && (new_size > 0)
+                   && (new_size <= LIMB_POOL_MAX_SIZE);
+
+  if (! old_pooled && ! new_pooled)
+    return (limb_pool_check (realloc (ptr, new_size)));
+
+  // Same size class, nothing to do.
+  if (old_pooled && new_pooled
+      && ((old_size - 1) / LIMB_POOL_CLASS_SIZE
+          == (new_size - 1) / LIMB_POOL_CLASS_SIZE))
+    return (ptr);
+
+  void *new_ptr = limb_pool_alloc (new_size);
+  memcpy (new_ptr, ptr, (old_size < new_size) ? old_size : new_size);
+  limb_pool_free (ptr, old_size);
+  return (new_ptr);
+}
+
+
+/**
+ * Install the limb memory pool as GMP memory functions.
+ *
+ * Must be called before any GMP or MPFR memory is allocated, thus at the
+ * beginning of each MEX call.  Subsequent calls do nothing.
+ */
+void
+mex_gmp_memory_pool_install (void)
+{
+  if (limb_pool_installed)
+    return;
+  mp_set_memory_functions (limb_pool_alloc, limb_pool_realloc,
+                           limb_pool_free);
+  limb_pool_installed = 1;
+}
+
+
+/**
+ * Release all memory of the limb memory pool.
+ *
+ * The caller must ensure, that no GMP or MPFR memory is in use anymore.
+ */
+void
+mex_gmp_memory_pool_release (void)
+{
+  DBG_PRINTF ("Release %d slabs.\n", (int) limb_pool_slabs_size);
+  for (size_t i = 0; i < limb_pool_slabs_size; i++)
+    free (limb_pool_slabs[i]);
+  free (limb_pool_slabs);
+  limb_pool_slabs          = NULL;
+  limb_pool_slabs_capacity = 0;
+  limb_pool_slabs_size     = 0;
+  memset (limb_pool_depot, 0, sizeof(limb_pool_depot));
+  memset (limb_pool_depot_size, 0, sizeof(limb_pool_depot_size));
+  limb_pool_generation++;
+}
+
+
+/**
+ * Set the mode of the limb memory pool.
+ *
+ * The caller must ensure, that no GMP or MPFR memory is in use anymore.
+ *
+ * @param mode One of `LIMB_POOL_MALLOC`, `LIMB_POOL_SLABS`, or
+ *             `LIMB_POOL_HUGE_PAGES`.
+ */
+void
+mex_gmp_memory_pool_set_mode (int mode)
+{
+  mex_gmp_memory_pool_release ();
+  limb_pool_mode = mode;
+}
+
+
+/**
+ * Get the mode of the limb memory pool.
+ *
+ * @returns One of `LIMB_POOL_MALLOC`, `LIMB_POOL_SLABS`, or
+ *          `LIMB_POOL_HUGE_PAGES`.
+ */
+int
+mex_gmp_memory_pool_get_mode (void)
+{
+  return (limb_pool_mode);
+}
+
+
+/**
+ * Get the size of all slabs of the limb memory pool.
+ *
+ * Blocks passed to the system allocator are not included.
+ *
+ * @param[out] max If not NULL, the largest size since startup.
+ *
+ * @returns current size of all slabs in bytes.
+ */
+size_t
+mex_gmp_memory_pool_get_bytes (size_t *max)
+{
+  if (max != NULL)
+    *max = limb_pool_slabs_max * LIMB_POOL_SLAB_SIZE;
+  return (limb_pool_slabs_size * LIMB_POOL_SLAB_SIZE);
+}
@@ -0,0 +1,912 @@
+/*
+ * This file is part of APA.
+ *
+ *  APA is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  APA is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mex_mdouble_interface.h"
+#include "mex_mpfr_interface.h"
+
+
+// Double-double and quad-double arithmetic
+// ========================================
+//
+// A double-double (quad-double) number is the unevaluated sum of k = 2
+// (k = 4) doubles of decreasing magnitude with about 106 (212) bits of
+// precision.  The algorithms are those of the QD library [1] built on the
+// error-free transformations `two_sum` and `two_prod`.  For quad-double
+// the faster "sloppy" addition and multiplication of QD are used.
+//
+// An array of `n` numbers is stored as Octave `[n x k]` double matrix, the
+// j-th components of all numbers are contiguous at `x + j * n`.  Thus all
+// kernels are plain loops over double arrays, which are vectorized with
+// `#pragma omp simd`.  Compiled with `-mavx2 -mfma` (or `-march=native`)
+// these are AVX2 instructions and `two_prod` uses the FMA instruction.
+// The error-free transformations require IEEE 754 double arithmetic, thus
+// do not compile this file with `-ffast-math`.
+//
+// All kernels are branch-free to be vectorized.  Therefore the quad-double
+// renormalization does not compact zero components after cancellation
+// like QD does, which only loses accuracy in this rare case.
+//
+// [1] Y. Hida, X. S. Li, D. H. Bailey, "Library for double-double and
+//     quad-double arithmetic", 2007.
+
+#define MDOUBLE_INLINE static inline __attribute__((always_inline))
+
+// Elements per OpenMP work item.
+#define MDOUBLE_CHUNK 4096
+
+// Independent partial sums of the dot product kernel.
+#define MDOUBLE_LANES 8
+
+
+/**
+ * Double-double (k = 2) or quad-double (k = 4) number.  For k = 2 the
+ * components `c[2]` and `c[3]` are zero and unused.
+ */
+typedef struct
+{
+  double c[4];
+} md_t;
+
+
+// Error-free transformations.
+
+MDOUBLE_INLINE double
+two_sum (double a, double b, double *err)
+{
+  double s  = a + b;
+  double bb = s - a;
+  *err = (a - (s - bb)) + (b - bb);
+  return (s);
+}
+
+
+// Requires |a| >= |b|.
+MDOUBLE_INLINE double
+quick_two_sum (double a, double b, double *err)
+{
+  double s = a + b;
+  *err = b - (s - a);
+  return (s);
+}
+
+
+MDOUBLE_INLINE double
+two_prod (double a, double b, double *err)
+{
+  double p = a * b;
+#ifdef FP_FAST_FMA
+  *err = fma (a, b, -p);
+#else
+  // Dekker's product with Veltkamp splitting at 2^27 + 1.
+  double t  = 134217729.0 * a;
+  double ah = t - (t - a);
+  double al = a - ah;
+  t = 134217729.0 * b;
+  double bh = t - (t - b);
+  double bl = b - bh;
+  *err = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+  return (p);
+}
+
+
+MDOUBLE_INLINE void
+three_sum (double *a, double *b, double *c)
+{
+  double t2, t3;
+  double t1 = two_sum (*a, *b, &t2);
+  *a = two_sum (*c, t1, &t3);
+  *b = two_sum (t2, t3, c);
+}
+
+
+MDOUBLE_INLINE void
+three_sum2 (double *a, double *b, double *c)
+{
+  double t2, t3;
+  double t1 = two_sum (*a, *b, &t2);
+  *a = two_sum (*c, t1, &t3);
+  *b = t2 + t3;
+}
+
+
+// Double-double arithmetic.
+
+MDOUBLE_INLINE md_t
+dd_add (md_t a, md_t b)
+{
+  double s2, t2;
+  double s1 = two_sum (a.c[0], b.c[0], &s2);
+  double t1 = two_sum (a.c[1], b.c[1], &t2);
+  s2 += t1;
+  s1  = quick_two_sum (s1, s2, &s2);
+  s2 += t2;
+  s1  = quick_two_sum (s1, s2, &s2);
+  return ((md_t) {{s1, s2, 0.0, 0.0}});
+}
+
+
+MDOUBLE_INLINE md_t
+dd_mul (md_t a, md_t b)
+{
+  double p2;
+  double p1 = two_prod (a.c[0], b.c[0], &p2);
+  p2 += a.c[0] * b.c[1] + a.c[1] * b.c[0];
+  p1  = quick_two_sum (p1, p2, &p2);
+  return ((md_t) {{p1, p2, 0.0, 0.0}});
+}
+
+
+// Returns a - b * d.
+MDOUBLE_INLINE md_t
+dd_sub_mul_d (md_t a, md_t b, double d)
+{
+  double p2;
+  double p1 = two_prod (b.c[0], d, &p2);
+  p2 += b.c[1] * d;
+  p1  = quick_two_sum (p1, p2, &p2);
+  return (dd_add (a, (md_t) {{-p1, -p2, 0.0, 0.0}}));
+}
+
+
+MDOUBLE_INLINE md_t
+dd_div (md_t a, md_t b)
+{
+  double q1 = a.c[0] / b.c[0];
+  md_t   r  = dd_sub_mul_d (a, b, q1);
+  double q2 = r.c[0] / b.c[0];
+  r = dd_sub_mul_d (r, b, q2);
+  double q3 = r.c[0] / b.c[0];
+  q1 = quick_two_sum (q1, q2, &q2);
+  double e;
+  double s = two_sum (q1, q3, &e);
+  e += q2;
+  s  = quick_two_sum (s, e, &e);
+  return ((md_t) {{s, e, 0.0, 0.0}});
+}
+
+
+// Quad-double arithmetic.
+
+MDOUBLE_INLINE md_t
+qd_renorm (double c0, double c1, double c2, double c3, double c4)
+{
+  double s0, s1, s2, s3;
+  s0 = quick_two_sum (c3, c4, &c4);
+  s0 = quick_two_sum (c2, s0, &c3);
+  s0 = quick_two_sum (c1, s0, &c2);
+  c0 = quick_two_sum (c0, s0, &c1);
+  s0 = quick_two_sum (c0, c1, &s1);
+  s1 = quick_two_sum (s1, c2, &s2);
+  s2 = quick_two_sum (s2, c3, &s3);
+  s3 += c4;
+  return ((md_t) {{s0, s1, s2, s3}});
+}
+
+
+MDOUBLE_INLINE md_t
+qd_add (md_t a, md_t b)
+{
+  double t0, t1, t2, t3;
+  double s0 = two_sum (a.c[0], b.c[0], &t0);
+  double s1 = two_sum (a.c[1], b.c[1], &t1);
+  double s2 = two_sum (a.c[2], b.c[2], &t2);
+  double s3 = two_sum (a.c[3], b.c[3], &t3);
+  s1 = two_sum (s1, t0, &t0);
+  three_sum (&s2, &t0, &t1);
+  three_sum2 (&s3, &t0, &t2);
+  t0 = t0 + t1 + t3;
+  return (qd_renorm (s0, s1, s2, s3, t0));
+}
+
+
+MDOUBLE_INLINE md_t
+qd_mul (md_t a, md_t b)
+{
+  double q0, q1, q2, q3, q4, q5;
+  double p0 = two_prod (a.c[0], b.c[0], &q0);
+  double p1 = two_prod (a.c[0], b.c[1], &q1);
+  double p2 = two_prod (a.c[1], b.c[0], &q2);
+  double p3 = two_prod (a.c[0], b.c[2], &q3);
+  double p4 = two_prod (a.c[1], b.c[1], &q4);
+  double p5 = two_prod (a.c[2], b.c[0], &q5);
+
+  // O(eps) terms.
+  three_sum (&p1, &p2, &q0);
+
+  // O(eps^2) terms.
+  three_sum (&p2, &q1, &q2);
+  three_sum (&p3, &p4, &p5);
+  double t0, t1;
+  double s0 = two_sum (p2, p3, &t0);
+  double s1 = two_sum (q1, p4, &t1);
+  double s2 = q2 + p5;
+  s1 = two_sum (s1, t0, &t0);
+  s2 += t0 + t1;
+
+  // O(eps^3) terms.
+  s1 += a.c[0] * b.c[3] + a.c[1] * b.c[2] + a.c[2] * b.c[1]
+        + a.c[3] * b.c[0] + q0 + q3 + q4 + q5;
+  return (qd_renorm (p0, p1, s0, s1, s2));
+}
+
+
+// Returns a - b * d.
+MDOUBLE_INLINE md_t
+qd_sub_mul_d (md_t a, md_t b, double d)
+{
+  double q0, q1, q2;
+  double p0 = two_prod (b.c[0], d, &q0);
+  double p1 = two_prod (b.c[1], d, &q1);
+  double p2 = two_prod (b.c[2], d, &q2);
+  double p3 = b.c[3] * d;
+  double s2;
+  double s1 = two_sum (q0, p1, &s2);
+  three_sum (&s2, &q1, &p2);
+  three_sum2 (&q1, &q2, &p3);
+  md_t bd = qd_renorm (p0, s1, s2, q1, q2 + p2);
+  return (qd_add (a, (md_t) {{-bd.c[0], -bd.c[1], -bd.c[2], -bd.c[3]}}));
+}
+
+
+MDOUBLE_INLINE md_t
+qd_div (md_t a, md_t b)
+{
+  double q0 = a.c[0] / b.c[0];
+  md_t   r  = qd_sub_mul_d (a, b, q0);
+  double q1 = r.c[0] / b.c[0];
+  r = qd_sub_mul_d (r, b, q1);
+  double q2 = r.c[0] / b.c[0];
+  r = qd_sub_mul_d (r, b, q2);
+  double q3 = r.c[0] / b.c[0];
+  return (qd_renorm (q0, q1, q2, q3, 0.0));
+}
+
+
+// Arithmetic of k components.  `k` is a constant in all kernels below, such
+// that the compiler removes the unused branch.
+
+MDOUBLE_INLINE md_t
+md_load (const double *x, size_t n, size_t i, int k)
+{
+  md_t a = {{x[i], x[i + n], 0.0, 0.0}};
+  if (k == 4)
+    {
+      a.c[2] = x[i + 2 * n];
+      a.c[3] = x[i + 3 * n];
+    }
+  return (a);
+}
+
+
+MDOUBLE_INLINE void
+md_store (double *x, size_t n, size_t i, md_t a, int k)
+{
+  x[i]     = a.c[0];
+  x[i + n] = a.c[1];
+  if (k == 4)
+    {
+      x[i + 2 * n] = a.c[2];
+      x[i + 3 * n] = a.c[3];
+    }
+}
+
+
+MDOUBLE_INLINE md_t
+md_neg (md_t a)
+{
+  return ((md_t) {{-a.c[0], -a.c[1], -a.c[2], -a.c[3]}});
+}
+
+
+MDOUBLE_INLINE md_t
+md_add (md_t a, md_t b, int k)
+{
+  return ((k == 2) ? dd_add (a, b) : qd_add (a, b));
+}
+
+
+MDOUBLE_INLINE md_t
+md_mul (md_t a, md_t b, int k)
+{
+  return ((k == 2) ? dd_mul (a, b) : qd_mul (a, b));
+}
+
+
+MDOUBLE_INLINE md_t
+md_div (md_t a, md_t b, int k)
+{
+  return ((k == 2) ? dd_div (a, b) : qd_div (a, b));
+}
+
+
+// Returns a * b + c.
+MDOUBLE_INLINE md_t
+md_fma (md_t a, md_t b, md_t c, int k)
+{
+  return (md_add (md_mul (a, b, k), c, k));
+}
+
+
+// Kernels
+// -------
+//
+// Arrays are passed as pointer to the first element and the component
+// stride `n`, i.e. the total number of elements of the array.
+
+// Loop `expr` of the operands `a`, `b`, and `c` in `mdouble_map_k`.
+#define MDOUBLE_MAP(expr)                                        \
+if ((xs == 1) && (ys == 1) && (ws == 1))                         \
+  {                                                              \
+    _Pragma ("omp simd")                                         \
+    for (size_t i = 0; i < len; i++)                             \
+      {                                                          \
+        md_t a = md_load (x, xn, i, k);                          \
+        md_t b = md_load (y, yn, i, k);                          \
+        md_t c = md_load (w, wn, i, k);                          \
+        (void) c;                                                \
+        md_store (z, zn, i, (expr), k);                          \
+      }                                                          \
+  }                                                              \
+else                                                             \
+  {                                                              \
+    _Pragma ("omp simd")                                         \
+    for (size_t i = 0; i < len; i++)                             \
+      {                                                          \
+        md_t a = md_load (x, xn, i * xs, k);                     \
+        md_t b = md_load (y, yn, i * ys, k);                     \
+        md_t c = md_load (w, wn, i * ws, k);                     \
+        (void) c;                                                \
+        md_store (z, zn, i, (expr), k);                          \
+      }                                                          \
+  }
+
+
+/**
+ * Element-wise operation `z = op (x, y, w)` of `len` elements.
+ *
+ * @param[in] op operation `MDOUBLE_OP_*`.
+ * @param[in] len number of elements to compute.
+ * @param[out] z result array.
+ * @param[in] zn component stride of `z`.
+ * @param[in] x first operand.
+ * @param[in] xn component stride of `x`.
+ * @param[in] xs element stride of `x` (1, or 0 for a scalar).
+ * @param[in] y second operand.
+ * @param[in] yn component stride of `y`.
+ * @param[in] ys element stride of `y` (1, or 0 for a scalar).
+ * @param[in] w third operand (`MDOUBLE_OP_FMA` only).
+ * @param[in] wn component stride of `w`.
+ * @param[in] ws element stride of `w` (1, or 0 for a scalar).
+ * @param[in] k number of components (2 or 4).
+ */
+MDOUBLE_INLINE void
+mdouble_map_k (int op, size_t len, double *z, size_t zn,
+               const double *x, size_t xn, size_t xs,
+               const double *y, size_t yn, size_t ys,
+               const double *w, size_t wn, size_t ws, int k)
+{
+  switch (op)
+    {
+      case MDOUBLE_OP_ADD:
+        MDOUBLE_MAP (md_add (a, b, k));
+        break;
+      case MDOUBLE_OP_SUB:
+        MDOUBLE_MAP (md_add (a, md_neg (b), k));
+        break;
+      case MDOUBLE_OP_MUL:
+        MDOUBLE_MAP (md_mul (a, b, k));
+        break;
+      case MDOUBLE_OP_DIV:
+        MDOUBLE_MAP (md_div (a, b, k));
+        break;
+      case MDOUBLE_OP_FMA:
+        MDOUBLE_MAP (md_fma (a, b, c, k));
+        break;
+    }
+}
+
+
+/**
+ * Dot product `x' * y` of `len` elements.
+ *
+ * @param[in] len number of elements.
+ * @param[in] x first operand.
+ * @param[in] xn component stride of `x`.
+ * @param[in] y second operand.
+ * @param[in] yn component stride of `y`.
+ * @param[in] k number of components (2 or 4).
+ *
+ * @returns dot product.
+ */
+MDOUBLE_INLINE md_t
+mdouble_dot_k (size_t len, const double *x, size_t xn,
+               const double *y, size_t yn, int k)
+{
+  // Partial sums stored like an array of `MDOUBLE_LANES` elements.
+  double s[4 * MDOUBLE_LANES] = {0.0};
+
+  size_t i = 0;
+  for (; i + MDOUBLE_LANES <= len; i += MDOUBLE_LANES)
+    {
+      #pragma omp simd
+      for (size_t l = 0; l < MDOUBLE_LANES; l++)
+        md_store (s, MDOUBLE_LANES, l,
+                  md_fma (md_load (x, xn, i + l, k),
+                          md_load (y, yn, i + l, k),
+                          md_load (s, MDOUBLE_LANES, l, k), k), k);
+    }
+
+  md_t sum = md_load (s, MDOUBLE_LANES, 0, k);
+  for (size_t l = 1; l < MDOUBLE_LANES; l++)
+    sum = md_add (sum, md_load (s, MDOUBLE_LANES, l, k), k);
+  for (; i < len; i++)
+    sum = md_fma (md_load (x, xn, i, k), md_load (y, yn, i, k), sum, k);
+  return (sum);
+}
+
+
+/**
+ * Vector update `y = a * x + y` of `len` elements.
+ *
+ * @param[in] len number of elements.
+ * @param[in,out] y updated vector.
+ * @param[in] yn component stride of `y`.
+ * @param[in] x vector.
+ * @param[in] xn component stride of `x`.
+ * @param[in] a scalar.
+ * @param[in] k number of components (2 or 4).
+ */
+MDOUBLE_INLINE void
+mdouble_axpy_k (size_t len, double *y, size_t yn,
+                const double *x, size_t xn, md_t a, int k)
+{
+  #pragma omp simd
+  for (size_t i = 0; i < len; i++)
+    md_store (y, yn, i, md_fma (a, md_load (x, xn, i, k),
+                                md_load (y, yn, i, k), k), k);
+}
+
+
+/**
+ * Vector scaling `x = x / a` of `len` elements.
+ *
+ * @param[in] len number of elements.
+ * @param[in,out] x scaled vector.
+ * @param[in] xn component stride of `x`.
+ * @param[in] a scalar.
+ * @param[in] k number of components (2 or 4).
+ */
+MDOUBLE_INLINE void
+mdouble_scal_k (size_t len, double *x, size_t xn, md_t a, int k)
+{
+  #pragma omp simd
+  for (size_t i = 0; i < len; i++)
+    md_store (x, xn, i, md_div (md_load (x, xn, i, k), a, k), k);
+}
+
+
+// Instances of the kernels for k = 2 and k = 4.
+
+static void
+mdouble_map (int op, size_t len, double *z, size_t zn,
+             const double *x, size_t xn, size_t xs,
+             const double *y, size_t yn, size_t ys,
+             const double *w, size_t wn, size_t ws, int k)
+{
+  if (k == 2)
+    mdouble_map_k (op, len, z, zn, x, xn, xs, y, yn, ys, w, wn, ws, 2);
+  else
+    mdouble_map_k (op, len, z, zn, x, xn, xs, y, yn, ys, w, wn, ws, 4);
+}
+
+
+static md_t
+mdouble_dot (size_t len, const double *x, size_t xn,
+             const double *y, size_t yn, int k)
+{
+  if (k == 2)
+    return (mdouble_dot_k (len, x, xn, y, yn, 2));
+  else
+    return (mdouble_dot_k (len, x, xn, y, yn, 4));
+}
+
+
+static void
+mdouble_axpy (size_t len, double *y, size_t yn,
+              const double *x, size_t xn, md_t a, int k)
+{
+  if (k == 2)
+    mdouble_axpy_k (len, y, yn, x, xn, a, 2);
+  else
+    mdouble_axpy_k (len, y, yn, x, xn, a, 4);
+}
+
+
+static void
+mdouble_scal (size_t len, double *x, size_t xn, md_t a, int k)
+{
+  if (k == 2)
+    mdouble_scal_k (len, x, xn, a, 2);
+  else
+    mdouble_scal_k (len, x, xn, a, 4);
+}
+
+
+/**
+ * Matrix multiplication `C = A * B`.
+ *
+ * Each OpenMP thread computes whole columns of `C` as sequence of `axpy`
+ * updates with the columns of `A`.
+ *
+ * @param[in] M rows of `A` and `C`.
+ * @param[in] N columns of `B` and `C`.
+ * @param[in] K columns of `A` and rows of `B`.
+ * @param[in] A [M x K] matrix.
+ * @param[in] B [K x N] matrix.
+ * @param[out] C [M x N] matrix.
+ * @param[in] k number of components (2 or 4).
+ */
+static void
+mdouble_gemm (size_t M, size_t N, size_t K, const double *A,
+              const double *B, double *C, int k)
+{
+  #pragma omp parallel for schedule(static) if (M * N * K >= MDOUBLE_CHUNK)
+  for (size_t j = 0; j < N; j++)
+    {
+      for (int l = 0; l < k; l++)
+        for (size_t i = 0; i < M; i++)
+          C[i + j * M + l * M * N] = 0.0;
+      for (size_t p = 0; p < K; p++)
+        {
+          md_t b = md_load (B, K * N, p + j * K, k);
+          mdouble_axpy (M, C + j * M, M * N, A + p * M, M * K, b, k);
+        }
+    }
+}
+
+
+/**
+ * LU factorization with partial pivoting `P * A = L * U` (like LAPACK
+ * GETRF).  The pivot is the element of largest magnitude of the leading
+ * component.
+ *
+ * @param[in] M rows of `A`.
+ * @param[in] N columns of `A`.
+ * @param[in,out] A [M x N] matrix, overwritten by the factors `L` (without
+ *                  unit diagonal) and `U`.
+ * @param[out] IPIV pivot indices (1-based) of length `min (M, N)`.
+ * @param[in] k number of components (2 or 4).
+ *
+ * @returns `0` on success, `i > 0` if `U(i,i)` is exactly zero.
+ */
+static int
+mdouble_getrf (size_t M, size_t N, double *A, double *IPIV, int k)
+{
+  int    INFO = 0;
+  size_t MN   = M * N;
+
+  for (size_t p = 0; (p < M) && (p < N); p++)
+    {
+      // Find pivot.
+      size_t piv = p;
+      for (size_t i = p + 1; i < M; i++)
+        if (fabs (A[i + p * M]) > fabs (A[piv + p * M]))
+          piv = i;
+      IPIV[p] = (double) (piv + 1);
+      if (A[piv + p * M] == 0.0)
+        {
+          if (INFO == 0)
+            INFO = (int) (p + 1);
+          continue;
+        }
+
+      // Swap rows.
+      if (piv != p)
+        for (size_t j = 0; j < N * k; j++)
+          {
+            double d = A[p + j * M];
+            A[p + j * M]   = A[piv + j * M];
+            A[piv + j * M] = d;
+          }
+
+      // Compute column of `L` and update trailing submatrix.
+      size_t len = M - p - 1;
+      mdouble_scal (len, A + p + 1 + p * M, MN, md_load (A, MN, p + p * M, k),
+                    k);
+
+      #pragma omp parallel for schedule(static) \
+              if (len * (N - p) >= MDOUBLE_CHUNK)
+      for (size_t j = p + 1; j < N; j++)
+        mdouble_axpy (len, A + p + 1 + j * M, MN, A + p + 1 + p * M, MN,
+                      md_neg (md_load (A, MN, p + j * M, k)), k);
+    }
+
+  return (INFO);
+}
+
+
+/**
+ * Safely read `[n x k]` double-double or quad-double array from MEX input.
+ *
+ * @param[in] idx MEX input position index (0 is first).
+ * @param[in] nrhs Number of right-hand sides.
+ * @param[in] mxArray  MEX input array.
+ * @param[out] x pointer to the array data.
+ * @param[out] n number of elements.
+ * @param[out] k number of components (2 or 4).
+ *
+ * @returns success of extraction.
+ */
+static int
+extract_mdouble (int idx, int nrhs, const mxArray *prhs[], double **x,
+                 size_t *n, int *k)
+{
+  if ((nrhs > idx) && mxIsDouble (prhs[idx]) && ! mxIsComplex (prhs[idx])
+      && ((mxGetN (prhs[idx]) == 2) || (mxGetN (prhs[idx]) == 4)))
+    {
+      *x = mxGetPr (prhs[idx]);
+      *n = mxGetM (prhs[idx]);
+      *k = (int) mxGetN (prhs[idx]);
+      return (1);
+    }
+  DBG_PRINTF ("%s\n", "Failed.");
+  return (0);
+}
+
+
+#define MEX_MDOUBLE_T(mex_rhs, name)                                 \
+  double *name;                                                      \
+  size_t  name ## _n;                                                \
+  int     name ## _k;                                                \
+  if (! extract_mdouble ((mex_rhs), nrhs, prhs, &name, &name ## _n,  \
+                         &name ## _k))                               \
+    MEX_FCN_ERR ("cmd[%d]:"#name " must be a real [n x 2] or [n x 4] " \
+                 "double matrix.\n", cmd_code);
+
+
+void
+mex_mdouble_interface (int nlhs, mxArray *plhs[],
+                       int nrhs, const mxArray *prhs[],
+                       uint64_t cmd_code)
+{
+  switch (cmd_code)
+    {
+      case 4000: // double[n x k] mdouble.from_mpfr (mpfr_t op, int k)
+      {
+        MEX_NARGINCHK (3);
+        MEX_MPFR_T (1, op);
+        uint64_t k = 0;
+        if (! extract_ui (2, nrhs, prhs, &k) || ((k != 2) && (k != 4)))
+          MEX_FCN_ERR ("%s\n", "cmd[mdouble.from_mpfr]:k must be 2 or 4.");
+        DBG_PRINTF ("cmd[mdouble.from_mpfr]: op = [%d:%d], k = %d\n",
+                    op.start, op.end, (int) k);
+
+        size_t n = length (&op);
+        plhs[0] = mxCreateNumericMatrix (n, k, mxDOUBLE_CLASS, mxREAL);
+        double *x = mxGetPr (plhs[0]);
+
+        // Subtracting the leading double is exact in the precision of `op`.
+        mpfr_prec_t prec = MPFR_PREC_MIN;
+        for (size_t i = 0; i < n; i++)
+          if (mpfr_get_prec (op_ptr + i) > prec)
+            prec = mpfr_get_prec (op_ptr + i);
+        mpfr_t t;
+        mpfr_init2 (t, prec);
+        for (size_t i = 0; i < n; i++)
+          {
+            mpfr_set (t, op_ptr + i, MPFR_RNDN);
+            for (size_t j = 0; j < k; j++)
+              {
+                x[i + j * n] = mpfr_get_d (t, MPFR_RNDN);
+                if (isfinite (x[i + j * n]))
+                  mpfr_sub_d (t, t, x[i + j * n], MPFR_RNDN);
+                else
+                  mpfr_set_zero (t, 1);
+              }
+          }
+        mpfr_clear (t);
+        break;
+      }
+
+      case 4001: // int mdouble.to_mpfr (mpfr_t rop, double[n x k] x, mpfr_rnd_t rnd)
+      {
+        MEX_NARGINCHK (4);
+        MEX_MPFR_T (1, rop);
+        MEX_MDOUBLE_T (2, x);
+        MEX_MPFR_RND_T (3, rnd);
+        if (length (&rop) != x_n)
+          MEX_FCN_ERR ("%s\n", "cmd[mdouble.to_mpfr]:x Invalid size.");
+        DBG_PRINTF ("cmd[mdouble.to_mpfr]: rop = [%d:%d], n = %d, k = %d, "
+                    "rnd = %d\n", rop.start, rop.end, (int) x_n, x_k,
+                    (int) rnd);
+
+        plhs[0] = mxCreateNumericMatrix (nlhs ? x_n : 1, 1, mxDOUBLE_CLASS,
+                                         mxREAL);
+        double *ret_ptr = mxGetPr (plhs[0]);
+
+        // Sum of the exact components with a single rounding.
+        #pragma omp parallel
+        {
+          int       ret = 0;
+          mpfr_t    c[4];
+          mpfr_ptr  tab[4];
+          for (int j = 0; j < x_k; j++)
+            {
+              mpfr_init2 (c[j], 53);
+              tab[j] = c[j];
+            }
+
+          #pragma omp for
+          for (size_t i = 0; i < x_n; i++)
+            {
+              for (int j = 0; j < x_k; j++)
+                mpfr_set_d (c[j], x[i + j * x_n], MPFR_RNDN);
+              int r = mpfr_sum (rop_ptr + i, tab, x_k, rnd);
+              if (nlhs)
+                ret_ptr[i] = (double) r;
+              else
+                ret |= r;
+            }
+
+          for (int j = 0; j < x_k; j++)
+            mpfr_clear (c[j]);
+          mpfr_free_cache ();
+
+          if (! nlhs && ret)
+            {
+              #pragma omp critical
+              ret_ptr[0] = 1.0;
+            }
+        }
+        break;
+      }
+
+      case 4002: // double[n x k] mdouble.elementwise (int op, double[n x k] x, double[n x k] y, double[n x k] w)
+      {
+        if ((nrhs != 4) && (nrhs != 5))
+          MEX_FCN_ERR ("cmd[%d]: Invalid number of arguments.\n", cmd_code);
+        uint64_t op = 0;
+        if (! extract_ui (1, nrhs, prhs, &op) || (op > MDOUBLE_OP_FMA)
+            || ((op == MDOUBLE_OP_FMA) != (nrhs == 5)))
+          MEX_FCN_ERR ("%s\n", "cmd[mdouble.elementwise]:op Invalid "
+                       "operation.");
+        MEX_MDOUBLE_T (2, x);
+        MEX_MDOUBLE_T (3, y);
+        double *w   = x;
+        size_t  w_n = x_n;
+        int     w_k = x_k;
+        if (nrhs == 5)
+          {
+            MEX_MDOUBLE_T (4, w4);
+            w   = w4;
+            w_n = w4_n;
+            w_k = w4_k;
+          }
+        if ((x_k != y_k) || (x_k != w_k))
+          MEX_FCN_ERR ("%s\n", "cmd[mdouble.elementwise]: Operands must "
+                       "have the same number of components.");
+
+        // Operands of a single element are broadcast.
+        size_t n = x_n;
+        if (n == 1)
+          n = y_n;
+        if (n == 1)
+          n = w_n;
+        if (((x_n != n) && (x_n != 1)) || ((y_n != n) && (y_n != 1))
+            || ((w_n != n) && (w_n != 1)))
+          MEX_FCN_ERR ("%s\n", "cmd[mdouble.elementwise]: Operands must "
+                       "have the same number of elements or a single one.");
+        DBG_PRINTF ("cmd[mdouble.elementwise]: op = %d, n = %d, k = %d\n",
+                    (int) op, (int) n, x_k);
+
+        plhs[0] = mxCreateNumericMatrix (n, x_k, mxDOUBLE_CLASS, mxREAL);
+        double *z  = mxGetPr (plhs[0]);
+        size_t  xs = (x_n == n);
+        size_t  ys = (y_n == n);
+        size_t  ws = (w_n == n);
+
+        #pragma omp parallel for schedule(static) if (n > MDOUBLE_CHUNK)
+        for (size_t i = 0; i < n; i += MDOUBLE_CHUNK)
+          {
+            size_t len = ((n - i) < MDOUBLE_CHUNK) ? (n - i) : MDOUBLE_CHUNK;
+            mdouble_map ((int) op, len, z + i, n, x + i * xs, x_n, xs,
+                         y + i * ys, y_n, ys, w + i * ws, w_n, ws, x_k);
+          }
+        break;
+      }
+
+      case 4003: // double[1 x k] mdouble.dot (double[n x k] x, double[n x k] y)
+      {
+        MEX_NARGINCHK (3);
+        MEX_MDOUBLE_T (1, x);
+        MEX_MDOUBLE_T (2, y);
+        if ((x_n != y_n) || (x_k != y_k))
+          MEX_FCN_ERR ("%s\n", "cmd[mdouble.dot]: Operands must have the "
+                       "same size.");
+        DBG_PRINTF ("cmd[mdouble.dot]: n = %d, k = %d\n", (int) x_n, x_k);
+
+        // Partial sums of chunks are added in fixed order, such that the
+        // result does not depend on the number of threads.
+        size_t num_chunks = (x_n + MDOUBLE_CHUNK - 1) / MDOUBLE_CHUNK;
+        md_t  *s = (md_t *) mxMalloc ((num_chunks + 1) * sizeof (md_t));
+        #pragma omp parallel for schedule(static) if (num_chunks > 1)
+        for (size_t c = 0; c < num_chunks; c++)
+          {
+            size_t i   = c * MDOUBLE_CHUNK;
+            size_t len = ((x_n - i) < MDOUBLE_CHUNK) ? (x_n - i)
+                                                     : MDOUBLE_CHUNK;
+            s[c] = mdouble_dot (len, x + i, x_n, y + i, y_n, x_k);
+          }
+        md_t sum = {{0.0, 0.0, 0.0, 0.0}};
+        for (size_t c = 0; c < num_chunks; c++)
+          sum = md_add (sum, s[c], x_k);
+        mxFree (s);
+
+        plhs[0] = mxCreateNumericMatrix (1, x_k, mxDOUBLE_CLASS, mxREAL);
+        md_store (mxGetPr (plhs[0]), 1, 0, sum, x_k);
+        break;
+      }
+
+      case 4004: // double[M*N x k] mdouble.mtimes (double[M*K x k] A, double[K*N x k] B, uint64_t M)
+      {
+        MEX_NARGINCHK (4);
+        MEX_MDOUBLE_T (1, A);
+        MEX_MDOUBLE_T (2, B);
+        uint64_t M = 0;
+        if (! extract_ui (3, nrhs, prhs, &M) || (M == 0))
+          MEX_FCN_ERR ("%s\n", "cmd[mdouble.mtimes]:M must be a positive "
+                       "numeric scalar denoting the rows of input A.");
+        uint64_t K = A_n / M;
+        uint64_t N = (K == 0) ? 0 : B_n / K;
+        if ((A_k != B_k) || (A_n != (M * K)) || (B_n != (K * N)))
+          MEX_FCN_ERR ("%s\n", "cmd[mdouble.mtimes]: Incompatible matrix "
+                       "dimensions.");
+        DBG_PRINTF ("cmd[mdouble.mtimes]: M = %d, N = %d, K = %d, k = %d\n",
+                    (int) M, (int) N, (int) K, A_k);
+
+        plhs[0] = mxCreateNumericMatrix (M * N, A_k, mxDOUBLE_CLASS, mxREAL);
+        mdouble_gemm (M, N, K, A, B, mxGetPr (plhs[0]), A_k);
+        break;
+      }
+
+      case 4005: // [double[M*N x k] LU, double[1 x min(M,N)] IPIV, int INFO] = mdouble.lu (double[M*N x k] A, uint64_t M)
+      {
+        MEX_NARGINCHK (3);
+        MEX_MDOUBLE_T (1, A);
+        uint64_t M = 0;
+        if (! extract_ui (2, nrhs, prhs, &M) || (M == 0) || (A_n % M))
+          MEX_FCN_ERR ("%s\n", "cmd[mdouble.lu]:M must be a positive "
+                       "numeric scalar denoting the rows of input A.");
+        uint64_t N = A_n / M;
+        uint64_t K = (M < N) ? M : N;
+        DBG_PRINTF ("cmd[mdouble.lu]: M = %d, N = %d, k = %d\n",
+                    (int) M, (int) N, A_k);
+
+        plhs[0] = mxCreateNumericMatrix (A_n, A_k, mxDOUBLE_CLASS, mxREAL);
+        double *LU = mxGetPr (plhs[0]);
+        memcpy (LU, A, A_n * A_k * sizeof (double));
+        plhs[1] = mxCreateNumericMatrix (1, K, mxDOUBLE_CLASS, mxREAL);
+        int INFO = mdouble_getrf (M, N, LU, mxGetPr (plhs[1]), A_k);
+        plhs[2] = mxCreateDoubleScalar ((double) INFO);
+        break;
+      }
+
+      default:
+        MEX_FCN_ERR ("Unknown command code '%d'\n", cmd_code);
+    }
+}
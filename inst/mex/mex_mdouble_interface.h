@@ -0,0 +1,47 @@
+/*
+ * This file is part of APA.
+ *
+ *  APA is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  APA is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MEX_MDOUBLE_INTERFACE_H_
+#define MEX_MDOUBLE_INTERFACE_H_
+
+
+#include "mex_apa_interface.h"
+
+/**
+ * Octave/Matlab MEX interface for double-double and quad-double arithmetic.
+ *
+ * @param[in] nlhs MEX parameter.
+ * @param[out] plhs MEX parameter.
+ * @param[in] nrhs MEX parameter.
+ * @param[in] prhs MEX parameter.
+ * @param[in] cmd_code code of command to execute (4000 - 4999).
+ */
+void
+mex_mdouble_interface (int nlhs, mxArray *plhs[],
+                       int nrhs, const mxArray *prhs[],
+                       uint64_t cmd_code);
+
+
+// Element-wise operations of command 4002.
+
+#define MDOUBLE_OP_ADD 0
+#define MDOUBLE_OP_SUB 1
+#define MDOUBLE_OP_MUL 2
+#define MDOUBLE_OP_DIV 3
+#define MDOUBLE_OP_FMA 4
+
+#endif  // MEX_MDOUBLE_INTERFACE_H_
@@ -58,8 +58,6 @@ mex_mpfr_algorithms (int nlhs, mxArray *plhs[],
         plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
                                          mxDOUBLE_CLASS, mxREAL);
         double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr    = &mpfr_data[rop.start - 1];
-        mpfr_ptr op_ptr     = &mpfr_data[op.start - 1];
         size_t   ret_stride = (nlhs) ? 1 : 0;
 
         for (uint64_t i = 0; i < ropM; i++)
@@ -110,9 +108,6 @@ mex_mpfr_algorithms (int nlhs, mxArray *plhs[],
         plhs[0] = mxCreateNumericMatrix (nlhs ? length (&C) : 1, 1,
                                          mxDOUBLE_CLASS, mxREAL);
         double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr C_ptr      = &mpfr_data[C.start - 1];
-        mpfr_ptr A_ptr      = &mpfr_data[A.start - 1];
-        mpfr_ptr B_ptr      = &mpfr_data[B.start - 1];
         size_t   ret_stride = (nlhs) ? 1 : 0;
 
         mpfr_apa_mmm (C_ptr, A_ptr, B_ptr, prec, rnd, M, N, K, ret_ptr,
@@ -156,9 +151,6 @@ mex_mpfr_algorithms (int nlhs, mxArray *plhs[],
 
         plhs[0] = mxCreateNumericMatrix ((nlhs ? M : 1), (nlhs ? N : 1),
                                          mxDOUBLE_CLASS, mxREAL);
-        mpfr_ptr L_ptr      = &mpfr_data[L.start - 1];
-        mpfr_ptr U_ptr      = &mpfr_data[U.start - 1];
-        mpfr_ptr A_ptr      = &mpfr_data[A.start - 1];
         double * ret_ptr    = mxGetPr (plhs[0]);
         size_t   ret_stride = (nlhs) ? 1 : 0;
 
@@ -244,8 +236,6 @@ mex_mpfr_algorithms (int nlhs, mxArray *plhs[],
 
         plhs[0] = mxCreateNumericMatrix ((nlhs ? N : 1), (nlhs ? N : 1),
                                          mxDOUBLE_CLASS, mxREAL);
-        mpfr_ptr A_ptr      = &mpfr_data[A.start - 1];
-        mpfr_ptr B_ptr      = &mpfr_data[B.start - 1];
         double * ret_ptr    = mxGetPr (plhs[0]);
         size_t   ret_stride = (nlhs) ? 1 : 0;
 
@@ -284,8 +274,6 @@ mex_mpfr_algorithms (int nlhs, mxArray *plhs[],
 
         plhs[0] = mxCreateNumericMatrix (N, 1, mxDOUBLE_CLASS, mxREAL);
         double * ret_ptr = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr = &mpfr_data[rop.start - 1];
-        mpfr_ptr op_ptr  = &mpfr_data[op.start - 1];
         #pragma omp parallel for
         for (size_t j = 0; j < N; j++)
           {
@@ -300,6 +288,331 @@ mex_mpfr_algorithms (int nlhs, mxArray *plhs[],
       }
 
 
+      case 2005: // int mpfr_t.fuse (mpfr_t rop, double prog[2 x K], mpfr_prec_t prec, mpfr_rnd_t rnd, operands...)
+      {
+        if (nrhs < 5)
+          MEX_FCN_ERR ("cmd[%d]: Invalid number of arguments.\n", cmd_code);
+        MEX_MPFR_T (1, rop);
+        MEX_MPFR_PREC_T (3, prec);
+        MEX_MPFR_RND_T (4, rnd);
+        if (! mxIsDouble (prhs[2]) || (mxGetM (prhs[2]) != 2))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.fuse]:prog must be a 2 x K "
+                       "double matrix.");
+        const double *prog = mxGetPr (prhs[2]);
+        size_t        len  = mxGetN (prhs[2]);
+        DBG_PRINTF ("cmd[mpfr_t.fuse]: rop = [%d:%d], len = %d, prec = %d, "
+                    "rnd = %d, num_ops = %d\n", rop.start, rop.end, (int) len,
+                    (int) prec, (int) rnd, nrhs - 5);
+
+        // Operands are MPFR variables or double values, as referenced by the
+        // program.  Scalar operands are applied to all elements.
+        size_t              num_ops = (size_t) (nrhs - 5);
+        mpfr_apa_operand_t *ops     = (mpfr_apa_operand_t *) mxMalloc (
+          (num_ops + 1) * sizeof(mpfr_apa_operand_t));
+        for (size_t k = 0; k < num_ops; k++)
+          {
+            int is_mpfr = -1;
+            for (size_t n = 0; n < len; n++)
+              if (((prog[2 * n] == MPFR_EXPR_MPFR)
+                   || (prog[2 * n] == MPFR_EXPR_DOUBLE))
+                  && (prog[2 * n + 1] == (double) (k + 1)))
+                is_mpfr = (prog[2 * n] == MPFR_EXPR_MPFR);
+
+            const mxArray *op = prhs[5 + k];
+            size_t         N  = 0;
+            ops[k].mpfr = NULL;
+            ops[k].d    = NULL;
+            if (is_mpfr == 1)
+              {
+                idx_t idx;
+                if (extract_idx ((int) (5 + k), nrhs, prhs, &idx))
+                  {
+                    ops[k].mpfr = mex_mpfr_ptr (&idx);
+                    N           = length (&idx);
+                  }
+              }
+            else if ((is_mpfr == 0) && mxIsDouble (op))
+              {
+                ops[k].d = mxGetPr (op);
+                N        = mxGetNumberOfElements (op);
+              }
+            ops[k].stride = (N == 1) ? 0 : 1;
+            if ((N != 1) && (N != length (&rop)))
+              {
+                mxFree (ops);
+                MEX_FCN_ERR ("cmd[mpfr_t.fuse]:Invalid operand %d.\n",
+                             (int) k + 1);
+              }
+          }
+
+        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
+                                         mxDOUBLE_CLASS, mxREAL);
+        double * ret_ptr    = mxGetPr (plhs[0]);
+        size_t   ret_stride = (nlhs) ? 1 : 0;
+
+        int valid = mpfr_apa_fused (rop_ptr, length (&rop), prog, len,
+                                    ops, num_ops, prec, rnd,
+                                    ret_ptr, ret_stride);
+        mxFree (ops);
+        if (! valid)
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.fuse]:Invalid program.");
+
+        return;
+      }
+
+
+      case 2006: // [int, double] mpfr_t.reduce (mpfr_t rop, mpfr_t op, uint64_t M, uint64_t dim, uint64_t kind, mpfr_prec_t prec, mpfr_rnd_t rnd)
+      {
+        MEX_NARGINCHK (8);
+        MEX_MPFR_T (1, rop);
+        MEX_MPFR_T (2, op);
+        uint64_t M = 0;
+        if (! extract_ui (3, nrhs, prhs, &M) || (M == 0))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.reduce]:M must be a positive "
+                       "numeric scalar denoting the rows of input op.");
+        uint64_t dim = 0;
+        if (! extract_ui (4, nrhs, prhs, &dim) || ((dim != 1) && (dim != 2)))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.reduce]:dim must be 1 or 2.");
+        uint64_t kind = 0;
+        if (! extract_ui (5, nrhs, prhs, &kind)
+            || (kind > MPFR_REDUCE_NORMINF))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.reduce]:kind Invalid reduction.");
+        MEX_MPFR_PREC_T (6, prec);
+        MEX_MPFR_RND_T (7, rnd);
+        DBG_PRINTF ("cmd[mpfr_t.reduce]: rop = [%d:%d], op = [%d:%d], "
+                    "M = %d, dim = %d, kind = %d, prec = %d, rnd = %d\n",
+                    rop.start, rop.end, op.start, op.end, (int) M, (int) dim,
+                    (int) kind, (int) prec, (int) rnd);
+
+        // Check matrix dimensions to be sane.
+        //    op [M x N]
+        //   rop [1 x N] (dim = 1) or [M x 1] (dim = 2)
+        uint64_t N = length (&op) / M;
+        if (length (&op) != (M * N))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.reduce]:M does not denote the "
+                       "number of rows of input op.");
+        if (length (&rop) != ((dim == 1) ? N : M))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.reduce]:rop Invalid size.");
+
+        plhs[0] = mxCreateNumericMatrix (length (&rop), 1, mxDOUBLE_CLASS,
+                                         mxREAL);
+        double *idx_ptr = NULL;
+        if ((nlhs > 1) && ((kind == MPFR_REDUCE_MAX)
+                           || (kind == MPFR_REDUCE_MIN)
+                           || (kind == MPFR_REDUCE_NORMINF)))
+          {
+            plhs[1] = mxCreateNumericMatrix (length (&rop), 1, mxDOUBLE_CLASS,
+                                             mxREAL);
+            idx_ptr = mxGetPr (plhs[1]);
+          }
+        mpfr_apa_reduce (rop_ptr, op_ptr, M, N, (int) dim, (int) kind, prec,
+                         rnd, mxGetPr (plhs[0]), idx_ptr);
+
+        return;
+      }
+
+
+      case 2007: // int mpfr_t.scan (mpfr_t rop, mpfr_t op, uint64_t M, uint64_t dim, uint64_t kind, uint64_t exclusive, mpfr_prec_t prec, mpfr_rnd_t rnd)
+      {
+        MEX_NARGINCHK (9);
+        MEX_MPFR_T (1, rop);
+        MEX_MPFR_T (2, op);
+        uint64_t M = 0;
+        if (! extract_ui (3, nrhs, prhs, &M) || (M == 0))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.scan]:M must be a positive "
+                       "numeric scalar denoting the rows of input op.");
+        uint64_t dim = 0;
+        if (! extract_ui (4, nrhs, prhs, &dim) || ((dim != 1) && (dim != 2)))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.scan]:dim must be 1 or 2.");
+        uint64_t kind = 0;
+        if (! extract_ui (5, nrhs, prhs, &kind) || (kind > MPFR_SCAN_MIN))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.scan]:kind Invalid scan.");
+        uint64_t exclusive = 0;
+        if (! extract_ui (6, nrhs, prhs, &exclusive) || (exclusive > 1))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.scan]:exclusive must be 0 or 1.");
+        MEX_MPFR_PREC_T (7, prec);
+        MEX_MPFR_RND_T (8, rnd);
+        DBG_PRINTF ("cmd[mpfr_t.scan]: rop = [%d:%d], op = [%d:%d], "
+                    "M = %d, dim = %d, kind = %d, exclusive = %d, "
+                    "prec = %d, rnd = %d\n",
+                    rop.start, rop.end, op.start, op.end, (int) M, (int) dim,
+                    (int) kind, (int) exclusive, (int) prec, (int) rnd);
+
+        // Check matrix dimensions to be sane.
+        //   op, rop [M x N]
+        uint64_t N = length (&op) / M;
+        if (length (&op) != (M * N))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.scan]:M does not denote the "
+                       "number of rows of input op.");
+        if (length (&rop) != length (&op))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.scan]:rop Invalid size.");
+        if ((rop.end >= op.start) && (op.end >= rop.start))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.scan]:rop must not overlap "
+                       "with op.");
+
+        plhs[0] = mxCreateNumericMatrix (length (&rop), 1, mxDOUBLE_CLASS,
+                                         mxREAL);
+        mpfr_apa_scan (rop_ptr, op_ptr, M, N, (int) dim, (int) kind,
+                       (int) exclusive, prec, rnd, mxGetPr (plhs[0]));
+
+        return;
+      }
+
+
+      case 2008: // double mpfr_t.sort (mpfr_t x, uint64_t M, uint64_t dim, uint64_t descend, uint64_t nan_first)
+      {
+        MEX_NARGINCHK (6);
+        MEX_MPFR_T (1, x);
+        uint64_t M = 0;
+        if (! extract_ui (2, nrhs, prhs, &M) || (M == 0))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.sort]:M must be a positive "
+                       "numeric scalar denoting the rows of input x.");
+        uint64_t dim = 0;
+        if (! extract_ui (3, nrhs, prhs, &dim) || ((dim != 1) && (dim != 2)))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.sort]:dim must be 1 or 2.");
+        uint64_t descend = 0;
+        if (! extract_ui (4, nrhs, prhs, &descend) || (descend > 1))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.sort]:descend must be 0 or 1.");
+        uint64_t nan_first = 0;
+        if (! extract_ui (5, nrhs, prhs, &nan_first) || (nan_first > 1))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.sort]:nan_first must be 0 or 1.");
+        DBG_PRINTF ("cmd[mpfr_t.sort]: x = [%d:%d], M = %d, dim = %d, "
+                    "descend = %d, nan_first = %d\n", x.start, x.end, (int) M,
+                    (int) dim, (int) descend, (int) nan_first);
+
+        uint64_t N = length (&x) / M;
+        if (length (&x) != (M * N))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.sort]:M does not denote the "
+                       "number of rows of input x.");
+
+        double *perm_ptr = NULL;
+        if (nlhs > 0)
+          {
+            plhs[0] = mxCreateNumericMatrix (M, N, mxDOUBLE_CLASS, mxREAL);
+            perm_ptr = mxGetPr (plhs[0]);
+          }
+        mpfr_apa_sort (x_ptr, M, N, (int) dim, (int) descend, (int) nan_first,
+                       perm_ptr);
+
+        return;
+      }
+
+
+      case 2009: // [int, double] mpfr_t.select (mpfr_t rop, mpfr_t op, uint64_t M, uint64_t dim, uint64_t[] ranks, mpfr_rnd_t rnd)
+      {
+        MEX_NARGINCHK (7);
+        MEX_MPFR_T (1, rop);
+        MEX_MPFR_T (2, op);
+        uint64_t M = 0;
+        if (! extract_ui (3, nrhs, prhs, &M) || (M == 0))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.select]:M must be a positive "
+                       "numeric scalar denoting the rows of input op.");
+        uint64_t dim = 0;
+        if (! extract_ui (4, nrhs, prhs, &dim) || ((dim != 1) && (dim != 2)))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.select]:dim must be 1 or 2.");
+        MEX_MPFR_RND_T (6, rnd);
+        uint64_t N = length (&op) / M;
+        if (length (&op) != (M * N))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.select]:M does not denote the "
+                       "number of rows of input op.");
+
+        // Ranks must be ascending and between 1 and the length along `dim`.
+        size_t    num_ranks = mxGetNumberOfElements (prhs[5]);
+        uint64_t *ranks     = NULL;
+        int       good      = (num_ranks > 0)
+                              && extract_ui_vector (5, nrhs, prhs, &ranks,
+                                                    num_ranks);
+        for (size_t r = 0; good && (r < num_ranks); r++)
+          good = (ranks[r] >= 1) && (ranks[r] <= ((dim == 1) ? M : N))
+                 && ((r == 0) || (ranks[r - 1] <= ranks[r]));
+        if (! good)
+          {
+            if (ranks != NULL)
+              mxFree (ranks);
+            MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.select]:ranks must be "
+                         "ascending indices along dim.");
+          }
+        DBG_PRINTF ("cmd[mpfr_t.select]: rop = [%d:%d], op = [%d:%d], "
+                    "M = %d, dim = %d, num_ranks = %d, rnd = %d\n",
+                    rop.start, rop.end, op.start, op.end, (int) M, (int) dim,
+                    (int) num_ranks, (int) rnd);
+
+        // Check matrix dimensions to be sane.
+        //    op [M x N]
+        //   rop [num_ranks x N] (dim = 1) or [M x num_ranks] (dim = 2)
+        if (length (&rop) != num_ranks * ((dim == 1) ? N : M))
+          {
+            mxFree (ranks);
+            MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.select]:rop Invalid size.");
+          }
+
+        plhs[0] = mxCreateNumericMatrix (length (&rop), 1, mxDOUBLE_CLASS,
+                                         mxREAL);
+        double *nan_ptr = NULL;
+        if (nlhs > 1)
+          {
+            plhs[1] = mxCreateNumericMatrix ((dim == 1) ? N : M, 1,
+                                             mxDOUBLE_CLASS, mxREAL);
+            nan_ptr = mxGetPr (plhs[1]);
+          }
+        mpfr_apa_select (rop_ptr, op_ptr, M, N, (int) dim, ranks, num_ranks,
+                         rnd, mxGetPr (plhs[0]), nan_ptr);
+        mxFree (ranks);
+
+        return;
+      }
+
+
+      case 2010: // double mpfr_t.sortrows (mpfr_t x, uint64_t M, int64_t[] cols)
+      {
+        MEX_NARGINCHK (4);
+        MEX_MPFR_T (1, x);
+        uint64_t M = 0;
+        if (! extract_ui (2, nrhs, prhs, &M) || (M == 0))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.sortrows]:M must be a positive "
+                       "numeric scalar denoting the rows of input x.");
+        uint64_t N = length (&x) / M;
+        if (length (&x) != (M * N))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.sortrows]:M does not denote the "
+                       "number of rows of input x.");
+
+        // Columns are non-zero integers between -N and N.
+        if (! mxIsDouble (prhs[3]))
+          MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.sortrows]:cols must be a double "
+                       "vector.");
+        size_t        num_cols = mxGetNumberOfElements (prhs[3]);
+        const double *cols_pr  = mxGetPr (prhs[3]);
+        int64_t *     cols     = (int64_t *) mxMalloc ((num_cols + 1)
+                                                       * sizeof(int64_t));
+        for (size_t c = 0; c < num_cols; c++)
+          {
+            double col = cols_pr[c];
+            if ((col == 0.0) || (floor (col) != col)
+                || (fabs (col) > (double) N))
+              {
+                mxFree (cols);
+                MEX_FCN_ERR ("%s\n", "cmd[mpfr_t.sortrows]:cols must be "
+                             "non-zero column indices.");
+              }
+            cols[c] = (int64_t) col;
+          }
+        DBG_PRINTF ("cmd[mpfr_t.sortrows]: x = [%d:%d], M = %d, "
+                    "num_cols = %d\n", x.start, x.end, (int) M,
+                    (int) num_cols);
+
+        double *perm_ptr = NULL;
+        if (nlhs > 0)
+          {
+            plhs[0] = mxCreateNumericMatrix (M, 1, mxDOUBLE_CLASS, mxREAL);
+            perm_ptr = mxGetPr (plhs[0]);
+          }
+        mpfr_apa_sortrows (x_ptr, M, N, cols, num_cols, perm_ptr);
+        mxFree (cols);
+
+        return;
+      }
+
+
       default:
         MEX_FCN_ERR ("Unknown command code '%d'\n", cmd_code);
     }
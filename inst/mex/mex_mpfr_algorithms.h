@@ -51,6 +51,19 @@ mpfr_apa_dot (mpfr_ptr rop, mpfr_ptr a, mpfr_ptr b, uint64_t N,
               mpfr_prec_t prec, mpfr_rnd_t rnd);
 
 
+/**
+ * MPFR Dot product `rop = a' * b` by Winograd's algorithm, given the pair
+ * products `xi = sum_l a(2l) * a(2l+1)` and `eta = sum_l b(2l) * b(2l+1)`,
+ * see mex_mpfr_algorithms_dot.c.
+ *
+ * @returns MPFR ternary return value (logical OR of all return values).
+ */
+int
+mpfr_apa_dot_winograd (mpfr_ptr rop, mpfr_ptr a, mpfr_ptr b, uint64_t N,
+                       mpfr_ptr xi, mpfr_ptr eta, mpfr_prec_t prec,
+                       mpfr_rnd_t rnd);
+
+
 /**
  * MPFR Matrix-Matrix-Multiplication `C = A * B`.
  *
@@ -66,7 +79,8 @@ mpfr_apa_dot (mpfr_ptr rop, mpfr_ptr a, mpfr_ptr b, uint64_t N,
  * @param ret_stride equals 1, if the array of MPFR return values should be
  *                   filled and has the same size as C.  Otherwise 0 for
  *                   scalar (ignored) return value.
- * @param strategy for matrix multiplication.
+ * @param strategy for matrix multiplication (0 to 12, see
+ *                 mex_mpfr_algorithms_mmm.c).
  */
 void
 mpfr_apa_mmm (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B,
@@ -74,6 +88,93 @@ mpfr_apa_mmm (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B,
               uint64_t M, uint64_t N, uint64_t K,
               double *ret_ptr, size_t ret_stride, uint64_t strategy);
 
+/**
+ * Test if the matrices A [M x K] and B [K x N] contain neither NaN nor Inf.
+ *
+ * Algorithms forming sums of the elements of A or B, like Strassen's, get
+ * NaN from Inf - Inf, where the conventional product is infinite.
+ *
+ * @returns non-zero, if all elements are numbers.
+ */
+int
+mpfr_apa_mmm_number_p (mpfr_ptr A, mpfr_ptr B, uint64_t M, uint64_t N,
+                       uint64_t K);
+
+// Smallest precision for which `mpfr_apa_mmm` strategy 0 selects Winograd's
+// inner product algorithm, `0` never.
+extern mpfr_prec_t mpfr_winograd_min_prec;
+
+/**
+ * MPFR Matrix-Matrix-Multiplication `C = A * B` with exact GMP integer
+ * accumulation.
+ *
+ * Each row of A and column of B is scaled by a power of two to integers,
+ * the inner products are accumulated exactly by `mpz_addmul` and rounded
+ * once by `rnd`.  Thus each element of C is correctly rounded and the MPFR
+ * return values are exact.  This is possible if A and B contain no NaN or
+ * Inf and the exponent spread of each row of A and column of B is less than
+ * three times the maximum precision of A and B.
+ *
+ * Parameters as for `mpfr_apa_mmm`, C must be zero-initialized.
+ *
+ * @returns zero, if not possible and C is unchanged.
+ */
+int
+mpfr_apa_mmm_exact (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B, mpfr_rnd_t rnd,
+                    uint64_t M, uint64_t N, uint64_t K,
+                    double *ret_ptr, size_t ret_stride);
+
+/**
+ * MPFR Matrix-Matrix-Multiplication `C = A * B` by the Ozaki scheme.
+ *
+ * Each row of A and column of B is split into slices of double precision
+ * integers, whose products are computed exactly by the BLAS routine DGEMM.
+ * The slice products are accumulated exactly and rounded once by `rnd`.
+ * The slices cover `prec` plus guard bits relative to the largest element
+ * of each row of A and column of B, thus the error bound is normwise.  This
+ * is possible if A and B contain no NaN or Inf, the number of slices
+ * does not exceed 32, which limits `prec` to about 600 bits for K = 1000,
+ * the slices take at most 1 GiB, and the integer type of the BLAS is known.
+ * The MPFR return values are non-zero as well, if the slices truncated a row
+ * of A or column of B, or the dropped slice products are possibly non-zero.
+ *
+ * Parameters as for `mpfr_apa_mmm`, C must be zero-initialized.
+ *
+ * @returns zero, if not possible and C is unchanged.
+ */
+int
+mpfr_apa_mmm_ozaki (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B, mpfr_prec_t prec,
+                    mpfr_rnd_t rnd, uint64_t M, uint64_t N, uint64_t K,
+                    double *ret_ptr, size_t ret_stride);
+
+
+// Largest matrix dimension multiplied conventionally by `mpfr_apa_strassen`.
+extern size_t mpfr_strassen_cutoff;
+
+/**
+ * MPFR Strassen-Winograd Matrix-Matrix-Multiplication `C = A * B`.
+ *
+ * Recursion stops at matrix dimensions of at most `mpfr_strassen_cutoff`.
+ * All intermediate results have `prec` plus 5 guard bits per recursion level
+ * and are rounded to nearest, the final result is rounded by `rnd`.  Unlike
+ * the conventional algorithm, the error is only bounded normwise.
+ *
+ * The workspace has about 2/3 of the size of C.  With more than one OpenMP
+ * thread, the seven products of the first one or two recursion levels are
+ * computed as tasks with their own temporaries, about 4 or 10 times the size
+ * of C, as long as they fit into `MPFR_STRASSEN_MAX_TASK_BYTES`.
+ *
+ * If A or B contain NaN or Inf, the conventional algorithm (strategy 8 of
+ * `mpfr_apa_mmm`) is used.
+ *
+ * Parameters as for `mpfr_apa_mmm`, C must be zero-initialized.  The MPFR
+ * return values are non-zero if any intermediate result was inexact.
+ */
+void
+mpfr_apa_strassen (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B, mpfr_prec_t prec,
+                   mpfr_rnd_t rnd, uint64_t M, uint64_t N, uint64_t K,
+                   double *ret_ptr, size_t ret_stride);
+
 
 /**
  * MPFR LU factorization of a general M-by-N matrix A using partial pivoting
@@ -174,5 +275,223 @@ mpfr_apa_GESV (uint64_t N, uint64_t NRHS, mpfr_ptr A, uint64_t LDA,
                double *ret_ptr, size_t ret_stride);
 
 
+// Element-wise expressions
+// ========================
+//
+// mex_mpfr_algorithms_fused.c
+//
+// An expression is a program, a 2 x K double matrix of instructions
+// `[opcode; arg]` in postfix order, see @mpfr_expr/mpfr_expr.m.
+
+#define MPFR_EXPR_MPFR   0  // Push MPFR operand number `arg` (1-based).
+#define MPFR_EXPR_DOUBLE 1  // Push double operand number `arg` (1-based).
+#define MPFR_EXPR_ADD    2
+#define MPFR_EXPR_SUB    3
+#define MPFR_EXPR_MUL    4
+#define MPFR_EXPR_DIV    5
+#define MPFR_EXPR_NEG    6
+#define MPFR_EXPR_POW_SI 7  // Power with integer exponent `arg`.
+#define MPFR_EXPR_SQR    8
+
+
+// Operand of an element-wise expression.
+
+typedef struct
+{
+  mpfr_ptr mpfr;    // MPFR variables or NULL.
+  double * d;       // Double values, if `mpfr == NULL`.
+  size_t   stride;  // 0 for scalar operands, 1 otherwise.
+} mpfr_apa_operand_t;
+
+
+/**
+ * Evaluate an element-wise expression `rop = f(ops)` in a single pass.
+ *
+ * Multiplications followed by an addition or subtraction are fused to
+ * `mpfr_fma`, `mpfr_fms`, `mpfr_fmma`, or `mpfr_fmms`, thus rounded only
+ * once.  Intermediate results are kept in per-thread scratch variables.
+ *
+ * @param rop vector @c mpfr_ptr of length @c N.
+ * @param N vector length of @c rop.
+ * @param prog program of the expression (2 x @c len instructions).
+ * @param len number of instructions.
+ * @param ops operands of the expression.
+ * @param num_ops number of operands.
+ * @param prec MPFR precision for intermediate operations.
+ * @param rnd  MPFR rounding mode for all operations.
+ * @param ret_ptr pointer to array of MPFR return values.
+ * @param ret_stride equals 1, if the array of MPFR return values should be
+ *                   filled and has the same size as rop.  Otherwise 0 for
+ *                   scalar return value (logical OR of all return values).
+ *
+ * @returns `0` if @c prog is invalid, otherwise `1`.
+ */
+int
+mpfr_apa_fused (mpfr_ptr rop, uint64_t N, const double *prog, size_t len,
+                const mpfr_apa_operand_t *ops, size_t num_ops,
+                mpfr_prec_t prec, mpfr_rnd_t rnd,
+                double *ret_ptr, size_t ret_stride);
+
+
+// Reductions
+// ==========
+//
+// mex_mpfr_algorithms_reduce.c
+
+#define MPFR_REDUCE_SUM     0
+#define MPFR_REDUCE_PROD    1
+#define MPFR_REDUCE_MAX     2
+#define MPFR_REDUCE_MIN     3
+#define MPFR_REDUCE_NORM1   4  // Sum of absolute values.
+#define MPFR_REDUCE_NORM2   5  // Square root of the sum of squares.
+#define MPFR_REDUCE_NORMINF 6  // Maximum of absolute values.
+
+
+/**
+ * Reduce a matrix `op` along dimension `dim` to `rop`.
+ *
+ * Long columns (or rows) are split into chunks of fixed length, which are
+ * reduced in parallel and combined in chunk order.  Thus the result does
+ * not depend on the number of threads.  Sums are correctly rounded.
+ *
+ * @param[out] rop vector @c mpfr_ptr of length @c N (dim = 1) or @c M
+ *                 (dim = 2).
+ * @param[in] op [M x N] @c mpfr_ptr.
+ * @param[in] M rows of @c op.
+ * @param[in] N columns of @c op.
+ * @param[in] dim dimension to reduce (1 or 2).
+ * @param[in] kind reduction `MPFR_REDUCE_*`.
+ * @param[in] prec MPFR precision for intermediate operations.
+ * @param[in] rnd  MPFR rounding mode for all operations.
+ * @param[out] ret_ptr array of MPFR return values of the length of @c rop
+ *                     (logical OR of all return values per element).
+ * @param[out] idx_ptr array of the length of @c rop for the (1-based) indices
+ *                     of the extreme values along @c dim, if @c kind is
+ *                     `MPFR_REDUCE_MAX`, `MPFR_REDUCE_MIN`, or
+ *                     `MPFR_REDUCE_NORMINF`.  May be NULL.
+ */
+void
+mpfr_apa_reduce (mpfr_ptr rop, mpfr_ptr op, uint64_t M, uint64_t N, int dim,
+                 int kind, mpfr_prec_t prec, mpfr_rnd_t rnd,
+                 double *ret_ptr, double *idx_ptr);
+
+
+// Prefix scans
+// ============
+//
+// mex_mpfr_algorithms_scan.c
+
+#define MPFR_SCAN_ADD 0
+#define MPFR_SCAN_MUL 1
+#define MPFR_SCAN_MAX 2  // NaN elements are ignored.
+#define MPFR_SCAN_MIN 3  // NaN elements are ignored.
+
+
+/**
+ * Inclusive or exclusive prefix scan of a matrix `op` along dimension `dim`.
+ *
+ * Long columns (or rows) are split into blocks of fixed length.  The block
+ * totals are computed in parallel, scanned, and used as carries for the
+ * parallel scans of the blocks.  Thus the result does not depend on the
+ * number of threads.  Within the first block the results are rounded as by
+ * a sequential scan.
+ *
+ * The first result of an exclusive scan is the identity element 0, 1, -Inf,
+ * or Inf, respectively.
+ *
+ * @param[out] rop [M x N] @c mpfr_ptr, must not overlap with @c op.
+ * @param[in] op [M x N] @c mpfr_ptr.
+ * @param[in] M rows of @c op.
+ * @param[in] N columns of @c op.
+ * @param[in] dim dimension to scan (1 or 2).
+ * @param[in] kind scan operation `MPFR_SCAN_*`.
+ * @param[in] exclusive if non-zero, each result excludes its own element.
+ * @param[in] prec MPFR precision of the block totals.
+ * @param[in] rnd  MPFR rounding mode for all operations.
+ * @param[out] ret_ptr [M x N] array of MPFR return values (logical OR of
+ *                     all return values contributing to a result).
+ */
+void
+mpfr_apa_scan (mpfr_ptr rop, mpfr_ptr op, uint64_t M, uint64_t N, int dim,
+               int kind, int exclusive, mpfr_prec_t prec, mpfr_rnd_t rnd,
+               double *ret_ptr);
+
+
+// Sorting and selection
+// =====================
+//
+// mex_mpfr_algorithms_sort.c
+//
+// The order of two numbers is determined by sign and exponent first, only
+// for equal signs and exponents by `mpfr_cmp`.  Signed zeros are equal.
+
+
+/**
+ * Stable in-place sort of a matrix `x` along dimension `dim`.
+ *
+ * The MPFR variables are exchanged by `mpfr_swap`, no significands are
+ * copied.  Blocks of fixed length are sorted in parallel and merged
+ * pairwise in parallel.
+ *
+ * @param[in,out] x [M x N] @c mpfr_ptr.
+ * @param[in] M rows of @c x.
+ * @param[in] N columns of @c x.
+ * @param[in] dim dimension to sort (1 or 2).
+ * @param[in] descend if non-zero, sort in descending order.
+ * @param[in] nan_first if non-zero, sort NaN before all numbers, otherwise
+ *                      after all numbers.
+ * @param[out] perm_ptr [M x N] array of the (1-based) indices along @c dim
+ *                      of the sorted elements in the original @c x.  May
+ *                      be NULL.
+ */
+void
+mpfr_apa_sort (mpfr_ptr x, uint64_t M, uint64_t N, int dim, int descend,
+               int nan_first, double *perm_ptr);
+
+
+/**
+ * Stable in-place lexicographic sort of the rows of a matrix `x`.
+ *
+ * NaN is greater than all numbers.
+ *
+ * @param[in,out] x [M x N] @c mpfr_ptr.
+ * @param[in] M rows of @c x.
+ * @param[in] N columns of @c x.
+ * @param[in] cols (1-based) columns to sort by in order of precedence,
+ *                 negative for descending order.
+ * @param[in] num_cols length of @c cols.
+ * @param[out] perm_ptr array of length @c M of the (1-based) indices of the
+ *                      sorted rows in the original @c x.  May be NULL.
+ */
+void
+mpfr_apa_sortrows (mpfr_ptr x, uint64_t M, uint64_t N, const int64_t *cols,
+                   size_t num_cols, double *perm_ptr);
+
+
+/**
+ * Select the k-th smallest elements of a matrix `op` along dimension `dim`.
+ *
+ * Quickselect on each column (or row) in parallel, `op` is not modified.
+ * NaN elements are greater than all numbers, like for `mpfr_apa_sort`.
+ *
+ * @param[out] rop [num_ranks x N] (dim = 1) or [M x num_ranks] (dim = 2)
+ *                 @c mpfr_ptr.
+ * @param[in] op [M x N] @c mpfr_ptr.
+ * @param[in] M rows of @c op.
+ * @param[in] N columns of @c op.
+ * @param[in] dim dimension to select along (1 or 2).
+ * @param[in] ranks ascending (1-based) ranks k.
+ * @param[in] num_ranks length of @c ranks.
+ * @param[in] rnd MPFR rounding mode to set @c rop.
+ * @param[out] ret_ptr array of MPFR return values of the length of @c rop.
+ * @param[out] nan_ptr array of the number of NaN elements of each column
+ *                     (dim = 1) or row (dim = 2).  May be NULL.
+ */
+void
+mpfr_apa_select (mpfr_ptr rop, mpfr_ptr op, uint64_t M, uint64_t N, int dim,
+                 const uint64_t *ranks, size_t num_ranks, mpfr_rnd_t rnd,
+                 double *ret_ptr, double *nan_ptr);
+
+
 #endif // MEX_MPFR_ALGORITHMS_H_
 
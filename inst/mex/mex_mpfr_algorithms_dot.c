@@ -35,15 +35,19 @@ mpfr_apa_dot (mpfr_ptr rop, mpfr_ptr a, mpfr_ptr b, uint64_t N,
 {
   int ret = 0;
 
+  // Fixed-limb kernel if all variables have the precision `prec`.
+  mpfr_fixed_op3_t fma_fcn = mex_mpfr_fixed_op3 (1056, prec, mpfr_fma);
+
   #pragma omp parallel shared(ret)
   {
     int    r = 0;
     mpfr_t c;
-    mpfr_init_set_d (c, 0.0, prec);
+    mpfr_init2 (c, prec);
+    mpfr_set_zero (c, 1);
 
     #pragma omp for
     for (uint64_t i = 0; i < N; i++)
-      r |= mpfr_fma (c, a + i, b + i, c, rnd);
+      r |= fma_fcn (c, a + i, b + i, c, rnd);
 
     // Sum `c` to `rop`, one thread at a time.
     #pragma omp critical
@@ -57,3 +61,59 @@ mpfr_apa_dot (mpfr_ptr rop, mpfr_ptr a, mpfr_ptr b, uint64_t N,
   return (ret);
 }
 
+
+
+/**
+ * MPFR Dot product `rop = a' * b` by Winograd's algorithm (1968).
+ *
+ *   a' * b = sum_l (a(2l) + b(2l+1)) * (a(2l+1) + b(2l)) - xi - eta
+ *
+ * with the pair products `xi = sum_l a(2l) * a(2l+1)` and
+ * `eta = sum_l b(2l) * b(2l+1)`.  Within a matrix product `xi` and `eta` are
+ * shared by all inner products with the same row of A or column of B, such
+ * that only N/2 instead of N multiplications remain per inner product.
+ *
+ * The error is bounded by (|a| + |b|)^2 instead of |a| |b|, thus @c a and
+ * @c b should be of similar magnitude and `prec` should contain guard bits.
+ * Unlike `mpfr_apa_dot` this function is serial.
+ *
+ * @param rop scalar @c mpfr_ptr.
+ * @param a vector @c mpfr_ptr of length @c N.
+ * @param b vector @c mpfr_ptr of length @c N.
+ * @param N vector length of @c a and @c b.
+ * @param xi pair products of @c a.
+ * @param eta pair products of @c b.
+ * @param prec MPFR precision for intermediate operations.
+ * @param rnd  MPFR rounding mode for all operations.
+ *
+ * @returns MPFR ternary return value (logical OR of all return values).
+ */
+int
+mpfr_apa_dot_winograd (mpfr_ptr rop, mpfr_ptr a, mpfr_ptr b, uint64_t N,
+                       mpfr_ptr xi, mpfr_ptr eta, mpfr_prec_t prec,
+                       mpfr_rnd_t rnd)
+{
+  int ret = 0;
+
+  // Fixed-limb kernel if all variables have the precision `prec`.
+  mpfr_fixed_op3_t fma_fcn = mex_mpfr_fixed_op3 (1056, prec, mpfr_fma);
+
+  mpfr_t c, u, v;
+  mpfr_inits2 (prec, c, u, v, (mpfr_ptr) 0);
+  mpfr_set_zero (c, 1);
+  for (uint64_t l = 0; l + 1 < N; l += 2)
+    {
+      ret |= mpfr_add (u, a + l, b + l + 1, rnd);
+      ret |= mpfr_add (v, a + l + 1, b + l, rnd);
+      ret |= fma_fcn (c, u, v, c, rnd);
+    }
+  if (N % 2)
+    ret |= fma_fcn (c, a + N - 1, b + N - 1, c, rnd);
+
+  ret |= mpfr_sub (c, c, xi, rnd);
+  ret |= mpfr_sub (c, c, eta, rnd);
+
+  ret |= mpfr_add (rop, rop, c, rnd);
+  mpfr_clears (c, u, v, (mpfr_ptr) 0);
+  return (ret);
+}
@@ -0,0 +1,199 @@
+/*
+ * This file is part of APA.
+ *
+ *  APA is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  APA is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mex_mpfr_interface.h"
+
+// Tile sizes.  Each thread packs a [MPFR_EXACT_TILE x MPFR_EXACT_KBLOCK]
+// panel of A and a [MPFR_EXACT_KBLOCK x MPFR_EXACT_TILE] panel of B at a
+// time.
+#define MPFR_EXACT_TILE   32
+#define MPFR_EXACT_KBLOCK 64
+
+// The integers of a row of A or column of B have at most this multiple of
+// the input precision bits, i.e. the exponent spread is less than three
+// times the precision.  Otherwise the integer products get too expensive.
+#define MPFR_EXACT_MAX_WIDTH 4
+
+
+/**
+ * Common exponent of a row of A or a column of B.
+ *
+ * @param[in] x first element.
+ * @param[in] len number of elements.
+ * @param[in] stride distance of the elements.
+ * @param[in] max_width maximum integer width in bits.
+ * @param[out] e exponent of the least significant bit of all elements, `0`
+ *               if all are zero.
+ *
+ * @returns zero, if there are NaN or Inf elements or the width exceeds
+ *          `max_width`.
+ */
+static int
+mpfr_apa_exact_exp (mpfr_ptr x, uint64_t len, uint64_t stride,
+                    mpfr_prec_t max_width, mpfr_exp_t *e)
+{
+  int        found = 0;
+  mpfr_exp_t emin  = 0;
+  mpfr_exp_t emax  = 0;
+  for (uint64_t l = 0; l < len; l++)
+    {
+      mpfr_ptr p = x + l * stride;
+      if (mpfr_zero_p (p))
+        continue;
+      if (! mpfr_regular_p (p))
+        return (0);
+      mpfr_exp_t ex = mpfr_get_exp (p);
+      mpfr_exp_t el = ex - mpfr_get_prec (p);
+      if (! found || (el < emin))
+        emin = el;
+      if (! found || (ex > emax))
+        emax = ex;
+      found = 1;
+    }
+  *e = emin;
+  return (emax - emin <= max_width);
+}
+
+
+/**
+ * Set `z = x * 2^(-e)`, which is an integer by the choice of `e`.
+ */
+static inline void
+mpfr_apa_exact_get_z (mpz_ptr z, mpfr_ptr x, mpfr_exp_t e)
+{
+  if (mpfr_zero_p (x))
+    mpz_set_ui (z, 0);
+  else
+    mpz_mul_2exp (z, z, mpfr_get_z_2exp (z, x) - e);
+}
+
+
+int
+mpfr_apa_mmm_exact (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B, mpfr_rnd_t rnd,
+                    uint64_t M, uint64_t N, uint64_t K,
+                    double *ret_ptr, size_t ret_stride)
+{
+  mpfr_prec_t pprec = MPFR_PREC_MIN;
+  for (uint64_t i = 0; i < M * K; i++)
+    if (mpfr_get_prec (A + i) > pprec)
+      pprec = mpfr_get_prec (A + i);
+  for (uint64_t i = 0; i < K * N; i++)
+    if (mpfr_get_prec (B + i) > pprec)
+      pprec = mpfr_get_prec (B + i);
+
+  // Exponents of the rows of A and columns of B.
+  mpfr_exp_t *ea = (mpfr_exp_t *) mxMalloc ((M + N) * sizeof(mpfr_exp_t));
+  mpfr_exp_t *eb = ea + M;
+  int         ok = 1;
+  #pragma omp parallel for reduction(&:ok)
+  for (uint64_t i = 0; i < M + N; i++)
+    ok &= (i < M)
+          ? mpfr_apa_exact_exp (A + i, K, M, MPFR_EXACT_MAX_WIDTH * pprec,
+                                ea + i)
+          : mpfr_apa_exact_exp (B + K * (i - M), K, 1,
+                                MPFR_EXACT_MAX_WIDTH * pprec, ea + i);
+  if (! ok)
+    {
+      DBG_PRINTF ("%s\n", "mpfr_apa_mmm_exact: not applicable");
+      mxFree (ea);
+      return (0);
+    }
+
+  // Panels and tile accumulators of each thread.
+  int    num_threads = omp_get_max_threads ();
+  size_t panel_len   = 2 * MPFR_EXACT_TILE * MPFR_EXACT_KBLOCK
+                       + MPFR_EXACT_TILE * MPFR_EXACT_TILE;
+  mpz_ptr panels = (mpz_ptr) mxMalloc (num_threads * panel_len
+                                       * sizeof(mpz_t));
+
+  uint64_t mt      = (M + MPFR_EXACT_TILE - 1) / MPFR_EXACT_TILE;
+  uint64_t nt      = (N + MPFR_EXACT_TILE - 1) / MPFR_EXACT_TILE;
+  int      ret_any = 0;
+
+  #pragma omp parallel
+  {
+    mpz_ptr Ap  = panels + omp_get_thread_num () * panel_len;
+    mpz_ptr Bp  = Ap + MPFR_EXACT_TILE * MPFR_EXACT_KBLOCK;
+    mpz_ptr acc = Bp + MPFR_EXACT_TILE * MPFR_EXACT_KBLOCK;
+    for (size_t p = 0; p < panel_len; p++)
+      mpz_init (Ap + p);
+
+    #pragma omp for schedule(dynamic) reduction(|:ret_any)
+    for (uint64_t t = 0; t < mt * nt; t++)
+      {
+        uint64_t i0 = (t % mt) * MPFR_EXACT_TILE;
+        uint64_t j0 = (t / mt) * MPFR_EXACT_TILE;
+        uint64_t mb = ((M - i0) < MPFR_EXACT_TILE) ? (M - i0)
+                      : MPFR_EXACT_TILE;
+        uint64_t nb = ((N - j0) < MPFR_EXACT_TILE) ? (N - j0)
+                      : MPFR_EXACT_TILE;
+        for (uint64_t p = 0; p < MPFR_EXACT_TILE * MPFR_EXACT_TILE; p++)
+          mpz_set_ui (acc + p, 0);
+
+        for (uint64_t k0 = 0; k0 < K; k0 += MPFR_EXACT_KBLOCK)
+          {
+            uint64_t kb = ((K - k0) < MPFR_EXACT_KBLOCK) ? (K - k0)
+                          : MPFR_EXACT_KBLOCK;
+
+            // Pack integers of rows of A and columns of B.
+            for (uint64_t k = 0; k < kb; k++)
+              for (uint64_t i = 0; i < mb; i++)
+                mpfr_apa_exact_get_z (Ap + i * MPFR_EXACT_KBLOCK + k,
+                                      A + (i0 + i) + M * (k0 + k),
+                                      ea[i0 + i]);
+            for (uint64_t j = 0; j < nb; j++)
+              for (uint64_t k = 0; k < kb; k++)
+                mpfr_apa_exact_get_z (Bp + j * MPFR_EXACT_KBLOCK + k,
+                                      B + (k0 + k) + K * (j0 + j),
+                                      eb[j0 + j]);
+
+            for (uint64_t j = 0; j < nb; j++)
+              for (uint64_t i = 0; i < mb; i++)
+                {
+                  mpz_ptr c = acc + j * MPFR_EXACT_TILE + i;
+                  mpz_ptr a = Ap + i * MPFR_EXACT_KBLOCK;
+                  mpz_ptr b = Bp + j * MPFR_EXACT_KBLOCK;
+                  for (uint64_t k = 0; k < kb; k++)
+                    mpz_addmul (c, a + k, b + k);
+                }
+          }
+
+        // The only rounding.  A scalar return value is combined after the
+        // parallel region.
+        for (uint64_t j = 0; j < nb; j++)
+          for (uint64_t i = 0; i < mb; i++)
+            {
+              int r = mpfr_set_z_2exp (C + M * (j0 + j) + (i0 + i),
+                                       acc + j * MPFR_EXACT_TILE + i,
+                                       ea[i0 + i] + eb[j0 + j], rnd);
+              if (ret_stride)
+                ret_ptr[M * (j0 + j) + (i0 + i)] = (double) r;
+              else
+                ret_any |= r;
+            }
+      }
+
+    for (size_t p = 0; p < panel_len; p++)
+      mpz_clear (Ap + p);
+  }
+  if (! ret_stride)
+    ret_ptr[0] = (double) ret_any;
+
+  mxFree (panels);
+  mxFree (ea);
+  return (1);
+}
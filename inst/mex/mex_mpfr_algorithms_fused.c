@@ -0,0 +1,338 @@
+/*
+ * This file is part of APA.
+ *
+ *  APA is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  APA is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <float.h>
+#include <limits.h>
+
+#include "mex_mpfr_interface.h"
+
+// Fused opcodes, created from MPFR_EXPR_MUL and its parent node.
+
+#define MPFR_EXPR_FMA  9   // a * b + c
+#define MPFR_EXPR_FMS  10  // a * b - c
+#define MPFR_EXPR_FNMA 11  // c - a * b
+#define MPFR_EXPR_FMMA 12  // a * b + c * d
+#define MPFR_EXPR_FMMS 13  // a * b - c * d
+
+// Node of the expression tree.  Child nodes precede their parent node.
+
+typedef struct
+{
+  int  op;      // Opcode.
+  int  arg[4];  // Child nodes, or operand number (0-based) of leaves.
+  long si;      // Exponent of MPFR_EXPR_POW_SI.
+  int  dead;    // Fused into the parent node, thus not evaluated.
+} mpfr_expr_node_t;
+
+
+/**
+ * Build and fuse the expression tree of a program.
+ *
+ * @param[in] prog program of the expression (2 x @c len instructions).
+ * @param[in] len number of instructions.
+ * @param[in] ops operands of the expression.
+ * @param[in] num_ops number of operands.
+ * @param[out] nodes expression tree of @c len nodes, the last one is the root.
+ *
+ * @returns `0` if @c prog is invalid, otherwise `1`.
+ */
+static int
+mpfr_expr_compile (const double *prog, size_t len,
+                   const mpfr_apa_operand_t *ops, size_t num_ops,
+                   mpfr_expr_node_t *nodes)
+{
+  // Operand stack, holds at most `len` nodes.
+  int *  stack = (int *) mxMalloc (len * sizeof(int));
+  int    depth = 0;
+  size_t n     = 0;
+
+  for (n = 0; n < len; n++)
+    {
+      double            op  = prog[2 * n];
+      double            arg = prog[2 * n + 1];
+      mpfr_expr_node_t *p   = nodes + n;
+      if ((op != floor (op)) || (arg != floor (arg)) || (fabs (op) > 100.0)
+          || (fabs (arg) > (double) LONG_MAX))
+        break;
+      p->op   = (int) op;
+      p->si   = 0;
+      p->dead = 0;
+
+      int arity = -1;
+      switch (p->op)
+        {
+          case MPFR_EXPR_MPFR:
+          case MPFR_EXPR_DOUBLE:
+            if ((arg >= 1) && (arg <= (double) num_ops)
+                && ((ops[(size_t) arg - 1].mpfr != NULL)
+                    == (p->op == MPFR_EXPR_MPFR)))
+              {
+                p->arg[0] = (int) arg - 1;
+                arity     = 0;
+              }
+            break;
+
+          case MPFR_EXPR_POW_SI:
+            p->si = (long) arg;
+            arity = 1;
+            break;
+
+          case MPFR_EXPR_NEG:
+          case MPFR_EXPR_SQR:
+            arity = 1;
+            break;
+
+          case MPFR_EXPR_ADD:
+          case MPFR_EXPR_SUB:
+          case MPFR_EXPR_MUL:
+          case MPFR_EXPR_DIV:
+            arity = 2;
+            break;
+
+          default:
+            break;
+        }
+
+      if ((arity < 0) || (depth < arity))
+        break;
+      depth -= arity;
+      for (int i = 0; i < arity; i++)
+        p->arg[i] = stack[depth + i];
+      stack[depth++] = (int) n;
+    }
+  mxFree (stack);
+  if ((len == 0) || (n < len) || (depth != 1))
+    return (0);
+
+  // Fuse multiplications into their parent addition or subtraction.
+  for (n = 0; n < len; n++)
+    {
+      mpfr_expr_node_t *p = nodes + n;
+      if ((p->op != MPFR_EXPR_ADD) && (p->op != MPFR_EXPR_SUB))
+        continue;
+
+      mpfr_expr_node_t *l = nodes + p->arg[0];
+      mpfr_expr_node_t *r = nodes + p->arg[1];
+      int               c = p->arg[1];
+      if ((l->op == MPFR_EXPR_MUL) && (r->op == MPFR_EXPR_MUL))
+        {
+          p->op     = (p->op == MPFR_EXPR_ADD) ? MPFR_EXPR_FMMA
+                                               : MPFR_EXPR_FMMS;
+          p->arg[0] = l->arg[0];
+          p->arg[1] = l->arg[1];
+          p->arg[2] = r->arg[0];
+          p->arg[3] = r->arg[1];
+          l->dead   = 1;
+          r->dead   = 1;
+        }
+      else if (l->op == MPFR_EXPR_MUL)
+        {
+          p->op     = (p->op == MPFR_EXPR_ADD) ? MPFR_EXPR_FMA
+                                               : MPFR_EXPR_FMS;
+          p->arg[0] = l->arg[0];
+          p->arg[1] = l->arg[1];
+          p->arg[2] = c;
+          l->dead   = 1;
+        }
+      else if (r->op == MPFR_EXPR_MUL)
+        {
+          p->op     = (p->op == MPFR_EXPR_ADD) ? MPFR_EXPR_FMA
+                                               : MPFR_EXPR_FNMA;
+          p->arg[2] = p->arg[0];
+          p->arg[0] = r->arg[0];
+          p->arg[1] = r->arg[1];
+          r->dead   = 1;
+        }
+    }
+  return (1);
+}
+
+
+/**
+ * Evaluate an element-wise expression `rop = f(ops)` in a single pass.
+ *
+ * Multiplications followed by an addition or subtraction are fused to
+ * `mpfr_fma`, `mpfr_fms`, `mpfr_fmma`, or `mpfr_fmms`, thus rounded only
+ * once.  Intermediate results are kept in per-thread scratch variables.
+ *
+ * @param rop vector @c mpfr_ptr of length @c N.
+ * @param N vector length of @c rop.
+ * @param prog program of the expression (2 x @c len instructions).
+ * @param len number of instructions.
+ * @param ops operands of the expression.
+ * @param num_ops number of operands.
+ * @param prec MPFR precision for intermediate operations.
+ * @param rnd  MPFR rounding mode for all operations.
+ * @param ret_ptr pointer to array of MPFR return values.
+ * @param ret_stride equals 1, if the array of MPFR return values should be
+ *                   filled and has the same size as rop.  Otherwise 0 for
+ *                   scalar return value (logical OR of all return values).
+ *
+ * @returns `0` if @c prog is invalid, otherwise `1`.
+ */
+int
+mpfr_apa_fused (mpfr_ptr rop, uint64_t N, const double *prog, size_t len,
+                const mpfr_apa_operand_t *ops, size_t num_ops,
+                mpfr_prec_t prec, mpfr_rnd_t rnd,
+                double *ret_ptr, size_t ret_stride)
+{
+  if (len == 0)
+    return (0);
+
+  mpfr_expr_node_t *nodes = (mpfr_expr_node_t *) mxMalloc (
+    len * sizeof(mpfr_expr_node_t));
+  if (! mpfr_expr_compile (prog, len, ops, num_ops, nodes))
+    {
+      mxFree (nodes);
+      return (0);
+    }
+  size_t root = len - 1;
+
+  // `c - a * b` is computed as `-(a * b - c)` with the opposite rounding.
+  mpfr_rnd_t rnd_neg = rnd;
+  if (rnd == MPFR_RNDU)
+    rnd_neg = MPFR_RNDD;
+  else if (rnd == MPFR_RNDD)
+    rnd_neg = MPFR_RNDU;
+
+  // Scratch variables and operand pointers of each thread and node.  Double
+  // operands are converted exactly.
+  int       num_threads = omp_get_max_threads ();
+  mpfr_ptr  scratch     = (mpfr_ptr) mxMalloc (
+    num_threads * len * sizeof(mpfr_t));
+  mpfr_ptr *vals        = (mpfr_ptr *) mxMalloc (
+    num_threads * len * sizeof(mpfr_ptr));
+  for (size_t i = 0; i < num_threads * len; i++)
+    mpfr_init2 (scratch + i, (nodes[i % len].op == MPFR_EXPR_DOUBLE)
+                ? DBL_MANT_DIG : prec);
+
+  int ret_any = 0;
+
+  #pragma omp parallel
+  {
+    mpfr_ptr  reg = scratch + omp_get_thread_num () * len;
+    mpfr_ptr *val = vals + omp_get_thread_num () * len;
+    int       ret_thread = 0;
+
+    #pragma omp for
+    for (uint64_t i = 0; i < N; i++)
+      {
+        int ret = 0;
+        for (size_t n = 0; n <= root; n++)
+          {
+            const mpfr_expr_node_t *p = nodes + n;
+            if (p->dead)
+              continue;
+
+            const mpfr_apa_operand_t *o = NULL;
+            mpfr_ptr                  r = (n == root) ? (rop + i) : (reg + n);
+            val[n] = r;
+            switch (p->op)
+              {
+                case MPFR_EXPR_MPFR:
+                  o      = ops + p->arg[0];
+                  val[n] = o->mpfr + i * o->stride;
+                  if (n == root)
+                    ret |= mpfr_set (r, val[n], rnd);
+                  break;
+
+                case MPFR_EXPR_DOUBLE:
+                  o      = ops + p->arg[0];
+                  val[n] = reg + n;
+                  mpfr_set_d (val[n], o->d[i * o->stride], rnd);
+                  if (n == root)
+                    ret |= mpfr_set (r, val[n], rnd);
+                  break;
+
+                case MPFR_EXPR_ADD:
+                  ret |= mpfr_add (r, val[p->arg[0]], val[p->arg[1]], rnd);
+                  break;
+
+                case MPFR_EXPR_SUB:
+                  ret |= mpfr_sub (r, val[p->arg[0]], val[p->arg[1]], rnd);
+                  break;
+
+                case MPFR_EXPR_MUL:
+                  ret |= mpfr_mul (r, val[p->arg[0]], val[p->arg[1]], rnd);
+                  break;
+
+                case MPFR_EXPR_DIV:
+                  ret |= mpfr_div (r, val[p->arg[0]], val[p->arg[1]], rnd);
+                  break;
+
+                case MPFR_EXPR_NEG:
+                  ret |= mpfr_neg (r, val[p->arg[0]], rnd);
+                  break;
+
+                case MPFR_EXPR_POW_SI:
+                  ret |= mpfr_pow_si (r, val[p->arg[0]], p->si, rnd);
+                  break;
+
+                case MPFR_EXPR_SQR:
+                  ret |= mpfr_sqr (r, val[p->arg[0]], rnd);
+                  break;
+
+                case MPFR_EXPR_FMA:
+                  ret |= mpfr_fma (r, val[p->arg[0]], val[p->arg[1]],
+                                   val[p->arg[2]], rnd);
+                  break;
+
+                case MPFR_EXPR_FMS:
+                  ret |= mpfr_fms (r, val[p->arg[0]], val[p->arg[1]],
+                                   val[p->arg[2]], rnd);
+                  break;
+
+                case MPFR_EXPR_FNMA:
+                  ret |= -mpfr_fms (r, val[p->arg[0]], val[p->arg[1]],
+                                    val[p->arg[2]], rnd_neg);
+                  mpfr_neg (r, r, rnd);
+                  break;
+
+                case MPFR_EXPR_FMMA:
+                  ret |= mpfr_fmma (r, val[p->arg[0]], val[p->arg[1]],
+                                    val[p->arg[2]], val[p->arg[3]], rnd);
+                  break;
+
+                case MPFR_EXPR_FMMS:
+                  ret |= mpfr_fmms (r, val[p->arg[0]], val[p->arg[1]],
+                                    val[p->arg[2]], val[p->arg[3]], rnd);
+                  break;
+              }
+          }
+        if (ret_stride)
+          ret_ptr[i] = (double) ret;
+        else
+          ret_thread |= ret;
+      }
+
+    // Combine scalar return values, one thread at a time.
+    #pragma omp critical
+    {
+      ret_any |= ret_thread;
+    }
+    mpfr_free_cache ();
+  }
+  if (! ret_stride)
+    ret_ptr[0] = (double) ret_any;
+
+  for (size_t i = 0; i < num_threads * len; i++)
+    mpfr_clear (scratch + i);
+  mxFree (scratch);
+  mxFree (vals);
+  mxFree (nodes);
+  return (1);
+}
@@ -17,6 +17,345 @@
 
 #include "mex_mpfr_interface.h"
 
+// Tile sizes of the packed strategy 8.  Each thread packs a
+// [MPFR_MMM_TILE x MPFR_MMM_KBLOCK] panel of A and a
+// [MPFR_MMM_KBLOCK x MPFR_MMM_TILE] panel of B at a time.
+#define MPFR_MMM_TILE   32
+#define MPFR_MMM_KBLOCK 64
+
+// Tile size of the Winograd strategy 10.  Each thread packs
+// MPFR_MMM_WINOGRAD_TILE whole rows of A and columns of B at a time.
+#define MPFR_MMM_WINOGRAD_TILE 16
+
+// Guard bits of the Winograd strategy 10 for the larger error bound of
+// `mpfr_apa_dot_winograd` with balanced operands.
+#define MPFR_WINOGRAD_GUARD_BITS 8
+
+// Strategy 0 selects the Winograd strategy 10 from this precision on, `0`
+// never (see benchmark_winograd.m).
+mpfr_prec_t mpfr_winograd_min_prec = 1024;
+
+
+/**
+ * Maximum precision of the elements of A and B.
+ *
+ * @param A [M x K] @c mpfr_ptr.
+ * @param B [K x N] @c mpfr_ptr.
+ * @param M Matrix dimension.
+ * @param N Matrix dimension.
+ * @param K Matrix dimension.
+ */
+static mpfr_prec_t
+mpfr_apa_mmm_max_prec (mpfr_ptr A, mpfr_ptr B, uint64_t M, uint64_t N,
+                       uint64_t K)
+{
+  mpfr_prec_t prec = MPFR_PREC_MIN;
+  for (uint64_t i = 0; i < M * K; i++)
+    if (mpfr_get_prec (A + i) > prec)
+      prec = mpfr_get_prec (A + i);
+  for (uint64_t i = 0; i < K * N; i++)
+    if (mpfr_get_prec (B + i) > prec)
+      prec = mpfr_get_prec (B + i);
+  return (prec);
+}
+
+
+/**
+ * Largest exponent of the regular elements of x.
+ *
+ * @param[in] x first element.
+ * @param[in] len number of elements.
+ * @param[in] stride distance of the elements.
+ * @param[out] emax largest exponent, unchanged if there are no regular
+ *                  elements.
+ *
+ * @returns non-zero, if there are regular elements.
+ */
+static int
+mpfr_apa_mmm_max_exp (mpfr_ptr x, uint64_t len, uint64_t stride,
+                      mpfr_exp_t *emax)
+{
+  int found = 0;
+  for (uint64_t i = 0; i < len; i++)
+    {
+      mpfr_ptr p = x + i * stride;
+      if (mpfr_regular_p (p) && (! found || (mpfr_get_exp (p) > *emax)))
+        {
+          *emax = mpfr_get_exp (p);
+          found = 1;
+        }
+    }
+  return (found);
+}
+
+
+int
+mpfr_apa_mmm_number_p (mpfr_ptr A, mpfr_ptr B, uint64_t M, uint64_t N,
+                       uint64_t K)
+{
+  int ok = 1;
+  #pragma omp parallel for reduction(&:ok)
+  for (uint64_t i = 0; i < M * K + K * N; i++)
+    ok &= (mpfr_number_p ((i < M * K) ? A + i : B + (i - M * K)) != 0);
+  return (ok);
+}
+
+
+/**
+ * Cache-blocked MPFR Matrix-Matrix-Multiplication `C = C + A * B`.
+ *
+ * C is split into [MPFR_MMM_TILE x MPFR_MMM_TILE] tiles, which are
+ * distributed over the threads of a single parallel region.  For each block
+ * of MPFR_MMM_KBLOCK columns of A (rows of B) a thread copies the rows of A
+ * and the columns of B touching its tile into contiguous panels (including
+ * the significands), such that the inner loop streams through memory.
+ *
+ * The panels have the maximum precision of A and B, thus packing is exact and
+ * the operations on each element of C are the same as in strategy 1.
+ *
+ * @param C [M x N] @c mpfr_ptr indexed by (i,j).
+ * @param A [M x K] @c mpfr_ptr indexed by (i,k).
+ * @param B [K x N] @c mpfr_ptr indexed by (k,j).
+ * @param rnd MPFR rounding mode for all operations.
+ * @param M Matrix dimension (see above).
+ * @param N Matrix dimension (see above).
+ * @param K Matrix dimension (see above).
+ * @param ret_ptr pointer to array of MPFR return values.
+ * @param ret_stride see `mpfr_apa_mmm`.
+ * @param fma_fcn fused multiply-add kernel.
+ */
+static void
+mpfr_apa_mmm_packed (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B, mpfr_rnd_t rnd,
+                     uint64_t M, uint64_t N, uint64_t K,
+                     double *ret_ptr, size_t ret_stride,
+                     mpfr_fixed_op3_t fma_fcn)
+{
+  mpfr_prec_t pprec = mpfr_apa_mmm_max_prec (A, B, M, N, K);
+
+  // Panels and tile return values of each thread.  The significands of the
+  // panel variables are stored contiguously as well.
+  int      num_threads = omp_get_max_threads ();
+  size_t   panel_len   = 2 * MPFR_MMM_TILE * MPFR_MMM_KBLOCK;
+  size_t   limb_size   = mpfr_custom_get_size (pprec);
+  mpfr_ptr panels      = (mpfr_ptr) mxMalloc (
+    num_threads * panel_len * sizeof(mpfr_t));
+  char *limbs = (char *) mxMalloc (num_threads * panel_len * limb_size);
+  int * rets  = (int *) mxMalloc (
+    num_threads * MPFR_MMM_TILE * MPFR_MMM_TILE * sizeof(int));
+
+  uint64_t mt      = (M + MPFR_MMM_TILE - 1) / MPFR_MMM_TILE;
+  uint64_t nt      = (N + MPFR_MMM_TILE - 1) / MPFR_MMM_TILE;
+  int      ret_any = 0;
+
+  #pragma omp parallel
+  {
+    int      tid = omp_get_thread_num ();
+    mpfr_ptr Ap  = panels + tid * panel_len;
+    mpfr_ptr Bp  = Ap + MPFR_MMM_TILE * MPFR_MMM_KBLOCK;
+    int *    ret = rets + tid * MPFR_MMM_TILE * MPFR_MMM_TILE;
+    for (size_t p = 0; p < panel_len; p++)
+      {
+        void *d = limbs + (tid * panel_len + p) * limb_size;
+        mpfr_custom_init (d, pprec);
+        mpfr_custom_init_set (Ap + p, MPFR_ZERO_KIND, 0, pprec, d);
+      }
+
+    // Consecutive tiles share the same columns of B.
+    #pragma omp for schedule(dynamic) reduction(|:ret_any)
+    for (uint64_t t = 0; t < mt * nt; t++)
+      {
+        uint64_t i0 = (t % mt) * MPFR_MMM_TILE;
+        uint64_t j0 = (t / mt) * MPFR_MMM_TILE;
+        uint64_t mb = ((M - i0) < MPFR_MMM_TILE) ? (M - i0) : MPFR_MMM_TILE;
+        uint64_t nb = ((N - j0) < MPFR_MMM_TILE) ? (N - j0) : MPFR_MMM_TILE;
+        for (uint64_t p = 0; p < MPFR_MMM_TILE * MPFR_MMM_TILE; p++)
+          ret[p] = 0;
+
+        for (uint64_t k0 = 0; k0 < K; k0 += MPFR_MMM_KBLOCK)
+          {
+            uint64_t kb = ((K - k0) < MPFR_MMM_KBLOCK) ? (K - k0)
+                          : MPFR_MMM_KBLOCK;
+
+            // Pack rows of A and columns of B, both contiguous in k.
+            for (uint64_t k = 0; k < kb; k++)
+              for (uint64_t i = 0; i < mb; i++)
+                mpfr_set (Ap + i * MPFR_MMM_KBLOCK + k,
+                          A + (i0 + i) + M * (k0 + k), rnd);
+            for (uint64_t j = 0; j < nb; j++)
+              for (uint64_t k = 0; k < kb; k++)
+                mpfr_set (Bp + j * MPFR_MMM_KBLOCK + k,
+                          B + (k0 + k) + K * (j0 + j), rnd);
+
+            for (uint64_t j = 0; j < nb; j++)
+              for (uint64_t i = 0; i < mb; i++)
+                {
+                  mpfr_ptr c = C + M * (j0 + j) + (i0 + i);
+                  mpfr_ptr a = Ap + i * MPFR_MMM_KBLOCK;
+                  mpfr_ptr b = Bp + j * MPFR_MMM_KBLOCK;
+                  int      r = 0;
+                  for (uint64_t k = 0; k < kb; k++)
+                    r |= fma_fcn (c, b + k, a + k, c, rnd);
+                  ret[j * MPFR_MMM_TILE + i] |= r;
+                }
+          }
+
+        // A scalar return value is combined after the parallel region.
+        for (uint64_t j = 0; j < nb; j++)
+          for (uint64_t i = 0; i < mb; i++)
+            if (ret_stride)
+              ret_ptr[M * (j0 + j) + (i0 + i)] =
+                (double) ret[j * MPFR_MMM_TILE + i];
+            else
+              ret_any |= ret[j * MPFR_MMM_TILE + i];
+      }
+    mpfr_free_cache ();
+  }
+
+  if (! ret_stride)
+    ret_ptr[0] = (double) ret_any;
+
+  // Panel variables use custom significands and need no `mpfr_clear`.
+  mxFree (rets);
+  mxFree (limbs);
+  mxFree (panels);
+}
+
+
+/**
+ * MPFR Matrix-Matrix-Multiplication `C = C + A * B` by Winograd's inner
+ * product algorithm, see `mpfr_apa_dot_winograd`.
+ *
+ * The pair products of all rows of A and columns of B are computed first.
+ * Then the [MPFR_MMM_WINOGRAD_TILE x MPFR_MMM_WINOGRAD_TILE] tiles of C are
+ * distributed over the threads, which pack the rows of A and columns of B
+ * of a tile into contiguous panels.  Each row of A and each column of B is
+ * scaled by a power of two to a largest magnitude in [1/2, 1), which is
+ * exact, and the inner products are scaled back.  They are computed with
+ * MPFR_WINOGRAD_GUARD_BITS guard bits, rounded to nearest, and finally
+ * rounded by `rnd` to C.  Like Strassen-Winograd, the error is only bounded
+ * normwise.  A and B must not contain NaN or Inf, which would give
+ * Inf - Inf in the pair products.
+ *
+ * Parameters see `mpfr_apa_mmm`.  The MPFR return values are non-zero if any
+ * intermediate result was inexact.
+ */
+static void
+mpfr_apa_mmm_winograd (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B,
+                       mpfr_prec_t prec, mpfr_rnd_t rnd,
+                       uint64_t M, uint64_t N, uint64_t K,
+                       double *ret_ptr, size_t ret_stride)
+{
+  mpfr_prec_t pprec = mpfr_apa_mmm_max_prec (A, B, M, N, K);
+  mpfr_prec_t wprec = ((prec > pprec) ? prec : pprec)
+                      + MPFR_WINOGRAD_GUARD_BITS;
+
+  // Scaled pair products, scaling exponents of the rows of A and columns of
+  // B, and per thread panels, the last variable is the result.
+  int         num_threads = omp_get_max_threads ();
+  size_t      panel_len   = 2 * MPFR_MMM_WINOGRAD_TILE * K + 1;
+  size_t      limb_size   = mpfr_custom_get_size (wprec);
+  mpfr_ptr    xi          = (mpfr_ptr) mxMalloc ((M + N) * sizeof(mpfr_t));
+  mpfr_ptr    eta         = xi + M;
+  mpfr_exp_t *ea          = (mpfr_exp_t *) mxMalloc (
+    (M + N) * sizeof(mpfr_exp_t));
+  mpfr_exp_t *eb = ea + M;
+  mpfr_ptr panels      = (mpfr_ptr) mxMalloc (
+    num_threads * panel_len * sizeof(mpfr_t));
+  char *limbs = (char *) mxMalloc (num_threads * panel_len * limb_size);
+
+  mpfr_fixed_op3_t fma_fcn = mex_mpfr_fixed_op3 (1056, wprec, mpfr_fma);
+
+  uint64_t mt = (M + MPFR_MMM_WINOGRAD_TILE - 1) / MPFR_MMM_WINOGRAD_TILE;
+  uint64_t nt = (N + MPFR_MMM_WINOGRAD_TILE - 1) / MPFR_MMM_WINOGRAD_TILE;
+
+  int pair_ret = 0;
+  int ret_any  = 0;
+
+  #pragma omp parallel
+  {
+    int      tid = omp_get_thread_num ();
+    mpfr_ptr Ap  = panels + tid * panel_len;
+    mpfr_ptr Bp  = Ap + MPFR_MMM_WINOGRAD_TILE * K;
+    mpfr_ptr c   = Ap + panel_len - 1;
+    for (size_t p = 0; p < panel_len; p++)
+      {
+        void *s = limbs + (tid * panel_len + p) * limb_size;
+        mpfr_custom_init (s, wprec);
+        mpfr_custom_init_set (Ap + p, MPFR_ZERO_KIND, 0, wprec, s);
+      }
+
+    #pragma omp for reduction(|:pair_ret)
+    for (uint64_t i = 0; i < M + N; i++)
+      {
+        mpfr_init2 (xi + i, wprec);
+        mpfr_set_zero (xi + i, 1);
+        ea[i] = 0;
+        if (i < M)
+          {
+            mpfr_apa_mmm_max_exp (A + i, K, M, ea + i);
+            for (uint64_t k = 0; k + 1 < K; k += 2)
+              pair_ret |= fma_fcn (xi + i, A + i + M * k, A + i + M * (k + 1),
+                                   xi + i, MPFR_RNDN);
+          }
+        else
+          {
+            mpfr_apa_mmm_max_exp (B + K * (i - M), K, 1, ea + i);
+            for (uint64_t k = 0; k + 1 < K; k += 2)
+              pair_ret |= fma_fcn (xi + i, B + k + K * (i - M),
+                                   B + k + 1 + K * (i - M), xi + i, MPFR_RNDN);
+          }
+        mpfr_mul_2si (xi + i, xi + i, -2 * ea[i], MPFR_RNDN);  // Exact.
+      }
+
+    #pragma omp for schedule(dynamic) reduction(|:ret_any)
+    for (uint64_t t = 0; t < mt * nt; t++)
+      {
+        uint64_t i0 = (t % mt) * MPFR_MMM_WINOGRAD_TILE;
+        uint64_t j0 = (t / mt) * MPFR_MMM_WINOGRAD_TILE;
+        uint64_t mb = ((M - i0) < MPFR_MMM_WINOGRAD_TILE) ? (M - i0)
+                      : MPFR_MMM_WINOGRAD_TILE;
+        uint64_t nb = ((N - j0) < MPFR_MMM_WINOGRAD_TILE) ? (N - j0)
+                      : MPFR_MMM_WINOGRAD_TILE;
+
+        // Pack scaled rows of A and columns of B, both contiguous in k.
+        for (uint64_t k = 0; k < K; k++)
+          for (uint64_t i = 0; i < mb; i++)
+            mpfr_mul_2si (Ap + i * K + k, A + (i0 + i) + M * k, -ea[i0 + i],
+                          MPFR_RNDN);
+        for (uint64_t j = 0; j < nb; j++)
+          for (uint64_t k = 0; k < K; k++)
+            mpfr_mul_2si (Bp + j * K + k, B + k + K * (j0 + j), -eb[j0 + j],
+                          MPFR_RNDN);
+
+        for (uint64_t j = 0; j < nb; j++)
+          for (uint64_t i = 0; i < mb; i++)
+            {
+              mpfr_set_zero (c, 1);
+              int ret = pair_ret | mpfr_apa_dot_winograd (
+                c, Ap + i * K, Bp + j * K, K, xi + i0 + i, eta + j0 + j,
+                wprec, MPFR_RNDN);
+              mpfr_ptr r = C + M * (j0 + j) + (i0 + i);
+              mpfr_mul_2si (c, c, ea[i0 + i] + eb[j0 + j], MPFR_RNDN);
+              int      rr = mpfr_add (r, r, c, rnd);
+              if (ret_stride)
+                ret_ptr[M * (j0 + j) + (i0 + i)] = (double) (rr ? rr : ret);
+              else
+                ret_any |= (rr ? rr : ret);
+            }
+      }
+    mpfr_free_cache ();
+  }
+  if (! ret_stride)
+    ret_ptr[0] = (double) ret_any;
+
+  for (uint64_t i = 0; i < M + N; i++)
+    mpfr_clear (xi + i);
+  mxFree (ea);
+  mxFree (limbs);
+  mxFree (panels);
+  mxFree (xi);
+}
+
 /**
  * MPFR Matrix-Matrix-Multiplication `C = A * B`.
  *
@@ -32,7 +371,8 @@
  * @param ret_stride equals 1, if the array of MPFR return values should be
  *                   filled and has the same size as C.  Otherwise 0 for
  *                   scalar (ignored) return value.
- * @param strategy for matrix multiplication.
+ * @param strategy for matrix multiplication, 0 selects 8 or 10 by
+ *                 `mpfr_winograd_min_prec`.
  */
 void
 mpfr_apa_mmm (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B,
@@ -40,6 +380,14 @@ mpfr_apa_mmm (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B,
               uint64_t M, uint64_t N, uint64_t K,
               double *ret_ptr, size_t ret_stride, uint64_t strategy)
 {
+  // Fixed-limb kernel if all matrices have the precision `prec`.
+  mpfr_fixed_op3_t fma_fcn = mex_mpfr_fixed_op3 (1056, prec, mpfr_fma);
+
+  // Automatic strategy.
+  if (strategy == 0)
+    strategy = ((mpfr_winograd_min_prec > 0)
+                && (prec >= mpfr_winograd_min_prec) && (K > 1)) ? 10 : 8;
+
   switch (strategy)
     {
       case 1:  // plain for-loop ijk
@@ -48,10 +396,10 @@ mpfr_apa_mmm (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B,
             {
               int ret = 0;
               for (uint64_t k = 0; k < K; k++)
-                ret |= mpfr_fma (C + (M * j) + i,
-                                 B + k + (K * j),
-                                 A + i + (M * k),
-                                 C + (M * j) + i, rnd);
+                ret |= fma_fcn (C + (M * j) + i,
+                                B + k + (K * j),
+                                A + i + (M * k),
+                                C + (M * j) + i, rnd);
               ret_ptr[((M * j) + i) * ret_stride] = (double) ret;
             }
         break;
@@ -63,10 +411,10 @@ mpfr_apa_mmm (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B,
             {
               int ret = 0;
               for (uint64_t k = 0; k < K; k++)
-                ret |= mpfr_fma (C + (M * j) + i,
-                                 B + k + (K * j),
-                                 A + i + (M * k),
-                                 C + (M * j) + i, rnd);
+                ret |= fma_fcn (C + (M * j) + i,
+                                B + k + (K * j),
+                                A + i + (M * k),
+                                C + (M * j) + i, rnd);
               ret_ptr[((M * j) + i) * ret_stride] = (double) ret;
             }
         break;
@@ -79,10 +427,10 @@ mpfr_apa_mmm (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B,
             {
               int ret = 0;
               for (uint64_t k = 0; k < K; k++)
-                ret |= mpfr_fma (C + (M * j) + i,
-                                 B + k + (K * j),
-                                 A + i + (M * k),
-                                 C + (M * j) + i, rnd);
+                ret |= fma_fcn (C + (M * j) + i,
+                                B + k + (K * j),
+                                A + i + (M * k),
+                                C + (M * j) + i, rnd);
               ret_ptr[((M * j) + i) * ret_stride] = (double) ret;
             }
         break;
@@ -95,10 +443,10 @@ mpfr_apa_mmm (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B,
             {
               int ret = 0;
               for (uint64_t k = 0; k < K; k++)
-                ret |= mpfr_fma (C + (M * j) + i,
-                                 B + k + (K * j),
-                                 A + i + (M * k),
-                                 C + (M * j) + i, rnd);
+                ret |= fma_fcn (C + (M * j) + i,
+                                B + k + (K * j),
+                                A + i + (M * k),
+                                C + (M * j) + i, rnd);
               ret_ptr[((M * j) + i) * ret_stride] = (double) ret;
             }
         break;
@@ -113,10 +461,10 @@ mpfr_apa_mmm (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B,
               {
                 int ret = 0;
                 for (uint64_t k = 0; k < K; k++)
-                  ret |= mpfr_fma (C + (M * j) + i,
-                                   B + k + (K * j),
-                                   A + i + (M * k),
-                                   C + (M * j) + i, rnd);
+                  ret |= fma_fcn (C + (M * j) + i,
+                                  B + k + (K * j),
+                                  A + i + (M * k),
+                                  C + (M * j) + i, rnd);
                 ret_ptr[((M * j) + i) * ret_stride] = (double) ret;
               }
           }
@@ -131,10 +479,10 @@ mpfr_apa_mmm (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B,
               {
                 int ret = 0;
                 for (uint64_t k = 0; k < K; k++)
-                  ret |= mpfr_fma (C + (M * j) + i,
-                                   B + k + (K * j),
-                                   A + i + (M * k),
-                                   C + (M * j) + i, rnd);
+                  ret |= fma_fcn (C + (M * j) + i,
+                                  B + k + (K * j),
+                                  A + i + (M * k),
+                                  C + (M * j) + i, rnd);
                 ret_ptr[((M * j) + i) * ret_stride] = (double) ret;
               }
           }
@@ -182,6 +530,42 @@ mpfr_apa_mmm (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B,
       break;
 
 
+      case 8:  // 1 omp region over tiles of C, packed panels of A and B
+        mpfr_apa_mmm_packed (C, A, B, rnd, M, N, K, ret_ptr, ret_stride,
+                             fma_fcn);
+        break;
+
+
+      case 9:  // Strassen-Winograd recursion, OpenMP tasks
+        mpfr_apa_strassen (C, A, B, prec, rnd, M, N, K, ret_ptr, ret_stride);
+        break;
+
+
+      case 10:  // Winograd's inner product, else strategy 8 for NaN or Inf
+        if (mpfr_apa_mmm_number_p (A, B, M, N, K))
+          mpfr_apa_mmm_winograd (C, A, B, prec, rnd, M, N, K, ret_ptr,
+                                 ret_stride);
+        else
+          mpfr_apa_mmm_packed (C, A, B, rnd, M, N, K, ret_ptr, ret_stride,
+                               fma_fcn);
+        break;
+
+
+      case 11:  // exact GMP integer accumulation, else strategy 8
+        if (! mpfr_apa_mmm_exact (C, A, B, rnd, M, N, K, ret_ptr, ret_stride))
+          mpfr_apa_mmm_packed (C, A, B, rnd, M, N, K, ret_ptr, ret_stride,
+                               fma_fcn);
+        break;
+
+
+      case 12:  // Ozaki scheme by double BLAS, else strategy 8
+        if (! mpfr_apa_mmm_ozaki (C, A, B, prec, rnd, M, N, K, ret_ptr,
+                                  ret_stride))
+          mpfr_apa_mmm_packed (C, A, B, rnd, M, N, K, ret_ptr, ret_stride,
+                               fma_fcn);
+        break;
+
+
       default:
         MEX_FCN_ERR ("mpfr_mmm: invalid strategy '%d'\n", (int) strategy);
     }
@@ -0,0 +1,307 @@
+/*
+ * This file is part of APA.
+ *
+ *  APA is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  APA is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mex_mpfr_interface.h"
+
+// Integer type of the BLAS, e.g. `int32_t` or `ptrdiff_t` for 64-bit BLAS
+// (Matlab), defined by install_apa.m.  If the type is unknown, the Ozaki
+// scheme is not used.
+#ifndef APA_BLAS_INT
+#define APA_BLAS_INT int
+#define APA_BLAS_INT_UNKNOWN
+#endif
+
+// Fortran name of DGEMM.
+#ifdef APA_BLAS_NO_UNDERSCORE
+#define APA_DGEMM dgemm
+#else
+#define APA_DGEMM dgemm_
+#endif
+
+void
+APA_DGEMM (const char *transa, const char *transb, const APA_BLAS_INT *m,
+           const APA_BLAS_INT *n, const APA_BLAS_INT *k, const double *alpha,
+           const double *a, const APA_BLAS_INT *lda, const double *b,
+           const APA_BLAS_INT *ldb, const double *beta, double *c,
+           const APA_BLAS_INT *ldc);
+
+// Columns of C computed per DGEMM call.
+#define MPFR_OZAKI_PANEL 256
+
+// Maximum number of slices, otherwise the number of DGEMM calls is too large.
+#define MPFR_OZAKI_MAX_SLICES 32
+
+// Bits beyond the precision, which cover the dropped slice products.
+#define MPFR_OZAKI_GUARD_BITS 8
+
+// Maximum bytes of the slices of A and B and the DGEMM results.
+#define MPFR_OZAKI_MAX_BYTES (((uint64_t) 1) << 30)
+
+
+/**
+ * Slice count policy.
+ *
+ * The inner products of `d` slices of length `K` with `beta` bits each are
+ * exact in double precision, if `2 * beta + ceil (log2 (d * K)) <= 53`.
+ * The number of slices `S` is the smallest one, that together with the
+ * largest such `beta` covers `prec + MPFR_OZAKI_GUARD_BITS` bits.
+ *
+ * @param[in] prec MPFR precision of C.
+ * @param[in] K Matrix dimension.
+ * @param[out] beta bits per slice.
+ *
+ * @returns number of slices, zero if more than `MPFR_OZAKI_MAX_SLICES`.
+ */
+static int
+mpfr_apa_ozaki_slices (mpfr_prec_t prec, uint64_t K, int *beta)
+{
+  for (int S = 1; S <= MPFR_OZAKI_MAX_SLICES; S++)
+    {
+      int log2_SK = 0;
+      while ((log2_SK < 64) && ((((uint64_t) 1) << log2_SK) < S * K))
+        log2_SK++;
+      *beta = (53 - log2_SK) / 2;
+      if (*beta < 1)
+        return (0);
+      if (S * (*beta) >= prec + MPFR_OZAKI_GUARD_BITS)
+        return (S);
+    }
+  return (0);
+}
+
+
+/**
+ * Maximum exponent of a row of A or a column of B.
+ *
+ * @param[in] x first element.
+ * @param[in] len number of elements.
+ * @param[in] stride distance of the elements.
+ * @param[out] e maximum exponent, `0` if all elements are zero.
+ *
+ * @returns zero, if there are NaN or Inf elements.
+ */
+static int
+mpfr_apa_ozaki_exp (mpfr_ptr x, uint64_t len, uint64_t stride,
+                    mpfr_exp_t *e)
+{
+  *e = 0;
+  int found = 0;
+  for (uint64_t l = 0; l < len; l++)
+    {
+      mpfr_ptr p = x + l * stride;
+      if (mpfr_zero_p (p))
+        continue;
+      if (! mpfr_regular_p (p))
+        return (0);
+      if (! found || (mpfr_get_exp (p) > *e))
+        *e = mpfr_get_exp (p);
+      found = 1;
+    }
+  return (1);
+}
+
+
+/**
+ * Split `x` with `|x| < 2^e` into `S` slices of `beta` bits, such that
+ * `x` truncated to `S * beta` bits equals
+ * `sum (s[q * stride] * 2^(e - (q + 1) * beta))` over `q = 0, ..., S - 1`.
+ *
+ * @param[out] s first slice, integers of magnitude less than `2^beta`.
+ * @param[in] stride distance of the slices.
+ * @param[in] x MPFR variable.
+ * @param[in] e exponent bound of @c x.
+ * @param[in] S number of slices.
+ * @param[in] beta bits per slice.
+ * @param[in] z temporary GMP integer.
+ * @param[in] r temporary GMP integer.
+ *
+ * @returns index of the last non-zero slice, `-1` if @c x is zero, and `S`
+ *          if bits of @c x were truncated.
+ */
+static int
+mpfr_apa_ozaki_split (double *s, int64_t stride, mpfr_ptr x, mpfr_exp_t e,
+                      int S, int beta, mpz_ptr z, mpz_ptr r)
+{
+  if (mpfr_zero_p (x))
+    {
+      for (int q = 0; q < S; q++)
+        s[q * stride] = 0.0;
+      return (-1);
+    }
+  int        last  = -1;
+  mpfr_exp_t shift = mpfr_get_z_2exp (z, x) + S * beta - e;
+  if (shift >= 0)
+    mpz_mul_2exp (z, z, shift);
+  else
+    {
+      if (mpz_scan1 (z, 0) < (mp_bitcnt_t) -shift)
+        last = S;
+      mpz_tdiv_q_2exp (z, z, -shift);
+    }
+  for (int q = S - 1; q >= 0; q--)
+    {
+      mpz_tdiv_r_2exp (r, z, beta);
+      s[q * stride] = mpz_get_d (r);
+      if ((last < 0) && (mpz_sgn (r) != 0))
+        last = q;
+      mpz_tdiv_q_2exp (z, z, beta);
+    }
+  return (last);
+}
+
+
+int
+mpfr_apa_mmm_ozaki (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B, mpfr_prec_t prec,
+                    mpfr_rnd_t rnd, uint64_t M, uint64_t N, uint64_t K,
+                    double *ret_ptr, size_t ret_stride)
+{
+  #ifdef APA_BLAS_INT_UNKNOWN
+  DBG_PRINTF ("%s\n", "mpfr_apa_mmm_ozaki: BLAS integer type unknown");
+  return (0);
+  #endif
+
+  int      beta  = 0;
+  int      S     = mpfr_apa_ozaki_slices (prec, K, &beta);
+  uint64_t nb    = (N < MPFR_OZAKI_PANEL) ? N : MPFR_OZAKI_PANEL;
+  uint64_t bytes = (M * K + K * N + M * nb) * S * sizeof(double);
+  if ((S == 0) || (K == 0) || (M > INT32_MAX) || (S * K > INT32_MAX)
+      || (bytes > MPFR_OZAKI_MAX_BYTES))
+    {
+      DBG_PRINTF ("%s\n", "mpfr_apa_mmm_ozaki: not applicable");
+      return (0);
+    }
+
+  // Exponents and last non-zero slices of the rows of A and columns of B.
+  mpfr_exp_t *ea = (mpfr_exp_t *) mxMalloc ((M + N) * sizeof(mpfr_exp_t));
+  mpfr_exp_t *eb = ea + M;
+  int *       la = (int *) mxMalloc ((M + N) * sizeof(int));
+  int *       lb = la + M;
+  int         ok = 1;
+  #pragma omp parallel for reduction(&:ok)
+  for (uint64_t i = 0; i < M + N; i++)
+    ok &= (i < M) ? mpfr_apa_ozaki_exp (A + i, K, M, ea + i)
+          : mpfr_apa_ozaki_exp (B + K * (i - M), K, 1, ea + i);
+  if (! ok)
+    {
+      DBG_PRINTF ("%s\n", "mpfr_apa_mmm_ozaki: not applicable");
+      mxFree (la);
+      mxFree (ea);
+      return (0);
+    }
+  DBG_PRINTF ("mpfr_apa_mmm_ozaki: %d slices of %d bits\n", S, beta);
+
+  // Slices of A [M x (S * K)] in order 0, ..., S - 1 and of
+  // B [(S * K) x N] in order S - 1, ..., 0.  Then the sum of all slice
+  // products of order `d` is a single DGEMM of A(:,1:(d+1)*K) and
+  // B((S-1-d)*K+1:end,:).
+  double * As = (double *) mxMalloc ((M * K + K * N) * S * sizeof(double));
+  double * Bs = As + M * K * S;
+  double * G  = (double *) mxMalloc (M * nb * S * sizeof(double));
+
+  #pragma omp parallel
+  {
+    mpz_t z, r;
+    mpz_init (z);
+    mpz_init (r);
+
+    #pragma omp for schedule(static)
+    for (uint64_t i = 0; i < M + N; i++)
+      {
+        la[i] = -1;
+        for (uint64_t k = 0; k < K; k++)
+          {
+            int l = (i < M)
+                    ? mpfr_apa_ozaki_split (As + i + M * k, M * K,
+                                            A + i + M * k, ea[i], S, beta,
+                                            z, r)
+                    : mpfr_apa_ozaki_split (Bs + (S - 1) * K + k
+                                            + S * K * (i - M), -(int64_t) K,
+                                            B + k + K * (i - M), ea[i], S,
+                                            beta, z, r);
+            if (l > la[i])
+              la[i] = l;
+          }
+      }
+
+    mpz_clear (z);
+    mpz_clear (r);
+  }
+
+  const double       one     = 1.0;
+  const double       zero    = 0.0;
+  const APA_BLAS_INT m       = (APA_BLAS_INT) M;
+  const APA_BLAS_INT ldb     = (APA_BLAS_INT) (S * K);
+  int                ret_any = 0;
+  for (uint64_t j0 = 0; j0 < N; j0 += nb)
+    {
+      const APA_BLAS_INT n = (APA_BLAS_INT) (((N - j0) < nb) ? (N - j0) : nb);
+
+      // The DGEMM are parallel themselves.
+      for (int d = 0; d < S; d++)
+        {
+          const APA_BLAS_INT k = (APA_BLAS_INT) ((d + 1) * K);
+          APA_DGEMM ("N", "N", &m, &n, &k, &one, As, &m,
+                     Bs + (S - 1 - d) * K + S * K * j0, &ldb, &zero,
+                     G + M * nb * d, &m);
+        }
+
+      // Exact accumulation of the slice product orders and the only
+      // rounding.  The result is inexact as well, if bits of row i of A or
+      // column j of B were truncated, or the dropped slice products of
+      // orders S and higher are possibly non-zero.  A scalar return value
+      // is combined after the loop.
+      #pragma omp parallel
+      {
+        mpz_t z, r;
+        mpz_init (z);
+        mpz_init (r);
+
+        #pragma omp for schedule(static) reduction(|:ret_any)
+        for (uint64_t ij = 0; ij < M * (uint64_t) n; ij++)
+          {
+            uint64_t i = ij % M;
+            uint64_t j = j0 + ij / M;
+            mpz_set_ui (z, 0);
+            for (int d = 0; d < S; d++)
+              {
+                mpz_mul_2exp (z, z, beta);
+                mpz_set_d (r, G[ij + M * nb * d]);
+                mpz_add (z, z, r);
+              }
+            int rr = mpfr_set_z_2exp (C + M * j + i, z,
+                                      ea[i] + eb[j] - (S + 1) * beta, rnd);
+            int ret = (la[i] + lb[j] >= S);
+            if (ret_stride)
+              ret_ptr[M * j + i] = (double) (rr ? rr : ret);
+            else
+              ret_any |= (rr ? rr : ret);
+          }
+
+        mpz_clear (z);
+        mpz_clear (r);
+      }
+    }
+
+  if (! ret_stride)
+    ret_ptr[0] = (double) ret_any;
+
+  mxFree (G);
+  mxFree (As);
+  mxFree (la);
+  mxFree (ea);
+  return (1);
+}
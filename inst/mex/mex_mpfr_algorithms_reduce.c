@@ -0,0 +1,349 @@
+/*
+ * This file is part of APA.
+ *
+ *  APA is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  APA is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mex_mpfr_interface.h"
+
+// Elements per chunk.  Must not depend on the number of threads, such that
+// the results are reproducible.
+#define MPFR_REDUCE_CHUNK 1024
+
+// Largest precision of an exact partial sum of a chunk.  Chunks with a
+// larger exponent range are summed by a single `mpfr_sum` call.
+#define MPFR_REDUCE_EXACT_PREC_MAX 65536
+
+
+/**
+ * Set `t` to a view of `|x|` sharing the significand of `x`.
+ *
+ * @param[out] t uninitialized MPFR variable, not to be cleared.
+ * @param[in] x MPFR variable.
+ */
+static inline void
+mpfr_apa_abs_view (mpfr_ptr t, mpfr_ptr x)
+{
+  int kind = mpfr_custom_get_kind (x);
+  mpfr_custom_init_set (t, (kind < 0) ? -kind : kind,
+                        mpfr_regular_p (x) ? mpfr_custom_get_exp (x) : 0,
+                        mpfr_get_prec (x), mpfr_custom_get_significand (x));
+}
+
+
+/**
+ * Fill a table of `len` MPFR pointers for `mpfr_sum`.
+ *
+ * @param[out] tab table of length @c len.
+ * @param[out] views storage of length @c len for the views of `|x|`, if
+ *                   @c kind is `MPFR_REDUCE_NORM1`.
+ * @param[in] kind `MPFR_REDUCE_SUM` or `MPFR_REDUCE_NORM1`.
+ * @param[in] x first element.
+ * @param[in] stride distance of the elements.
+ * @param[in] len number of elements.
+ */
+static void
+mpfr_apa_sum_table (mpfr_ptr *tab, mpfr_ptr views, int kind, mpfr_ptr x,
+                    uint64_t stride, uint64_t len)
+{
+  for (uint64_t i = 0; i < len; i++)
+    if (kind == MPFR_REDUCE_NORM1)
+      {
+        mpfr_apa_abs_view (views + i, x + i * stride);
+        tab[i] = views + i;
+      }
+    else
+      tab[i] = x + i * stride;
+}
+
+
+/**
+ * Precision of the exact sum of the absolute values of `len` elements.
+ *
+ * @param[in] x first element.
+ * @param[in] stride distance of the elements.
+ * @param[in] len number of elements.
+ *
+ * @returns precision, or `0` if an element is NaN or infinite or the
+ *          precision exceeds `MPFR_REDUCE_EXACT_PREC_MAX`.
+ */
+static mpfr_prec_t
+mpfr_apa_exact_sum_prec (mpfr_ptr x, uint64_t stride, uint64_t len)
+{
+  mpfr_exp_t emax = 0;  // Largest exponent.
+  mpfr_exp_t lmin = 0;  // Smallest weight of the last bit.
+  int        any  = 0;
+  for (uint64_t i = 0; i < len; i++)
+    {
+      mpfr_ptr xi = x + i * stride;
+      if (mpfr_zero_p (xi))
+        continue;
+      if (! mpfr_regular_p (xi))
+        return (0);
+      mpfr_exp_t e = mpfr_get_exp (xi);
+      mpfr_exp_t l = e - mpfr_get_prec (xi);
+      emax = (! any || (e > emax)) ? e : emax;
+      lmin = (! any || (l < lmin)) ? l : lmin;
+      any  = 1;
+    }
+  if (! any)  // All elements are zero.
+    return (MPFR_PREC_MIN);
+
+  // The carries of `len` summands need at most `log2 (len) + 1` bits.
+  mpfr_exp_t carry_bits = 1;
+  while (((uint64_t) 1 << (carry_bits - 1)) < len)
+    carry_bits++;
+  if (emax - lmin > MPFR_REDUCE_EXACT_PREC_MAX - carry_bits)
+    return (0);
+  return ((mpfr_prec_t) (emax - lmin + carry_bits));
+}
+
+
+/**
+ * Is `a` a better extreme value than `b`?  NaN is never better.
+ *
+ * @param[in] kind `MPFR_REDUCE_MAX`, `MPFR_REDUCE_MIN`, or
+ *                 `MPFR_REDUCE_NORMINF`.
+ * @param[in] a MPFR variable.
+ * @param[in] b MPFR variable.
+ *
+ * @returns non-zero if `a` is better than `b`.
+ */
+static inline int
+mpfr_apa_better (int kind, mpfr_ptr a, mpfr_ptr b)
+{
+  if (mpfr_nan_p (a))
+    return (0);
+  if (mpfr_nan_p (b))
+    return (1);
+  switch (kind)
+    {
+      case MPFR_REDUCE_MAX:
+        return (mpfr_greater_p (a, b));
+      case MPFR_REDUCE_MIN:
+        return (mpfr_less_p (a, b));
+      default:
+        return (mpfr_cmpabs (a, b) > 0);
+    }
+}
+
+
+/**
+ * Reduce a chunk of `len > 0` elements, except for sums.
+ *
+ * @param[in] kind reduction `MPFR_REDUCE_*`.
+ * @param[out] t partial product or sum of squares.
+ * @param[out] idx (0-based) index of the extreme value in the chunk.
+ * @param[in] x first element.
+ * @param[in] stride distance of the elements.
+ * @param[in] len number of elements.
+ * @param[in] rnd MPFR rounding mode for all operations.
+ *
+ * @returns MPFR ternary return value (logical OR of all return values).
+ */
+static int
+mpfr_apa_reduce_chunk (int kind, mpfr_ptr t, uint64_t *idx, mpfr_ptr x,
+                       uint64_t stride, uint64_t len, mpfr_rnd_t rnd)
+{
+  int ret = 0;
+  switch (kind)
+    {
+      case MPFR_REDUCE_PROD:
+        ret = mpfr_set (t, x, rnd);
+        for (uint64_t i = 1; i < len; i++)
+          ret |= mpfr_mul (t, t, x + i * stride, rnd);
+        break;
+
+      case MPFR_REDUCE_NORM2:
+        ret = mpfr_sqr (t, x, rnd);
+        for (uint64_t i = 1; i < len; i++)
+          ret |= mpfr_fma (t, x + i * stride, x + i * stride, t, rnd);
+        break;
+
+      default:
+        *idx = 0;
+        for (uint64_t i = 1; i < len; i++)
+          if (mpfr_apa_better (kind, x + i * stride, x + *idx * stride))
+            *idx = i;
+    }
+  return (ret);
+}
+
+
+void
+mpfr_apa_reduce (mpfr_ptr rop, mpfr_ptr op, uint64_t M, uint64_t N, int dim,
+                 int kind, mpfr_prec_t prec, mpfr_rnd_t rnd,
+                 double *ret_ptr, double *idx_ptr)
+{
+  uint64_t count   = (dim == 1) ? N : M;  // Number of results.
+  uint64_t len     = (dim == 1) ? M : N;  // Elements per result.
+  uint64_t ostride = (dim == 1) ? M : 1;
+  uint64_t lstride = (dim == 1) ? 1 : M;
+  int      is_sum  = ((kind == MPFR_REDUCE_SUM)
+                      || (kind == MPFR_REDUCE_NORM1));
+
+  uint64_t num_chunks = (len + MPFR_REDUCE_CHUNK - 1) / MPFR_REDUCE_CHUNK;
+  if (num_chunks < 1)
+    num_chunks = 1;
+
+  // Partial results of all chunks, if there are more than one.  Partial
+  // sums are exact, unless `part_prec` is 0.
+  uint64_t     num_parts = (num_chunks > 1) ? count * num_chunks : 0;
+  mpfr_ptr     part      = (mpfr_ptr) mxMalloc (
+    (num_parts + 1) * sizeof(__mpfr_struct));
+  mpfr_prec_t *part_prec = (mpfr_prec_t *) mxMalloc (
+    (num_parts + 1) * sizeof(mpfr_prec_t));
+  uint64_t *   part_idx  = (uint64_t *) mxMalloc (
+    (num_parts + 1) * sizeof(uint64_t));
+  int *        part_ret  = (int *) mxMalloc ((num_parts + 1) * sizeof(int));
+
+  // Per-thread tables for `mpfr_sum`.
+  int       num_threads = omp_get_max_threads ();
+  uint64_t  tab_len     = ((len > num_chunks) ? len : num_chunks) + 1;
+  mpfr_ptr *tabs        = (mpfr_ptr *) mxMalloc (
+    num_threads * tab_len * sizeof(mpfr_ptr));
+  mpfr_ptr views = (mpfr_ptr) mxMalloc (
+    ((kind == MPFR_REDUCE_NORM1) ? num_threads * tab_len : 1)
+    * sizeof(__mpfr_struct));
+
+  #pragma omp parallel
+  {
+    mpfr_ptr *tab  = tabs + omp_get_thread_num () * tab_len;
+    mpfr_ptr  view = views;
+    if (kind == MPFR_REDUCE_NORM1)
+      view += omp_get_thread_num () * tab_len;
+    mpfr_t t;
+    mpfr_init2 (t, prec);
+
+    // Phase 1: reduce all chunks.
+    #pragma omp for schedule(dynamic)
+    for (uint64_t k = 0; k < num_parts; k++)
+      {
+        uint64_t o    = k / num_chunks;
+        uint64_t c    = k % num_chunks;
+        uint64_t clen = ((len - c * MPFR_REDUCE_CHUNK) < MPFR_REDUCE_CHUNK)
+                        ? (len - c * MPFR_REDUCE_CHUNK) : MPFR_REDUCE_CHUNK;
+        mpfr_ptr x = op + o * ostride + c * MPFR_REDUCE_CHUNK * lstride;
+        part_ret[k]  = 0;
+        part_prec[k] = 0;
+        if (is_sum)
+          {
+            part_prec[k] = mpfr_apa_exact_sum_prec (x, lstride, clen);
+            if (part_prec[k] > 0)
+              {
+                mpfr_init2 (part + k, part_prec[k]);
+                mpfr_apa_sum_table (tab, view, kind, x, lstride, clen);
+                mpfr_sum (part + k, tab, clen, MPFR_RNDN);
+              }
+          }
+        else
+          {
+            part_prec[k] = prec;
+            mpfr_init2 (part + k, prec);
+            part_ret[k] = mpfr_apa_reduce_chunk (kind, part + k, part_idx + k,
+                                                 x, lstride, clen, rnd);
+            part_idx[k] += c * MPFR_REDUCE_CHUNK;
+          }
+      }
+
+    // Phase 2: combine the chunks in order.
+    #pragma omp for schedule(dynamic)
+    for (uint64_t o = 0; o < count; o++)
+      {
+        mpfr_ptr x    = op + o * ostride;
+        mpfr_ptr p    = part + o * num_chunks;
+        int      ret  = 0;
+        uint64_t best = 0;
+
+        if (len == 0)
+          {
+            if (kind == MPFR_REDUCE_PROD)
+              mpfr_set_ui (rop + o, 1, rnd);
+            else if (is_sum || (kind == MPFR_REDUCE_NORM2))
+              mpfr_set_zero (rop + o, 1);
+            else
+              mpfr_set_nan (rop + o);
+          }
+        else if (is_sum)
+          {
+            int exact = (num_chunks > 1);
+            for (uint64_t c = 0; exact && (c < num_chunks); c++)
+              exact = (part_prec[o * num_chunks + c] > 0);
+            if (exact)  // Correctly rounded sum of exact partial sums.
+              {
+                for (uint64_t c = 0; c < num_chunks; c++)
+                  tab[c] = p + c;
+                ret = mpfr_sum (rop + o, tab, num_chunks, rnd);
+              }
+            else
+              {
+                mpfr_apa_sum_table (tab, view, kind, x, lstride, len);
+                ret = mpfr_sum (rop + o, tab, len, rnd);
+              }
+          }
+        else
+          {
+            // Partial results of a single chunk are computed here.
+            if (num_chunks == 1)
+              {
+                p   = t;
+                ret = mpfr_apa_reduce_chunk (kind, t, &best, x, lstride, len,
+                                             rnd);
+              }
+            else
+              {
+                best = part_idx[o * num_chunks];
+                ret  = part_ret[o * num_chunks];
+              }
+            for (uint64_t c = 1; c < num_chunks; c++)
+              {
+                uint64_t k = o * num_chunks + c;
+                ret |= part_ret[k];
+                if (kind == MPFR_REDUCE_PROD)
+                  ret |= mpfr_mul (p, p, p + c, rnd);
+                else if (kind == MPFR_REDUCE_NORM2)
+                  ret |= mpfr_add (p, p, p + c, rnd);
+                else if (mpfr_apa_better (kind, x + part_idx[k] * lstride,
+                                          x + best * lstride))
+                  best = part_idx[k];
+              }
+            if (kind == MPFR_REDUCE_PROD)
+              ret |= mpfr_set (rop + o, p, rnd);
+            else if (kind == MPFR_REDUCE_NORM2)
+              ret |= mpfr_sqrt (rop + o, p, rnd);
+            else if (kind == MPFR_REDUCE_NORMINF)
+              ret |= mpfr_abs (rop + o, x + best * lstride, rnd);
+            else
+              ret |= mpfr_set (rop + o, x + best * lstride, rnd);
+          }
+
+        ret_ptr[o] = (double) ret;
+        if (idx_ptr != NULL)
+          idx_ptr[o] = (len == 0) ? 0.0 : (double) (best + 1);
+      }
+
+    mpfr_clear (t);
+    mpfr_free_cache ();
+  }
+
+  for (uint64_t k = 0; k < num_parts; k++)
+    if (part_prec[k] > 0)
+      mpfr_clear (part + k);
+  mxFree (views);
+  mxFree (tabs);
+  mxFree (part_ret);
+  mxFree (part_idx);
+  mxFree (part_prec);
+  mxFree (part);
+}
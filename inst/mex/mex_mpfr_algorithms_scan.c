@@ -0,0 +1,225 @@
+/*
+ * This file is part of APA.
+ *
+ *  APA is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  APA is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mex_mpfr_interface.h"
+
+// Elements per block.  Must not depend on the number of threads, such that
+// the results are reproducible.
+#define MPFR_SCAN_BLOCK 1024
+
+
+/**
+ * Binary operation `rop = a op b` of a scan.
+ *
+ * For `MPFR_SCAN_MAX` and `MPFR_SCAN_MIN` NaN operands are ignored, unless
+ * both are NaN.
+ *
+ * @param[in] kind scan operation `MPFR_SCAN_*`.
+ * @param[out] rop MPFR variable.
+ * @param[in] a MPFR variable.
+ * @param[in] b MPFR variable.
+ * @param[in] rnd MPFR rounding mode.
+ *
+ * @returns MPFR ternary return value.
+ */
+static inline int
+mpfr_apa_scan_op (int kind, mpfr_ptr rop, mpfr_ptr a, mpfr_ptr b,
+                  mpfr_rnd_t rnd)
+{
+  switch (kind)
+    {
+      case MPFR_SCAN_ADD:
+        return (mpfr_add (rop, a, b, rnd));
+      case MPFR_SCAN_MUL:
+        return (mpfr_mul (rop, a, b, rnd));
+      case MPFR_SCAN_MAX:
+        return (mpfr_max (rop, a, b, rnd));
+      default:
+        return (mpfr_min (rop, a, b, rnd));
+    }
+}
+
+
+/**
+ * Set `rop` to the identity element of the scan operation.
+ *
+ * @param[in] kind scan operation `MPFR_SCAN_*`.
+ * @param[out] rop MPFR variable.
+ */
+static inline void
+mpfr_apa_scan_identity (int kind, mpfr_ptr rop)
+{
+  switch (kind)
+    {
+      case MPFR_SCAN_ADD:
+        mpfr_set_zero (rop, 1);
+        break;
+      case MPFR_SCAN_MUL:
+        mpfr_set_ui (rop, 1, MPFR_RNDN);
+        break;
+      case MPFR_SCAN_MAX:
+        mpfr_set_inf (rop, -1);
+        break;
+      default:
+        mpfr_set_inf (rop, 1);
+    }
+}
+
+
+/**
+ * Scan a block of `len > 0` elements starting from `carry`.
+ *
+ * @param[in] kind scan operation `MPFR_SCAN_*`.
+ * @param[in] exclusive if non-zero, exclude the element itself.
+ * @param[out] rop first result.
+ * @param[in] x first element.
+ * @param[in] stride distance of the elements and results.
+ * @param[in] len number of elements.
+ * @param[in] carry scan of all elements before the block, NULL for the
+ *                  first block.
+ * @param[in] carry_ret MPFR ternary return value of @c carry.
+ * @param[in] t temporary MPFR variable for exclusive scans.
+ * @param[in] rnd MPFR rounding mode for all operations.
+ * @param[out] ret_ptr MPFR return values of the results (logical OR of all
+ *                     return values contributing to a result).
+ */
+static void
+mpfr_apa_scan_block (int kind, int exclusive, mpfr_ptr rop, mpfr_ptr x,
+                     uint64_t stride, uint64_t len, mpfr_ptr carry,
+                     int carry_ret, mpfr_ptr t, mpfr_rnd_t rnd,
+                     double *ret_ptr)
+{
+  int ret = carry_ret;
+  if (! exclusive)  // Accumulate directly in `rop`.
+    {
+      mpfr_ptr prev = carry;
+      for (uint64_t i = 0; i < len; i++)
+        {
+          mpfr_ptr r = rop + i * stride;
+          if (prev == NULL)
+            ret = mpfr_set (r, x, rnd);
+          else
+            ret |= mpfr_apa_scan_op (kind, r, prev, x + i * stride, rnd);
+          ret_ptr[i * stride] = (double) ret;
+          prev = r;
+        }
+      return;
+    }
+
+  // Exclusive scan: accumulate in `t`, which lags one element behind.
+  if (carry == NULL)
+    {
+      mpfr_apa_scan_identity (kind, rop);
+      mpfr_apa_scan_identity (kind, t);
+      ret_ptr[0] = 0.0;
+      ret        = mpfr_apa_scan_op (kind, t, t, x, rnd);  // Skips NaN max/min.
+    }
+  else
+    {
+      mpfr_set (t, carry, rnd);  // Same precision, exact.
+      ret_ptr[0] = (double) (ret | mpfr_set (rop, t, rnd));
+      ret       |= mpfr_apa_scan_op (kind, t, t, x, rnd);
+    }
+  for (uint64_t i = 1; i < len; i++)
+    {
+      ret_ptr[i * stride] = (double) (ret | mpfr_set (rop + i * stride, t,
+                                                      rnd));
+      ret |= mpfr_apa_scan_op (kind, t, t, x + i * stride, rnd);
+    }
+}
+
+
+void
+mpfr_apa_scan (mpfr_ptr rop, mpfr_ptr op, uint64_t M, uint64_t N, int dim,
+               int kind, int exclusive, mpfr_prec_t prec, mpfr_rnd_t rnd,
+               double *ret_ptr)
+{
+  uint64_t count   = (dim == 1) ? N : M;  // Number of scans.
+  uint64_t len     = (dim == 1) ? M : N;  // Elements per scan.
+  uint64_t ostride = (dim == 1) ? M : 1;
+  uint64_t lstride = (dim == 1) ? 1 : M;
+
+  if ((count == 0) || (len == 0))
+    return;
+
+  uint64_t num_blocks = (len + MPFR_SCAN_BLOCK - 1) / MPFR_SCAN_BLOCK;
+
+  // Totals of all blocks but the last, which become the carries into the
+  // next blocks.
+  uint64_t num_parts = (num_blocks > 1) ? count * (num_blocks - 1) : 0;
+  mpfr_ptr part      = (mpfr_ptr) mxMalloc (
+    (num_parts + 1) * sizeof(__mpfr_struct));
+  int *part_ret = (int *) mxMalloc ((num_parts + 1) * sizeof(int));
+
+  #pragma omp parallel
+  {
+    mpfr_t t;
+    mpfr_init2 (t, prec);
+
+    // Phase 1: totals of the blocks.
+    #pragma omp for schedule(dynamic)
+    for (uint64_t k = 0; k < num_parts; k++)
+      {
+        uint64_t o = k / (num_blocks - 1);
+        uint64_t b = k % (num_blocks - 1);
+        mpfr_ptr x = op + o * ostride + b * MPFR_SCAN_BLOCK * lstride;
+        mpfr_init2 (part + k, prec);
+        part_ret[k] = mpfr_set (part + k, x, rnd);
+        for (uint64_t i = 1; i < MPFR_SCAN_BLOCK; i++)
+          part_ret[k] |= mpfr_apa_scan_op (kind, part + k, part + k,
+                                           x + i * lstride, rnd);
+      }
+
+    // Phase 2: scan of the block totals.
+    if (num_parts > 0)
+      {
+        #pragma omp for schedule(static)
+        for (uint64_t o = 0; o < count; o++)
+          {
+            mpfr_ptr p = part + o * (num_blocks - 1);
+            int *    r = part_ret + o * (num_blocks - 1);
+            for (uint64_t b = 1; b < num_blocks - 1; b++)
+              r[b] |= r[b - 1] | mpfr_apa_scan_op (kind, p + b, p + b - 1,
+                                                    p + b, rnd);
+          }
+      }
+
+    // Phase 3: scan of the blocks starting from the carries.
+    #pragma omp for schedule(dynamic)
+    for (uint64_t k = 0; k < count * num_blocks; k++)
+      {
+        uint64_t o      = k / num_blocks;
+        uint64_t b      = k % num_blocks;
+        uint64_t offset = o * ostride + b * MPFR_SCAN_BLOCK * lstride;
+        uint64_t blen   = ((len - b * MPFR_SCAN_BLOCK) < MPFR_SCAN_BLOCK)
+                          ? (len - b * MPFR_SCAN_BLOCK) : MPFR_SCAN_BLOCK;
+        uint64_t c      = o * (num_blocks - 1) + b - 1;
+        mpfr_apa_scan_block (kind, exclusive, rop + offset, op + offset,
+                             lstride, blen, (b > 0) ? part + c : NULL,
+                             (b > 0) ? part_ret[c] : 0, t, rnd,
+                             ret_ptr + offset);
+      }
+
+    mpfr_clear (t);
+    mpfr_free_cache ();
+  }
+
+  for (uint64_t k = 0; k < num_parts; k++)
+    mpfr_clear (part + k);
+  mxFree (part_ret);
+  mxFree (part);
+}
@@ -0,0 +1,418 @@
+/*
+ * This file is part of APA.
+ *
+ *  APA is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  APA is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mex_mpfr_interface.h"
+
+// Elements per block sorted by a single thread.  A power of two, such that
+// the merge passes within a block end in the original buffer.
+#define MPFR_SORT_BLOCK_LOG2 10
+#define MPFR_SORT_BLOCK (1 << MPFR_SORT_BLOCK_LOG2)
+
+
+// Sort keys of the items to sort.  Item `i` has the keys
+// `x + i * istride + key_off[c]`, c = 0, ..., num_keys - 1.
+
+typedef struct
+{
+  mpfr_ptr        x;
+  uint64_t        istride;
+  const uint64_t *key_off;
+  const int *     descend;    // Per key, descending order.
+  const int *     nan_first;  // Per key, NaN before all numbers.
+  size_t          num_keys;
+} mpfr_sort_keys_t;
+
+
+/**
+ * Compare two MPFR variables, which are not NaN.
+ *
+ * The cheap sign and exponent are compared first, `mpfr_cmp` is only called
+ * for equal signs and exponents.  Signed zeros are equal.
+ *
+ * @param[in] a MPFR variable.
+ * @param[in] b MPFR variable.
+ *
+ * @returns negative, zero, or positive value if a < b, a = b, or a > b.
+ */
+static inline int
+mpfr_apa_sort_cmp (mpfr_srcptr a, mpfr_srcptr b)
+{
+  int sa = mpfr_zero_p (a) ? 0 : (mpfr_signbit (a) ? -1 : 1);
+  int sb = mpfr_zero_p (b) ? 0 : (mpfr_signbit (b) ? -1 : 1);
+  if (sa != sb)
+    return ((sa < sb) ? -1 : 1);
+  if (sa == 0)
+    return (0);
+  if (mpfr_regular_p (a) && mpfr_regular_p (b))
+    {
+      mpfr_exp_t ea = mpfr_get_exp (a);
+      mpfr_exp_t eb = mpfr_get_exp (b);
+      if (ea != eb)
+        return ((ea < eb) ? -sa : sa);
+    }
+  return (mpfr_cmp (a, b));  // Infinities and equal exponents.
+}
+
+
+/**
+ * Compare the keys of two items.
+ *
+ * @param[in] keys sort keys.
+ * @param[in] i item.
+ * @param[in] j item.
+ *
+ * @returns negative, zero, or positive value if item i is sorted before, at
+ *          the same position as, or after item j.
+ */
+static inline int
+mpfr_apa_sort_cmp_items (const mpfr_sort_keys_t *keys, uint64_t i,
+                         uint64_t j)
+{
+  for (size_t c = 0; c < keys->num_keys; c++)
+    {
+      mpfr_ptr a     = keys->x + i * keys->istride + keys->key_off[c];
+      mpfr_ptr b     = keys->x + j * keys->istride + keys->key_off[c];
+      int      a_nan = mpfr_nan_p (a);
+      int      b_nan = mpfr_nan_p (b);
+      if (a_nan || b_nan)
+        {
+          if (a_nan && b_nan)
+            continue;
+          return ((a_nan == keys->nan_first[c]) ? -1 : 1);
+        }
+      int cmp = mpfr_apa_sort_cmp (a, b);
+      if (cmp != 0)
+        return (keys->descend[c] ? -cmp : cmp);
+    }
+  return (0);
+}
+
+
+/**
+ * Stable merge of the sorted ranges `src[lo:mid-1]` and `src[mid:hi-1]` into
+ * `dst[lo:hi-1]`.
+ */
+static void
+mpfr_apa_sort_merge (const mpfr_sort_keys_t *keys, const uint64_t *src,
+                     uint64_t *dst, uint64_t lo, uint64_t mid, uint64_t hi)
+{
+  uint64_t i = lo;
+  uint64_t j = mid;
+  uint64_t k = lo;
+  if ((mid >= hi) || (mpfr_apa_sort_cmp_items (keys, src[mid - 1], src[mid])
+                      <= 0))
+    {
+      memcpy (dst + lo, src + lo, (hi - lo) * sizeof(uint64_t));
+      return;  // Already in order.
+    }
+  while ((i < mid) && (j < hi))
+    dst[k++] = (mpfr_apa_sort_cmp_items (keys, src[j], src[i]) < 0)
+               ? src[j++] : src[i++];
+  while (i < mid)
+    dst[k++] = src[i++];
+  while (j < hi)
+    dst[k++] = src[j++];
+}
+
+
+/**
+ * Apply the permutation `perm` to `len` items, such that item `t` becomes
+ * the former item `perm[t]`.  The items are exchanged by `mpfr_swap`.
+ *
+ * @param[in] x first item.
+ * @param[in] istride distance of the items.
+ * @param[in] ilen number of MPFR variables per item.
+ * @param[in] estride distance of the MPFR variables of an item.
+ * @param[in,out] perm permutation of length @c len, destroyed.
+ * @param[in] len number of items.
+ */
+static void
+mpfr_apa_sort_permute (mpfr_ptr x, uint64_t istride, uint64_t ilen,
+                       uint64_t estride, uint64_t *perm, uint64_t len)
+{
+  for (uint64_t s = 0; s < len; s++)
+    {
+      uint64_t t = s;
+      while (perm[t] != t)  // Follow cycle, mark done items by perm[t] = t.
+        {
+          uint64_t n = perm[t];
+          perm[t] = t;
+          if (n == s)
+            break;
+          for (uint64_t e = 0; e < ilen; e++)
+            mpfr_swap (x + t * istride + e * estride,
+                       x + n * istride + e * estride);
+          t = n;
+        }
+    }
+}
+
+
+/**
+ * Stable parallel merge sort of `count` independent sequences of `len` items
+ * each.
+ *
+ * @param[in] keys sort keys of the first sequence.
+ * @param[in] sstride distance of the sequences.
+ * @param[in] count number of sequences.
+ * @param[in] len items per sequence.
+ * @param[in] ilen number of MPFR variables per item.
+ * @param[in] estride distance of the MPFR variables of an item.
+ * @param[out] perm_ptr (1-based) permutations, may be NULL.
+ * @param[in] pstride distance of the permutations in @c perm_ptr.
+ * @param[in] pistride distance of the entries of a permutation in
+ *                     @c perm_ptr.
+ */
+static void
+mpfr_apa_sort_items (const mpfr_sort_keys_t *keys, uint64_t sstride,
+                     uint64_t count, uint64_t len, uint64_t ilen,
+                     uint64_t estride, double *perm_ptr, uint64_t pstride,
+                     uint64_t pistride)
+{
+  if ((count == 0) || (len == 0))
+    return;
+
+  uint64_t  num_blocks = (len + MPFR_SORT_BLOCK - 1) / MPFR_SORT_BLOCK;
+  uint64_t *perm       = (uint64_t *) mxMalloc (
+    count * len * sizeof(uint64_t));
+  uint64_t *tmp = (uint64_t *) mxMalloc (count * len * sizeof(uint64_t));
+  uint64_t *src        = perm;  // Buffer holding the current runs.
+
+  #pragma omp parallel
+  {
+    // Sort the blocks.  The even number of passes ends in `perm`.
+    #pragma omp for schedule(dynamic)
+    for (uint64_t k = 0; k < count * num_blocks; k++)
+      {
+        uint64_t o  = k / num_blocks;
+        uint64_t lo = (k % num_blocks) * MPFR_SORT_BLOCK;
+        uint64_t hi = ((len - lo) < MPFR_SORT_BLOCK) ? len
+                      : (lo + MPFR_SORT_BLOCK);
+        mpfr_sort_keys_t key = *keys;
+        key.x += o * sstride;
+        uint64_t *a = perm + o * len;
+        uint64_t *b = tmp + o * len;
+        for (uint64_t i = lo; i < hi; i++)
+          a[i] = i;
+        for (int pass = 0; pass < MPFR_SORT_BLOCK_LOG2; pass++)
+          {
+            uint64_t w = (uint64_t) 1 << pass;
+            for (uint64_t l = lo; l < hi; l += 2 * w)
+              mpfr_apa_sort_merge (&key, a, b, l,
+                                   ((hi - l) < w) ? hi : (l + w),
+                                   ((hi - l) < 2 * w) ? hi : (l + 2 * w));
+            uint64_t *c = a;
+            a = b;
+            b = c;
+          }
+      }
+
+    // Merge the blocks pairwise.
+    for (uint64_t w = MPFR_SORT_BLOCK; w < len; w *= 2)
+      {
+        uint64_t *dst       = (src == perm) ? tmp : perm;
+        uint64_t  num_pairs = (len + 2 * w - 1) / (2 * w);
+        #pragma omp for schedule(dynamic)
+        for (uint64_t k = 0; k < count * num_pairs; k++)
+          {
+            uint64_t o  = k / num_pairs;
+            uint64_t lo = (k % num_pairs) * 2 * w;
+            mpfr_sort_keys_t key = *keys;
+            key.x += o * sstride;
+            mpfr_apa_sort_merge (&key, src + o * len, dst + o * len, lo,
+                                 ((len - lo) < w) ? len : (lo + w),
+                                 ((len - lo) < 2 * w) ? len : (lo + 2 * w));
+          }
+        #pragma omp single
+        src = dst;
+      }
+
+    // Store and apply the permutations.
+    #pragma omp for schedule(dynamic)
+    for (uint64_t o = 0; o < count; o++)
+      {
+        uint64_t *p = src + o * len;
+        if (perm_ptr != NULL)
+          for (uint64_t i = 0; i < len; i++)
+            perm_ptr[o * pstride + i * pistride] = (double) (p[i] + 1);
+        mpfr_apa_sort_permute (keys->x + o * sstride, keys->istride, ilen,
+                               estride, p, len);
+      }
+  }
+
+  mxFree (tmp);
+  mxFree (perm);
+}
+
+
+void
+mpfr_apa_sort (mpfr_ptr x, uint64_t M, uint64_t N, int dim, int descend,
+               int nan_first, double *perm_ptr)
+{
+  uint64_t         key_off = 0;
+  mpfr_sort_keys_t keys    = { x, (dim == 1) ? 1 : M, &key_off, &descend,
+                               &nan_first, 1 };
+
+  mpfr_apa_sort_items (&keys, (dim == 1) ? M : 1, (dim == 1) ? N : M,
+                       (dim == 1) ? M : N, 1, 0, perm_ptr, (dim == 1) ? M : 1,
+                       (dim == 1) ? 1 : M);
+}
+
+
+void
+mpfr_apa_sortrows (mpfr_ptr x, uint64_t M, uint64_t N, const int64_t *cols,
+                   size_t num_cols, double *perm_ptr)
+{
+  uint64_t *key_off   = (uint64_t *) mxMalloc ((num_cols + 1)
+                                               * sizeof(uint64_t));
+  int *     descend   = (int *) mxMalloc ((num_cols + 1) * sizeof(int));
+  int *     nan_first = (int *) mxMalloc ((num_cols + 1) * sizeof(int));
+  for (size_t c = 0; c < num_cols; c++)
+    {
+      key_off[c]   = ((cols[c] < 0) ? -cols[c] : cols[c]) - 1;
+      key_off[c]  *= M;
+      descend[c]   = (cols[c] < 0);
+      nan_first[c] = descend[c];  // NaN is greater than all numbers.
+    }
+  mpfr_sort_keys_t keys = { x, 1, key_off, descend, nan_first, num_cols };
+
+  mpfr_apa_sort_items (&keys, 0, 1, M, N, M, perm_ptr, 0, 1);
+
+  mxFree (nan_first);
+  mxFree (descend);
+  mxFree (key_off);
+}
+
+
+/**
+ * Partially sort `idx[lo:hi-1]` in ascending order of `x[idx[i] * stride]`,
+ * such that position `k` holds the k-th smallest element, all smaller
+ * elements are before and all greater elements after it.
+ *
+ * Quickselect with median-of-three pivot and Hoare partitioning, which
+ * stays balanced for sorted input and many equal elements.  No element may
+ * be NaN.
+ */
+static void
+mpfr_apa_select_range (mpfr_ptr x, uint64_t stride, uint64_t *idx,
+                       uint64_t lo, uint64_t hi, uint64_t k)
+{
+  #define MPFR_SELECT_CMP(i, j) \
+  mpfr_apa_sort_cmp (x + (i) * stride, x + (j) * stride)
+  #define MPFR_SELECT_SWAP(i, j) \
+  { uint64_t tmp_ = idx[i]; idx[i] = idx[j]; idx[j] = tmp_; }
+
+  while (hi - lo > 3)
+    {
+      // Median of three as pivot, the others are sentinels for the scans.
+      uint64_t mid = lo + (hi - lo) / 2;
+      if (MPFR_SELECT_CMP (idx[mid], idx[lo]) < 0)
+        MPFR_SELECT_SWAP (mid, lo);
+      if (MPFR_SELECT_CMP (idx[hi - 1], idx[lo]) < 0)
+        MPFR_SELECT_SWAP (hi - 1, lo);
+      if (MPFR_SELECT_CMP (idx[hi - 1], idx[mid]) < 0)
+        MPFR_SELECT_SWAP (hi - 1, mid);
+      uint64_t pivot = idx[mid];
+
+      // Partition into [lo, j] <= pivot and [j + 1, hi) >= pivot.
+      uint64_t i = lo;
+      uint64_t j = hi - 1;
+      while (1)
+        {
+          do
+            i++;
+          while (MPFR_SELECT_CMP (idx[i], pivot) < 0);
+          do
+            j--;
+          while (MPFR_SELECT_CMP (idx[j], pivot) > 0);
+          if (i >= j)
+            break;
+          MPFR_SELECT_SWAP (i, j);
+        }
+      if (k <= j)
+        hi = j + 1;
+      else
+        lo = j + 1;
+    }
+
+  // Insertion sort of the remaining elements.
+  for (uint64_t i = lo + 1; i < hi; i++)
+    for (uint64_t j = i; (j > lo) && (MPFR_SELECT_CMP (idx[j], idx[j - 1])
+                                     < 0); j--)
+      MPFR_SELECT_SWAP (j, j - 1);
+
+  #undef MPFR_SELECT_SWAP
+  #undef MPFR_SELECT_CMP
+}
+
+
+void
+mpfr_apa_select (mpfr_ptr rop, mpfr_ptr op, uint64_t M, uint64_t N, int dim,
+                 const uint64_t *ranks, size_t num_ranks, mpfr_rnd_t rnd,
+                 double *ret_ptr, double *nan_ptr)
+{
+  uint64_t count   = (dim == 1) ? N : M;  // Number of sequences.
+  uint64_t len     = (dim == 1) ? M : N;  // Elements per sequence.
+  uint64_t ostride = (dim == 1) ? M : 1;
+  uint64_t lstride = (dim == 1) ? 1 : M;
+  uint64_t rstride = (dim == 1) ? 1 : M;  // Distance of the results.
+  uint64_t rostride = (dim == 1) ? num_ranks : 1;
+
+  // Per-thread index buffers.
+  int       num_threads = omp_get_max_threads ();
+  uint64_t *idx_bufs    = (uint64_t *) mxMalloc (
+    num_threads * (len + 1) * sizeof(uint64_t));
+
+  #pragma omp parallel
+  {
+    uint64_t *idx = idx_bufs + omp_get_thread_num () * (len + 1);
+
+    #pragma omp for schedule(dynamic)
+    for (uint64_t o = 0; o < count; o++)
+      {
+        mpfr_ptr x = op + o * ostride;
+
+        // Indices of the numbers, NaN elements are sorted last.
+        uint64_t num = 0;
+        for (uint64_t l = 0; l < len; l++)
+          if (! mpfr_nan_p (x + l * lstride))
+            idx[num++] = l;
+        if (nan_ptr != NULL)
+          nan_ptr[o] = (double) (len - num);
+
+        // Ascending ranks narrow the range of the next selection.
+        uint64_t lo = 0;
+        for (size_t r = 0; r < num_ranks; r++)
+          {
+            uint64_t k = ranks[r] - 1;
+            mpfr_ptr y = rop + o * rostride + r * rstride;
+            if (k >= num)
+              {
+                mpfr_set_nan (y);
+                ret_ptr[o * rostride + r * rstride] = 0.0;
+                continue;
+              }
+            mpfr_apa_select_range (x, lstride, idx, lo, num, k);
+            lo = k;
+            ret_ptr[o * rostride + r * rstride] = (double) mpfr_set (
+              y, x + idx[k] * lstride, rnd);
+          }
+      }
+  }
+
+  mxFree (idx_bufs);
+}
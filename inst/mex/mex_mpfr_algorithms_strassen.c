@@ -0,0 +1,327 @@
+/*
+ * This file is part of APA.
+ *
+ *  APA is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  APA is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mex_mpfr_interface.h"
+
+// Matrices with a dimension of at most `mpfr_strassen_cutoff` are multiplied
+// by the conventional algorithm (see benchmark_strassen.m).
+size_t mpfr_strassen_cutoff = 32;
+
+// Guard bits per recursion level.  The normwise error bound of
+// Strassen-Winograd grows by a factor of about 18 per level (Higham,
+// "Accuracy and Stability of Numerical Algorithms", 2nd ed., Sec. 23.2.2).
+#define MPFR_STRASSEN_GUARD_BITS 5
+
+// Maximum bytes of the workspace, if the products are computed as OpenMP
+// tasks.  Each task needs its own temporaries, on one level about 4 times the
+// size of C for square matrices, on two levels about 10 times.  Above the
+// limit, the serial schedule with about 2/3 of the size of C is used.
+#define MPFR_STRASSEN_MAX_TASK_BYTES (((uint64_t) 1) << 28)
+
+
+/**
+ * Test if the product of [M x K] and [K x N] matrices is computed by the
+ * conventional algorithm.
+ */
+static inline int
+mpfr_apa_strassen_stop (uint64_t M, uint64_t N, uint64_t K)
+{
+  return ((M < 2) || (N < 2) || (K < 2) || (M <= mpfr_strassen_cutoff)
+          || (N <= mpfr_strassen_cutoff) || (K <= mpfr_strassen_cutoff));
+}
+
+
+/**
+ * Number of MPFR variables of the workspace of `mpfr_apa_strassen_rec`.
+ *
+ * @param[in] M Matrix dimension.
+ * @param[in] N Matrix dimension.
+ * @param[in] K Matrix dimension.
+ * @param[in] tasks number of recursion levels creating OpenMP tasks.
+ */
+static uint64_t
+mpfr_apa_strassen_ws (uint64_t M, uint64_t N, uint64_t K, int tasks)
+{
+  if (mpfr_apa_strassen_stop (M, N, K))
+    return (0);
+  uint64_t m = M / 2;
+  uint64_t n = N / 2;
+  uint64_t k = K / 2;
+  uint64_t child = mpfr_apa_strassen_ws (m, n, k,
+                                         (tasks > 0) ? (tasks - 1) : 0);
+  if (tasks > 0)
+    return (4 * m * k + 4 * k * n + 3 * m * n + 7 * child);
+  return (((m * k > m * n) ? m * k : m * n) + k * n + child);
+}
+
+
+/**
+ * Element-wise `R = X + Y` or `R = X - Y` of [m x n] matrices with leading
+ * dimensions `ldr`, `ldx`, and `ldy`, rounded to nearest.
+ *
+ * @returns MPFR ternary return value (logical OR of all return values).
+ */
+static int
+mpfr_apa_strassen_add (mpfr_ptr R, uint64_t ldr, mpfr_ptr X, uint64_t ldx,
+                       mpfr_ptr Y, uint64_t ldy, uint64_t m, uint64_t n,
+                       int sub)
+{
+  int ret = 0;
+  for (uint64_t j = 0; j < n; j++)
+    for (uint64_t i = 0; i < m; i++)
+      ret |= (sub ? mpfr_sub : mpfr_add) (R + i + ldr * j, X + i + ldx * j,
+                                          Y + i + ldy * j, MPFR_RNDN);
+  return (ret);
+}
+
+
+/**
+ * Conventional `C = A * B` (or `C = C + A * B` if `acc` is non-zero) of
+ * matrices with leading dimensions, rounded to nearest.
+ *
+ * @returns MPFR ternary return value (logical OR of all return values).
+ */
+static int
+mpfr_apa_strassen_base (mpfr_ptr C, uint64_t ldc, mpfr_ptr A, uint64_t lda,
+                        mpfr_ptr B, uint64_t ldb, uint64_t M, uint64_t N,
+                        uint64_t K, int acc, mpfr_fixed_op3_t fma_fcn)
+{
+  int ret = 0;
+  for (uint64_t j = 0; j < N; j++)
+    for (uint64_t i = 0; i < M; i++)
+      {
+        mpfr_ptr c = C + i + ldc * j;
+        if (! acc)
+          mpfr_set_zero (c, 1);
+        for (uint64_t k = 0; k < K; k++)
+          ret |= fma_fcn (c, B + k + ldb * j, A + i + lda * k, c, MPFR_RNDN);
+      }
+  return (ret);
+}
+
+
+/**
+ * Strassen-Winograd `C = A * B` of matrices with leading dimensions.
+ *
+ * Odd dimensions are handled by peeling the last row, column, and rank-one
+ * update.  The first `tasks` recursion levels compute the seven products as
+ * OpenMP tasks, which requires more temporaries, the other levels use the
+ * schedule with two temporaries by Douglas et al. (1994).
+ *
+ * @param[out] C [M x N] matrix of precision `wprec`.
+ * @param[in] A [M x K] matrix.
+ * @param[in] B [K x N] matrix.
+ * @param[in] W workspace of `mpfr_apa_strassen_ws` variables of precision
+ *              `wprec`.
+ * @param[in] tasks number of recursion levels creating OpenMP tasks.
+ * @param[in] fma_fcn fused multiply-add kernel.
+ *
+ * @returns MPFR ternary return value (logical OR of all return values).
+ */
+static int
+mpfr_apa_strassen_rec (mpfr_ptr C, uint64_t ldc, mpfr_ptr A, uint64_t lda,
+                       mpfr_ptr B, uint64_t ldb, uint64_t M, uint64_t N,
+                       uint64_t K, mpfr_ptr W, int tasks,
+                       mpfr_fixed_op3_t fma_fcn)
+{
+  if (mpfr_apa_strassen_stop (M, N, K))
+    return (mpfr_apa_strassen_base (C, ldc, A, lda, B, ldb, M, N, K, 0,
+                                    fma_fcn));
+
+  uint64_t m = M / 2;
+  uint64_t n = N / 2;
+  uint64_t k = K / 2;
+  mpfr_ptr A11 = A;
+  mpfr_ptr A12 = A + lda * k;
+  mpfr_ptr A21 = A + m;
+  mpfr_ptr A22 = A + m + lda * k;
+  mpfr_ptr B11 = B;
+  mpfr_ptr B12 = B + ldb * n;
+  mpfr_ptr B21 = B + k;
+  mpfr_ptr B22 = B + k + ldb * n;
+  mpfr_ptr C11 = C;
+  mpfr_ptr C12 = C + ldc * n;
+  mpfr_ptr C21 = C + m;
+  mpfr_ptr C22 = C + m + ldc * n;
+  int      ret = 0;
+
+  if (tasks > 0)
+    {
+      mpfr_ptr S = W;               // S1, ..., S4 [m x k]
+      mpfr_ptr T = S + 4 * m * k;   // T1, ..., T4 [k x n]
+      mpfr_ptr P = T + 4 * k * n;   // P1, P6, P7  [m x n]
+      mpfr_ptr V = P + 3 * m * n;   // Workspaces of the products.
+      uint64_t vlen = mpfr_apa_strassen_ws (m, n, k, tasks - 1);
+      mpfr_ptr S1 = S, S2 = S + m * k, S3 = S + 2 * m * k, S4 = S + 3 * m * k;
+      mpfr_ptr T1 = T, T2 = T + k * n, T3 = T + 2 * k * n, T4 = T + 3 * k * n;
+      mpfr_ptr P1 = P, P6 = P + m * n, P7 = P + 2 * m * n;
+
+      ret |= mpfr_apa_strassen_add (S1, m, A21, lda, A22, lda, m, k, 0);
+      ret |= mpfr_apa_strassen_add (S2, m, S1, m, A11, lda, m, k, 1);
+      ret |= mpfr_apa_strassen_add (S3, m, A11, lda, A21, lda, m, k, 1);
+      ret |= mpfr_apa_strassen_add (S4, m, A12, lda, S2, m, m, k, 1);
+      ret |= mpfr_apa_strassen_add (T1, k, B12, ldb, B11, ldb, k, n, 1);
+      ret |= mpfr_apa_strassen_add (T2, k, B22, ldb, T1, k, k, n, 1);
+      ret |= mpfr_apa_strassen_add (T3, k, B22, ldb, B12, ldb, k, n, 1);
+      ret |= mpfr_apa_strassen_add (T4, k, T2, k, B21, ldb, k, n, 1);
+
+      // The products P2, ..., P5 are stored in C.
+      mpfr_ptr rop[7] = { P1, C11, C12, C21, C22, P6, P7 };
+      uint64_t ldr[7] = { m, ldc, ldc, ldc, ldc, m, m };
+      mpfr_ptr op1[7] = { A11, A12, S4, A22, S1, S2, S3 };
+      uint64_t ld1[7] = { lda, lda, m, lda, m, m, m };
+      mpfr_ptr op2[7] = { B11, B21, B22, T4, T1, T2, T3 };
+      uint64_t ld2[7] = { ldb, ldb, ldb, k, k, k, k };
+      int      rets[7];
+      for (int p = 0; p < 7; p++)
+        {
+          #pragma omp task default(shared) firstprivate(p)
+          rets[p] = mpfr_apa_strassen_rec (rop[p], ldr[p], op1[p], ld1[p],
+                                           op2[p], ld2[p], m, n, k,
+                                           V + p * vlen, tasks - 1, fma_fcn);
+        }
+      #pragma omp taskwait
+      for (int p = 0; p < 7; p++)
+        ret |= rets[p];
+
+      ret |= mpfr_apa_strassen_add (C11, ldc, P1, m, C11, ldc, m, n, 0);
+      ret |= mpfr_apa_strassen_add (P6, m, P1, m, P6, m, m, n, 0);
+      ret |= mpfr_apa_strassen_add (P7, m, P6, m, P7, m, m, n, 0);
+      ret |= mpfr_apa_strassen_add (C12, ldc, C12, ldc, P6, m, m, n, 0);
+      ret |= mpfr_apa_strassen_add (C12, ldc, C12, ldc, C22, ldc, m, n, 0);
+      ret |= mpfr_apa_strassen_add (C21, ldc, P7, m, C21, ldc, m, n, 1);
+      ret |= mpfr_apa_strassen_add (C22, ldc, P7, m, C22, ldc, m, n, 0);
+    }
+  else
+    {
+      mpfr_ptr X = W;  // [m x k] or [m x n]
+      mpfr_ptr Y = X + ((m * k > m * n) ? m * k : m * n);  // [k x n]
+      mpfr_ptr V = Y + k * n;
+
+      ret |= mpfr_apa_strassen_add (X, m, A11, lda, A21, lda, m, k, 1);  // S3
+      ret |= mpfr_apa_strassen_add (Y, k, B22, ldb, B12, ldb, k, n, 1);  // T3
+      ret |= mpfr_apa_strassen_rec (C21, ldc, X, m, Y, k, m, n, k, V, 0,
+                                    fma_fcn);                           // P7
+      ret |= mpfr_apa_strassen_add (X, m, A21, lda, A22, lda, m, k, 0);  // S1
+      ret |= mpfr_apa_strassen_add (Y, k, B12, ldb, B11, ldb, k, n, 1);  // T1
+      ret |= mpfr_apa_strassen_rec (C22, ldc, X, m, Y, k, m, n, k, V, 0,
+                                    fma_fcn);                           // P5
+      ret |= mpfr_apa_strassen_add (X, m, X, m, A11, lda, m, k, 1);      // S2
+      ret |= mpfr_apa_strassen_add (Y, k, B22, ldb, Y, k, k, n, 1);      // T2
+      ret |= mpfr_apa_strassen_rec (C12, ldc, X, m, Y, k, m, n, k, V, 0,
+                                    fma_fcn);                           // P6
+      ret |= mpfr_apa_strassen_add (X, m, A12, lda, X, m, m, k, 1);      // S4
+      ret |= mpfr_apa_strassen_rec (C11, ldc, X, m, B22, ldb, m, n, k, V, 0,
+                                    fma_fcn);                           // P3
+      ret |= mpfr_apa_strassen_rec (X, m, A11, lda, B11, ldb, m, n, k, V, 0,
+                                    fma_fcn);                           // P1
+      ret |= mpfr_apa_strassen_add (C12, ldc, X, m, C12, ldc, m, n, 0);  // U2
+      ret |= mpfr_apa_strassen_add (C21, ldc, C12, ldc, C21, ldc, m, n, 0);
+      ret |= mpfr_apa_strassen_add (C12, ldc, C12, ldc, C22, ldc, m, n, 0);
+      ret |= mpfr_apa_strassen_add (C22, ldc, C21, ldc, C22, ldc, m, n, 0);
+      ret |= mpfr_apa_strassen_add (C12, ldc, C12, ldc, C11, ldc, m, n, 0);
+      ret |= mpfr_apa_strassen_add (Y, k, Y, k, B21, ldb, k, n, 1);      // T4
+      ret |= mpfr_apa_strassen_rec (C11, ldc, A22, lda, Y, k, m, n, k, V, 0,
+                                    fma_fcn);                           // P4
+      ret |= mpfr_apa_strassen_add (C21, ldc, C21, ldc, C11, ldc, m, n, 1);
+      ret |= mpfr_apa_strassen_rec (C11, ldc, A12, lda, B21, ldb, m, n, k, V,
+                                    0, fma_fcn);                        // P2
+      ret |= mpfr_apa_strassen_add (C11, ldc, X, m, C11, ldc, m, n, 0);  // U1
+    }
+
+  // Peel odd dimensions.
+  if (K > 2 * k)
+    ret |= mpfr_apa_strassen_base (C, ldc, A + lda * (K - 1), lda,
+                                   B + (K - 1), ldb, 2 * m, 2 * n, 1, 1,
+                                   fma_fcn);
+  if (M > 2 * m)
+    ret |= mpfr_apa_strassen_base (C + (M - 1), ldc, A + (M - 1), lda, B, ldb,
+                                   1, N, K, 0, fma_fcn);
+  if (N > 2 * n)
+    ret |= mpfr_apa_strassen_base (C + ldc * (N - 1), ldc, A, lda,
+                                   B + ldb * (N - 1), ldb, 2 * m, 1, K, 0,
+                                   fma_fcn);
+  return (ret);
+}
+
+
+void
+mpfr_apa_strassen (mpfr_ptr C, mpfr_ptr A, mpfr_ptr B, mpfr_prec_t prec,
+                   mpfr_rnd_t rnd, uint64_t M, uint64_t N, uint64_t K,
+                   double *ret_ptr, size_t ret_stride)
+{
+  int levels = 0;
+  for (uint64_t m = M, n = N, k = K; ! mpfr_apa_strassen_stop (m, n, k);
+       m /= 2, n /= 2, k /= 2)
+    levels++;
+  if ((levels == 0) || ! mpfr_apa_mmm_number_p (A, B, M, N, K))
+    {
+      mpfr_apa_mmm (C, A, B, prec, rnd, M, N, K, ret_ptr, ret_stride, 8);
+      return;
+    }
+
+  mpfr_prec_t wprec = prec + MPFR_STRASSEN_GUARD_BITS * levels;
+  uint64_t    bytes = sizeof(mpfr_t) + mpfr_custom_get_size (wprec);
+
+  // Tasks on the first level for at most 7 threads, else on two levels,
+  // unless their workspace is too large.
+  int num_threads = omp_get_max_threads ();
+  int tasks       = (num_threads > 1) + (num_threads > 7);
+  if (tasks > levels)
+    tasks = levels;
+  while ((tasks > 0) && (mpfr_apa_strassen_ws (M, N, K, tasks) * bytes
+                         > MPFR_STRASSEN_MAX_TASK_BYTES))
+    tasks--;
+
+  // Product of working precision, followed by the workspace.
+  uint64_t len = M * N + mpfr_apa_strassen_ws (M, N, K, tasks);
+  mpfr_ptr    W     = (mpfr_ptr) mxMalloc (len * sizeof(mpfr_t));
+  #pragma omp parallel for
+  for (uint64_t i = 0; i < len; i++)
+    mpfr_init2 (W + i, wprec);
+  DBG_PRINTF ("mpfr_apa_strassen: levels = %d, tasks = %d, wprec = %d, "
+              "workspace = %d\n", levels, tasks, (int) wprec, (int) len);
+
+  mpfr_fixed_op3_t fma_fcn = mex_mpfr_fixed_op3 (1056, wprec, mpfr_fma);
+  int ret = 0;
+  #pragma omp parallel
+  {
+    #pragma omp single
+    ret = mpfr_apa_strassen_rec (W, M, A, M, B, K, M, N, K, W + M * N, tasks,
+                                 fma_fcn);
+  }
+
+  // Round to C, which is zero-initialized.  A scalar return value is
+  // combined after the loop.
+  int ret_any = 0;
+  #pragma omp parallel for reduction(|:ret_any)
+  for (uint64_t i = 0; i < M * N; i++)
+    {
+      int r = mpfr_add (C + i, C + i, W + i, rnd);
+      if (ret_stride)
+        ret_ptr[i] = (double) (r ? r : ret);
+      else
+        ret_any |= (r ? r : ret);
+    }
+  if (! ret_stride)
+    ret_ptr[0] = (double) ret_any;
+
+  #pragma omp parallel for
+  for (uint64_t i = 0; i < len; i++)
+    mpfr_clear (W + i);
+  mxFree (W);
+}
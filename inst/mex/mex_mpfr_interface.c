@@ -21,9 +21,94 @@
   ({ __typeof__(a)_a = (a); __typeof__(b)_b = (b); \
      _a > _b ? _a : _b; })
 
+int mpfr_ternary_summary = 0;
+
+
+// Ternary values of element-wise loops
+// ====================================
+//
+// With output (`nlhs > 0`), a loop over `n` MPFR variables returns all `n`
+// ternary values, or in a `mpfr_t.summary` call a summary `[up, down,
+// exact]` of the number of results greater than, lower than, and equal to
+// the exact result.  Without output, a scalar `1` (some results greater),
+// `-1` (some results lower), or `0` (all exact) is returned.  Summaries are
+// reduced per thread:
+//
+//   MEX_MPFR_TERNARY_T (n);
+//   #pragma omp parallel for reduction(+:ternary_up, ternary_down)
+//   for (size_t i = 0; i < n; i++)
+//     MEX_MPFR_TERNARY_SET (i, mpfr_add (...));
+//   MEX_MPFR_TERNARY_RETURN ();
+
+#define MEX_MPFR_TERNARY_T(n)                                          \
+  size_t  ternary_n    = (n);                                          \
+  size_t  ternary_up   = 0;                                            \
+  size_t  ternary_down = 0;                                            \
+  double *ret_ptr      = mex_mpfr_ternary_init (nlhs, plhs, ternary_n);
+
+#define MEX_MPFR_TERNARY_SET(i, value) \
+  {                                    \
+    int ternary = (value);             \
+    if (ret_ptr != NULL)               \
+      ret_ptr[i] = (double) ternary;   \
+    else if (ternary > 0)              \
+      ternary_up++;                    \
+    else if (ternary < 0)              \
+      ternary_down++;                  \
+  }
+
+#define MEX_MPFR_TERNARY_RETURN()                             \
+  mex_mpfr_ternary_return (nlhs, plhs, ternary_n, ternary_up, \
+                           ternary_down)
+
 
 /**
- * Octave/Matlab MEX interface for MPFR.
+ * Create the output array for all ternary values, if requested.
+ *
+ * @param nlhs MEX parameter.
+ * @param plhs MEX parameter.
+ * @param n Number of ternary values.
+ *
+ * @returns pointer to `n` ternary values, NULL if a summary is returned.
+ */
+static double *
+mex_mpfr_ternary_init (int nlhs, mxArray *plhs[], size_t n)
+{
+  if ((nlhs == 0) || mpfr_ternary_summary)
+    return (NULL);
+  plhs[0] = mxCreateNumericMatrix (n, 1, mxDOUBLE_CLASS, mxREAL);
+  return (mxGetPr (plhs[0]));
+}
+
+
+/**
+ * Create the output summary of ternary values, if requested.
+ *
+ * @param nlhs MEX parameter.
+ * @param plhs MEX parameter.
+ * @param n Number of ternary values.
+ * @param up Number of positive ternary values.
+ * @param down Number of negative ternary values.
+ */
+static void
+mex_mpfr_ternary_return (int nlhs, mxArray *plhs[], size_t n, size_t up,
+                         size_t down)
+{
+  if (nlhs == 0)
+    plhs[0] = mxCreateDoubleScalar (up ? 1.0 : (down ? -1.0 : 0.0));
+  else if (mpfr_ternary_summary)
+    {
+      plhs[0] = mxCreateNumericMatrix (1, 3, mxDOUBLE_CLASS, mxREAL);
+      double *ptr = mxGetPr (plhs[0]);
+      ptr[0] = (double) up;
+      ptr[1] = (double) down;
+      ptr[2] = (double) (n - up - down);
+    }
+}
+
+
+/**
+ * Execute a command of the Octave/Matlab MEX interface for MPFR.
  *
  * @param nlhs MEX parameter.
  * @param plhs MEX parameter.
@@ -31,15 +116,18 @@
  * @param prhs MEX parameter.
  * @param cmd_code code of command to execute (1000 - 1999).
  */
-void
-mex_mpfr_interface (int nlhs, mxArray *plhs[],
-                    int nrhs, const mxArray *prhs[],
-                    uint64_t cmd_code)
+static void
+mex_mpfr_interface_cmd (int nlhs, mxArray *plhs[],
+                        int nrhs, const mxArray *prhs[],
+                        uint64_t cmd_code)
 {
   #if (! defined(MPFR_VERSION) || (MPFR_VERSION < MPFR_VERSION_NUM (4, 0, 0)))
   # error "Oldest supported MPFR version is 4.0.0."
   #endif
 
+  // Number of threads of element-wise loops, see `mex_mpfr_omp_schedule`.
+  int omp_threads = 1;
+
   switch (cmd_code)
     {
       /**
@@ -56,27 +144,36 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
       case 1901: // size_t mpfr_t.get_data_size (void)
       {
         MEX_NARGINCHK (1);
+        mex_mpfr_flush_free ();
         plhs[0] = mxCreateDoubleScalar ((double) mpfr_data_size);
         return;
       }
 
-      case 1902: // idx_t mpfr_t.allocate (size_t count)
+      case 1902: // idx_t mpfr_t.allocate (size_t count, mpfr_prec_t prec)
       {
-        MEX_NARGINCHK (2);
+        if ((nrhs != 2) && (nrhs != 3))
+          MEX_FCN_ERR ("cmd[%d]: Invalid number of arguments.\n", cmd_code);
         uint64_t count = 0;
         if (! extract_ui (1, nrhs, prhs, &count) || (count == 0))
           MEX_FCN_ERR ("cmd[%s]: Count must be a positive numeric scalar.\n",
                        "mpfr_t.allocate");
-
-        DBG_PRINTF ("allocate '%d' new MPFR variables\n", (int) count);
+        mpfr_prec_t prec = 0;  // Optional preferred precision, `0` for any.
+        if ((nrhs == 3) && ! extract_prec (2, nrhs, prhs, &prec))
+          MEX_FCN_ERR ("cmd[%s]: Precision must be a numeric scalar between "
+                       "%ld and %ld.\n", "mpfr_t.allocate", MPFR_PREC_MIN,
+                       MPFR_PREC_MAX);
+
+        DBG_PRINTF ("allocate '%d' new MPFR variables (prec = %d)\n",
+                    (int) count, (int) prec);
+        idx_t handle;
         idx_t idx;
-        if (! mex_mpfr_allocate ((size_t) count, &idx))
+        if (! mex_mpfr_allocate ((size_t) count, prec, &handle, &idx))
           MEX_FCN_ERR ("%s\n", "Memory allocation failed.");
-        // Return start and end indices (1-based).
+        // Return start and end handles (1-based).
         plhs[0] = mxCreateNumericMatrix (2, 1, mxDOUBLE_CLASS, mxREAL);
         double *ptr = mxGetPr (plhs[0]);
-        ptr[0] = (double) idx.start;
-        ptr[1] = (double) idx.end;
+        ptr[0] = (double) handle.start;
+        ptr[1] = (double) handle.end;
         return;
       }
 
@@ -87,10 +184,210 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
           return;
 
         MEX_NARGINCHK (2);
-        MEX_MPFR_T (1, idx);
+        idx_t handle;
+        if (! extract_handle (1, nrhs, prhs, &handle))
+          MEX_FCN_ERR ("cmd[%s]: Invalid MPFR variable handles.\n",
+                       "mpfr_t.mark_free");
         DBG_PRINTF ("cmd[mpfr_t.mark_free]: [%d:%d] will be marked as free\n",
-                    idx.start, idx.end);
-        mex_mpfr_mark_free (&idx);
+                    handle.start, handle.end);
+        mex_mpfr_mark_free (&handle);
+        return;
+      }
+
+      case 1905: // void mpfr_t.flush_free (void)
+      {
+        MEX_NARGINCHK (1);
+        mex_mpfr_flush_free ();
+        return;
+      }
+
+      case 1906: // void mpfr_t.compact (void)
+      {
+        MEX_NARGINCHK (1);
+        if (! mex_mpfr_compact ())
+          MEX_FCN_ERR ("%s\n", "Memory allocation failed.");
+        return;
+      }
+
+      case 1907: // struct mpfr_t.get_memory_stats (void)
+      {
+        MEX_NARGINCHK (1);
+        plhs[0] = mex_mpfr_memory_stats ();
+        if (plhs[0] == NULL)
+          MEX_FCN_ERR ("%s\n", "Memory allocation failed.");
+        return;
+      }
+
+      case 1908: // void mpfr_t.tape_begin (void)
+      {
+        MEX_NARGINCHK (1);
+        mex_mpfr_tape_begin ();
+        return;
+      }
+
+      case 1909: // cell mpfr_t.tape_end (void)
+      {
+        MEX_NARGINCHK (1);
+        plhs[0] = mex_mpfr_tape_end ();
+        return;
+      }
+
+      case 1910: // void mpfr_t.tape_run (cell tape, size_t count)
+      {
+        if ((nrhs != 2) && (nrhs != 3))
+          MEX_FCN_ERR ("cmd[%d]: Invalid number of arguments.\n", cmd_code);
+        size_t bad_call = mex_mpfr_tape_check (prhs[1]);
+        if (bad_call > 0)
+          MEX_FCN_ERR ("cmd[%s]: Invalid call %d, tape must be a cell array "
+                       "of cell arrays {cmd_code, args...} with command codes "
+                       "1000 to 1899.\n", "mpfr_t.tape_run", (int) bad_call);
+        uint64_t count = 1;
+        if ((nrhs == 3) && ! extract_ui (2, nrhs, prhs, &count))
+          MEX_FCN_ERR ("cmd[%s]: Count must be a non-negative numeric "
+                       "scalar.\n", "mpfr_t.tape_run");
+        DBG_PRINTF ("cmd[mpfr_t.tape_run]: %d calls, %d times\n",
+                    (int) mxGetNumberOfElements (prhs[1]), (int) count);
+        if (! mex_mpfr_tape_run (prhs[1], (size_t) count))
+          MEX_FCN_ERR ("%s\n", "Memory allocation failed.");
+        return;
+      }
+
+      case 1911: // double[3] mpfr_t.summary (uint64_t cmd_code, args...)
+      {
+        uint64_t code = 0;
+        if ((nrhs < 2) || ! extract_ui (1, nrhs, prhs, &code)
+            || (code < 1000) || (code > 1899))
+          MEX_FCN_ERR ("cmd[%s]: First argument must be a command code "
+                       "1000 to 1899.\n", "mpfr_t.summary");
+        DBG_PRINTF ("cmd[mpfr_t.summary]: cmd[%d]\n", (int) code);
+
+        // Return `[up, down, exact]` instead of all ternary values.  The flag
+        // is reset by `mexFunction` if the call fails.
+        mpfr_ternary_summary = 1;
+        mex_mpfr_interface (nlhs, plhs, nrhs - 1, prhs + 1, code);
+        mpfr_ternary_summary = 0;
+        return;
+      }
+
+      case 1904: // [idx_t, double[3]] mpfr_t.allocate_init (size_t dims[2], mpfr_prec_t prec, mpfr_rnd_t rnd, int fill, src)
+      {
+        if ((nrhs != 5) && (nrhs != 6))
+          MEX_FCN_ERR ("cmd[%d]: Invalid number of arguments.\n", cmd_code);
+        uint64_t *dims = NULL;
+        if ((mxGetM (prhs[1]) * mxGetN (prhs[1]) != 2)
+            || ! extract_ui_vector (1, nrhs, prhs, &dims, 2))
+          MEX_FCN_ERR ("cmd[%s]: Dimensions must be two non-negative "
+                       "integers.\n", "mpfr_t.allocate_init");
+        if ((dims[1] != 0) && (dims[0] > SIZE_MAX / dims[1]))
+          {
+            mxFree (dims);
+            MEX_FCN_ERR ("cmd[%s]: Too many elements.\n",
+                         "mpfr_t.allocate_init");
+          }
+        size_t rows  = (size_t) dims[0];
+        size_t count = (size_t) dims[0] * (size_t) dims[1];
+        mxFree (dims);
+        if (count == 0)
+          MEX_FCN_ERR ("cmd[%s]: Count must be a positive numeric scalar.\n",
+                       "mpfr_t.allocate_init");
+        MEX_MPFR_PREC_T (2, prec);
+        MEX_MPFR_RND_T (3, rnd);
+        int64_t fill = -1;
+        if (! extract_si (4, nrhs, prhs, &fill) || (fill < MPFR_FILL_DOUBLE)
+            || (fill > MPFR_FILL_NAN))
+          MEX_FCN_ERR ("cmd[%s]: Invalid fill value.\n",
+                       "mpfr_t.allocate_init");
+
+        // Check source before allocating.
+        double  *op_pr     = NULL;
+        size_t   op_stride = 0;
+        mpfr_ptr op_ptr    = NULL;
+        if ((fill == MPFR_FILL_DOUBLE) || (fill == MPFR_FILL_MPFR))
+          {
+            if (nrhs != 6)
+              MEX_FCN_ERR ("cmd[%d]: Invalid number of arguments.\n",
+                           cmd_code);
+            if (fill == MPFR_FILL_DOUBLE)
+              {
+                size_t opMN = mxGetM (prhs[5]) * mxGetN (prhs[5]);
+                if (! mxIsDouble (prhs[5]) || ((opMN != count) && (opMN != 1)))
+                  MEX_FCN_ERR ("cmd[%d]:op must be a double-precision matrix "
+                               "of length 1 or %d\n.", cmd_code, count);
+                op_pr     = mxGetPr (prhs[5]);
+                op_stride = (opMN == 1) ? 0 : 1;
+              }
+            else
+              {
+                MEX_MPFR_T (5, op_idx);
+                if (length (&op_idx) != count)
+                  MEX_FCN_ERR ("cmd[%d]:op Invalid size.\n", cmd_code);
+                op_ptr = op_idx_ptr;
+              }
+          }
+
+        DBG_PRINTF ("cmd[mpfr_t.allocate_init]: %d x %d (prec = %d, "
+                    "fill = %d)\n", (int) rows, (int) (count / rows),
+                    (int) prec, (int) fill);
+        idx_t handle;
+        idx_t idx;
+        if (! mex_mpfr_allocate (count, prec, &handle, &idx))
+          MEX_FCN_ERR ("%s\n", "Memory allocation failed.");
+        mpfr_ptr idx_ptr = mex_mpfr_ptr (&idx);
+
+        // Summary of ternary values, see `MEX_MPFR_TERNARY_T`.
+        size_t ternary_up   = 0;
+        size_t ternary_down = 0;
+
+        // Set precision and value in a single pass.
+        int contiguous = mex_mpfr_init2_contiguous (idx_ptr, count, prec);
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, count, prec);
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
+        for (size_t i = 0; i < count; i++)
+          {
+            int ternary = 0;
+            if (! contiguous)
+              mex_mpfr_set_prec (idx_ptr + i, prec);
+            switch (fill)
+              {
+                case MPFR_FILL_DOUBLE:
+                  ternary = mpfr_set_d (idx_ptr + i, op_pr[i * op_stride], rnd);
+                  break;
+                case MPFR_FILL_MPFR:
+                  ternary = mpfr_set (idx_ptr + i, op_ptr + i, rnd);
+                  break;
+                case MPFR_FILL_ZEROS:
+                  mpfr_set_zero (idx_ptr + i, 1);
+                  break;
+                case MPFR_FILL_ONES:
+                  mpfr_set_ui (idx_ptr + i, 1, rnd);
+                  break;
+                case MPFR_FILL_EYE:
+                  mpfr_set_ui (idx_ptr + i, ((i % rows) == (i / rows)), rnd);
+                  break;
+                default:  // MPFR_FILL_NAN, already set by mpfr_set_prec.
+                  break;
+              }
+            if (ternary > 0)
+              ternary_up++;
+            else if (ternary < 0)
+              ternary_down++;
+          }
+
+        // Return start and end handles (1-based).
+        plhs[0] = mxCreateNumericMatrix (2, 1, mxDOUBLE_CLASS, mxREAL);
+        double *ptr = mxGetPr (plhs[0]);
+        ptr[0] = (double) handle.start;
+        ptr[1] = (double) handle.end;
+        if (nlhs > 1)
+          {
+            plhs[1] = mxCreateNumericMatrix (1, 3, mxDOUBLE_CLASS, mxREAL);
+            ptr = mxGetPr (plhs[1]);
+            ptr[0] = (double) ternary_up;
+            ptr[1] = (double) ternary_down;
+            ptr[2] = (double) (count - ternary_up - ternary_down);
+          }
         return;
       }
 
@@ -106,11 +403,15 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         MEX_MPFR_PREC_T (2, prec);
         DBG_PRINTF ("cmd[mpfr_init2]: [%d:%d] (prec = %d)\n",
                     idx.start, idx.end, (int) prec);
-        #pragma omp parallel for
+        if (mex_mpfr_init2_contiguous (idx_ptr, length (&idx), prec))
+          return;
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&idx), prec);
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&idx); i++)
           {
-            mpfr_clear (&mpfr_data[(idx.start - 1) + i]);
-            mpfr_init2 (&mpfr_data[(idx.start - 1) + i], prec);
+            mex_mpfr_clear (idx_ptr + i);
+            mpfr_init2 (idx_ptr + i, prec);
           }
         return;
       }
@@ -120,11 +421,14 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         MEX_NARGINCHK (2);
         MEX_MPFR_T (1, idx);
         DBG_PRINTF ("cmd[mpfr_init]: [%d:%d]\n", idx.start, idx.end);
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&idx),
+                                             mpfr_get_default_prec ());
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&idx); i++)
           {
-            mpfr_clear (&mpfr_data[(idx.start - 1) + i]);
-            mpfr_init (&mpfr_data[(idx.start - 1) + i]);
+            mex_mpfr_clear (idx_ptr + i);
+            mpfr_init (idx_ptr + i);
           }
         return;
       }
@@ -151,9 +455,13 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         MEX_MPFR_PREC_T (2, prec);
         DBG_PRINTF ("cmd[mpfr_set_prec]: [%d:%d] (prec = %d)\n",
                     idx.start, idx.end, (int) prec);
-        #pragma omp parallel for
+        if (mex_mpfr_init2_contiguous (idx_ptr, length (&idx), prec))
+          return;
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&idx), prec);
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&idx); i++)
-          mpfr_set_prec (&mpfr_data[(idx.start - 1) + i], prec);
+          mex_mpfr_set_prec (idx_ptr + i, prec);
         return;
       }
 
@@ -418,9 +726,12 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         mpfr_prec_t (*fcn)(const mpfr_t) = ((cmd_code == 1004) ? mpfr_get_prec
                                             : mpfr_min_prec);
 
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&idx),
+                                             mpfr_get_prec (idx_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&idx); i++)
-          plhs_0_pr[i] = (double) fcn (&mpfr_data[(idx.start - 1) + i]);
+          plhs_0_pr[i] = (double) fcn (idx_ptr + i);
         return;
       }
 
@@ -460,9 +771,12 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         else
           MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
 
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&idx),
+                                             mpfr_get_prec (idx_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&idx); i++)
-          plhs_0_pr[i] = (double) fcn (&mpfr_data[(idx.start - 1) + i]);
+          plhs_0_pr[i] = (double) fcn (idx_ptr + i);
         return;
       }
 
@@ -484,9 +798,12 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         else
           MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
 
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&idx),
+                                             mpfr_get_prec (idx_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&idx); i++)
-          fcn (&mpfr_data[(idx.start - 1) + i]);
+          fcn (idx_ptr + i);
         return;
       }
 
@@ -513,48 +830,61 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         DBG_PRINTF ("cmd[%d]: [%d:%d] (rnd: %d)\n", cmd_code, rop.start,
                     rop.end, (int) rnd);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr    = &mpfr_data[rop.start - 1];
+        MEX_MPFR_TERNARY_T (length (&rop));
         double * op_ptr     = mxGetPr (prhs[2]);
         double * exp_ptr    = mxGetPr (prhs[3]);
-        size_t   ret_stride = (nlhs) ? 1 : 0;
         size_t   op_stride  = ((opM * opN) == 1) ? 0 : 1;
         size_t   exp_stride = ((expM * expN) == 1) ? 0 : 1;
         if (cmd_code == 1007)
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                                 mpfr_get_prec (rop_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1) \
+              reduction(+:ternary_up, ternary_down)
             for (size_t i = 0; i < length (&rop); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_set_ui_2exp (
+              MEX_MPFR_TERNARY_SET (i, mpfr_set_ui_2exp (
                 rop_ptr + i, (unsigned long) op_ptr[i * op_stride],
-                (mpfr_exp_t) exp_ptr[i * exp_stride], rnd);
+                (mpfr_exp_t) exp_ptr[i * exp_stride], rnd));
           }
         else if (cmd_code == 1008)
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                                 mpfr_get_prec (rop_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1) \
+              reduction(+:ternary_up, ternary_down)
             for (size_t i = 0; i < length (&rop); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_set_si_2exp (
+              MEX_MPFR_TERNARY_SET (i, mpfr_set_si_2exp (
                 rop_ptr + i, (long) op_ptr[i * op_stride],
-                (mpfr_exp_t) exp_ptr[i * exp_stride], rnd);
+                (mpfr_exp_t) exp_ptr[i * exp_stride], rnd));
           }
         else if (cmd_code == 1320)
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                                 mpfr_get_prec (rop_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1) \
+              reduction(+:ternary_up, ternary_down)
             for (size_t i = 0; i < length (&rop); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_set_uj_2exp (
+              MEX_MPFR_TERNARY_SET (i, mpfr_set_uj_2exp (
                 rop_ptr + i, (uintmax_t) op_ptr[i * op_stride],
-                (intmax_t) exp_ptr[i * exp_stride], rnd);
+                (intmax_t) exp_ptr[i * exp_stride], rnd));
           }
         else
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                                 mpfr_get_prec (rop_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1) \
+              reduction(+:ternary_up, ternary_down)
             for (size_t i = 0; i < length (&rop); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_set_sj_2exp (
+              MEX_MPFR_TERNARY_SET (i, mpfr_set_sj_2exp (
                 rop_ptr + i, (intmax_t) op_ptr[i * op_stride],
-                (intmax_t) exp_ptr[i * exp_stride], rnd);
+                (intmax_t) exp_ptr[i * exp_stride], rnd));
           }
 
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -607,7 +937,7 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
                   }
                 char *endptr = NULL;
                 ret_ptr[i * ret_stride] = (double) mpfr_strtofr (
-                  &mpfr_data[(idx.start - 1) + i], str, &endptr,
+                  idx_ptr + i, str, &endptr,
                   (int) base_ptr[i * base_stride], rnd);
                 end_ptr[i * end_ptr_stride] = (endptr == NULL)
                                               ? -1.0
@@ -626,10 +956,10 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
                     mxFree (str);
                     str = mxArrayToString (mxGetCell (prhs[2], i * str_stride));
                   }
-                if (cmd_code == 1009)
-                  mpfr_clear (&mpfr_data[(idx.start - 1) + i]);
+                if (cmd_code == 1016)
+                  mex_mpfr_clear (idx_ptr + i);
                 ret_ptr[i * ret_stride] = (double) fcn (
-                  &mpfr_data[(idx.start - 1) + i], str,
+                  idx_ptr + i, str,
                   (int) base_ptr[i * base_stride], rnd);
               }
           }
@@ -656,9 +986,12 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         double *sign_ptr    = mxGetPr (prhs[2]);
         size_t  sign_stride = ((signM * signN) == 1) ? 0 : 1;
 
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&idx),
+                                             mpfr_get_prec (idx_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&idx); i++)
-          fcn (&mpfr_data[(idx.start - 1) + i],
+          fcn (idx_ptr + i,
                (int) sign_ptr[i * sign_stride]);
         return;
       }
@@ -676,17 +1009,23 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
 
         if (cmd_code == 1013)
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&x),
+                                                 mpfr_get_prec (x_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1)
             for (size_t i = 0; i < length (&x); i++)
-              mpfr_swap (&mpfr_data[x.start - 1 + i],
-                         &mpfr_data[y.start - 1 + i]);
+              mpfr_swap (x_ptr + i,
+                         y_ptr + i);
           }
         else
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&x),
+                                                 mpfr_get_prec (x_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1)
             for (size_t i = 0; i < length (&x); i++)
-              mpfr_nexttoward (&mpfr_data[x.start - 1 + i],
-                               &mpfr_data[y.start - 1 + i]);
+              mpfr_nexttoward (x_ptr + i,
+                               y_ptr + i);
           }
         return;
       }
@@ -702,19 +1041,20 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         DBG_PRINTF ("cmd[%d]: rop = [%d:%d], op = [%d:%d] (rnd = %d)\n",
                     cmd_code, rop.start, rop.end, op.start, op.end, (int) rnd);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double *ret_ptr    = mxGetPr (plhs[0]);
-        size_t  ret_stride = (nlhs) ? 1 : 0;
+        MEX_MPFR_TERNARY_T (length (&rop));
 
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                             mpfr_get_default_prec ());
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&rop); i++)
           {
-            mpfr_clear (&mpfr_data[(rop.start - 1) + i]);
-            ret_ptr[i * ret_stride] = (double) mpfr_init_set (
-              &mpfr_data[(rop.start - 1) + i], &mpfr_data[(op.start - 1) + i],
-              rnd);
+            mex_mpfr_clear (rop_ptr + i);
+            MEX_MPFR_TERNARY_SET (i, mpfr_init_set (rop_ptr + i, op_ptr + i,
+                                                    rnd));
           }
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -740,10 +1080,13 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         plhs[0] = mxCreateNumericMatrix (length (&op), 1, mxDOUBLE_CLASS,
                                          mxREAL);
         double *ret_ptr = mxGetPr (plhs[0]);
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&op),
+                                             mpfr_get_prec (op_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&op); i++)
           ret_ptr[i] =
-            (double) mpfr_get_d (&mpfr_data[(op.start - 1) + i], rnd);
+            (double) mpfr_get_d (op_ptr + i, rnd);
         return;
       }
 
@@ -762,12 +1105,15 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
                                          mxREAL);
         double *ret_ptr = mxGetPr (plhs[0]);
         double *exp_ptr = mxGetPr (plhs[1]);
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&op),
+                                             mpfr_get_prec (op_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&op); i++)
           {
             long exp = 0;
             ret_ptr[i] = (double) mpfr_get_d_2exp (&exp,
-                                                   &mpfr_data[(op.start - 1) + i],
+                                                   op_ptr + i,
                                                    rnd);
             exp_ptr[i] = (double) exp;
           }
@@ -793,13 +1139,16 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
                                          mxREAL);
         double *ret_ptr = mxGetPr (plhs[0]);
         double *exp_ptr = mxGetPr (plhs[1]);
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&y),
+                                             mpfr_get_prec (y_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&y); i++)
           {
             mpfr_exp_t exp = 0;
             ret_ptr[i] = (double) mpfr_frexp (&exp,
-                                              &mpfr_data[(y.start - 1) + i],
-                                              &mpfr_data[(x.start - 1) + i],
+                                              y_ptr + i,
+                                              x_ptr + i,
                                               rnd);
             exp_ptr[i] = (double) exp;
           }
@@ -832,7 +1181,10 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         size_t  op1_stride = (op1Dim == 1) ? 0 : 1;
         size_t  op2_stride = (op2Dim == 1) ? 0 : 1;
 
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, MAX (op1Dim, op2Dim),
+                                             mpfr_get_default_prec ());
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < MAX (op1Dim, op2Dim); i++)
           ret_ptr[i] = (double) mpfr_get_str_ndigits (
             (int) op1_ptr[i * op1_stride],
@@ -869,30 +1221,37 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         MEX_MPFR_RND_T (3, rnd);
         DBG_PRINTF ("cmd[%d]: [%d:%d]\n", cmd_code, rop.start, rop.end);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double *ret_ptr    = mxGetPr (plhs[0]);
-        double *op_pr      = mxGetPr (prhs[2]);
-        size_t  ret_stride = (nlhs) ? 1 : 0;
-        size_t  op_stride  = ((opM * opN) == 1) ? 0 : 1;
+        MEX_MPFR_TERNARY_T (length (&rop));
+        double *op_pr     = mxGetPr (prhs[2]);
+        size_t  op_stride = ((opM * opN) == 1) ? 0 : 1;
 
         if (cmd_code < 1310)
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                                 mpfr_get_prec (rop_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1) \
+              reduction(+:ternary_up, ternary_down)
             for (size_t i = 0; i < length (&rop); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_set_d (
-                &mpfr_data[(rop.start - 1) + i], op_pr[i * op_stride], rnd);
+              MEX_MPFR_TERNARY_SET (i, mpfr_set_d (rop_ptr + i,
+                                                   op_pr[i * op_stride], rnd));
           }
         else
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                                 mpfr_get_default_prec ());
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1) \
+              reduction(+:ternary_up, ternary_down)
             for (size_t i = 0; i < length (&rop); i++)
               {
-                mpfr_clear (&mpfr_data[(rop.start - 1) + i]);
-                ret_ptr[i * ret_stride] = (double) mpfr_init_set_d (
-                  &mpfr_data[(rop.start - 1) + i], op_pr[i * op_stride], rnd);
+                mex_mpfr_clear (rop_ptr + i);
+                MEX_MPFR_TERNARY_SET (i, mpfr_init_set_d (rop_ptr + i,
+                                                          op_pr[i * op_stride],
+                                                          rnd));
               }
           }
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -932,7 +1291,7 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
             char *     str    = mpfr_get_str (NULL, &expptr,
                                               (int) base_ptr[i * base_stride],
                                               (size_t) nSig_ptr[i * nSig_stride],
-                                              &mpfr_data[(op.start - 1) + i],
+                                              op_ptr + i,
                                               rnd);
             if (str != NULL)
               {
@@ -988,9 +1347,12 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         plhs[0] = mxCreateNumericMatrix (length (&op), 1, mxDOUBLE_CLASS,
                                          mxREAL);
         double *ret_ptr = mxGetPr (plhs[0]);
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&op),
+                                             mpfr_get_prec (op_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&op); i++)
-          ret_ptr[i] = (double) fcn (&mpfr_data[(op.start - 1) + i], rnd);
+          ret_ptr[i] = (double) fcn (op_ptr + i, rnd);
         return;
       }
 
@@ -1061,21 +1423,20 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
           fcn = mpfr_copysign;
         else
           MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
+        fcn = mex_mpfr_fixed_op2 (cmd_code, mpfr_get_prec (rop_ptr), fcn);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr    = &mpfr_data[rop.start - 1];
-        mpfr_ptr op1_ptr    = &mpfr_data[op1.start - 1];
-        mpfr_ptr op2_ptr    = &mpfr_data[op2.start - 1];
-        size_t   ret_stride = (nlhs) ? 1 : 0;
+        MEX_MPFR_TERNARY_T (length (&rop));
         size_t   op1_stride = (length (&op1) == 1) ? 0 : 1;
         size_t   op2_stride = (length (&op2) == 1) ? 0 : 1;
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                             mpfr_get_prec (rop_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&rop); i++)
-          ret_ptr[i * ret_stride] =
-            (double) fcn (rop_ptr + i, op1_ptr + (i * op1_stride),
-                          op2_ptr + (i * op2_stride), rnd);
+          MEX_MPFR_TERNARY_SET (i, fcn (rop_ptr + i, op1_ptr + (i * op1_stride),
+                                        op2_ptr + (i * op2_stride), rnd));
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -1110,19 +1471,17 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         else
           MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&sop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr sop_ptr    = &mpfr_data[sop.start - 1];
-        mpfr_ptr cop_ptr    = &mpfr_data[cop.start - 1];
-        mpfr_ptr op_ptr     = &mpfr_data[op.start - 1];
-        size_t   ret_stride = (nlhs) ? 1 : 0;
-        size_t   op_stride  = (length (&op) == 1) ? 0 : 1;
-        #pragma omp parallel for
+        MEX_MPFR_TERNARY_T (length (&sop));
+        size_t   op_stride = (length (&op) == 1) ? 0 : 1;
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&sop),
+                                             mpfr_get_prec (sop_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&sop); i++)
-          ret_ptr[i * ret_stride] = (double) fcn (sop_ptr + i, cop_ptr + i,
-                                                  op_ptr + (i * op_stride),
-                                                  rnd);
+          MEX_MPFR_TERNARY_SET (i, fcn (sop_ptr + i, cop_ptr + i,
+                                        op_ptr + (i * op_stride), rnd));
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -1169,19 +1528,18 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         else
           MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr    = &mpfr_data[rop.start - 1];
-        mpfr_ptr op1_ptr    = &mpfr_data[op1.start - 1];
+        MEX_MPFR_TERNARY_T (length (&rop));
         double * op2_ptr    = mxGetPr (prhs[3]);
-        size_t   ret_stride = (nlhs) ? 1 : 0;
         size_t   op2_stride = ((op2M * op2N) == 1) ? 0 : 1;
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                             mpfr_get_prec (rop_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&rop); i++)
-          ret_ptr[i * ret_stride] =
-            (double) fcn (rop_ptr + i, op1_ptr + i, op2_ptr[i * op2_stride],
-                          rnd);
+          MEX_MPFR_TERNARY_SET (i, fcn (rop_ptr + i, op1_ptr + i,
+                                        op2_ptr[i * op2_stride], rnd));
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -1211,75 +1569,79 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
                     "(rnd = %d)\n", cmd_code, rop.start, rop.end, op1M, op1N,
                     op2.start, op2.end, (int) rnd);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr    = &mpfr_data[rop.start - 1];
+        MEX_MPFR_TERNARY_T (length (&rop));
         double * op1_ptr    = mxGetPr (prhs[2]);
-        mpfr_ptr op2_ptr    = &mpfr_data[op2.start - 1];
-        size_t   ret_stride = (nlhs) ? 1 : 0;
         size_t   op1_stride = ((op1M * op1N) == 1) ? 0 : 1;
         size_t   op2_stride = (length (&op2) == 1) ? 0 : 1;
         if ((1343 <= cmd_code) && (cmd_code <= 1345))
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                                 mpfr_get_prec (rop_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1) \
+              reduction(+:ternary_up, ternary_down)
             for (size_t i = 0; i < length (&rop); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_d_sub (rop_ptr + i,
-                                                             op1_ptr[i *
-                                                                     op1_stride],
-                                                             op2_ptr +
-                                                             (i * op2_stride),
-                                                             rnd);
+              MEX_MPFR_TERNARY_SET (i, mpfr_d_sub (rop_ptr + i,
+                                                   op1_ptr[i * op1_stride],
+                                                   op2_ptr + (i * op2_stride),
+                                                   rnd));
           }
         else if ((1363 <= cmd_code) && (cmd_code <= 1365))
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                                 mpfr_get_prec (rop_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1) \
+              reduction(+:ternary_up, ternary_down)
             for (size_t i = 0; i < length (&rop); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_d_div (rop_ptr + i,
-                                                             op1_ptr[i *
-                                                                     op1_stride],
-                                                             op2_ptr +
-                                                             (i * op2_stride),
-                                                             rnd);
+              MEX_MPFR_TERNARY_SET (i, mpfr_d_div (rop_ptr + i,
+                                                   op1_ptr[i * op1_stride],
+                                                   op2_ptr + (i * op2_stride),
+                                                   rnd));
           }
         else if (cmd_code == 1097)
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                                 mpfr_get_prec (rop_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1) \
+              reduction(+:ternary_up, ternary_down)
             for (size_t i = 0; i < length (&rop); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_ui_pow (rop_ptr + i,
-                                                              (unsigned long int) op1_ptr[
-                                                                i * op1_stride],
-                                                              op2_ptr +
-                                                              (i * op2_stride),
-                                                              rnd);
+              MEX_MPFR_TERNARY_SET (i, mpfr_ui_pow (
+                rop_ptr + i, (unsigned long int) op1_ptr[i * op1_stride],
+                op2_ptr + (i * op2_stride), rnd));
           }
         else if (cmd_code == 1133)
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                                 mpfr_get_prec (rop_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1) \
+              reduction(+:ternary_up, ternary_down)
             for (size_t i = 0; i < length (&rop); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_jn (rop_ptr + i,
-                                                          (long) op1_ptr[i *
-                                                                         op1_stride],
-                                                          op2_ptr +
-                                                          (i * op2_stride),
-                                                          rnd);
+              MEX_MPFR_TERNARY_SET (i, mpfr_jn (rop_ptr + i,
+                                                (long) op1_ptr[i * op1_stride],
+                                                op2_ptr + (i * op2_stride),
+                                                rnd));
           }
         else if (cmd_code == 1136)
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                                 mpfr_get_prec (rop_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1) \
+              reduction(+:ternary_up, ternary_down)
             for (size_t i = 0; i < length (&rop); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_yn (rop_ptr + i,
-                                                          (long) op1_ptr[i *
-                                                                         op1_stride],
-                                                          op2_ptr +
-                                                          (i * op2_stride),
-                                                          rnd);
+              MEX_MPFR_TERNARY_SET (i, mpfr_yn (rop_ptr + i,
+                                                (long) op1_ptr[i * op1_stride],
+                                                op2_ptr + (i * op2_stride),
+                                                rnd));
           }
         else
           {
-            mxFree (plhs[0]);
             MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
           }
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -1302,23 +1664,21 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
                     "(rnd = %d)\n", cmd_code, rop.start, rop.end, op1M, op1N,
                     op2M, op2N, (int) rnd);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr    = &mpfr_data[rop.start - 1];
+        MEX_MPFR_TERNARY_T (length (&rop));
         double * op1_ptr    = mxGetPr (prhs[2]);
         double * op2_ptr    = mxGetPr (prhs[3]);
-        size_t   ret_stride = (nlhs) ? 1 : 0;
         size_t   op1_stride = ((op1M * op1N) == 1) ? 0 : 1;
         size_t   op2_stride = ((op2M * op2N) == 1) ? 0 : 1;
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                             mpfr_get_prec (rop_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&rop); i++)
-          ret_ptr[i * ret_stride] = (double) mpfr_ui_pow_ui (rop_ptr + i,
-                                                             (unsigned long int) op1_ptr[
-                                                               i * op1_stride],
-                                                             (unsigned long int) op2_ptr[
-                                                               i * op2_stride],
-                                                             rnd);
+          MEX_MPFR_TERNARY_SET (i, mpfr_ui_pow_ui (
+            rop_ptr + i, (unsigned long int) op1_ptr[i * op1_stride],
+            (unsigned long int) op2_ptr[i * op2_stride], rnd));
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -1493,15 +1853,15 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         else
           MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr    = &mpfr_data[rop.start - 1];
-        mpfr_ptr op_ptr     = &mpfr_data[op.start - 1];
-        size_t   ret_stride = (nlhs) ? 1 : 0;
-        #pragma omp parallel for
+        MEX_MPFR_TERNARY_T (length (&rop));
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                             mpfr_get_prec (rop_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&rop); i++)
-          ret_ptr[i * ret_stride] = (double) fcn (rop_ptr + i, op_ptr + i, rnd);
+          MEX_MPFR_TERNARY_SET (i, fcn (rop_ptr + i, op_ptr + i, rnd));
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -1533,20 +1893,19 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         else
           MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr    = &mpfr_data[rop.start - 1];
-        double * op_ptr     = mxGetPr (prhs[2]);
-        size_t   ret_stride = (nlhs) ? 1 : 0;
-        size_t   op_stride  = ((opM * opN) == 1) ? 0 : 1;
-        #pragma omp parallel for
+        MEX_MPFR_TERNARY_T (length (&rop));
+        double * op_ptr    = mxGetPr (prhs[2]);
+        size_t   op_stride = ((opM * opN) == 1) ? 0 : 1;
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                             mpfr_get_prec (rop_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&rop); i++)
-          ret_ptr[i * ret_stride] = (double) fcn (rop_ptr + i,
-                                                  (unsigned long int) op_ptr[i *
-                                                                             op_stride],
-                                                  rnd);
+          MEX_MPFR_TERNARY_SET (i, fcn (
+            rop_ptr + i, (unsigned long int) op_ptr[i * op_stride], rnd));
 
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -1582,24 +1941,21 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         else
           MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr    = &mpfr_data[rop.start - 1];
-        mpfr_ptr op1_ptr    = &mpfr_data[op1.start - 1];
+        MEX_MPFR_TERNARY_T (length (&rop));
         double * op2_ptr    = mxGetPr (prhs[3]);
-        size_t   ret_stride = (nlhs) ? 1 : 0;
         size_t   op1_stride = (length (&op1) == 1) ? 0 : 1;
         size_t   op2_stride = ((op2M * op2N) == 1) ? 0 : 1;
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                             mpfr_get_prec (rop_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&rop); i++)
-          ret_ptr[i * ret_stride] = (double) fcn (rop_ptr + i,
-                                                  op1_ptr + (i * op1_stride),
-                                                  (unsigned long int) op2_ptr[i
-                                                                              *
-                                                                              op2_stride],
-                                                  rnd);
+          MEX_MPFR_TERNARY_SET (i, fcn (
+            rop_ptr + i, op1_ptr + (i * op1_stride),
+            (unsigned long int) op2_ptr[i * op2_stride], rnd));
 
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -1632,23 +1988,21 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         else
           MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr    = &mpfr_data[rop.start - 1];
-        mpfr_ptr op1_ptr    = &mpfr_data[op1.start - 1];
+        MEX_MPFR_TERNARY_T (length (&rop));
         double * op2_ptr    = mxGetPr (prhs[3]);
-        size_t   ret_stride = (nlhs) ? 1 : 0;
         size_t   op1_stride = (length (&op1) == 1) ? 0 : 1;
         size_t   op2_stride = ((op2M * op2N) == 1) ? 0 : 1;
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                             mpfr_get_prec (rop_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&rop); i++)
-          ret_ptr[i * ret_stride] = (double) fcn (rop_ptr + i,
-                                                  op1_ptr + (i * op1_stride),
-                                                  (long int) op2_ptr[i *
-                                                                     op2_stride],
-                                                  rnd);
+          MEX_MPFR_TERNARY_SET (i, fcn (rop_ptr + i, op1_ptr + (i * op1_stride),
+                                        (long int) op2_ptr[i * op2_stride],
+                                        rnd));
 
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -1673,25 +2027,18 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
                     "(rnd = %d)\n", cmd_code, rop.start, rop.end,
                     op1.start, op1.end, op2M, op2N, (int) rnd);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr    = &mpfr_data[rop.start - 1];
-        mpfr_ptr op1_ptr    = &mpfr_data[op1.start - 1];
+        MEX_MPFR_TERNARY_T (length (&rop));
         double * op2_ptr    = mxGetPr (prhs[3]);
-        size_t   ret_stride = (nlhs) ? 1 : 0;
         size_t   op1_stride = (length (&op1) == 1) ? 0 : 1;
         size_t   op2_stride = ((op2M * op2N) == 1) ? 0 : 1;
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
         for (size_t i = 0; i < length (&rop); i++)
-          ret_ptr[i * ret_stride] = (double) mpfr_root (rop_ptr + i,
-                                                        op1_ptr +
-                                                        (i * op1_stride),
-                                                        (unsigned long int) op2_ptr[
-                                                          i * op2_stride],
-                                                        rnd);
+          MEX_MPFR_TERNARY_SET (i, mpfr_root (
+            rop_ptr + i, op1_ptr + (i * op1_stride),
+            (unsigned long int) op2_ptr[i * op2_stride], rnd));
         #pragma GCC diagnostic pop
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -1718,25 +2065,22 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         int (*fcn)(mpfr_t, const mpfr_t, const mpfr_t,
                    const mpfr_t, mpfr_rnd_t) = ((cmd_code == 1056) ? mpfr_fma
                                                 : mpfr_fms);
+        fcn = mex_mpfr_fixed_op3 (cmd_code, mpfr_get_prec (rop_ptr), fcn);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr    = &mpfr_data[rop.start - 1];
-        mpfr_ptr op1_ptr    = &mpfr_data[op1.start - 1];
-        mpfr_ptr op2_ptr    = &mpfr_data[op2.start - 1];
-        mpfr_ptr op3_ptr    = &mpfr_data[op3.start - 1];
-        size_t   ret_stride = (nlhs) ? 1 : 0;
+        MEX_MPFR_TERNARY_T (length (&rop));
         size_t   op1_stride = (length (&op1) == 1) ? 0 : 1;
         size_t   op2_stride = (length (&op2) == 1) ? 0 : 1;
         size_t   op3_stride = (length (&op3) == 1) ? 0 : 1;
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                             mpfr_get_prec (rop_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&rop); i++)
-          ret_ptr[i * ret_stride] = (double) fcn (rop_ptr + i,
-                                                  op1_ptr + (i * op1_stride),
-                                                  op2_ptr + (i * op2_stride),
-                                                  op3_ptr + (i * op3_stride),
-                                                  rnd);
+          MEX_MPFR_TERNARY_SET (i, fcn (rop_ptr + i, op1_ptr + (i * op1_stride),
+                                        op2_ptr + (i * op2_stride),
+                                        op3_ptr + (i * op3_stride), rnd));
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -1767,27 +2111,22 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
                    const mpfr_t, mpfr_rnd_t) = ((cmd_code == 1058) ? mpfr_fmma
                                                 : mpfr_fmms);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr    = &mpfr_data[rop.start - 1];
-        mpfr_ptr op1_ptr    = &mpfr_data[op1.start - 1];
-        mpfr_ptr op2_ptr    = &mpfr_data[op2.start - 1];
-        mpfr_ptr op3_ptr    = &mpfr_data[op3.start - 1];
-        mpfr_ptr op4_ptr    = &mpfr_data[op4.start - 1];
-        size_t   ret_stride = (nlhs) ? 1 : 0;
+        MEX_MPFR_TERNARY_T (length (&rop));
         size_t   op1_stride = (length (&op1) == 1) ? 0 : 1;
         size_t   op2_stride = (length (&op2) == 1) ? 0 : 1;
         size_t   op3_stride = (length (&op3) == 1) ? 0 : 1;
         size_t   op4_stride = (length (&op4) == 1) ? 0 : 1;
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                             mpfr_get_prec (rop_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&rop); i++)
-          ret_ptr[i * ret_stride] = (double) fcn (rop_ptr + i,
-                                                  op1_ptr + (i * op1_stride),
-                                                  op2_ptr + (i * op2_stride),
-                                                  op3_ptr + (i * op3_stride),
-                                                  op4_ptr + (i * op4_stride),
-                                                  rnd);
+          MEX_MPFR_TERNARY_SET (i, fcn (rop_ptr + i, op1_ptr + (i * op1_stride),
+                                        op2_ptr + (i * op2_stride),
+                                        op3_ptr + (i * op3_stride),
+                                        op4_ptr + (i * op4_stride), rnd));
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -1813,15 +2152,13 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
 
         plhs[0] = mxCreateNumericMatrix (1, 1, mxDOUBLE_CLASS, mxREAL);
         double * ret_ptr = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr = &mpfr_data[rop.start - 1];
 
-        mpfr_ptr *tab_ptr = (mpfr_ptr *) mxMalloc (n * sizeof(mpfr_ptr *));
-        #pragma omp parallel for
+        mpfr_ptr *tab_vec = (mpfr_ptr *) mxMalloc (n * sizeof(mpfr_ptr *));
         for (size_t i = 0; i < n; i++)
-          tab_ptr[i] = mpfr_data + tab.start - 1 + i;
+          tab_vec[i] = tab_ptr + i;
 
-        *ret_ptr = (double) mpfr_sum (rop_ptr, tab_ptr, n, rnd);
-        mxFree (tab_ptr);
+        *ret_ptr = (double) mpfr_sum (rop_ptr, tab_vec, n, rnd);
+        mxFree (tab_vec);
         return;
       }
 
@@ -1852,20 +2189,18 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
 
         plhs[0] = mxCreateNumericMatrix (1, 1, mxDOUBLE_CLASS, mxREAL);
         double * ret_ptr = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr = &mpfr_data[rop.start - 1];
 
-        mpfr_ptr *a_ptr = (mpfr_ptr *) mxMalloc (n * sizeof(mpfr_ptr *));
-        mpfr_ptr *b_ptr = (mpfr_ptr *) mxMalloc (n * sizeof(mpfr_ptr *));
-        #pragma omp parallel for
+        mpfr_ptr *a_vec = (mpfr_ptr *) mxMalloc (n * sizeof(mpfr_ptr *));
+        mpfr_ptr *b_vec = (mpfr_ptr *) mxMalloc (n * sizeof(mpfr_ptr *));
         for (size_t i = 0; i < n; i++)
           {
-            a_ptr[i] = mpfr_data + a.start - 1 + i;
-            b_ptr[i] = mpfr_data + b.start - 1 + i;
+            a_vec[i] = a_ptr + i;
+            b_vec[i] = b_ptr + i;
           }
 
-        *ret_ptr = (double) mpfr_dot (rop_ptr, a_ptr, b_ptr, n, rnd);
-        mxFree (a_ptr);
-        mxFree (b_ptr);
+        *ret_ptr = (double) mpfr_dot (rop_ptr, a_vec, b_vec, n, rnd);
+        mxFree (a_vec);
+        mxFree (b_vec);
         #endif
         return;
       }
@@ -1921,20 +2256,19 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         else
           MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs
-                                         ? MAX (length (&op1), length (&op2))
-                                         : 1,
-                                         1, mxDOUBLE_CLASS, mxREAL);
+        plhs[0] = mxCreateNumericMatrix (MAX (length (&op1), length (&op2)), 1,
+                                         mxDOUBLE_CLASS, mxREAL);
         double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr op1_ptr    = &mpfr_data[op1.start - 1];
-        mpfr_ptr op2_ptr    = &mpfr_data[op2.start - 1];
-        size_t   ret_stride = (nlhs) ? 1 : 0;
         size_t   op1_stride = (length (&op1) == 1) ? 0 : 1;
         size_t   op2_stride = (length (&op2) == 1) ? 0 : 1;
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code,
+                                             MAX (length (&op1), length (&op2)),
+                                             mpfr_get_prec (op1_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < MAX (length (&op1), length (&op2)); i++)
-          ret_ptr[i * ret_stride] = (double) fcn (op1_ptr + (i * op1_stride),
-                                                  op2_ptr + (i * op2_stride));
+          ret_ptr[i] = (double) fcn (op1_ptr + (i * op1_stride),
+                                     op2_ptr + (i * op2_stride));
         return;
       }
 
@@ -1954,55 +2288,71 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         DBG_PRINTF ("cmd[%d]: op1 = [%d:%d] , op2 = [%d x %d]\n", cmd_code,
                     op1.start, op1.end, op2M, op2N);
 
-        plhs[0] = mxCreateNumericMatrix (
-          (nlhs ? MAX (length (&op1), (op2M * op2N)) : 1), 1, mxDOUBLE_CLASS,
-          mxREAL);
+        plhs[0] = mxCreateNumericMatrix (MAX (length (&op1), (op2M * op2N)), 1,
+                                         mxDOUBLE_CLASS, mxREAL);
         double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr op1_ptr    = &mpfr_data[op1.start - 1];
         double * op2_ptr    = mxGetPr (prhs[2]);
-        size_t   ret_stride = (nlhs) ? 1 : 0;
         size_t   op1_stride = (length (&op1) == 1) ? 0 : 1;
         size_t   op2_stride = ((op2M * op2N) == 1) ? 0 : 1;
         if (cmd_code == 1064)
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (
+              cmd_code, MAX (length (&op1), (op2M * op2N)),
+              mpfr_get_prec (op1_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1)
             for (size_t i = 0; i < MAX (length (&op1), (op2M * op2N)); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_cmp_d (
+              ret_ptr[i] = (double) mpfr_cmp_d (
                 op1_ptr + (i * op1_stride), op2_ptr[i * op2_stride]);
           }
         else if (cmd_code == 1034)
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (
+              cmd_code, MAX (length (&op1), (op2M * op2N)),
+              mpfr_get_prec (op1_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1)
             for (size_t i = 0; i < MAX (length (&op1), (op2M * op2N)); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_cmp_ui (
+              ret_ptr[i] = (double) mpfr_cmp_ui (
                 op1_ptr + (i * op1_stride),
                 (unsigned long) op2_ptr[i * op2_stride]);
           }
         else if (cmd_code == 1037)
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (
+              cmd_code, MAX (length (&op1), (op2M * op2N)),
+              mpfr_get_prec (op1_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1)
             for (size_t i = 0; i < MAX (length (&op1), (op2M * op2N)); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_cmp_si (
+              ret_ptr[i] = (double) mpfr_cmp_si (
                 op1_ptr + (i * op1_stride), (long) op2_ptr[i * op2_stride]);
           }
         else if (cmd_code == 1035)
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (
+              cmd_code, MAX (length (&op1), (op2M * op2N)),
+              mpfr_get_prec (op1_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1)
             for (size_t i = 0; i < MAX (length (&op1), (op2M * op2N)); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_cmp_si (
+              ret_ptr[i] = (double) mpfr_cmp_si (
                 op1_ptr + (i * op1_stride),
                 (long double) op2_ptr[i * op2_stride]);
           }
         else
           {
           #if (MPFR_VERSION < MPFR_VERSION_NUM (4, 1, 0))
-            mxFree (plhs[0]);
             MEX_FCN_ERR ("cmd[%d]: Not supported in MPFR %s.\n",
                          cmd_code, MPFR_VERSION_STRING);
           #else
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (
+              cmd_code, MAX (length (&op1), (op2M * op2N)),
+              mpfr_get_prec (op1_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1)
             for (size_t i = 0; i < MAX (length (&op1), (op2M * op2N)); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_cmpabs_ui (
+              ret_ptr[i] = (double) mpfr_cmpabs_ui (
                 op1_ptr + (i * op1_stride),
                 (unsigned long) op2_ptr[i * op2_stride]);
           #endif
@@ -2024,28 +2374,33 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         DBG_PRINTF ("cmd[%d]: op1 = [%d:%d] , op2 = [%d x %d]\n", cmd_code,
                     op1.start, op1.end, op2M, op2N);
 
-        plhs[0] = mxCreateNumericMatrix (
-          (nlhs ? MAX (length (&op1), (op2M * op2N)) : 1), 1, mxDOUBLE_CLASS,
-          mxREAL);
+        plhs[0] = mxCreateNumericMatrix (MAX (length (&op1), (op2M * op2N)), 1,
+                                         mxDOUBLE_CLASS, mxREAL);
         double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr op1_ptr    = &mpfr_data[op1.start - 1];
         double * op2_ptr    = mxGetPr (prhs[2]);
-        size_t   ret_stride = (nlhs) ? 1 : 0;
         size_t   op1_stride = (length (&op1) == 1) ? 0 : 1;
         size_t   op2_stride = ((op2M * op2N) == 1) ? 0 : 1;
         if (cmd_code == 1065)
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (
+              cmd_code, MAX (length (&op1), (op2M * op2N)),
+              mpfr_get_prec (op1_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1)
             for (size_t i = 0; i < MAX (length (&op1), (op2M * op2N)); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_cmp_ui_2exp (
+              ret_ptr[i] = (double) mpfr_cmp_ui_2exp (
                 op1_ptr + (i * op1_stride),
                 (unsigned long int) op2_ptr[i * op2_stride], e);
           }
         else
           {
-            #pragma omp parallel for
+            omp_threads = mex_mpfr_omp_schedule (
+              cmd_code, MAX (length (&op1), (op2M * op2N)),
+              mpfr_get_prec (op1_ptr));
+            #pragma omp parallel for schedule(runtime) \
+              num_threads (omp_threads) if (omp_threads > 1)
             for (size_t i = 0; i < MAX (length (&op1), (op2M * op2N)); i++)
-              ret_ptr[i * ret_stride] = (double) mpfr_cmp_si_2exp (
+              ret_ptr[i] = (double) mpfr_cmp_si_2exp (
                 op1_ptr + (i * op1_stride), (long int) op2_ptr[i * op2_stride],
                 e);
           }
@@ -2069,10 +2424,11 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
                                          mxREAL);
         double * ret_ptr   = mxGetPr (plhs[0]);
         double * signp_ptr = mxGetPr (plhs[1]);
-        mpfr_ptr rop_ptr   = &mpfr_data[rop.start - 1];
-        mpfr_ptr op_ptr    = &mpfr_data[op.start - 1];
         size_t   op_stride = (length (&op) == 1) ? 0 : 1;
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                             mpfr_get_prec (rop_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&rop); i++)
           {
             int signp = 0;
@@ -2106,15 +2462,16 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         else
           MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double *ret_ptr    = mxGetPr (plhs[0]);
-        size_t  ret_stride = (nlhs) ? 1 : 0;
+        MEX_MPFR_TERNARY_T (length (&rop));
 
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                             mpfr_get_prec (rop_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&rop); i++)
-          ret_ptr[i * ret_stride] = (double) fcn (&mpfr_data[rop.start - 1 + i],
-                                                  rnd);
+          MEX_MPFR_TERNARY_SET (i, fcn (rop_ptr + i, rnd));
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -2146,15 +2503,16 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         else
           MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double *ret_ptr    = mxGetPr (plhs[0]);
-        size_t  ret_stride = (nlhs) ? 1 : 0;
+        MEX_MPFR_TERNARY_T (length (&rop));
 
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                             mpfr_get_prec (rop_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&rop); i++)
-          ret_ptr[i * ret_stride] = (double) fcn (&mpfr_data[rop.start - 1 + i],
-                                                  &mpfr_data[op.start - 1 + i]);
+          MEX_MPFR_TERNARY_SET (i, fcn (rop_ptr + i, op_ptr + i));
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -2182,28 +2540,31 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         else
           MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&r) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        plhs[1] = mxCreateNumericMatrix (nlhs ? length (&r) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        double * q_ptr      = mxGetPr (plhs[1]);
-        mpfr_ptr r_ptr      = &mpfr_data[r.start - 1];
-        mpfr_ptr x_ptr      = &mpfr_data[x.start - 1];
-        mpfr_ptr y_ptr      = &mpfr_data[y.start - 1];
-        size_t   ret_stride = (nlhs) ? 1 : 0;
-        size_t   x_stride   = (length (&x) == 1) ? 0 : 1;
-        size_t   y_stride   = (length (&y) == 1) ? 0 : 1;
-        #pragma omp parallel for
-        for (size_t i = 0; i < length (&x); i++)
+        MEX_MPFR_TERNARY_T (length (&r));
+        double *q_ptr = NULL;
+        if (nlhs > 1)
+          {
+            plhs[1] = mxCreateNumericMatrix (length (&r), 1, mxDOUBLE_CLASS,
+                                             mxREAL);
+            q_ptr = mxGetPr (plhs[1]);
+          }
+        size_t x_stride = (length (&x) == 1) ? 0 : 1;
+        size_t y_stride = (length (&y) == 1) ? 0 : 1;
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&r),
+                                             mpfr_get_prec (r_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
+        for (size_t i = 0; i < length (&r); i++)
           {
             long q;
-            ret_ptr[i * ret_stride] = (double) fcn (r_ptr + i, &q,
-                                                    x_ptr + (i * x_stride),
-                                                    y_ptr + (i * y_stride),
-                                                    rnd);
-            q_ptr[i * ret_stride] = (double) q;
+            MEX_MPFR_TERNARY_SET (i, fcn (r_ptr + i, &q,
+                                          x_ptr + (i * x_stride),
+                                          y_ptr + (i * y_stride), rnd));
+            if (q_ptr != NULL)
+              q_ptr[i] = (double) q;
           }
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -2216,16 +2577,16 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         DBG_PRINTF ("cmd[%d]: x = [%d:%d], prec = %d, rnd = %d\n", cmd_code,
                     x.start, x.end, (int) prec, (int) rnd);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&x) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr x_ptr      = &mpfr_data[x.start - 1];
-        size_t   ret_stride = (nlhs) ? 1 : 0;
+        MEX_MPFR_TERNARY_T (length (&x));
 
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&x),
+                                             mpfr_get_prec (x_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&x); i++)
-          ret_ptr[i * ret_stride] = (double) mpfr_prec_round (x_ptr + i, prec,
-                                                              rnd);
+          MEX_MPFR_TERNARY_SET (i, mex_mpfr_prec_round (x_ptr + i, prec, rnd));
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -2241,16 +2602,17 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
                     cmd_code, b.start, b.end, (int) rnd1, (int) rnd2,
                     (int) prec);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&b) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr b_ptr      = &mpfr_data[b.start - 1];
-        size_t   ret_stride = (nlhs) ? 1 : 0;
+        plhs[0] = mxCreateNumericMatrix (length (&b), 1, mxDOUBLE_CLASS,
+                                         mxREAL);
+        double * ret_ptr = mxGetPr (plhs[0]);
 
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&b),
+                                             mpfr_get_prec (b_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&b); i++)
-          ret_ptr[i * ret_stride] = (double) mpfr_can_round (b_ptr + i, err,
-                                                             rnd1, rnd2, prec);
+          ret_ptr[i] = (double) mpfr_can_round (b_ptr + i, err, rnd1, rnd2,
+                                                prec);
         return;
       }
 
@@ -2263,9 +2625,11 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         plhs[0] = mxCreateNumericMatrix (length (&x), 1, mxDOUBLE_CLASS,
                                          mxREAL);
         double * ret_ptr = mxGetPr (plhs[0]);
-        mpfr_ptr x_ptr   = &mpfr_data[x.start - 1];
 
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&x),
+                                             mpfr_get_prec (x_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&x); i++)
           ret_ptr[i] = (double) mpfr_get_exp (x_ptr + i);
         return;
@@ -2279,15 +2643,16 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         DBG_PRINTF ("cmd[%d]: [%d:%d] (exp = %d)\n", cmd_code, x.start, x.end,
                     (int) e);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&x) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr x_ptr      = &mpfr_data[x.start - 1];
-        size_t   ret_stride = (nlhs) ? 1 : 0;
+        plhs[0] = mxCreateNumericMatrix (length (&x), 1, mxDOUBLE_CLASS,
+                                         mxREAL);
+        double * ret_ptr = mxGetPr (plhs[0]);
 
-        #pragma omp parallel for
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&x),
+                                             mpfr_get_prec (x_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1)
         for (size_t i = 0; i < length (&x); i++)
-          ret_ptr[i * ret_stride] = (double) mpfr_set_exp (x_ptr + i, e);
+          ret_ptr[i] = (double) mpfr_set_exp (x_ptr + i, e);
         return;
       }
 
@@ -2308,23 +2673,21 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
                     "(rnd = %d)\n", cmd_code, rop.start, rop.end,
                     op.start, op.end, sM, sN, (int) rnd);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&rop) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr rop_ptr    = &mpfr_data[rop.start - 1];
-        mpfr_ptr op_ptr     = &mpfr_data[op.start - 1];
-        double * s_ptr      = mxGetPr (prhs[3]);
-        size_t   ret_stride = (nlhs) ? 1 : 0;
-        size_t   op_stride  = (length (&op) == 1) ? 0 : 1;
-        size_t   s_stride   = ((sM * sN) == 1) ? 0 : 1;
-        #pragma omp parallel for
+        MEX_MPFR_TERNARY_T (length (&rop));
+        double * s_ptr     = mxGetPr (prhs[3]);
+        size_t   op_stride = (length (&op) == 1) ? 0 : 1;
+        size_t   s_stride  = ((sM * sN) == 1) ? 0 : 1;
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&rop),
+                                             mpfr_get_prec (rop_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&rop); i++)
-          ret_ptr[i * ret_stride] = (double) mpfr_setsign (rop_ptr + i,
-                                                           op_ptr +
-                                                           (i * op_stride),
-                                                           (int) s_ptr[i *
-                                                                       s_stride],
-                                                           rnd);
+          MEX_MPFR_TERNARY_SET (i, mpfr_setsign (rop_ptr + i,
+                                                 op_ptr + (i * op_stride),
+                                                 (int) s_ptr[i * s_stride],
+                                                 rnd));
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -2366,18 +2729,18 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
         else
           MEX_FCN_ERR ("cmd[%d]: Bad operator.\n", cmd_code);
 
-        plhs[0] = mxCreateNumericMatrix (nlhs ? length (&x) : 1, 1,
-                                         mxDOUBLE_CLASS, mxREAL);
-        double * ret_ptr    = mxGetPr (plhs[0]);
-        mpfr_ptr x_ptr      = &mpfr_data[x.start - 1];
-        double * t_ptr      = mxGetPr (prhs[2]);
-        size_t   ret_stride = (nlhs) ? 1 : 0;
-        size_t   t_stride   = ((tM * tN) == 1) ? 0 : 1;
-        #pragma omp parallel for
+        MEX_MPFR_TERNARY_T (length (&x));
+        double * t_ptr    = mxGetPr (prhs[2]);
+        size_t   t_stride = ((tM * tN) == 1) ? 0 : 1;
+        omp_threads = mex_mpfr_omp_schedule (cmd_code, length (&x),
+                                             mpfr_get_prec (x_ptr));
+        #pragma omp parallel for schedule(runtime) \
+          num_threads (omp_threads) if (omp_threads > 1) \
+          reduction(+:ternary_up, ternary_down)
         for (size_t i = 0; i < length (&x); i++)
-          ret_ptr[i * ret_stride] = (double) fcn (x_ptr + i,
-                                                  (int) t_ptr[i * t_stride],
-                                                  rnd);
+          MEX_MPFR_TERNARY_SET (i, fcn (x_ptr + i, (int) t_ptr[i * t_stride],
+                                        rnd));
+        MEX_MPFR_TERNARY_RETURN ();
         return;
       }
 
@@ -2433,3 +2796,31 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
     }
 }
 
+
+/**
+ * Octave/Matlab MEX interface for MPFR.
+ *
+ * @param nlhs MEX parameter.
+ * @param plhs MEX parameter.
+ * @param nrhs MEX parameter.
+ * @param prhs MEX parameter.
+ * @param cmd_code code of command to execute (1000 - 1999).
+ */
+void
+mex_mpfr_interface (int nlhs, mxArray *plhs[],
+                    int nrhs, const mxArray *prhs[],
+                    uint64_t cmd_code)
+{
+  int failed = MEX_FCN_FAILED;
+  MEX_FCN_FAILED = 0;
+  mex_mpfr_interface_cmd (nlhs, plhs, nrhs, prhs, cmd_code);
+  if (MEX_FCN_FAILED)
+    return;
+  MEX_FCN_FAILED = failed;
+
+  // Record genuine MPFR interface functions after success, see
+  // `mex_mpfr_tape_begin`.
+  if (mpfr_tape_recording && ! mpfr_tape_replaying && (cmd_code < 1900)
+      && ! mex_mpfr_tape_record (nrhs, prhs))
+    MEX_FCN_ERR ("%s\n", "Memory allocation failed.");
+}
@@ -28,16 +28,36 @@
 // MPFR memory management
 // ======================
 //
-// mex_mpfr_algorithms.c
+// mex_mpfr_interface_memory_managment.c
 //
-// Similar to C++ std::vector:
-// - xxx_capacity: number of elements that `xxx` has currently allocated
-//                 space for.
-// - xxx_size:     number of elements in `xxx`.
+// - mpfr_data_capacity: number of MPFR variables allocated space for.
+// - mpfr_data_size:     largest index (1-based) of a used MPFR variable.
+//
+// Access MPFR variables only through `mex_mpfr_ptr` or the `name_ptr`
+// declared by `MEX_MPFR_T`.
+//
+// Octave objects store handles instead of indices, which are resolved by
+// `extract_idx`.  Thus `mex_mpfr_compact` can relocate MPFR variables.
+
+extern size_t mpfr_data_capacity;
+extern size_t mpfr_data_size;
+
+#define MPFR_HANDLE_MAX ((size_t) 1 << 53)  // Exact in double precision.
+
+
+// Return a summary of ternary values instead of all ternary values?  Set by
+// `mpfr_t.summary` (command 1911) for the duration of a single call.
+extern int mpfr_ternary_summary;
 
-extern mpfr_ptr mpfr_data;
-extern size_t   mpfr_data_capacity;
-extern size_t   mpfr_data_size;
+
+// Fill values of `mpfr_t.allocate_init` (command 1904).
+
+#define MPFR_FILL_DOUBLE 0  // From a double-precision matrix.
+#define MPFR_FILL_MPFR   1  // From MPFR variables.
+#define MPFR_FILL_ZEROS  2
+#define MPFR_FILL_ONES   3
+#define MPFR_FILL_EYE    4  // Identity matrix.
+#define MPFR_FILL_NAN    5
 
 
 /**
@@ -58,6 +78,8 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
 /**
  * Safely declare and read MPFR_T variable(-arrays) from MEX interface.
  *
+ * Additionally, `name_ptr` points to the first MPFR variable.
+ *
  * @param mex_rhs Position (0-based) in MEX input.
  * @param name    Desired variable name.
  */
@@ -65,7 +87,9 @@ mex_mpfr_interface (int nlhs, mxArray *plhs[],
   idx_t name;                                                         \
   if (! extract_idx ((mex_rhs), nrhs, prhs, &name))                   \
     MEX_FCN_ERR ("cmd[%d]:"#name " Invalid MPFR variable indices.\n", \
-                 cmd_code);
+                 cmd_code);                                           \
+  mpfr_ptr name ## _ptr = mex_mpfr_ptr (&name);                       \
+  (void) name ## _ptr;  // Not used by all commands.
 
 
 /**
@@ -125,6 +149,37 @@ int
 is_valid (idx_t *idx);
 
 
+/**
+ * Resolve a range of handles to the index range of its MPFR variables.
+ *
+ * @param[in,out] idx Pointer to range of handles (1-based, idx_t).  If
+ *                    function returns `1`, it is replaced by the index range
+ *                    (1-based, idx_t) of the MPFR variables, otherwise `idx`
+ *                    remains unchanged.
+ *
+ * @returns `1` if `idx` is a subrange of an allocated range of handles,
+ *          otherwise `0`.
+ */
+int
+mex_mpfr_resolve (idx_t *idx);
+
+
+/**
+ * Safely read a range of handles (idx_t) without resolving it.
+ *
+ * @param[in] idx MEX input position index (0 is first).
+ * @param[in] nrhs Number of right-hand sides.
+ * @param[in] mxArray  MEX input array.
+ * @param[out] idx_vec If function returns `1`, `idx_vec` contains the range
+ *                     of handles (idx_t) extracted from the MEX input,
+ *                     otherwise `idx_vec` remains unchanged.
+ *
+ * @returns success of extraction.
+ */
+int
+extract_handle (int idx, int nrhs, const mxArray *prhs[], idx_t *idx_vec);
+
+
 /**
  * Safely read MPFR index (idx_t) structure.
  *
@@ -132,8 +187,8 @@ is_valid (idx_t *idx);
  * @param[in] nrhs Number of right-hand sides.
  * @param[in] mxArray  MEX input array.
  * @param[out] idx_vec If function returns `1`, `idx_vec` contains a valid
- *                     index (idx_t) structure extracted from the MEX input,
- *                     otherwise `idx_vec` remains unchanged.
+ *                     index (idx_t) structure resolved from the handles in
+ *                     the MEX input, otherwise `idx_vec` remains unchanged.
  *
  * @returns success of extraction.
  */
@@ -190,6 +245,10 @@ extract_prec (int idx, int nrhs, const mxArray *prhs[], mpfr_prec_t *prec);
  * Constructor for new MPFR variables.
  *
  * @param[in] count Number of MPFR variables to create.
+ * @param[in] prec Preferred precision of reused MPFR variables, `0` for any.
+ * @param[out] handle If function returns `1`, pointer to range of handles
+ *                    (1-based, idx_t) of MPFR variables, otherwise the value
+ *                    of `handle` remains unchanged.
  * @param[out] idx If function returns `1`, pointer to index (1-based, idx_t)
  *                 of MPFR variables, otherwise the value of `idx` remains
  *                 unchanged.
@@ -197,19 +256,312 @@ extract_prec (int idx, int nrhs, const mxArray *prhs[], mpfr_prec_t *prec);
  * @returns success of MPFR variable creation.
  */
 int
-mex_mpfr_allocate (size_t count, idx_t *idx);
+mex_mpfr_allocate (size_t count, mpfr_prec_t prec, idx_t *handle, idx_t *idx);
 
 
 /**
  * Mark MPFR variable as no longer used.
  *
- * @param[in] idx Pointer to index (1-based, idx_t) of MPFR variable to be no
- *                longer used.
+ * The handles become invalid immediately, the index range is released
+ * deferred, see `mex_mpfr_flush_free`.
+ *
+ * @param[in] handle Pointer to range of handles (1-based, idx_t) of MPFR
+ *                   variable to be no longer used, as returned by
+ *                   `mex_mpfr_allocate`.
+ */
+void
+mex_mpfr_mark_free (idx_t *handle);
+
+
+/**
+ * Release all index ranges marked as no longer used.
+ */
+void
+mex_mpfr_flush_free (void);
+
+
+/**
+ * Relocate all used MPFR variables to the smallest indices and release the
+ * memory of all unused MPFR variables after them.
+ *
+ * Handles remain valid, indices of MPFR variables change.
+ *
+ * @returns success of compaction.
+ */
+int
+mex_mpfr_compact (void);
+
+
+/**
+ * Memory statistics of MPFR variables.
+ *
+ * See `mex_mpfr_interface_memory_managment.c` for the fields.
+ *
+ * @returns MEX struct (1x1), NULL if memory allocation failed.
+ */
+mxArray *
+mex_mpfr_memory_stats (void);
+
+
+/**
+ * Release all memory of MPFR variables, if none is in use.
  *
- * @returns success of MPFR variables creation.
+ * @returns `1` if the memory was released, otherwise `0`.
+ */
+int
+mex_mpfr_release (void);
+
+
+/**
+ * Pointer to the first MPFR variable of a valid index range.
+ *
+ * @param[in] idx Pointer to index (1-based, idx_t) of MPFR variables.
+ *
+ * @returns pointer to the first MPFR variable, all other MPFR variables of
+ *          `idx` follow contiguously.
+ */
+mpfr_ptr
+mex_mpfr_ptr (idx_t *idx);
+
+
+// Contiguous limb blocks, see mex_mpfr_interface_limb_blocks.c
+// ============================================================
+
+// Minimal number of MPFR variables to get a contiguous limb block,
+// `0` disables contiguous limb blocks.
+extern size_t mpfr_limb_blocks_threshold;
+
+
+/**
+ * Initialize MPFR variables with a contiguous limb block.
+ *
+ * @param[in] x Pointer to `n` initialized MPFR variables.
+ * @param[in] n Number of MPFR variables.
+ * @param[in] prec Precision of all MPFR variables.
+ *
+ * @returns `1` if the variables are reinitialized with precision `prec` and
+ *          value NaN, otherwise `0` and the variables are unchanged.
+ */
+int
+mex_mpfr_init2_contiguous (mpfr_ptr x, size_t n, mpfr_prec_t prec);
+
+
+/**
+ * Release contiguous limb blocks no longer referenced by MPFR variables.
+ */
+void
+mex_mpfr_limb_blocks_collect (void);
+
+
+/**
+ * Release all contiguous limb blocks.
  */
 void
-mex_mpfr_mark_free (idx_t *idx);
+mex_mpfr_limb_blocks_release (void);
+
+
+/**
+ * Detach a MPFR variable from its contiguous limb block.
+ *
+ * @param[in] x MPFR variable.
+ *
+ * @returns `1` if `x` had its significand in a limb block and is
+ *          uninitialized now, otherwise `0` and `x` is unchanged.
+ */
+int
+mex_mpfr_detach (mpfr_ptr x);
+
+
+/**
+ * Like `mpfr_clear`, aware of contiguous limb blocks.
+ *
+ * @param[in] x MPFR variable.
+ */
+void
+mex_mpfr_clear (mpfr_ptr x);
+
+
+/**
+ * Like `mpfr_set_prec`, aware of contiguous limb blocks.
+ *
+ * @param[in] x MPFR variable.
+ * @param[in] prec New precision of `x`.
+ */
+void
+mex_mpfr_set_prec (mpfr_ptr x, mpfr_prec_t prec);
+
+
+/**
+ * Like `mpfr_prec_round`, aware of contiguous limb blocks.
+ *
+ * @param[in] x MPFR variable.
+ * @param[in] prec New precision of `x`.
+ * @param[in] rnd Rounding mode.
+ *
+ * @returns ternary value like `mpfr_prec_round`.
+ */
+int
+mex_mpfr_prec_round (mpfr_ptr x, mpfr_prec_t prec, mpfr_rnd_t rnd);
+
+
+// Command tapes, see mex_mpfr_interface_tape.c
+// =============================================
+
+// Record MPFR interface calls (command codes 1000 - 1899)?
+extern int mpfr_tape_recording;
+
+// Replaying a tape?  Replayed calls are not recorded.
+extern int mpfr_tape_replaying;
+
+
+/**
+ * Stop recording and release all recorded calls.
+ */
+void
+mex_mpfr_tape_release (void);
+
+
+/**
+ * Start recording MPFR interface calls, previously recorded calls are
+ * discarded.
+ */
+void
+mex_mpfr_tape_begin (void);
+
+
+/**
+ * Append a MPFR interface call to the recorded tape.
+ *
+ * @param[in] nrhs MEX parameter.
+ * @param[in] prhs MEX parameter, `prhs[0]` is the command code.
+ *
+ * @returns success of recording.
+ */
+int
+mex_mpfr_tape_record (int nrhs, const mxArray *prhs[]);
+
+
+/**
+ * Stop recording MPFR interface calls.
+ *
+ * @returns the recorded tape (cell array of calls).
+ */
+mxArray *
+mex_mpfr_tape_end (void);
+
+
+/**
+ * Check a tape.
+ *
+ * @param[in] tape MEX input array.
+ *
+ * @returns position (1-based) of the first invalid call, `0` if all calls
+ *          are valid.
+ */
+size_t
+mex_mpfr_tape_check (const mxArray *tape);
+
+
+/**
+ * Execute a valid tape (see `mex_mpfr_tape_check`).
+ *
+ * Output values of the calls, e.g. ternary values, are discarded.  Errors of
+ * a call are reported as usual and stop the execution.
+ *
+ * @param[in] tape MEX input array.
+ * @param[in] count Number of executions of the whole tape.
+ *
+ * @returns success of execution.
+ */
+int
+mex_mpfr_tape_run (const mxArray *tape, size_t count);
+
+
+// OpenMP scheduling, see mex_mpfr_interface_schedule.c
+// ====================================================
+
+// Schedule kinds of element-wise loops, other values are `omp_sched_t`.
+#define MPFR_OMP_SCHED_COST 0  // Chosen by the cost of the MPFR function.
+
+// Minimal estimated cost of a loop to use more than one thread.
+extern double mpfr_omp_min_cost;
+
+// Estimated cost of a chunk of loop iterations.
+extern double mpfr_omp_chunk_cost;
+
+// Schedule kind of element-wise loops.
+extern int mpfr_omp_sched_kind;
+
+
+/**
+ * Schedule an element-wise loop over MPFR variables.
+ *
+ * Sets the OpenMP runtime schedule (`schedule(runtime)`) for a loop of `n`
+ * calls of the MPFR function of command `cmd_code`:
+ *
+ * @code
+ * omp_threads = mex_mpfr_omp_schedule (cmd_code, n, prec);
+ * #pragma omp parallel for schedule(runtime) \
+ *   num_threads (omp_threads) if (omp_threads > 1)
+ * @endcode
+ *
+ * @param[in] cmd_code Command code of the MPFR function (1000 - 1899).
+ * @param[in] n Number of loop iterations.
+ * @param[in] prec Typical precision of the MPFR variables in the loop.
+ *
+ * @returns number of threads to use, `1` to run the loop serially.
+ */
+int
+mex_mpfr_omp_schedule (uint64_t cmd_code, size_t n, mpfr_prec_t prec);
+
+
+// Fixed-limb kernels, see mex_mpfr_interface_fixed.c
+// ==================================================
+
+// Largest number of limbs with a fixed-limb kernel (512 bits).
+#define MPFR_FIXED_MAX_LIMBS 8
+
+// Largest number of limbs to use fixed-limb kernels for, `0` disables them.
+extern size_t mpfr_fixed_max_limbs;
+
+// Signatures of `mpfr_mul` and `mpfr_fma`.
+typedef int (*mpfr_fixed_op2_t)(mpfr_ptr, mpfr_srcptr, mpfr_srcptr,
+                                mpfr_rnd_t);
+typedef int (*mpfr_fixed_op3_t)(mpfr_ptr, mpfr_srcptr, mpfr_srcptr,
+                                mpfr_srcptr, mpfr_rnd_t);
+
+
+/**
+ * Select a fixed-limb kernel for `mpfr_mul` or `mpfr_div`.
+ *
+ * The kernel has the signature of the MPFR function and falls back to it
+ * for operands it cannot handle, e.g. of a precision other than `prec`.
+ * For other functions, or if the kernel is not faster for `prec`, `fcn` is
+ * returned.
+ *
+ * @param[in] cmd_code Command code of the MPFR function (1000 - 1899).
+ * @param[in] prec Precision of the result variables.
+ * @param[in] fcn MPFR function to use if there is no kernel.
+ *
+ * @returns kernel or `fcn`.
+ */
+mpfr_fixed_op2_t
+mex_mpfr_fixed_op2 (uint64_t cmd_code, mpfr_prec_t prec,
+                    mpfr_fixed_op2_t fcn);
+
+
+/**
+ * Select a fixed-limb kernel for `mpfr_fma` or `mpfr_fms`.
+ *
+ * @param[in] cmd_code Command code of the MPFR function (1000 - 1899).
+ * @param[in] prec Precision of the result variables.
+ * @param[in] fcn MPFR function to use if there is no kernel.
+ *
+ * @returns kernel or `fcn`, see `mex_mpfr_fixed_op2`.
+ */
+mpfr_fixed_op3_t
+mex_mpfr_fixed_op3 (uint64_t cmd_code, mpfr_prec_t prec,
+                    mpfr_fixed_op3_t fcn);
 
 #endif  // MEX_MPFR_INTERFACE_H_
 
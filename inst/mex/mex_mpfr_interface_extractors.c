@@ -19,60 +19,96 @@
 
 
 /**
- * Safely read MPFR index (idx_t) structure.
+ * Safely read a range of handles (idx_t) without resolving it.
  *
  * @param[in] idx MEX input position index (0 is first).
  * @param[in] nrhs Number of right-hand sides.
  * @param[in] mxArray  MEX input array.
- * @param[out] idx_vec If function returns `1`, `idx_vec` contains a valid
- *                     index (idx_t) structure extracted from the MEX input,
+ * @param[out] idx_vec If function returns `1`, `idx_vec` contains the range
+ *                     of handles (idx_t) extracted from the MEX input,
  *                     otherwise `idx_vec` remains unchanged.
  *
  * @returns success of extraction.
  */
 int
-extract_idx (int idx, int nrhs, const mxArray *prhs[], idx_t *idx_vec)
+extract_handle (int idx, int nrhs, const mxArray *prhs[], idx_t *idx_vec)
 {
   if (idx >= nrhs)
     {
-      DBG_PRINTF ("extract_idx: idx(%d) >= nrhs(%d).\n", idx, nrhs);
+      DBG_PRINTF ("extract_handle: idx(%d) >= nrhs(%d).\n", idx, nrhs);
       return (0);
     }
 
-  const mxArray *mpfr_t_idx = NULL;
+  // Handles passed directly (e.g. `x.idx`) are the fast path.  Otherwise the
+  // class name comparison and the property copy of @mpfr_t objects cost more
+  // than most scalar MPFR operations.
+  const mxArray *mpfr_t_idx = prhs[idx];
+  mxArray *      prop       = NULL;
 
-  if (mxIsClass (prhs[idx], "mpfr_t"))
+  if (! mxIsDouble (mpfr_t_idx))
     {
-      mpfr_t_idx = mxGetProperty (prhs[idx], 0, "idx");
-      if (mpfr_t_idx == NULL)
+      if (mxIsClass (mpfr_t_idx, "mpfr_t"))
+        prop = mxGetProperty (mpfr_t_idx, 0, "idx");
+      if (prop == NULL)
         {
-          DBG_PRINTF ("mpfr_t object in prhs[%d] has no 'idx' field.\n", idx);
+          DBG_PRINTF ("prhs[%d] is neither handles nor mpfr_t object.\n",
+                      idx);
           return (0);
         }
+      mpfr_t_idx = prop;
     }
-  else
-    mpfr_t_idx = prhs[idx];
 
-  if (mxIsNumeric (mpfr_t_idx)
-      && ((mxGetM (mpfr_t_idx) * mxGetN (mpfr_t_idx) == 2)))
+  int good = 0;
+  if (mxIsDouble (mpfr_t_idx) && (mxGetNumberOfElements (mpfr_t_idx) == 2))
     {
+      // Exact conversion rejects negative, fractional, and non-finite values.
       double *vec = mxGetPr (mpfr_t_idx);
-      if ((vec[0] >= 0.0) && mxIsFinite (vec[0]) && (floor (vec[0]) == vec[0])
-          && (vec[1] >= 0.0) && mxIsFinite (vec[1])
-          && (floor (vec[1]) == vec[1]))
+      if ((vec[0] >= 0.0) && (vec[0] < (double) MPFR_HANDLE_MAX)
+          && (vec[1] >= 0.0) && (vec[1] < (double) MPFR_HANDLE_MAX)
+          && ((double) (size_t) vec[0] == vec[0])
+          && ((double) (size_t) vec[1] == vec[1]))
         {
-          idx_t tmp_vec = { (size_t) vec[0], (size_t) vec[1] };
-          if (is_valid (&tmp_vec))
-            {
-              (*idx_vec).start = tmp_vec.start;
-              (*idx_vec).end   = tmp_vec.end;
-              return (1);
-            }
-
-          DBG_PRINTF ("Invalid index [%d:%d].\n", (*idx_vec).start,
-                      (*idx_vec).end);
+          (*idx_vec).start = (size_t) vec[0];
+          (*idx_vec).end   = (size_t) vec[1];
+          good = 1;
         }
     }
+  if (prop != NULL)
+    mxDestroyArray (prop);
+
+  if (! good)
+    DBG_PRINTF ("extract_handle: %s\n", "Failed.");
+  return (good);
+}
+
+
+/**
+ * Safely read MPFR index (idx_t) structure.
+ *
+ * @param[in] idx MEX input position index (0 is first).
+ * @param[in] nrhs Number of right-hand sides.
+ * @param[in] mxArray  MEX input array.
+ * @param[out] idx_vec If function returns `1`, `idx_vec` contains a valid
+ *                     index (idx_t) structure resolved from the handles in
+ *                     the MEX input, otherwise `idx_vec` remains unchanged.
+ *
+ * @returns success of extraction.
+ */
+int
+extract_idx (int idx, int nrhs, const mxArray *prhs[], idx_t *idx_vec)
+{
+  idx_t tmp_vec;
+
+  if (extract_handle (idx, nrhs, prhs, &tmp_vec))
+    {
+      if (mex_mpfr_resolve (&tmp_vec))
+        {
+          *idx_vec = tmp_vec;
+          return (1);
+        }
+
+      DBG_PRINTF ("Invalid handles [%d:%d].\n", tmp_vec.start, tmp_vec.end);
+    }
 
   DBG_PRINTF ("extract_idx: %s\n", "Failed.");
   return (0);
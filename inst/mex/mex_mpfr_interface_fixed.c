@@ -0,0 +1,595 @@
+/*
+ * This file is part of APA.
+ *
+ *  APA is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  APA is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mex_mpfr_interface.h"
+
+// Fixed-limb kernels
+// ==================
+//
+// For operands of `n = 1, ..., MPFR_FIXED_MAX_LIMBS` limbs, e.g. 128 or 256
+// bits, a good part of the time of `mpfr_mul` and friends is spent on
+// dispatching to the right algorithm.  The kernels below are generated for
+// each limb count `n`, thus all loops have a constant trip count.  They work
+// directly on the significands of regular (non-zero, finite) numbers if all
+// operands have the precision of `rop`.  The exact result is computed in a
+// buffer of more than `n` limbs and a sticky bit, then rounded like MPFR,
+// including the ternary value and the inexact flag.  In all other cases,
+// e.g. special values, mixed precision, an exact zero result, or an
+// exponent out of range, the corresponding MPFR function is called instead.
+// The exponent range is read once by the selectors, as `mpfr_get_emin` and
+// `mpfr_get_emax` are too costly for each call.
+//
+// MPFR itself has special code for `mpfr_add` and `mpfr_sub` of one to three
+// limbs and for `mpfr_mul` and `mpfr_div` of precisions below three limbs,
+// which are no multiple of the limb size.  The selectors only return a
+// kernel, where it was measured to be faster (doc/benchmarks/
+// benchmark_fixed_limbs.m), see `fixed_profitable_p`.
+
+size_t mpfr_fixed_max_limbs = MPFR_FIXED_MAX_LIMBS;
+
+static mpfr_exp_t fixed_emin = 0;
+static mpfr_exp_t fixed_emax = 0;
+
+#define FIXED_INLINE static inline __attribute__ ((always_inline))
+#define FIXED_LIMB_BITS ((mpfr_uexp_t) GMP_NUMB_BITS)
+#define FIXED_HIGHBIT ((mp_limb_t) 1 << (GMP_NUMB_BITS - 1))
+
+
+/**
+ * Number of limbs of precision `prec`.
+ *
+ * @param[in] prec MPFR precision.
+ *
+ * @returns number of limbs.
+ */
+FIXED_INLINE size_t
+fixed_limbs (mpfr_prec_t prec)
+{
+  return ((size_t) ((prec + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS));
+}
+
+
+/**
+ * Limb `k` of a significand of `lx` limbs placed at the top of `L` limbs.
+ *
+ * The buffers below are never filled by plain copy loops, as compilers
+ * turn them into `memcpy` calls or `rep movs` instructions, which are too
+ * costly for a few limbs.
+ *
+ * @param[in] x Significand of `lx` limbs.
+ * @param[in] lx Number of limbs of `x`.
+ * @param[in] L Number of limbs of the buffer, `L >= lx`.
+ * @param[in] k Limb index, may exceed `L`.
+ *
+ * @returns `x[k - (L - lx)]` or zero.
+ */
+FIXED_INLINE mp_limb_t
+fixed_limb (const mp_limb_t *x, size_t lx, size_t L, size_t k)
+{
+  size_t j = k - (L - lx);  // Wraps around for `k < L - lx`.
+  return ((j < lx) ? x[j] : 0);
+}
+
+
+/**
+ * Check the exponent of an unrounded result.
+ *
+ * @param[in] exp Exponent before rounding, it grows by one at most.
+ *
+ * @returns non-zero, if the rounded result is in the exponent range.
+ */
+FIXED_INLINE int
+fixed_exp_p (mpfr_exp_t exp)
+{
+  return ((exp >= fixed_emin) && (exp < fixed_emax));
+}
+
+
+/**
+ * Round the exact value `(x + sticky) * 2^exp` to `prec` bits and store it
+ * in `rop`.
+ *
+ * @param[out] rop MPFR variable of precision `prec`.
+ * @param[in] x Normalized significand of `len > n` limbs, the most
+ *              significant bit of `x[len - 1]` is set.
+ * @param[in] len Number of limbs of `x`.
+ * @param[in] sticky Non-zero, if there are non-zero bits below `x`.
+ * @param[in] neg Non-zero, if the value is negative.
+ * @param[in] exp Exponent, checked by `fixed_exp_p`.
+ * @param[in] n Number of limbs of `rop`.
+ * @param[in] prec MPFR precision of `rop`.
+ * @param[in] rnd MPFR rounding mode (MPFR_RNDN to MPFR_RNDA).
+ *
+ * @returns MPFR ternary value.
+ */
+FIXED_INLINE int
+fixed_round (mpfr_ptr rop, const mp_limb_t *x, size_t len, mp_limb_t sticky,
+             int neg, mpfr_exp_t exp, size_t n, mpfr_prec_t prec,
+             mpfr_rnd_t rnd)
+{
+  size_t    lo  = len - n;  // Least significant limb of `rop` in `x`.
+  unsigned  sh  = (unsigned) (n * GMP_NUMB_BITS - (size_t) prec);
+  mp_limb_t ulp = (mp_limb_t) 1 << sh;
+  mp_limb_t rb;  // Round bit.
+  mp_limb_t st  = sticky;
+
+  for (size_t i = 0; i + 1 < lo; i++)
+    st |= x[i];
+  if (sh > 0)
+    {
+      rb  = x[lo] & (ulp >> 1);
+      st |= (x[lo] & ((ulp >> 1) - 1)) | x[lo - 1];
+    }
+  else
+    {
+      rb  = x[lo - 1] & FIXED_HIGHBIT;
+      st |= x[lo - 1] & ~FIXED_HIGHBIT;
+    }
+
+  int inc = 0;
+  if (rb || st)
+    switch (rnd)
+      {
+        case MPFR_RNDN:  // Ties to even.
+          inc = (rb != 0) && ((st != 0) || ((x[lo] & ulp) != 0));
+          break;
+        case MPFR_RNDZ:
+          inc = 0;
+          break;
+        case MPFR_RNDU:
+          inc = ! neg;
+          break;
+        case MPFR_RNDD:
+          inc = neg;
+          break;
+        default:  // MPFR_RNDA
+          inc = 1;
+          break;
+      }
+
+  mp_limb_t *d     = (mp_limb_t *) mpfr_custom_get_significand (rop);
+  mp_limb_t  carry = inc ? ulp : 0;
+  for (size_t i = 0; i < n; i++)
+    {
+      mp_limb_t v = x[lo + i] & ((i == 0) ? ~(ulp - 1) : ~(mp_limb_t) 0);
+      d[i]  = v + carry;
+      carry = (d[i] < carry);
+    }
+  if (carry)  // Significand `1.0`.
+    {
+      d[n - 1] = FIXED_HIGHBIT;
+      exp++;
+    }
+  mpfr_custom_init_set (rop, neg ? -MPFR_REGULAR_KIND : MPFR_REGULAR_KIND,
+                        exp, prec, d);
+  if (! rb && ! st)
+    return (0);
+  mpfr_set_inexflag ();
+  return ((inc != (neg != 0)) ? 1 : -1);
+}
+
+
+/**
+ * Compare the magnitudes of two significands of possibly different length.
+ *
+ * @param[in] x Significand of `lx` limbs.
+ * @param[in] lx Number of limbs of `x`.
+ * @param[in] y Significand of `ly` limbs.
+ * @param[in] ly Number of limbs of `y`.
+ *
+ * @returns positive, zero, or negative if `x > y`, `x == y`, or `x < y`.
+ */
+FIXED_INLINE int
+fixed_cmp (const mp_limb_t *x, size_t lx, const mp_limb_t *y, size_t ly)
+{
+  size_t l = (lx > ly) ? lx : ly;
+  for (size_t i = 1; i <= l; i++)
+    {
+      mp_limb_t xi = (i <= lx) ? x[lx - i] : 0;
+      mp_limb_t yi = (i <= ly) ? y[ly - i] : 0;
+      if (xi != yi)
+        return ((xi > yi) ? 1 : -1);
+    }
+  return (0);
+}
+
+
+/**
+ * Exact sum `x + y` of two regular numbers given by their significands,
+ * exponents, and signs, truncated to a normalized buffer and a sticky bit.
+ *
+ * The significand with the larger magnitude is placed at the top of a
+ * buffer of `L = max (lx, ly) + 1` limbs, the other one is shifted into it.
+ * Bits shifted out of the buffer are only possible for an exponent
+ * difference of two or more, thus at most one bit cancels and the sticky
+ * bit suffices for correct rounding.
+ *
+ * @param[out] a Normalized significand of `L` limbs.
+ * @param[out] exp Exponent of the result.
+ * @param[out] neg Sign of the result.
+ * @param[out] sticky Non-zero, if there are non-zero bits below `a`.
+ * @param[in] x Normalized significand of `lx` limbs.
+ * @param[in] lx Number of limbs of `x`.
+ * @param[in] ex Exponent of `x`.
+ * @param[in] nx Non-zero, if `x` is negative.
+ * @param[in] y Normalized significand of `ly` limbs.
+ * @param[in] ly Number of limbs of `y`.
+ * @param[in] ey Exponent of `y`.
+ * @param[in] ny Non-zero, if `y` is negative.
+ *
+ * @returns `1` on success, `0` if the sum is exactly zero.
+ */
+FIXED_INLINE int
+fixed_sum (mp_limb_t *a, mpfr_exp_t *exp, int *neg, mp_limb_t *sticky,
+           const mp_limb_t *x, size_t lx, mpfr_exp_t ex, int nx,
+           const mp_limb_t *y, size_t ly, mpfr_exp_t ey, int ny)
+{
+  // Order by magnitude, `|x| >= |y|`.
+  int cmp = (ex != ey) ? ((ex > ey) ? 1 : -1) : fixed_cmp (x, lx, y, ly);
+  int sub = (nx != 0) != (ny != 0);
+  if (cmp == 0)
+    {
+      if (sub)
+        return (0);
+    }
+  else if (cmp < 0)
+    {
+      const mp_limb_t *t  = x;
+      size_t           tl = lx;
+      mpfr_exp_t       te = ex;
+      int              tn = nx;
+      x = y; lx = ly; ex = ey; nx = ny;
+      y = t; ly = tl; ey = te; ny = tn;
+    }
+
+  // Shift `y` right by `d = q * GMP_NUMB_BITS + s` bits, the bits shifted
+  // out are sticky.
+  size_t      L = ((lx > ly) ? lx : ly) + 1;
+  mpfr_uexp_t d = (mpfr_uexp_t) ex - (mpfr_uexp_t) ey;
+  size_t      q = L;
+  unsigned    s = 0;
+  if (d < L * FIXED_LIMB_BITS)
+    {
+      q = (size_t) (d / FIXED_LIMB_BITS);
+      s = (unsigned) (d % FIXED_LIMB_BITS);
+    }
+  mp_limb_t st = 0;
+  for (size_t j = 0; j < ly; j++)
+    {
+      size_t k = L - ly + j;
+      st |= y[j] & ((k < q) ? ~(mp_limb_t) 0
+                    : (k == q) ? ((mp_limb_t) 1 << s) - 1 : 0);
+    }
+  #define FIXED_Y(i) ((fixed_limb (y, ly, L, (i) + q) >> s)                \
+                      | ((fixed_limb (y, ly, L, (i) + q + 1) << 1)         \
+                         << (GMP_NUMB_BITS - 1 - s)))
+
+  *exp = ex;
+  if (! sub)
+    {
+      mp_limb_t carry = 0;
+      for (size_t i = 0; i < L; i++)
+        {
+          mp_limb_t c1 = __builtin_add_overflow (fixed_limb (x, lx, L, i),
+                                                 carry, &a[i]);
+          mp_limb_t c2 = __builtin_add_overflow (a[i], FIXED_Y (i), &a[i]);
+          carry = c1 | c2;
+        }
+      if (carry)
+        {
+          st |= a[0] & 1;
+          for (size_t i = 0; i + 1 < L; i++)
+            a[i] = (a[i] >> 1) | (a[i + 1] << (GMP_NUMB_BITS - 1));
+          a[L - 1] = (a[L - 1] >> 1) | FIXED_HIGHBIT;
+          (*exp)++;
+        }
+    }
+  else
+    {
+      // Bits of `y` below the buffer are subtracted by taking one unit of
+      // the last place, the remainder `1 - y_low` remains sticky.
+      mp_limb_t borrow = (st != 0);
+      for (size_t i = 0; i < L; i++)
+        {
+          mp_limb_t c1 = __builtin_sub_overflow (fixed_limb (x, lx, L, i),
+                                                 borrow, &a[i]);
+          mp_limb_t c2 = __builtin_sub_overflow (a[i], FIXED_Y (i), &a[i]);
+          borrow = c1 | c2;
+        }
+
+      // Normalize, more than one bit cancels only if the sum is exact.
+      if (! (a[L - 1] & FIXED_HIGHBIT))
+        {
+          size_t h = L - 1;
+          while (a[h] == 0)
+            h--;
+          size_t   z  = L - 1 - h;
+          unsigned lz = (unsigned) __builtin_clzll ((unsigned long long) a[h]);
+          for (size_t i = L; i-- > 0;)
+            {
+              mp_limb_t hi = (i >= z) ? a[i - z] : 0;
+              mp_limb_t lw = (i >= z + 1) ? a[i - z - 1] : 0;
+              a[i] = (hi << lz) | ((lw >> 1) >> (GMP_NUMB_BITS - 1 - lz));
+            }
+          *exp -= (mpfr_exp_t) (z * GMP_NUMB_BITS + lz);
+        }
+    }
+  #undef FIXED_Y
+
+  *neg    = nx;
+  *sticky = st;
+  return (1);
+}
+
+
+/**
+ * Exact, normalized product of two significands of `n` limbs.
+ *
+ * @param[out] p Product of `2 * n` limbs.
+ * @param[in] x Significand of `n` limbs.
+ * @param[in] y Significand of `n` limbs.
+ * @param[in] n Number of limbs.
+ *
+ * @returns `0` or `-1`, the exponent correction by normalization.
+ */
+FIXED_INLINE mpfr_exp_t
+fixed_mul_exact (mp_limb_t *p, const mp_limb_t *x, const mp_limb_t *y,
+                 size_t n)
+{
+  mpn_mul_n (p, x, y, (mp_size_t) n);
+  if (p[2 * n - 1] & FIXED_HIGHBIT)
+    return (0);
+  for (size_t i = 2 * n - 1; i > 0; i--)
+    p[i] = (p[i] << 1) | (p[i - 1] >> (GMP_NUMB_BITS - 1));
+  p[0] <<= 1;
+  return (-1);
+}
+
+
+/**
+ * Check the operands of a fixed-limb kernel.
+ *
+ * @param[in] rop MPFR variable of the result.
+ * @param[in] op MPFR operand.
+ * @param[in] n Number of limbs of the kernel.
+ *
+ * @returns non-zero, if `op` is regular and has the precision of `rop`,
+ *          which has `n` limbs.
+ */
+FIXED_INLINE int
+fixed_operand_p (mpfr_srcptr rop, mpfr_srcptr op, size_t n)
+{
+  return (mpfr_regular_p (op) && (mpfr_get_prec (op) == mpfr_get_prec (rop))
+          && (fixed_limbs (mpfr_get_prec (rop)) == n));
+}
+
+
+/**
+ * Fixed-limb `rop = op1 * op2`.
+ */
+FIXED_INLINE int
+fixed_mul (mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd,
+           size_t n)
+{
+  if (fixed_operand_p (rop, op1, n) && fixed_operand_p (rop, op2, n)
+      && (rnd >= MPFR_RNDN) && (rnd <= MPFR_RNDA))
+    {
+      mp_limb_t  p[2 * MPFR_FIXED_MAX_LIMBS];
+      int        neg = (mpfr_signbit (op1) != 0) != (mpfr_signbit (op2) != 0);
+      mpfr_exp_t exp = mpfr_custom_get_exp (op1) + mpfr_custom_get_exp (op2)
+                       + fixed_mul_exact (p,
+                                          mpfr_custom_get_significand (op1),
+                                          mpfr_custom_get_significand (op2),
+                                          n);
+      if (fixed_exp_p (exp))
+        return (fixed_round (rop, p, 2 * n, 0, neg, exp, n,
+                             mpfr_get_prec (rop), rnd));
+    }
+  return (mpfr_mul (rop, op1, op2, rnd));
+}
+
+
+/**
+ * Fixed-limb `rop = op1 * op2 + op3` or `rop = op1 * op2 - op3`.
+ */
+FIXED_INLINE int
+fixed_fma (mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2, mpfr_srcptr op3,
+           mpfr_rnd_t rnd, int sub, size_t n)
+{
+  if (fixed_operand_p (rop, op1, n) && fixed_operand_p (rop, op2, n)
+      && (fixed_operand_p (rop, op3, n) || mpfr_zero_p (op3))
+      && (rnd >= MPFR_RNDN) && (rnd <= MPFR_RNDA))
+    {
+      mp_limb_t  p[2 * MPFR_FIXED_MAX_LIMBS];
+      int        np = (mpfr_signbit (op1) != 0) != (mpfr_signbit (op2) != 0);
+      mpfr_exp_t ep = mpfr_custom_get_exp (op1) + mpfr_custom_get_exp (op2)
+                      + fixed_mul_exact (p,
+                                         mpfr_custom_get_significand (op1),
+                                         mpfr_custom_get_significand (op2),
+                                         n);
+      if (mpfr_zero_p (op3))  // E.g. first step of a dot product.
+        {
+          if (fixed_exp_p (ep))
+            return (fixed_round (rop, p, 2 * n, 0, np, ep, n,
+                                 mpfr_get_prec (rop), rnd));
+        }
+      else
+        {
+          mp_limb_t  a[2 * MPFR_FIXED_MAX_LIMBS + 1];
+          mp_limb_t  sticky;
+          mpfr_exp_t exp;
+          int        neg;
+          if (fixed_sum (a, &exp, &neg, &sticky, p, 2 * n, ep, np,
+                         mpfr_custom_get_significand (op3), n,
+                         mpfr_custom_get_exp (op3),
+                         (mpfr_signbit (op3) != 0) != sub)
+              && fixed_exp_p (exp))
+            return (fixed_round (rop, a, 2 * n + 1, sticky, neg, exp, n,
+                                 mpfr_get_prec (rop), rnd));
+        }
+    }
+  return (sub ? mpfr_fms (rop, op1, op2, op3, rnd)
+          : mpfr_fma (rop, op1, op2, op3, rnd));
+}
+
+
+/**
+ * Fixed-limb `rop = op1 / op2`.
+ *
+ * The quotient of `n + 2` limbs is computed by `mpn_tdiv_qr`, a non-zero
+ * remainder is sticky.
+ */
+FIXED_INLINE int
+fixed_div (mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd,
+           size_t n)
+{
+  if (fixed_operand_p (rop, op1, n) && fixed_operand_p (rop, op2, n)
+      && (rnd >= MPFR_RNDN) && (rnd <= MPFR_RNDA))
+    {
+      const mp_limb_t *x = mpfr_custom_get_significand (op1);
+      mp_limb_t        u[2 * MPFR_FIXED_MAX_LIMBS + 1];
+      mp_limb_t        q[MPFR_FIXED_MAX_LIMBS + 2];
+      mp_limb_t        rem[MPFR_FIXED_MAX_LIMBS];
+      for (size_t i = 0; i < 2 * n + 1; i++)
+        u[i] = fixed_limb (x, n, 2 * n + 1, i);
+      mpn_tdiv_qr (q, rem, 0, u, (mp_size_t) (2 * n + 1),
+                   mpfr_custom_get_significand (op2), (mp_size_t) n);
+
+      mp_limb_t sticky = 0;
+      for (size_t i = 0; i < n; i++)
+        sticky |= rem[i];
+      mpfr_exp_t exp = mpfr_custom_get_exp (op1) - mpfr_custom_get_exp (op2);
+      if (q[n + 1] != 0)  // Quotient in [1, 2).
+        {
+          sticky |= q[0] & 1;
+          for (size_t i = 0; i <= n; i++)
+            q[i] = (q[i] >> 1) | (q[i + 1] << (GMP_NUMB_BITS - 1));
+          exp++;
+        }
+      int neg = (mpfr_signbit (op1) != 0) != (mpfr_signbit (op2) != 0);
+      if (fixed_exp_p (exp))
+        return (fixed_round (rop, q, n + 1, sticky, neg, exp, n,
+                             mpfr_get_prec (rop), rnd));
+    }
+  return (mpfr_div (rop, op1, op2, rnd));
+}
+
+
+// Kernels for `N` limbs.
+
+#define MPFR_FIXED_KERNELS(N)                                               \
+  static int                                                                \
+  mpfr_fixed_mul_##N (mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2,       \
+                      mpfr_rnd_t rnd)                                       \
+  {                                                                         \
+    return (fixed_mul (rop, op1, op2, rnd, N));                             \
+  }                                                                         \
+  static int                                                                \
+  mpfr_fixed_div_##N (mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2,       \
+                      mpfr_rnd_t rnd)                                       \
+  {                                                                         \
+    return (fixed_div (rop, op1, op2, rnd, N));                             \
+  }                                                                         \
+  static int                                                                \
+  mpfr_fixed_fma_##N (mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2,       \
+                      mpfr_srcptr op3, mpfr_rnd_t rnd)                      \
+  {                                                                         \
+    return (fixed_fma (rop, op1, op2, op3, rnd, 0, N));                     \
+  }                                                                         \
+  static int                                                                \
+  mpfr_fixed_fms_##N (mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2,       \
+                      mpfr_srcptr op3, mpfr_rnd_t rnd)                      \
+  {                                                                         \
+    return (fixed_fma (rop, op1, op2, op3, rnd, 1, N));                     \
+  }
+
+MPFR_FIXED_KERNELS (1)
+MPFR_FIXED_KERNELS (2)
+MPFR_FIXED_KERNELS (3)
+MPFR_FIXED_KERNELS (4)
+MPFR_FIXED_KERNELS (5)
+MPFR_FIXED_KERNELS (6)
+MPFR_FIXED_KERNELS (7)
+MPFR_FIXED_KERNELS (8)
+
+#define MPFR_FIXED_TABLE(op)                                              \
+  { NULL, mpfr_fixed_##op##_1, mpfr_fixed_##op##_2, mpfr_fixed_##op##_3,  \
+    mpfr_fixed_##op##_4, mpfr_fixed_##op##_5, mpfr_fixed_##op##_6,        \
+    mpfr_fixed_##op##_7, mpfr_fixed_##op##_8 }
+
+static const mpfr_fixed_op2_t mpfr_fixed_mul[] = MPFR_FIXED_TABLE (mul);
+static const mpfr_fixed_op2_t mpfr_fixed_div[] = MPFR_FIXED_TABLE (div);
+static const mpfr_fixed_op3_t mpfr_fixed_fma[] = MPFR_FIXED_TABLE (fma);
+static const mpfr_fixed_op3_t mpfr_fixed_fms[] = MPFR_FIXED_TABLE (fms);
+
+
+/**
+ * Check if a fixed-limb kernel is faster than the MPFR function.
+ *
+ * @param[in] cmd_code Command code of the MPFR function (1000 - 1899).
+ * @param[in] prec Precision of the result variables.
+ *
+ * @returns non-zero, if the kernel is to be used.
+ */
+static int
+fixed_profitable_p (uint64_t cmd_code, mpfr_prec_t prec)
+{
+  size_t n = fixed_limbs (prec);
+  if ((n == 0) || (n > mpfr_fixed_max_limbs) || (n > MPFR_FIXED_MAX_LIMBS))
+    return (0);
+
+  // Precision with special code in MPFR.
+  int mpfr_special = (n < 3) && ((prec % GMP_NUMB_BITS) != 0);
+  switch (cmd_code)
+    {
+      case 1036:  // mpfr_mul
+        return ((n > 1) && ! mpfr_special);
+      case 1039:  // mpfr_div
+        return ((n > 1) && (n <= 4) && ! mpfr_special);
+      case 1056:  // mpfr_fma
+      case 1057:  // mpfr_fms
+        return (n <= 3);
+      default:
+        return (0);
+    }
+}
+
+
+mpfr_fixed_op2_t
+mex_mpfr_fixed_op2 (uint64_t cmd_code, mpfr_prec_t prec,
+                    mpfr_fixed_op2_t fcn)
+{
+  if (! fixed_profitable_p (cmd_code, prec))
+    return (fcn);
+  fixed_emin = mpfr_get_emin ();
+  fixed_emax = mpfr_get_emax ();
+  return ((cmd_code == 1036) ? mpfr_fixed_mul[fixed_limbs (prec)]
+          : mpfr_fixed_div[fixed_limbs (prec)]);
+}
+
+
+mpfr_fixed_op3_t
+mex_mpfr_fixed_op3 (uint64_t cmd_code, mpfr_prec_t prec,
+                    mpfr_fixed_op3_t fcn)
+{
+  if (! fixed_profitable_p (cmd_code, prec))
+    return (fcn);
+  fixed_emin = mpfr_get_emin ();
+  fixed_emax = mpfr_get_emax ();
+  return ((cmd_code == 1056) ? mpfr_fixed_fma[fixed_limbs (prec)]
+          : mpfr_fixed_fms[fixed_limbs (prec)]);
+}
@@ -0,0 +1,308 @@
+/*
+ * This file is part of APA.
+ *
+ *  APA is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  APA is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mex_mpfr_interface.h"
+
+// Contiguous limb blocks
+// ======================
+//
+// Setting the precision of at least `mpfr_limb_blocks_threshold` MPFR
+// variables at once (e.g. by the @mpfr_t constructor) allocates a single
+// contiguous limb block for all of them.  The variables are initialized by
+// `mpfr_custom_init_set`, thus neighboring matrix elements share cache lines
+// and pages.  A threshold of `0` disables contiguous limb blocks.
+//
+// MPFR must neither free nor reallocate the significand of such a variable.
+// They are recognized by the address of their significand and
+// `mex_mpfr_clear`, `mex_mpfr_set_prec`, and `mex_mpfr_prec_round` must be
+// used instead of the respective MPFR functions.  A variable that needs a
+// larger significand gets its own one (detach).  A block is released, once
+// no variable refers to it anymore.  `mpfr_swap` can be used as usual.
+
+typedef struct
+{
+  char  *limbs;     // Start of the block.
+  size_t size;      // Size of the block in bytes.
+  size_t stride;    // Size of each significand in bytes.
+  size_t refcount;  // Number of variables with a significand in this block.
+} mpfr_limb_block_t;
+
+static mpfr_limb_block_t *mpfr_limb_blocks          = NULL;  // Sorted by limbs.
+static size_t             mpfr_limb_blocks_capacity = 0;
+static size_t             mpfr_limb_blocks_size     = 0;
+
+size_t mpfr_limb_blocks_threshold = 0;
+
+
+/**
+ * Find the limb block containing the significand of a MPFR variable.
+ *
+ * @param x MPFR variable.
+ *
+ * @returns pointer to the limb block, NULL if `x` has no significand in a
+ *          limb block.
+ */
+static mpfr_limb_block_t *
+mpfr_limb_block_find (mpfr_srcptr x)
+{
+  if (mpfr_limb_blocks_size == 0)
+    return (NULL);
+
+  uintptr_t p  = (uintptr_t) mpfr_custom_get_significand (x);
+  size_t    lo = 0;
+  size_t    hi = mpfr_limb_blocks_size;
+  while (lo < hi)  // Number of blocks starting at or before `p`.
+    {
+      size_t mid = lo + (hi - lo) / 2;
+      if ((uintptr_t) mpfr_limb_blocks[mid].limbs <= p)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  if (lo == 0)
+    return (NULL);
+
+  mpfr_limb_block_t *block = &mpfr_limb_blocks[lo - 1];
+  if (p < (uintptr_t) block->limbs + block->size)
+    return (block);
+  return (NULL);
+}
+
+
+/**
+ * Remove the reference of a MPFR variable to a limb block.
+ *
+ * Thread-safe.
+ *
+ * @param block Pointer to limb block.
+ */
+static inline void
+mpfr_limb_block_detach (mpfr_limb_block_t *block)
+{
+  #pragma omp atomic
+  block->refcount--;
+}
+
+
+/**
+ * Release limb blocks without any reference.
+ *
+ * Not thread-safe.
+ */
+void
+mex_mpfr_limb_blocks_collect (void)
+{
+  size_t j = 0;
+
+  for (size_t i = 0; i < mpfr_limb_blocks_size; i++)
+    if (mpfr_limb_blocks[i].refcount == 0)
+      {
+        DBG_PRINTF ("Release limb block %p.\n",
+                    (void *) mpfr_limb_blocks[i].limbs);
+        mxFree (mpfr_limb_blocks[i].limbs);
+      }
+    else
+      mpfr_limb_blocks[j++] = mpfr_limb_blocks[i];
+  mpfr_limb_blocks_size = j;
+}
+
+
+/**
+ * Release all limb blocks.
+ *
+ * Not thread-safe.  Afterwards, no MPFR variable may refer to a limb block.
+ */
+void
+mex_mpfr_limb_blocks_release (void)
+{
+  for (size_t i = 0; i < mpfr_limb_blocks_size; i++)
+    mxFree (mpfr_limb_blocks[i].limbs);
+  mxFree (mpfr_limb_blocks);
+  mpfr_limb_blocks          = NULL;
+  mpfr_limb_blocks_capacity = 0;
+  mpfr_limb_blocks_size     = 0;
+}
+
+
+/**
+ * Initialize MPFR variables with a contiguous limb block.
+ *
+ * Not thread-safe.  Nothing is done, if `n` is below the threshold
+ * `mpfr_limb_blocks_threshold`.
+ *
+ * @param x Pointer to `n` initialized MPFR variables.
+ * @param n Number of MPFR variables.
+ * @param prec Precision of all MPFR variables.
+ *
+ * @returns `1` if the variables are reinitialized with precision `prec` and
+ *          value NaN, otherwise `0` and the variables are unchanged.
+ */
+int
+mex_mpfr_init2_contiguous (mpfr_ptr x, size_t n, mpfr_prec_t prec)
+{
+  if ((mpfr_limb_blocks_threshold == 0) || (n < mpfr_limb_blocks_threshold))
+    return (0);
+
+  // Extend space if necessary.
+  if (mpfr_limb_blocks_size == mpfr_limb_blocks_capacity)
+    {
+      size_t new_capacity = mpfr_limb_blocks_capacity + DATA_CHUNK_SIZE;
+      mpfr_limb_block_t *new_blocks = NULL;
+      if (mpfr_limb_blocks == NULL)
+        new_blocks = (mpfr_limb_block_t *) mxMalloc (
+          new_capacity * sizeof(mpfr_limb_block_t));
+      else
+        new_blocks = (mpfr_limb_block_t *) mxRealloc (
+          mpfr_limb_blocks, new_capacity * sizeof(mpfr_limb_block_t));
+      if (new_blocks == NULL)
+        return (0);  // Memory allocation failed.
+
+      mexMakeMemoryPersistent (new_blocks);
+      mpfr_limb_blocks          = new_blocks;
+      mpfr_limb_blocks_capacity = new_capacity;
+    }
+
+  size_t stride = mpfr_custom_get_size (prec);
+  char  *limbs  = (char *) mxMalloc (n * stride);
+  if (limbs == NULL)
+    return (0);  // Memory allocation failed.
+
+  mexMakeMemoryPersistent (limbs);
+  DBG_PRINTF ("New limb block %p for %d variables (prec = %d).\n",
+              (void *) limbs, (int) n, (int) prec);
+
+  // Release old significands before the block table changes.  This may
+  // leave limb blocks of reused free variables without reference.
+  #pragma omp parallel for
+  for (size_t i = 0; i < n; i++)
+    mex_mpfr_clear (x + i);
+  mex_mpfr_limb_blocks_collect ();
+
+  // Insert block, keep table sorted by address.
+  size_t pos = mpfr_limb_blocks_size;
+  while ((pos > 0)
+         && ((uintptr_t) mpfr_limb_blocks[pos - 1].limbs > (uintptr_t) limbs))
+    {
+      mpfr_limb_blocks[pos] = mpfr_limb_blocks[pos - 1];
+      pos--;
+    }
+  mpfr_limb_blocks[pos].limbs    = limbs;
+  mpfr_limb_blocks[pos].size     = n * stride;
+  mpfr_limb_blocks[pos].stride   = stride;
+  mpfr_limb_blocks[pos].refcount = n;
+  mpfr_limb_blocks_size++;
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < n; i++)
+    {
+      mpfr_custom_init (limbs + i * stride, prec);
+      mpfr_custom_init_set (x + i, MPFR_NAN_KIND, 0, prec, limbs + i * stride);
+    }
+  return (1);
+}
+
+
+/**
+ * Detach a MPFR variable from its contiguous limb block.
+ *
+ * Thread-safe, as long as no limb block is created or collected.
+ *
+ * @param x MPFR variable.
+ *
+ * @returns `1` if `x` had its significand in a limb block and is
+ *          uninitialized now, otherwise `0` and `x` is unchanged.
+ */
+int
+mex_mpfr_detach (mpfr_ptr x)
+{
+  mpfr_limb_block_t *block = mpfr_limb_block_find (x);
+
+  if (block == NULL)
+    return (0);
+  mpfr_limb_block_detach (block);
+  return (1);
+}
+
+
+/**
+ * Like `mpfr_clear`, aware of contiguous limb blocks.
+ *
+ * Thread-safe, as long as no limb block is created or collected.
+ *
+ * @param x MPFR variable.
+ */
+void
+mex_mpfr_clear (mpfr_ptr x)
+{
+  if (! mex_mpfr_detach (x))
+    mpfr_clear (x);
+}
+
+
+/**
+ * Like `mpfr_set_prec`, aware of contiguous limb blocks.
+ *
+ * Thread-safe, as long as no limb block is created or collected.
+ *
+ * @param x MPFR variable.
+ * @param prec New precision of `x`.
+ */
+void
+mex_mpfr_set_prec (mpfr_ptr x, mpfr_prec_t prec)
+{
+  mpfr_limb_block_t *block = mpfr_limb_block_find (x);
+
+  if (block == NULL)
+    mpfr_set_prec (x, prec);
+  else if (mpfr_custom_get_size (prec) <= block->stride)
+    mpfr_custom_init_set (x, MPFR_NAN_KIND, 0, prec,
+                          mpfr_custom_get_significand (x));
+  else
+    {
+      mpfr_limb_block_detach (block);
+      mpfr_init2 (x, prec);
+    }
+}
+
+
+/**
+ * Like `mpfr_prec_round`, aware of contiguous limb blocks.
+ *
+ * Thread-safe, as long as no limb block is created or collected.
+ *
+ * @param x MPFR variable.
+ * @param prec New precision of `x`.
+ * @param rnd Rounding mode.
+ *
+ * @returns ternary value like `mpfr_prec_round`.
+ */
+int
+mex_mpfr_prec_round (mpfr_ptr x, mpfr_prec_t prec, mpfr_rnd_t rnd)
+{
+  mpfr_limb_block_t *block = mpfr_limb_block_find (x);
+
+  if (block == NULL)
+    return (mpfr_prec_round (x, prec, rnd));
+
+  // MPFR cannot round in place, detach `x` from the block.
+  mpfr_t tmp;
+  mpfr_init2 (tmp, prec);
+  int ret = mpfr_set (tmp, x, rnd);
+  mpfr_limb_block_detach (block);
+  *x = *tmp;
+  return (ret);
+}
@@ -15,23 +15,177 @@
  *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <stdlib.h>  // qsort
+
+#include "mex_gmp_interface.h"
 #include "mex_mpfr_interface.h"
 
 // MPFR memory management
 // ======================
 //
+// MPFR variables are addressed by 1-based indices and stored in segments of
+// one or more pages with `DATA_CHUNK_SIZE` variables each.  Segments never
+// move in memory and index ranges never cross segment boundaries, thus each
+// index range is a contiguous array of MPFR variables.  The page table maps
+// each page to its segment.
+//
+// Variables of a segment are initialized (`mpfr_init`) lazily on first use,
+// up to the index `init_end`.
+//
 // Similar to C++ std::vector:
 // - xxx_capacity: number of elements that `xxx` has currently allocated
 //                 space for.
 // - xxx_size:     number of elements in `xxx`.
+//
+// - mpfr_data_capacity: number of variables in all segments.
+// - mpfr_data_size:     largest index of a used variable.
+//
+// `mex_mpfr_compact` relocates all used variables to the smallest indices
+// and releases segments without used variables.
+
+typedef struct
+{
+  mpfr_ptr data;      // Variables of this segment.
+  size_t   start;     // First index (1-based) of this segment.
+  size_t   end;       // Last index (1-based) of this segment.
+  size_t   init_end;  // Last initialized index, `start - 1` if none.
+} mpfr_segment_t;
+
+static mpfr_segment_t *mpfr_segments          = NULL;
+static size_t          mpfr_segments_capacity = 0;
+static size_t          mpfr_segments_size     = 0;
 
-mpfr_ptr mpfr_data          = NULL;
-size_t   mpfr_data_capacity = 0;
-size_t   mpfr_data_size     = 0;
+static size_t *mpfr_page_table          = NULL;  // Page -> segment number.
+static size_t  mpfr_page_table_capacity = 0;
+static size_t  mpfr_page_table_size     = 0;
 
-idx_t *mpfr_free_list          = NULL;
-size_t mpfr_free_list_capacity = 0;
-size_t mpfr_free_list_size     = 0;
+size_t mpfr_data_capacity = 0;
+size_t mpfr_data_size     = 0;
+
+#define SEGMENT_OF(i) mpfr_segments[mpfr_page_table[((i) - 1) / DATA_CHUNK_SIZE]]
+
+
+// Pool of free MPFR variables
+// ===========================
+//
+// Each free index range is a node of an AVL tree ordered by the start index.
+// The tree finds the neighbors of a range to merge in O(log n).
+//
+// Additionally, free ranges are kept in segregated size classes (bins).  Bin
+// `k` holds the nodes of all free ranges whose length `l` satisfies
+// `2^k <= l < 2^(k+1)`.  The bitmap `mpfr_free_bins_used` marks non-empty
+// bins, thus a fitting range is found without scanning the whole pool.
+//
+// Free variables keep their significands (lazy reclaim), also those in
+// contiguous limb blocks.  Each free range is tagged with the precision of
+// all its variables, or `0` if mixed, and `mex_mpfr_allocate` prefers ranges
+// of the requested precision.  Thus the subsequent `mpfr_set_prec` usually
+// needs no memory allocation.  Memory of free variables is only released by
+// `mpfr_tidy_up` or when a limb block loses its last variable on reuse.
+//
+// Nodes are addressed by 1-based ids into `mpfr_free_nodes`, id `0` is the
+// empty tree.  Unused nodes are chained by their `left` member, starting
+// with `mpfr_free_nodes_unused`.
+//
+// - mpfr_free_list_size: total number of free ranges.
+
+#define MPFR_FREE_BINS     64  // One bin for each bit of `size_t`.
+#define MPFR_FREE_BIN_SCAN 16  // Max. entries to scan in a partially fitting bin.
+
+typedef struct
+{
+  idx_t       idx;      // Free index range.
+  mpfr_prec_t prec;     // Precision of all variables in `idx`, `0` if mixed.
+  size_t      left;     // Node id of left subtree (smaller start indices).
+  size_t      right;    // Node id of right subtree (larger start indices).
+  int         height;   // Height of the subtree rooted at this node.
+  size_t      bin_pos;  // Position (0-based) of this node in its bin.
+} mpfr_free_node_t;
+
+typedef struct
+{
+  size_t *list;  // Node ids.
+  size_t capacity;
+  size_t size;
+} mpfr_free_bin_t;
+
+static mpfr_free_node_t *mpfr_free_nodes          = NULL;
+static size_t            mpfr_free_nodes_capacity = 0;
+static size_t            mpfr_free_nodes_unused   = 0;
+static size_t            mpfr_free_tree           = 0;
+
+static mpfr_free_bin_t mpfr_free_bins[MPFR_FREE_BINS];
+static uint64_t        mpfr_free_bins_used = 0;
+size_t                 mpfr_free_list_size = 0;
+
+#define NODE(id) mpfr_free_nodes[(id) - 1]
+
+
+// Handles
+// =======
+//
+// Octave objects do not store indices of MPFR variables, but handles.  Each
+// allocation gets a range of handles of the same length.  Handles are never
+// reused, thus stale handles (e.g. in recorded tapes) are detected instead of
+// addressing other MPFR variables.  The handle table maps each handle
+// range to its current index range, thus MPFR variables can be relocated.
+// Subranges of a handle range (e.g. matrix columns) resolve to the
+// respective subranges of indices.
+//
+// New handles are always larger than existing ones, thus appending keeps the
+// table sorted.  Released entries have length `0` and are removed, once they
+// are the majority.
+//
+// A small direct-mapped cache remembers the table entries of recently
+// resolved handles, thus most calls skip the binary search.  Cached
+// positions are validated on use and never need to be invalidated.
+
+#define MPFR_HANDLE_CACHE_SIZE 64  // Power of two.
+
+typedef struct
+{
+  size_t handle;  // First handle (1-based) of the range.
+  size_t start;   // First index (1-based) of the MPFR variables.
+  size_t length;  // Number of MPFR variables, `0` if released.
+} mpfr_handle_t;
+
+static mpfr_handle_t *mpfr_handles          = NULL;  // Sorted by handle.
+static size_t         mpfr_handles_capacity = 0;
+static size_t         mpfr_handles_size     = 0;
+static size_t         mpfr_handles_released = 0;  // Entries of length `0`.
+static size_t         mpfr_handles_next     = 1;  // Smallest unused handle.
+
+static size_t mpfr_handle_cache[MPFR_HANDLE_CACHE_SIZE];  // Table positions.
+
+
+// Deferred release
+// ================
+//
+// `mex_mpfr_mark_free` only appends an index range to a queue.  The queue is
+// processed in one batch, sorted by start index with neighboring ranges
+// coalesced, when it is full, by `mex_mpfr_flush_free`, or before
+// `mex_mpfr_allocate` searches the pool.  Before that, `mex_mpfr_allocate`
+// reuses a queued range of exactly the requested length, the common case of
+// temporary variables in loops.
+
+#define MPFR_FREE_QUEUE_SIZE 256
+
+static idx_t  mpfr_free_queue[MPFR_FREE_QUEUE_SIZE];
+static size_t mpfr_free_queue_size = 0;
+
+
+// Statistics since startup
+// ========================
+//
+// Not reset by `mpfr_tidy_up`, see `mex_mpfr_memory_stats`.
+
+static size_t mpfr_stats_allocate       = 0;  // Calls of `mex_mpfr_allocate`.
+static size_t mpfr_stats_allocate_queue = 0;  // Ranges reused from the queue.
+static size_t mpfr_stats_allocate_pool  = 0;  // Ranges reused from the pool.
+static size_t mpfr_stats_mark_free      = 0;  // Calls of `mex_mpfr_mark_free`.
+static size_t mpfr_stats_compact        = 0;  // Calls of `mex_mpfr_compact`.
+static size_t mpfr_data_capacity_max    = 0;  // High-water marks.
+static size_t mpfr_data_size_max        = 0;
 
 
 /**
@@ -45,7 +199,50 @@ int
 is_valid (idx_t *idx)
 {
   return ((1 <= (*idx).start) && ((*idx).start <= (*idx).end)
-          && ((*idx).end <= mpfr_data_size));
+          && ((*idx).end <= mpfr_data_size)
+          && (SEGMENT_OF ((*idx).start).end >= (*idx).end));
+}
+
+
+/**
+ * Pointer to the first MPFR variable of a valid index range.
+ *
+ * @param[in] idx Pointer to index (1-based, idx_t) of MPFR variables.
+ *
+ * @returns pointer to the first MPFR variable, all other MPFR variables of
+ *          `idx` follow contiguously.
+ */
+mpfr_ptr
+mex_mpfr_ptr (idx_t *idx)
+{
+  mpfr_segment_t *seg = &SEGMENT_OF (idx->start);
+
+  return (seg->data + (idx->start - seg->start));
+}
+
+
+/**
+ * Empty the pool of free MPFR variables and release its memory.
+ *
+ * The free MPFR variables themselves are not touched.
+ */
+static void
+mpfr_free_list_release (void)
+{
+  mxFree (mpfr_free_nodes);
+  mpfr_free_nodes          = NULL;
+  mpfr_free_nodes_capacity = 0;
+  mpfr_free_nodes_unused   = 0;
+  mpfr_free_tree           = 0;
+  for (size_t k = 0; k < MPFR_FREE_BINS; k++)
+    {
+      mxFree (mpfr_free_bins[k].list);
+      mpfr_free_bins[k].list     = NULL;
+      mpfr_free_bins[k].capacity = 0;
+      mpfr_free_bins[k].size     = 0;
+    }
+  mpfr_free_bins_used = 0;
+  mpfr_free_list_size = 0;
 }
 
 
@@ -57,145 +254,1008 @@ static void
 mpfr_tidy_up (void)
 {
   DBG_PRINTF ("%s\n", "Call");
-  for (size_t i = 0; i < mpfr_data_size; i++)
-    mpfr_clear (&mpfr_data[i]);
-  mxFree (mpfr_data);
-  mpfr_data          = NULL;
-  mpfr_data_capacity = 0;
-  mpfr_data_size     = 0;
-  mxFree (mpfr_free_list);
-  mpfr_free_list          = NULL;
-  mpfr_free_list_capacity = 0;
-  mpfr_free_list_size     = 0;
+  for (size_t s = 0; s < mpfr_segments_size; s++)
+    {
+      mpfr_segment_t *seg = &mpfr_segments[s];
+      for (size_t i = 0; i < seg->init_end + 1 - seg->start; i++)
+        mex_mpfr_clear (seg->data + i);
+      mxFree (seg->data);
+    }
+  mex_mpfr_limb_blocks_release ();
+  mex_mpfr_tape_release ();
+  mxFree (mpfr_segments);
+  mpfr_segments          = NULL;
+  mpfr_segments_capacity = 0;
+  mpfr_segments_size     = 0;
+  mxFree (mpfr_page_table);
+  mpfr_page_table          = NULL;
+  mpfr_page_table_capacity = 0;
+  mpfr_page_table_size     = 0;
+  mpfr_data_capacity       = 0;
+  mpfr_data_size           = 0;
+  mpfr_free_list_release ();
+  mpfr_free_queue_size = 0;
+  mxFree (mpfr_handles);
+  mpfr_handles          = NULL;
+  mpfr_handles_capacity = 0;
+  mpfr_handles_size     = 0;
+  mpfr_handles_released = 0;
+
+  // Free MPFR caches (e.g. of `mpfr_const_pi`) of all threads, before
+  // releasing their limb memory.
+  #if (MPFR_VERSION >= MPFR_VERSION_NUM (4, 0, 0))
+  #pragma omp parallel
+  mpfr_free_cache2 (MPFR_FREE_LOCAL_CACHE);
+  mpfr_free_cache2 (MPFR_FREE_LOCAL_CACHE | MPFR_FREE_GLOBAL_CACHE);
+  #else
+  mpfr_free_cache ();
+  #endif
+  mex_gmp_memory_pool_release ();
 }
 
 
 /**
- * Remove the i-th entry from the pool of free MPFR variables.
+ * Release all memory of MPFR variables, if none is in use.
  *
- * @param i index (0-based) to entry to remove from the pool.
+ * @returns `1` if the memory was released, otherwise `0`.
  */
-void
-mpfr_free_list_remove (size_t i)
+int
+mex_mpfr_release (void)
+{
+  mex_mpfr_flush_free ();
+  if (mpfr_data_size > 0)
+    return (0);
+  mpfr_tidy_up ();
+  return (1);
+}
+
+
+/**
+ * Initialize all MPFR variables of a segment up to a given index.
+ *
+ * @param seg Pointer to segment.
+ * @param end Last index (1-based) that must be initialized.
+ */
+static void
+mpfr_segment_init (mpfr_segment_t *seg, size_t end)
+{
+  for (size_t i = seg->init_end + 1; i <= end; i++)
+    mpfr_init (seg->data + (i - seg->start));
+  if (end > seg->init_end)
+    seg->init_end = end;
+}
+
+
+/**
+ * Append a new segment with a given number of pages.
+ *
+ * The page table and the segment list grow geometrically, already existing
+ * MPFR variables are not moved.
+ *
+ * @param num_pages Number of pages of the new segment.
+ *
+ * @returns success of segment creation.
+ */
+static int
+mpfr_segment_append (size_t num_pages)
+{
+  // Extend space of page table and segment list if necessary.
+  if (mpfr_page_table_size + num_pages > mpfr_page_table_capacity)
+    {
+      size_t new_capacity = (mpfr_page_table_capacity == 0)
+                            ? 16 : 2 * mpfr_page_table_capacity;
+      while (mpfr_page_table_size + num_pages > new_capacity)
+        new_capacity *= 2;
+      DBG_PRINTF ("Increase page table capacity to '%d'.\n", new_capacity);
+      size_t *new_table = NULL;
+      if (mpfr_page_table == NULL)
+        new_table = (size_t *) mxMalloc (new_capacity * sizeof(size_t));
+      else
+        new_table = (size_t *) mxRealloc (mpfr_page_table,
+                                          new_capacity * sizeof(size_t));
+      if (new_table == NULL)
+        return (0);  // Memory allocation failed.
+
+      mexMakeMemoryPersistent (new_table);
+      mpfr_page_table          = new_table;
+      mpfr_page_table_capacity = new_capacity;
+    }
+  if (mpfr_segments_size == mpfr_segments_capacity)
+    {
+      size_t new_capacity = (mpfr_segments_capacity == 0)
+                            ? 16 : 2 * mpfr_segments_capacity;
+      mpfr_segment_t *new_segments = NULL;
+      if (mpfr_segments == NULL)
+        new_segments = (mpfr_segment_t *) mxMalloc (
+          new_capacity * sizeof(mpfr_segment_t));
+      else
+        new_segments = (mpfr_segment_t *) mxRealloc (
+          mpfr_segments, new_capacity * sizeof(mpfr_segment_t));
+      if (new_segments == NULL)
+        return (0);  // Memory allocation failed.
+
+      mexMakeMemoryPersistent (new_segments);
+      mpfr_segments          = new_segments;
+      mpfr_segments_capacity = new_capacity;
+    }
+
+  size_t   num_vars = num_pages * DATA_CHUNK_SIZE;
+  mpfr_ptr data     = (mpfr_ptr) mxMalloc (num_vars * sizeof(mpfr_t));
+  if (data == NULL)
+    return (0);  // Memory allocation failed.
+
+  mexMakeMemoryPersistent (data);
+  if (mpfr_segments_size == 0)
+    mexAtExit (mpfr_tidy_up);
+
+  mpfr_segment_t *seg = &mpfr_segments[mpfr_segments_size];
+  seg->data     = data;
+  seg->start    = mpfr_data_capacity + 1;
+  seg->end      = mpfr_data_capacity + num_vars;
+  seg->init_end = mpfr_data_capacity;
+  for (size_t i = 0; i < num_pages; i++)
+    mpfr_page_table[mpfr_page_table_size++] = mpfr_segments_size;
+  mpfr_segments_size++;
+  mpfr_data_capacity += num_vars;
+  if (mpfr_data_capacity > mpfr_data_capacity_max)
+    mpfr_data_capacity_max = mpfr_data_capacity;
+  DBG_PRINTF ("New segment [%d:%d].\n", seg->start, seg->end);
+  return (1);
+}
+
+
+/**
+ * Size class (bin) of an index range length.
+ *
+ * @param len Length of index range (`len > 0`).
+ *
+ * @returns `floor (log2 (len))`.
+ */
+static inline size_t
+mpfr_free_bin_floor (size_t len)
+{
+  return (MPFR_FREE_BINS - 1 - (size_t) __builtin_clzll (len));
+}
+
+
+/**
+ * Smallest size class (bin) whose ranges all have at least length `len`.
+ *
+ * @param len Length of index range (`len > 0`).
+ *
+ * @returns `ceil (log2 (len))`.
+ */
+static inline size_t
+mpfr_free_bin_ceil (size_t len)
+{
+  return ((len == 1) ? 0 : mpfr_free_bin_floor (len - 1) + 1);
+}
+
+
+/**
+ * Remove a node from its bin.
+ *
+ * The last entry of the bin takes its place, thus this operation is O(1).
+ *
+ * @param node Node id.
+ */
+static void
+mpfr_free_bin_remove (size_t node)
 {
-  for (; i < mpfr_free_list_size; i++)
+  size_t           k    = mpfr_free_bin_floor (length (&NODE (node).idx));
+  mpfr_free_bin_t *bin  = &mpfr_free_bins[k];
+  size_t           i    = NODE (node).bin_pos;
+  size_t           last = bin->list[bin->size - 1];
+
+  bin->list[i]         = last;
+  NODE (last).bin_pos = i;
+  bin->size--;
+  if (bin->size == 0)
+    mpfr_free_bins_used &= ~(((uint64_t) 1) << k);
+}
+
+
+/**
+ * Insert a node into the bin matching the length of its index range.
+ *
+ * @param node Node id.
+ *
+ * @returns success of insertion.
+ */
+static int
+mpfr_free_bin_insert (size_t node)
+{
+  size_t           k   = mpfr_free_bin_floor (length (&NODE (node).idx));
+  mpfr_free_bin_t *bin = &mpfr_free_bins[k];
+
+  // Extend space if necessary.
+  if (bin->size == bin->capacity)
+    {
+      size_t new_capacity = bin->capacity + DATA_CHUNK_SIZE;
+      DBG_PRINTF ("Increase capacity of bin %d to '%d'.\n", (int) k,
+                  new_capacity);
+      size_t *new_list = NULL;
+      if (bin->list == NULL)
+        {
+          new_list = (size_t *) mxMalloc (new_capacity * sizeof(size_t));
+          mexAtExit (mpfr_tidy_up);
+        }
+      else
+        new_list = (size_t *) mxRealloc (bin->list,
+                                         new_capacity * sizeof(size_t));
+      if (new_list == NULL)
+        return (0);  // Memory allocation failed.
+
+      mexMakeMemoryPersistent (new_list);
+      bin->list     = new_list;
+      bin->capacity = new_capacity;
+    }
+
+  NODE (node).bin_pos     = bin->size;
+  bin->list[bin->size++] = node;
+  mpfr_free_bins_used   |= ((uint64_t) 1) << k;
+  return (1);
+}
+
+
+/**
+ * Height of an AVL subtree.
+ *
+ * @param t Node id of the subtree root.
+ *
+ * @returns height of the subtree, `0` for the empty tree.
+ */
+static inline int
+mpfr_free_tree_height (size_t t)
+{
+  return ((t == 0) ? 0 : NODE (t).height);
+}
+
+
+/**
+ * Update the height of an AVL node from its children.
+ *
+ * @param t Node id.
+ */
+static inline void
+mpfr_free_tree_update (size_t t)
+{
+  int hl = mpfr_free_tree_height (NODE (t).left);
+  int hr = mpfr_free_tree_height (NODE (t).right);
+
+  NODE (t).height = ((hl > hr) ? hl : hr) + 1;
+}
+
+
+/**
+ * Rotate an AVL subtree to the right.
+ *
+ * @param t Node id of the subtree root.
+ *
+ * @returns node id of the new subtree root.
+ */
+static size_t
+mpfr_free_tree_rotate_right (size_t t)
+{
+  size_t l = NODE (t).left;
+
+  NODE (t).left  = NODE (l).right;
+  NODE (l).right = t;
+  mpfr_free_tree_update (t);
+  mpfr_free_tree_update (l);
+  return (l);
+}
+
+
+/**
+ * Rotate an AVL subtree to the left.
+ *
+ * @param t Node id of the subtree root.
+ *
+ * @returns node id of the new subtree root.
+ */
+static size_t
+mpfr_free_tree_rotate_left (size_t t)
+{
+  size_t r = NODE (t).right;
+
+  NODE (t).right = NODE (r).left;
+  NODE (r).left  = t;
+  mpfr_free_tree_update (t);
+  mpfr_free_tree_update (r);
+  return (r);
+}
+
+
+/**
+ * Restore the AVL property of a subtree whose children are balanced.
+ *
+ * @param t Node id of the subtree root.
+ *
+ * @returns node id of the new subtree root.
+ */
+static size_t
+mpfr_free_tree_balance (size_t t)
+{
+  int balance = mpfr_free_tree_height (NODE (t).left)
+                - mpfr_free_tree_height (NODE (t).right);
+
+  if (balance > 1)
+    {
+      size_t l = NODE (t).left;
+      if (mpfr_free_tree_height (NODE (l).left)
+          < mpfr_free_tree_height (NODE (l).right))
+        NODE (t).left = mpfr_free_tree_rotate_left (l);
+      return (mpfr_free_tree_rotate_right (t));
+    }
+  if (balance < -1)
     {
-      mpfr_free_list[i].start = mpfr_free_list[i + 1].start;
-      mpfr_free_list[i].end   = mpfr_free_list[i + 1].end;
+      size_t r = NODE (t).right;
+      if (mpfr_free_tree_height (NODE (r).right)
+          < mpfr_free_tree_height (NODE (r).left))
+        NODE (t).right = mpfr_free_tree_rotate_right (r);
+      return (mpfr_free_tree_rotate_left (t));
     }
+  mpfr_free_tree_update (t);
+  return (t);
+}
+
+
+/**
+ * Insert a node into an AVL subtree.
+ *
+ * @param t Node id of the subtree root.
+ * @param node Node id to insert.
+ *
+ * @returns node id of the new subtree root.
+ */
+static size_t
+mpfr_free_tree_insert (size_t t, size_t node)
+{
+  if (t == 0)
+    return (node);
+  if (NODE (node).idx.start < NODE (t).idx.start)
+    NODE (t).left = mpfr_free_tree_insert (NODE (t).left, node);
+  else
+    NODE (t).right = mpfr_free_tree_insert (NODE (t).right, node);
+  return (mpfr_free_tree_balance (t));
+}
+
+
+/**
+ * Detach the node with the smallest start index from an AVL subtree.
+ *
+ * @param t Node id of the subtree root.
+ * @param[out] min Node id of the detached node.
+ *
+ * @returns node id of the new subtree root.
+ */
+static size_t
+mpfr_free_tree_remove_min (size_t t, size_t *min)
+{
+  if (NODE (t).left == 0)
+    {
+      *min = t;
+      return (NODE (t).right);
+    }
+  NODE (t).left = mpfr_free_tree_remove_min (NODE (t).left, min);
+  return (mpfr_free_tree_balance (t));
+}
+
+
+/**
+ * Detach a node from an AVL subtree.
+ *
+ * Node ids of all other nodes remain unchanged.
+ *
+ * @param t Node id of the subtree root.
+ * @param node Node id to detach.
+ *
+ * @returns node id of the new subtree root.
+ */
+static size_t
+mpfr_free_tree_remove (size_t t, size_t node)
+{
+  if (t == 0)
+    return (0);
+  if (NODE (node).idx.start < NODE (t).idx.start)
+    NODE (t).left = mpfr_free_tree_remove (NODE (t).left, node);
+  else if (NODE (node).idx.start > NODE (t).idx.start)
+    NODE (t).right = mpfr_free_tree_remove (NODE (t).right, node);
+  else
+    {
+      size_t l = NODE (t).left;
+      size_t r = NODE (t).right;
+      if (r == 0)
+        return (l);
+      size_t min = 0;
+      r               = mpfr_free_tree_remove_min (r, &min);
+      NODE (min).left  = l;
+      NODE (min).right = r;
+      return (mpfr_free_tree_balance (min));
+    }
+  return (mpfr_free_tree_balance (t));
+}
+
+
+/**
+ * Find the free range with the largest start index less than `start`.
+ *
+ * @param start Start index (1-based).
+ *
+ * @returns node id of the free range, `0` if none exists.
+ */
+static size_t
+mpfr_free_tree_find_before (size_t start)
+{
+  size_t found = 0;
+
+  for (size_t t = mpfr_free_tree; t != 0;)
+    if (NODE (t).idx.start < start)
+      {
+        found = t;
+        t     = NODE (t).right;
+      }
+    else
+      t = NODE (t).left;
+  return (found);
+}
+
+
+/**
+ * Find the free range with the smallest start index greater than `start`.
+ *
+ * @param start Start index (1-based).
+ *
+ * @returns node id of the free range, `0` if none exists.
+ */
+static size_t
+mpfr_free_tree_find_after (size_t start)
+{
+  size_t found = 0;
+
+  for (size_t t = mpfr_free_tree; t != 0;)
+    if (NODE (t).idx.start > start)
+      {
+        found = t;
+        t     = NODE (t).left;
+      }
+    else
+      t = NODE (t).right;
+  return (found);
+}
+
+
+/**
+ * Remove a free range from the pool of free MPFR variables.
+ *
+ * @param node Node id of the free range.
+ */
+static void
+mpfr_free_list_remove (size_t node)
+{
+  mpfr_free_bin_remove (node);
+  mpfr_free_tree = mpfr_free_tree_remove (mpfr_free_tree, node);
+  NODE (node).left       = mpfr_free_nodes_unused;
+  mpfr_free_nodes_unused = node;
   mpfr_free_list_size--;
 }
 
 
 /**
- * Try to compress the pool of free MPFR variables.
+ * Insert an index range into the pool of free MPFR variables.
+ *
+ * The range must neither overlap nor neighbor any free range in the pool.
+ *
+ * @param[in] idx Pointer to index (1-based, idx_t) of free MPFR variables.
+ * @param[in] prec Precision of all variables in `idx`, `0` if mixed.
+ *
+ * @returns success of insertion.
  */
-void
-mpfr_free_list_compress ()
+static int
+mpfr_free_list_insert (idx_t *idx, mpfr_prec_t prec)
 {
-  int have_merge = 0;
+  // Extend space if necessary.
+  if (mpfr_free_nodes_unused == 0)
+    {
+      size_t new_capacity = mpfr_free_nodes_capacity + DATA_CHUNK_SIZE;
+      DBG_PRINTF ("Increase free node capacity to '%d'.\n", new_capacity);
+      mpfr_free_node_t *new_nodes = NULL;
+      if (mpfr_free_nodes == NULL)
+        {
+          new_nodes = (mpfr_free_node_t *) mxMalloc (
+            new_capacity * sizeof(mpfr_free_node_t));
+          mexAtExit (mpfr_tidy_up);
+        }
+      else
+        new_nodes = (mpfr_free_node_t *) mxRealloc (
+          mpfr_free_nodes, new_capacity * sizeof(mpfr_free_node_t));
+      if (new_nodes == NULL)
+        return (0);  // Memory allocation failed.
+
+      mexMakeMemoryPersistent (new_nodes);
+      mpfr_free_nodes = new_nodes;
+      for (size_t i = new_capacity; i > mpfr_free_nodes_capacity; i--)
+        {
+          NODE (i).left          = mpfr_free_nodes_unused;
+          mpfr_free_nodes_unused = i;
+        }
+      mpfr_free_nodes_capacity = new_capacity;
+    }
 
-  do
+  size_t node = mpfr_free_nodes_unused;
+  NODE (node).idx  = *idx;
+  NODE (node).prec = prec;
+  if (! mpfr_free_bin_insert (node))
+    return (0);  // Memory allocation failed, node remains unused.
+
+  mpfr_free_nodes_unused = NODE (node).left;
+  NODE (node).left       = 0;
+  NODE (node).right      = 0;
+  NODE (node).height     = 1;
+  mpfr_free_tree         = mpfr_free_tree_insert (mpfr_free_tree, node);
+  mpfr_free_list_size++;
+  return (1);
+}
+
+
+/**
+ * Find a free index range of at least length `count`.
+ *
+ * First, up to `MPFR_FREE_BIN_SCAN` entries of the bins from
+ * `floor (log2 (count))` on are inspected for a fitting range of precision
+ * `prec`.  Otherwise, all ranges in bins `k >= ceil (log2 (count))` fit, thus
+ * the last entry of the smallest non-empty bin is taken in O(1).  Only if all
+ * those bins are empty, a few entries of bin `floor (log2 (count))` are
+ * inspected.
+ *
+ * @param[in] count Desired length of the index range.
+ * @param[in] prec Preferred precision, `0` for any.
+ *
+ * @returns node id of a fitting free range, `0` if none was found.
+ */
+static size_t
+mpfr_free_list_find (size_t count, mpfr_prec_t prec)
+{
+  size_t   k_fit = mpfr_free_bin_ceil (count);
+  uint64_t mask  = (k_fit < MPFR_FREE_BINS)
+                   ? (mpfr_free_bins_used & (~((uint64_t) 0) << k_fit)) : 0;
+
+  if (prec != 0)
     {
-      have_merge = 0;
-      for (size_t i = 0; i < mpfr_free_list_size; i++)
+      uint64_t scan_mask = mpfr_free_bins_used
+                           & (~((uint64_t) 0) << mpfr_free_bin_floor (count));
+      size_t   scanned   = 0;
+      while ((scan_mask != 0) && (scanned < MPFR_FREE_BIN_SCAN))
         {
-          // Rule 1: If end index of entry matches `mpfr_data_size` decrease.
-          if (mpfr_free_list[i].end == mpfr_data_size)
+          mpfr_free_bin_t *bin = &mpfr_free_bins[__builtin_ctzll (scan_mask)];
+          for (size_t j = 0; (j < bin->size) && (scanned < MPFR_FREE_BIN_SCAN);
+               j++, scanned++)
             {
-              have_merge = 1;
-              DBG_PRINTF ("mmgr: Rule 1 for [%d:%d].\n",
-                          mpfr_free_list[i].start, mpfr_free_list[i].end);
-              mpfr_data_size = mpfr_free_list[i].start - 1;
-              mpfr_free_list_remove (i);
-              break;
+              size_t node = bin->list[bin->size - 1 - j];
+              if ((NODE (node).prec == prec)
+                  && (count <= length (&NODE (node).idx)))
+                return (node);
             }
-          // Rule 2: Merge neighboring entries.
-          int do_break = 0;
-          for (size_t j = i + 1; j < mpfr_free_list_size; j++)
-            if ((mpfr_free_list[i].end + 1 == mpfr_free_list[j].start)
-                || (mpfr_free_list[j].end + 1 == mpfr_free_list[i].start))
-              {
-                have_merge = 1;
-                do_break   = 1;
-                DBG_PRINTF ("mmgr: Rule 2 for [%d:%d] + [%d:%d].\n",
-                            mpfr_free_list[i].start, mpfr_free_list[i].end,
-                            mpfr_free_list[j].start, mpfr_free_list[j].end);
-                mpfr_free_list[i].start =
-                  (mpfr_free_list[i].start <= mpfr_free_list[j].start
-                   ? mpfr_free_list[i].start
-                   : mpfr_free_list[j].start);
-                mpfr_free_list[i].end =
-                  (mpfr_free_list[i].end >= mpfr_free_list[j].end
-                   ? mpfr_free_list[i].end
-                   : mpfr_free_list[j].end);
-                mpfr_free_list_remove (j);
-                break;
-              }
-          if (do_break)
-            break;
+          scan_mask &= scan_mask - 1;
         }
-    } while (have_merge);
+    }
+
+  if (mask != 0)
+    {
+      mpfr_free_bin_t *bin = &mpfr_free_bins[__builtin_ctzll (mask)];
+      return (bin->list[bin->size - 1]);
+    }
+
+  mpfr_free_bin_t *bin = &mpfr_free_bins[mpfr_free_bin_floor (count)];
+  for (size_t j = 0; (j < bin->size) && (j < MPFR_FREE_BIN_SCAN); j++)
+    {
+      size_t node = bin->list[bin->size - 1 - j];
+      if (count <= length (&NODE (node).idx))
+        return (node);
+    }
+  return (0);
+}
+
+
+/**
+ * Return a valid index range to the pool of free MPFR variables.
+ *
+ * @param[in] idx Pointer to index (1-based, idx_t) of MPFR variables to be
+ *                no longer used.
+ */
+static void
+mpfr_mark_free_now (idx_t *idx)
+{
+  // Keep significands, also those in contiguous limb blocks.  Determine the
+  // common precision of the variables.
+  mpfr_ptr    idx_ptr = mex_mpfr_ptr (idx);
+  mpfr_prec_t prec    = mpfr_get_prec (idx_ptr);
+  for (size_t i = 1; (i < length (idx)) && (prec != 0); i++)
+    if (mpfr_get_prec (idx_ptr + i) != prec)
+      prec = 0;
+
+  // Merge with neighboring free ranges of the same segment.
+  mpfr_segment_t *seg    = &SEGMENT_OF (idx->start);
+  idx_t           merged = *idx;
+  size_t          node   = mpfr_free_tree_find_before (idx->start);
+  if ((node != 0) && (NODE (node).idx.end + 1 == merged.start)
+      && (seg->start < merged.start))
+    {
+      DBG_PRINTF ("mmgr: Merge [%d:%d] + [%d:%d].\n", NODE (node).idx.start,
+                  NODE (node).idx.end, merged.start, merged.end);
+      merged.start = NODE (node).idx.start;
+      if (NODE (node).prec != prec)
+        prec = 0;
+      mpfr_free_list_remove (node);
+    }
+  node = mpfr_free_tree_find_after (idx->start);
+  if ((node != 0) && (merged.end + 1 == NODE (node).idx.start)
+      && (merged.end < seg->end))
+    {
+      DBG_PRINTF ("mmgr: Merge [%d:%d] + [%d:%d].\n", merged.start,
+                  merged.end, NODE (node).idx.start, NODE (node).idx.end);
+      merged.end = NODE (node).idx.end;
+      if (NODE (node).prec != prec)
+        prec = 0;
+      mpfr_free_list_remove (node);
+    }
+
+  // If the free range is at the end, decrease `mpfr_data_size`.  Another free
+  // range can end right before only at the end of the previous segment.
+  if (merged.end == mpfr_data_size)
+    {
+      DBG_PRINTF ("mmgr: Trim [%d:%d].\n", merged.start, merged.end);
+      mpfr_data_size = merged.start - 1;
+      while (((node = mpfr_free_tree_find_before (mpfr_data_size + 1)) != 0)
+             && (NODE (node).idx.end == mpfr_data_size))
+        {
+          DBG_PRINTF ("mmgr: Trim [%d:%d].\n", NODE (node).idx.start,
+                      NODE (node).idx.end);
+          mpfr_data_size = NODE (node).idx.start - 1;
+          mpfr_free_list_remove (node);
+        }
+      return;
+    }
+
+  // Append variables to pool.
+  mpfr_free_list_insert (&merged, prec);
+}
+
+
+/**
+ * Find the handle table entry of a handle.
+ *
+ * @param handle Handle (1-based).
+ *
+ * @returns pointer to the entry with the largest first handle not greater
+ *          than `handle`, NULL if none exists.  The caller must check, that
+ *          `handle` is part of that entry.
+ */
+static mpfr_handle_t *
+mpfr_handle_find (size_t handle)
+{
+  size_t *cached = &mpfr_handle_cache[handle & (MPFR_HANDLE_CACHE_SIZE - 1)];
+
+  if ((*cached < mpfr_handles_size)
+      && (mpfr_handles[*cached].handle <= handle)
+      && (handle < mpfr_handles[*cached].handle
+          + mpfr_handles[*cached].length))
+    return (&mpfr_handles[*cached]);
+
+  size_t lo = 0;
+  size_t hi = mpfr_handles_size;
+
+  while (lo < hi)  // Number of entries starting at or before `handle`.
+    {
+      size_t mid = lo + (hi - lo) / 2;
+      if (mpfr_handles[mid].handle <= handle)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  if (lo == 0)
+    return (NULL);
 
-  /* Very verbose debug output.
-   * for (size_t i = 0; i < mpfr_free_list_size; i++)
-   * DBG_PRINTF ("mmgr: mpfr_free_list[%d] = [%d:%d].\n", i,
-   *            mpfr_free_list[i].start, mpfr_free_list[i].end);
-   */
+  *cached = lo - 1;
+  return (&mpfr_handles[lo - 1]);
+}
+
+
+/**
+ * Resolve a range of handles to the index range of its MPFR variables.
+ *
+ * @param[in,out] idx Pointer to range of handles (1-based, idx_t).  If
+ *                    function returns `1`, it is replaced by the index range
+ *                    (1-based, idx_t) of the MPFR variables, otherwise `idx`
+ *                    remains unchanged.
+ *
+ * @returns `1` if `idx` is a subrange of an allocated range of handles,
+ *          otherwise `0`.
+ */
+int
+mex_mpfr_resolve (idx_t *idx)
+{
+  if ((idx->start < 1) || (idx->start > idx->end))
+    return (0);
+
+  mpfr_handle_t *h = mpfr_handle_find (idx->start);
+  if ((h == NULL) || (idx->end >= h->handle + h->length))
+    return (0);  // Also for released entries, as `h->length == 0`.
+
+  idx->end   = h->start + (idx->end - h->handle);
+  idx->start = h->start + (idx->start - h->handle);
+  return (1);
+}
+
+
+/**
+ * Remove released entries from the handle table.
+ */
+static void
+mpfr_handles_vacuum (void)
+{
+  size_t j = 0;
+
+  for (size_t i = 0; i < mpfr_handles_size; i++)
+    if (mpfr_handles[i].length > 0)
+      mpfr_handles[j++] = mpfr_handles[i];
+  mpfr_handles_size     = j;
+  mpfr_handles_released = 0;
+}
+
+
+/**
+ * Ensure space for one more entry in the handle table.
+ *
+ * @returns success of memory allocation.
+ */
+static int
+mpfr_handles_reserve (void)
+{
+  if (mpfr_handles_size < mpfr_handles_capacity)
+    return (1);
+
+  size_t new_capacity = (mpfr_handles_capacity == 0)
+                        ? DATA_CHUNK_SIZE : 2 * mpfr_handles_capacity;
+  DBG_PRINTF ("Increase handle table capacity to '%d'.\n", new_capacity);
+  mpfr_handle_t *new_handles = NULL;
+  if (mpfr_handles == NULL)
+    {
+      new_handles = (mpfr_handle_t *) mxMalloc (
+        new_capacity * sizeof(mpfr_handle_t));
+      mexAtExit (mpfr_tidy_up);
+    }
+  else
+    new_handles = (mpfr_handle_t *) mxRealloc (
+      mpfr_handles, new_capacity * sizeof(mpfr_handle_t));
+  if (new_handles == NULL)
+    return (0);  // Memory allocation failed.
+
+  mexMakeMemoryPersistent (new_handles);
+  mpfr_handles          = new_handles;
+  mpfr_handles_capacity = new_capacity;
+  return (1);
+}
+
+
+/**
+ * Compare index ranges by start index (for qsort).
+ */
+static int
+mpfr_idx_compare (const void *a, const void *b)
+{
+  size_t a_start = ((const idx_t *) a)->start;
+  size_t b_start = ((const idx_t *) b)->start;
+  return ((a_start > b_start) - (a_start < b_start));
+}
+
+
+/**
+ * Release all queued index ranges (see `mex_mpfr_mark_free`).
+ */
+void
+mex_mpfr_flush_free (void)
+{
+  if (mpfr_free_queue_size == 0)
+    return;
+
+  DBG_PRINTF ("Flush %d queued ranges.\n", (int) mpfr_free_queue_size);
+  qsort (mpfr_free_queue, mpfr_free_queue_size, sizeof(idx_t),
+         mpfr_idx_compare);
+
+  // Coalesce neighboring ranges of the same segment.
+  idx_t merged = mpfr_free_queue[0];
+  for (size_t i = 1; i < mpfr_free_queue_size; i++)
+    {
+      idx_t *next = &mpfr_free_queue[i];
+      if ((next->start == merged.end + 1)
+          && (SEGMENT_OF (next->start).start <= merged.start))
+        merged.end = next->end;
+      else
+        {
+          mpfr_mark_free_now (&merged);
+          merged = *next;
+        }
+    }
+  mpfr_free_queue_size = 0;
+  mpfr_mark_free_now (&merged);
 }
 
 
 /**
  * Mark MPFR variable as no longer used.
  *
- * @param[in] idx Pointer to index (1-based, idx_t) of MPFR variable to be no
- *                longer used.
+ * The handles become invalid immediately, the index range is released
+ * deferred, see `mex_mpfr_flush_free`.
  *
- * @returns success of MPFR variables creation.
+ * @param[in] handle Pointer to range of handles (1-based, idx_t) of MPFR
+ *                   variable to be no longer used, as returned by
+ *                   `mex_mpfr_allocate`.
  */
 void
-mex_mpfr_mark_free (idx_t *idx)
+mex_mpfr_mark_free (idx_t *handle)
 {
-  // Check for impossible start and end index.
-  if (! is_valid (idx))
+  // Check for unknown or already released handles.
+  mpfr_handle_t *h = mpfr_handle_find (handle->start);
+  if ((h == NULL) || (h->handle != handle->start)
+      || (h->length == 0) || (h->length != length (handle)))
     {
-      DBG_PRINTF ("%s\n", "Bad indices");
+      DBG_PRINTF ("%s\n", "Bad handles");
       return;
     }
 
-  // Extend space if necessary.
-  if (mpfr_free_list_size == mpfr_free_list_capacity)
+  mpfr_stats_mark_free++;
+  idx_t idx = { h->start, h->start + h->length - 1 };
+  h->length = 0;
+  mpfr_handles_released++;
+  while ((mpfr_handles_size > 0)
+         && (mpfr_handles[mpfr_handles_size - 1].length == 0))
     {
-      size_t new_capacity = mpfr_free_list_capacity + DATA_CHUNK_SIZE;
-      DBG_PRINTF ("Increase capacity to '%d'.\n", new_capacity);
-      if (mpfr_free_list == NULL)
+      mpfr_handles_size--;
+      mpfr_handles_released--;
+    }
+  if ((mpfr_handles_released > DATA_CHUNK_SIZE)
+      && (2 * mpfr_handles_released > mpfr_handles_size))
+    mpfr_handles_vacuum ();
+
+  if (mpfr_free_queue_size == MPFR_FREE_QUEUE_SIZE)
+    mex_mpfr_flush_free ();
+  mpfr_free_queue[mpfr_free_queue_size++] = idx;
+}
+
+
+/**
+ * Take a queued index range of exactly length `count` (see
+ * `mex_mpfr_mark_free`).
+ *
+ * The most recently queued range of precision `prec` is preferred.
+ *
+ * @param[in] count Desired length of the index range.
+ * @param[in] prec Preferred precision, `0` for any.
+ * @param[out] idx If function returns `1`, pointer to index (1-based, idx_t)
+ *                 of MPFR variables, otherwise `idx` remains unchanged.
+ *
+ * @returns `1` if a queued range was taken, otherwise `0`.
+ */
+static int
+mpfr_free_queue_take (size_t count, mpfr_prec_t prec, idx_t *idx)
+{
+  size_t found = mpfr_free_queue_size;
+
+  for (size_t i = mpfr_free_queue_size; i > 0; i--)
+    {
+      idx_t *queued = &mpfr_free_queue[i - 1];
+      if (length (queued) != count)
+        continue;
+      if (found == mpfr_free_queue_size)
+        found = i - 1;
+      if ((prec == 0) || (mpfr_get_prec (mex_mpfr_ptr (queued)) == prec))
         {
-          mpfr_free_list = (idx_t *) mxMalloc (new_capacity * sizeof(idx_t));
-          mexAtExit (mpfr_tidy_up);
+          found = i - 1;
+          break;
+        }
+    }
+  if (found == mpfr_free_queue_size)
+    return (0);
+
+  *idx = mpfr_free_queue[found];
+  mpfr_free_queue[found] = mpfr_free_queue[--mpfr_free_queue_size];
+  return (1);
+}
+
+
+/**
+ * Find unused MPFR variables.
+ *
+ * @param[in] count Number of MPFR variables (`count > 0`).
+ * @param[in] prec Preferred precision of reused MPFR variables, `0` for any.
+ * @param[out] idx If function returns `1`, pointer to index (1-based, idx_t)
+ *                 of MPFR variables, otherwise the value of `idx` remains
+ *                 unchanged.
+ *
+ * @returns success of MPFR variable creation.
+ */
+static int
+mpfr_allocate_idx (size_t count, mpfr_prec_t prec, idx_t *idx)
+{
+  // Reuse a recently freed range of exactly the same length.
+  if (mpfr_free_queue_take (count, prec, idx))
+    {
+      DBG_PRINTF ("New MPFR variable [%d:%d] reused from queue.\n",
+                  idx->start, idx->end);
+      mpfr_stats_allocate_queue++;
+      return (1);
+    }
+  mex_mpfr_flush_free ();
+
+  // Try to reuse a free marked variable from the pool.
+  size_t node = mpfr_free_list_find (count, prec);
+  if (node != 0)
+    {
+      size_t start = NODE (node).idx.start;
+
+      // Shrinking the range from the left does not change its position in
+      // the tree, only the bin might change.
+      if (count < length (&NODE (node).idx))
+        {
+          mpfr_free_bin_remove (node);
+          NODE (node).idx.start += count;
+          if (! mpfr_free_bin_insert (node))
+            {
+              // Memory allocation failed, restore the node in its old bin,
+              // which has space left.
+              NODE (node).idx.start -= count;
+              mpfr_free_bin_insert (node);
+              return (0);
+            }
         }
       else
-        mpfr_free_list = (idx_t *) mxRealloc (mpfr_free_list,
-                                              new_capacity * sizeof(idx_t));
-      if (mpfr_free_list == NULL)
-        return;  // Memory allocation failed.
+        mpfr_free_list_remove (node);
 
-      mexMakeMemoryPersistent (mpfr_free_list);
-      mpfr_free_list_capacity = new_capacity;
+      idx->start = start;
+      idx->end   = start + count - 1;
+      DBG_PRINTF ("New MPFR variable [%d:%d] reused.\n", idx->start, idx->end);
+      mpfr_stats_allocate_pool++;
+      return (is_valid (idx));
     }
 
-  // Reinitialize MPFR variables (free significant memory).
-  for (size_t i = idx->start - 1; i < idx->end; i++)
+  // Find a segment after the used variables with enough space.  Unused
+  // variables of skipped segments become free.
+  while (mpfr_data_size < mpfr_data_capacity)
     {
-      mpfr_clear (mpfr_data + i);
-      mpfr_init (mpfr_data + i);
+      mpfr_segment_t *seg = &SEGMENT_OF (mpfr_data_size + 1);
+      if (mpfr_data_size + count <= seg->end)
+        {
+          mpfr_segment_init (seg, mpfr_data_size + count);
+          break;
+        }
+      idx_t rest = { mpfr_data_size + 1, seg->end };
+      mpfr_segment_init (seg, rest.end);
+      if (! mpfr_free_list_insert (&rest, 0))
+        return (0);  // Memory allocation failed.
+
+      mpfr_data_size = rest.end;
     }
 
-  // Append reinitialized variables to pool.
-  mpfr_free_list[mpfr_free_list_size].start = idx->start;
-  mpfr_free_list[mpfr_free_list_size].end   = idx->end;
-  mpfr_free_list_size++;
+  // Create a new segment if necessary.
+  if (mpfr_data_size == mpfr_data_capacity)
+    {
+      if (! mpfr_segment_append ((count + DATA_CHUNK_SIZE - 1)
+                                 / DATA_CHUNK_SIZE))
+        return (0);  // Memory allocation failed.
+
+      mpfr_segment_init (&mpfr_segments[mpfr_segments_size - 1],
+                         mpfr_data_size + count);
+    }
 
-  mpfr_free_list_compress ();
+  idx->start      = mpfr_data_size + 1;
+  mpfr_data_size += count;
+  idx->end        = mpfr_data_size;
+  if (mpfr_data_size > mpfr_data_size_max)
+    mpfr_data_size_max = mpfr_data_size;
+  DBG_PRINTF ("New MPFR variable [%d:%d] allocated.\n", idx->start, idx->end);
+  return (is_valid (idx));
 }
 
 
@@ -203,6 +1263,10 @@ mex_mpfr_mark_free (idx_t *idx)
  * Constructor for new MPFR variables.
  *
  * @param[in] count Number of MPFR variables to create.
+ * @param[in] prec Preferred precision of reused MPFR variables, `0` for any.
+ * @param[out] handle If function returns `1`, pointer to range of handles
+ *                    (1-based, idx_t) of MPFR variables, otherwise the value
+ *                    of `handle` remains unchanged.
  * @param[out] idx If function returns `1`, pointer to index (1-based, idx_t)
  *                 of MPFR variables, otherwise the value of `idx` remains
  *                 unchanged.
@@ -210,61 +1274,278 @@ mex_mpfr_mark_free (idx_t *idx)
  * @returns success of MPFR variable creation.
  */
 int
-mex_mpfr_allocate (size_t count, idx_t *idx)
+mex_mpfr_allocate (size_t count, mpfr_prec_t prec, idx_t *handle, idx_t *idx)
 {
+  mpfr_stats_allocate++;
+
   // Check for trivial case, failure as indices do not make sense.
-  if (count == 0)
+  if ((count == 0) || (count >= MPFR_HANDLE_MAX - mpfr_handles_next))
     return (0);
 
-  // Try to reuse a free marked variable from the pool.
-  for (size_t i = 0; i < mpfr_free_list_size; i++)
-    if (count <= length (mpfr_free_list + i))
-      {
-        idx->start = mpfr_free_list[i].start;
-        idx->end   = mpfr_free_list[i].start + count - 1;
-        DBG_PRINTF ("New MPFR variable [%d:%d] reused.\n",
-                    idx->start, idx->end);
-        if (count < length (mpfr_free_list + i))
-          mpfr_free_list[i].start += count;
-        else
-          mpfr_free_list_remove (i);
-        return (is_valid (idx));
-      }
+  if (! mpfr_handles_reserve () || ! mpfr_allocate_idx (count, prec, idx))
+    return (0);
+
+  mpfr_handle_t *h = &mpfr_handles[mpfr_handles_size++];
+  h->handle          = mpfr_handles_next;
+  h->start           = idx->start;
+  h->length          = count;
+  handle->start      = mpfr_handles_next;
+  handle->end        = mpfr_handles_next + count - 1;
+  mpfr_handles_next += count;
+  return (1);
+}
 
-  // Check if there is enough space to create new MPFR variables.
-  if ((mpfr_data_size + count) > mpfr_data_capacity)
+
+/**
+ * Compare handle table entries, given by their positions, by start index
+ * (for qsort).
+ */
+static int
+mpfr_handle_compare_start (const void *a, const void *b)
+{
+  size_t a_start = mpfr_handles[*((const size_t *) a)].start;
+  size_t b_start = mpfr_handles[*((const size_t *) b)].start;
+  return ((a_start > b_start) - (a_start < b_start));
+}
+
+
+/**
+ * Relocate all used MPFR variables to the smallest indices and release the
+ * memory of all unused MPFR variables after them.
+ *
+ * Used index ranges are moved in ascending order by `mpfr_swap`, thus values
+ * and significands are not copied.  Ranges still do not cross segment
+ * boundaries, the remaining gaps at the end of segments form the new pool of
+ * free MPFR variables.  Afterwards, segments without used MPFR variables are
+ * released.  If no MPFR variable is used, all memory is released.
+ *
+ * Handles remain valid, indices of MPFR variables change.
+ *
+ * @returns success of compaction.
+ */
+int
+mex_mpfr_compact (void)
+{
+  mpfr_stats_compact++;
+  mex_mpfr_flush_free ();
+  mpfr_handles_vacuum ();
+  if (mpfr_handles_size == 0)
     {
-      // Determine new capacity.
-      size_t new_capacity = mpfr_data_capacity;
-      while ((mpfr_data_size + count) > new_capacity)
-        new_capacity += DATA_CHUNK_SIZE;
+      if (mpfr_data_capacity > 0)
+        mpfr_tidy_up ();
+      return (1);
+    }
 
-      DBG_PRINTF ("Increase capacity to '%d'.\n", new_capacity);
-      // Reallocate memory.
-      if (mpfr_data == NULL)
+  // Order used index ranges by start index.
+  size_t *order = (size_t *) mxMalloc (mpfr_handles_size * sizeof(size_t));
+  if (order == NULL)
+    return (0);  // Memory allocation failed.
+
+  for (size_t i = 0; i < mpfr_handles_size; i++)
+    order[i] = i;
+  qsort (order, mpfr_handles_size, sizeof(size_t), mpfr_handle_compare_start);
+
+  // Move each range to the smallest index after the previous one.  The
+  // target lies before or overlaps the source from the left, thus swapping
+  // in ascending order moves all used MPFR variables and all free ones to
+  // the end.
+  mpfr_free_list_release ();
+  size_t dst = 1;
+  for (size_t i = 0; i < mpfr_handles_size; i++)
+    {
+      mpfr_handle_t *h = &mpfr_handles[order[i]];
+      while (dst + h->length - 1 > SEGMENT_OF (dst).end)
         {
-          mpfr_data = (mpfr_ptr) mxMalloc (new_capacity * sizeof(mpfr_t));
-          mexAtExit (mpfr_tidy_up);
+          idx_t gap = { dst, SEGMENT_OF (dst).end };
+          mpfr_free_list_insert (&gap, 0);
+          dst = gap.end + 1;
         }
-      else
-        mpfr_data =
-          (mpfr_ptr) mxRealloc (mpfr_data, new_capacity * sizeof(mpfr_t));
-      if (mpfr_data == NULL)
-        return (0); // Memory allocation failed.
-
-      mexMakeMemoryPersistent (mpfr_data);
+      if (dst != h->start)
+        {
+          idx_t    from     = { h->start, h->start + h->length - 1 };
+          idx_t    to       = { dst, dst + h->length - 1 };
+          mpfr_ptr from_ptr = mex_mpfr_ptr (&from);
+          mpfr_ptr to_ptr   = mex_mpfr_ptr (&to);
+          DBG_PRINTF ("mmgr: Move [%d:%d] -> [%d:%d].\n", from.start,
+                      from.end, to.start, to.end);
+          for (size_t j = 0; j < h->length; j++)
+            mpfr_swap (to_ptr + j, from_ptr + j);
+          h->start = dst;
+        }
+      dst += h->length;
+    }
+  mxFree (order);
+  mpfr_data_size = dst - 1;
 
-      // Initialize new MPFR variables.
-      for (size_t i = mpfr_data_capacity; i < new_capacity; i++)
-        mpfr_init (mpfr_data + i);
+  // Clear unused MPFR variables after `mpfr_data_size` and release segments
+  // without used MPFR variables.
+  while (mpfr_segments_size > 0)
+    {
+      mpfr_segment_t *seg = &mpfr_segments[mpfr_segments_size - 1];
+      size_t          end = (seg->start > mpfr_data_size)
+                            ? seg->start - 1 : mpfr_data_size;
+      for (size_t j = end + 1; j <= seg->init_end; j++)
+        mex_mpfr_clear (seg->data + (j - seg->start));
+      if (seg->init_end > end)
+        seg->init_end = end;
+      if (seg->start <= mpfr_data_size)
+        break;
 
-      mpfr_data_capacity = new_capacity;
+      DBG_PRINTF ("mmgr: Release segment [%d:%d].\n", seg->start, seg->end);
+      mxFree (seg->data);
+      mpfr_page_table_size -= (seg->end + 1 - seg->start) / DATA_CHUNK_SIZE;
+      mpfr_data_capacity    = seg->start - 1;
+      mpfr_segments_size--;
     }
+  mex_mpfr_limb_blocks_collect ();
+  return (1);
+}
 
-  idx->start      = mpfr_data_size + 1;
-  mpfr_data_size += count;
-  idx->end        = mpfr_data_size;
-  DBG_PRINTF ("New MPFR variable [%d:%d] allocated.\n", idx->start, idx->end);
-  return (is_valid (idx));
+
+/**
+ * Compare MPFR precisions (for qsort).
+ */
+static int
+mpfr_prec_compare (const void *a, const void *b)
+{
+  mpfr_prec_t a_prec = *((const mpfr_prec_t *) a);
+  mpfr_prec_t b_prec = *((const mpfr_prec_t *) b);
+  return ((a_prec > b_prec) - (a_prec < b_prec));
 }
 
+
+/**
+ * Set a scalar field of a MEX struct.
+ *
+ * @param s MEX struct (1x1).
+ * @param name Field name.
+ * @param val Value.
+ */
+static void
+mpfr_stats_set (mxArray *s, const char *name, double val)
+{
+  mxSetField (s, 0, name, mxCreateDoubleScalar (val));
+}
+
+
+/**
+ * Memory statistics of MPFR variables.
+ *
+ * Queued index ranges are released first.  The returned struct has the
+ * following fields:
+ *
+ * - data_capacity, data_size: like `mpfr_data_capacity` and `mpfr_data_size`.
+ * - data_capacity_max, data_size_max: high-water marks since startup.
+ * - used_ranges: number of allocated index ranges (handles).
+ * - free_ranges: number of index ranges in the pool of free variables.
+ * - free_vars: number of variables in the pool of free variables.
+ * - free_histogram: element `k + 1` is the number of free ranges of length
+ *                   `2^k` to `2^(k+1) - 1`.
+ * - fragmentation: `free_vars / data_size`, the fraction of variables up to
+ *                  `data_size`, that `mex_mpfr_compact` could release.
+ * - limb_bytes: significand bytes of all initialized variables (used and
+ *               free).
+ * - limb_bytes_by_prec: one row `[prec, number of variables, bytes]` for each
+ *                       precision of initialized variables.
+ * - limb_pool_bytes, limb_pool_bytes_max: current and largest size of the
+ *                                         limb memory pool.
+ * - allocate_calls, allocate_from_queue, allocate_from_pool: calls of
+ *   `mex_mpfr_allocate` and how many reused free variables since startup.
+ * - mark_free_calls, compact_calls: calls of `mex_mpfr_mark_free` and
+ *   `mex_mpfr_compact` since startup.
+ *
+ * @returns MEX struct (1x1), NULL if memory allocation failed.
+ */
+mxArray *
+mex_mpfr_memory_stats (void)
+{
+  static const char *fields[] = {
+    "data_capacity", "data_size", "data_capacity_max", "data_size_max",
+    "used_ranges", "free_ranges", "free_vars", "free_histogram",
+    "fragmentation", "limb_bytes", "limb_bytes_by_prec", "limb_pool_bytes",
+    "limb_pool_bytes_max", "allocate_calls", "allocate_from_queue",
+    "allocate_from_pool", "mark_free_calls", "compact_calls"
+  };
+
+  mex_mpfr_flush_free ();
+
+  // Precisions of all initialized variables.
+  size_t num_init = 0;
+  for (size_t i = 0; i < mpfr_segments_size; i++)
+    num_init += mpfr_segments[i].init_end + 1 - mpfr_segments[i].start;
+  mpfr_prec_t *precs = (mpfr_prec_t *) mxMalloc (
+    (num_init + 1) * sizeof(mpfr_prec_t));
+  if (precs == NULL)
+    return (NULL);  // Memory allocation failed.
+
+  size_t k = 0;
+  for (size_t i = 0; i < mpfr_segments_size; i++)
+    {
+      mpfr_segment_t *seg = &mpfr_segments[i];
+      for (size_t j = 0; j < seg->init_end + 1 - seg->start; j++)
+        precs[k++] = mpfr_get_prec (seg->data + j);
+    }
+  qsort (precs, num_init, sizeof(mpfr_prec_t), mpfr_prec_compare);
+  size_t num_precs = 0;
+  for (size_t i = 0; i < num_init; i++)
+    if ((i == 0) || (precs[i] != precs[i - 1]))
+      num_precs++;
+
+  mxArray *by_prec = mxCreateNumericMatrix (num_precs, 3, mxDOUBLE_CLASS,
+                                            mxREAL);
+  double *by_prec_pr = mxGetPr (by_prec);
+  double  limb_bytes = 0.0;
+  k = 0;
+  for (size_t i = 0; i < num_init; i++)
+    {
+      if ((i > 0) && (precs[i] != precs[i - 1]))
+        k++;
+      double bytes = (double) mpfr_custom_get_size (precs[i]);
+      by_prec_pr[k]                  = (double) precs[i];
+      by_prec_pr[k + num_precs]     += 1.0;
+      by_prec_pr[k + 2 * num_precs] += bytes;
+      limb_bytes                    += bytes;
+    }
+  mxFree (precs);
+
+  // Free ranges by size class.
+  size_t num_bins = (mpfr_free_bins_used == 0)
+                    ? 0 : MPFR_FREE_BINS - __builtin_clzll (mpfr_free_bins_used);
+  mxArray *histogram = mxCreateNumericMatrix (1, num_bins, mxDOUBLE_CLASS,
+                                              mxREAL);
+  double *histogram_pr = mxGetPr (histogram);
+  size_t  free_vars    = 0;
+  for (size_t b = 0; b < num_bins; b++)
+    {
+      histogram_pr[b] = (double) mpfr_free_bins[b].size;
+      for (size_t j = 0; j < mpfr_free_bins[b].size; j++)
+        free_vars += length (&NODE (mpfr_free_bins[b].list[j]).idx);
+    }
+
+  size_t   pool_max   = 0;
+  size_t   pool_bytes = mex_gmp_memory_pool_get_bytes (&pool_max);
+  mxArray *s          = mxCreateStructMatrix (1, 1, sizeof(fields)
+                                              / sizeof(fields[0]), fields);
+  mpfr_stats_set (s, "data_capacity", (double) mpfr_data_capacity);
+  mpfr_stats_set (s, "data_size", (double) mpfr_data_size);
+  mpfr_stats_set (s, "data_capacity_max", (double) mpfr_data_capacity_max);
+  mpfr_stats_set (s, "data_size_max", (double) mpfr_data_size_max);
+  mpfr_stats_set (s, "used_ranges",
+                  (double) (mpfr_handles_size - mpfr_handles_released));
+  mpfr_stats_set (s, "free_ranges", (double) mpfr_free_list_size);
+  mpfr_stats_set (s, "free_vars", (double) free_vars);
+  mxSetField (s, 0, "free_histogram", histogram);
+  mpfr_stats_set (s, "fragmentation", (mpfr_data_size == 0)
+                  ? 0.0 : (double) free_vars / (double) mpfr_data_size);
+  mpfr_stats_set (s, "limb_bytes", limb_bytes);
+  mxSetField (s, 0, "limb_bytes_by_prec", by_prec);
+  mpfr_stats_set (s, "limb_pool_bytes", (double) pool_bytes);
+  mpfr_stats_set (s, "limb_pool_bytes_max", (double) pool_max);
+  mpfr_stats_set (s, "allocate_calls", (double) mpfr_stats_allocate);
+  mpfr_stats_set (s, "allocate_from_queue",
+                  (double) mpfr_stats_allocate_queue);
+  mpfr_stats_set (s, "allocate_from_pool", (double) mpfr_stats_allocate_pool);
+  mpfr_stats_set (s, "mark_free_calls", (double) mpfr_stats_mark_free);
+  mpfr_stats_set (s, "compact_calls", (double) mpfr_stats_compact);
+  return (s);
+}
@@ -0,0 +1,253 @@
+/*
+ * This file is part of APA.
+ *
+ *  APA is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  APA is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <limits.h>
+
+#include "mex_mpfr_interface.h"
+
+// OpenMP scheduling
+// =================
+//
+// The cost of a MPFR function call is estimated from its cost class and the
+// number of limbs of the precision.  The unit is roughly the time to copy a
+// limb.  A loop over `n` MPFR variables is run with as many threads as
+// there are portions of `mpfr_omp_min_cost`, thus a small loop forks no
+// thread team at all.  The iterations are distributed in chunks of cost
+// `mpfr_omp_chunk_cost`.  Cheap functions of uniform cost use a static
+// schedule, the cost of elementary functions depends on the argument
+// (guided schedule), the cost of special functions like `mpfr_gamma_inc`
+// or `mpfr_zeta` varies by orders of magnitude (dynamic schedule).
+
+#define MPFR_COST_CHEAP      0  // Copy, compare, predicates, rounding.
+#define MPFR_COST_ARITH      1  // Arithmetic, roots.
+#define MPFR_COST_ELEMENTARY 2  // Exponential, logarithm, trigonometric.
+#define MPFR_COST_SPECIAL    3  // Gamma, zeta, Bessel, etc.
+
+double mpfr_omp_min_cost   = 32768.0;
+double mpfr_omp_chunk_cost = 65536.0;
+int    mpfr_omp_sched_kind = MPFR_OMP_SCHED_COST;
+
+
+/**
+ * Cost class of a MPFR function.
+ *
+ * @param[in] cmd_code Command code of the MPFR function (1000 - 1899).
+ *
+ * @returns one of MPFR_COST_*.
+ */
+static int
+mpfr_cost_class (uint64_t cmd_code)
+{
+  switch (cmd_code)
+    {
+      case 1031:  // mpfr_add
+      case 1033:  // mpfr_sub
+      case 1036:  // mpfr_mul
+      case 1038:  // mpfr_sqr
+      case 1039:  // mpfr_div
+      case 1042:  // mpfr_sqrt
+      case 1043:  // mpfr_sqrt_ui
+      case 1044:  // mpfr_rec_sqrt
+      case 1045:  // mpfr_cbrt
+      case 1046:  // mpfr_rootn_ui
+      case 1047:  // mpfr_root
+      case 1050:  // mpfr_dim
+      case 1056:  // mpfr_fma
+      case 1057:  // mpfr_fms
+      case 1058:  // mpfr_fmma
+      case 1059:  // mpfr_fmms
+      case 1060:  // mpfr_hypot
+      case 1061:  // mpfr_sum
+      case 1062:  // mpfr_dot
+      case 1093:  // mpfr_pow_ui
+      case 1094:  // mpfr_pow_si
+      case 1096:  // mpfr_ui_pow_ui
+      case 1155:  // mpfr_modf
+      case 1156:  // mpfr_fmod
+      case 1157:  // mpfr_fmodquo
+      case 1158:  // mpfr_remainder
+      case 1159:  // mpfr_remquo
+      case 1330:  // mpfr_add_d
+      case 1331:  // mpfr_add_ui
+      case 1332:  // mpfr_add_si
+      case 1340:  // mpfr_sub_d
+      case 1341:  // mpfr_sub_ui
+      case 1342:  // mpfr_sub_si
+      case 1343:  // mpfr_d_sub
+      case 1344:  // mpfr_ui_sub
+      case 1345:  // mpfr_si_sub
+      case 1350:  // mpfr_mul_d
+      case 1351:  // mpfr_mul_ui
+      case 1352:  // mpfr_mul_si
+      case 1360:  // mpfr_div_d
+      case 1361:  // mpfr_div_ui
+      case 1362:  // mpfr_div_si
+      case 1363:  // mpfr_d_div
+      case 1364:  // mpfr_ui_div
+      case 1365:  // mpfr_si_div
+        return (MPFR_COST_ARITH);
+
+      case 1083:  // mpfr_log
+      case 1084:  // mpfr_log_ui
+      case 1085:  // mpfr_log2
+      case 1086:  // mpfr_log10
+      case 1087:  // mpfr_log1p
+      case 1088:  // mpfr_exp
+      case 1089:  // mpfr_exp2
+      case 1090:  // mpfr_exp10
+      case 1091:  // mpfr_expm1
+      case 1092:  // mpfr_pow
+      case 1097:  // mpfr_ui_pow
+      case 1098:  // mpfr_cos
+      case 1099:  // mpfr_sin
+      case 1100:  // mpfr_tan
+      case 1101:  // mpfr_sin_cos
+      case 1102:  // mpfr_sec
+      case 1103:  // mpfr_csc
+      case 1104:  // mpfr_cot
+      case 1105:  // mpfr_acos
+      case 1106:  // mpfr_asin
+      case 1107:  // mpfr_atan
+      case 1108:  // mpfr_atan2
+      case 1109:  // mpfr_cosh
+      case 1110:  // mpfr_sinh
+      case 1111:  // mpfr_tanh
+      case 1112:  // mpfr_sinh_cosh
+      case 1113:  // mpfr_sech
+      case 1114:  // mpfr_csch
+      case 1115:  // mpfr_coth
+      case 1116:  // mpfr_acosh
+      case 1117:  // mpfr_asinh
+      case 1118:  // mpfr_atanh
+      case 1129:  // mpfr_erf
+      case 1130:  // mpfr_erfc
+      case 1137:  // mpfr_agm
+      case 1139:  // mpfr_const_log2
+      case 1140:  // mpfr_const_pi
+      case 1141:  // mpfr_const_euler
+      case 1142:  // mpfr_const_catalan
+        return (MPFR_COST_ELEMENTARY);
+
+      case 1055:  // mpfr_fac_ui
+      case 1119:  // mpfr_eint
+      case 1120:  // mpfr_li2
+      case 1121:  // mpfr_gamma
+      case 1122:  // mpfr_gamma_inc
+      case 1123:  // mpfr_lngamma
+      case 1124:  // mpfr_lgamma
+      case 1125:  // mpfr_digamma
+      case 1126:  // mpfr_beta
+      case 1127:  // mpfr_zeta
+      case 1128:  // mpfr_zeta_ui
+      case 1131:  // mpfr_j0
+      case 1132:  // mpfr_j1
+      case 1133:  // mpfr_jn
+      case 1134:  // mpfr_y0
+      case 1135:  // mpfr_y1
+      case 1136:  // mpfr_yn
+      case 1138:  // mpfr_ai
+        return (MPFR_COST_SPECIAL);
+
+      default:
+        return (MPFR_COST_CHEAP);
+    }
+}
+
+
+/**
+ * Estimated cost of a single MPFR function call.
+ *
+ * @param[in] cost_class One of MPFR_COST_*.
+ * @param[in] prec Precision of the MPFR variables.
+ *
+ * @returns estimated cost (see above).
+ */
+static double
+mpfr_cost (int cost_class, mpfr_prec_t prec)
+{
+  double limbs = (double) ((prec + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS);
+
+  switch (cost_class)
+    {
+      case MPFR_COST_ARITH:
+        return (32.0 * limbs * sqrt (limbs));
+
+      case MPFR_COST_ELEMENTARY:
+        return (512.0 * limbs * sqrt (limbs) * (1.0 + log2 (limbs)));
+
+      case MPFR_COST_SPECIAL:
+        return (8192.0 * limbs * limbs);
+
+      default:
+        return (8.0 + limbs);
+    }
+}
+
+
+int
+mex_mpfr_omp_schedule (uint64_t cmd_code, size_t n, mpfr_prec_t prec)
+{
+  if (n < 2)
+    return (1);
+
+  int    cost_class = mpfr_cost_class (cmd_code);
+  double cost       = mpfr_cost (cost_class, prec);
+
+  // Number of threads, each gets at least `mpfr_omp_min_cost`.
+  double num_threads = floor ((double) n * cost / mpfr_omp_min_cost);
+  int    max_threads = omp_get_max_threads ();
+  if (num_threads > (double) max_threads)
+    num_threads = (double) max_threads;
+  if (num_threads > (double) n)
+    num_threads = (double) n;
+  if (num_threads < 2.0)
+    return (1);
+
+  omp_sched_t kind = (omp_sched_t) mpfr_omp_sched_kind;
+  if (mpfr_omp_sched_kind == MPFR_OMP_SCHED_COST)
+    {
+      if (cost_class == MPFR_COST_SPECIAL)
+        kind = omp_sched_dynamic;
+      else if (cost_class == MPFR_COST_ELEMENTARY)
+        kind = omp_sched_guided;
+      else
+        kind = omp_sched_static;
+    }
+
+  // Chunk size scaled by precision, but at least one chunk per thread and
+  // four for varying costs.  A chunk cost of `0` selects the OpenMP default.
+  double chunk = 0.0;
+  if (mpfr_omp_chunk_cost > 0.0)
+    {
+      double max_chunk = (kind == omp_sched_static)
+                         ? ceil ((double) n / num_threads)
+                         : floor ((double) n / (4.0 * num_threads));
+      chunk = ceil (mpfr_omp_chunk_cost / cost);
+      if (chunk > max_chunk)
+        chunk = max_chunk;
+      if (chunk < 1.0)
+        chunk = 1.0;
+      if (chunk > (double) INT_MAX)
+        chunk = (double) INT_MAX;
+    }
+
+  omp_set_schedule (kind, (int) chunk);
+  DBG_PRINTF ("cmd[%d]: n = %d, prec = %d, threads = %d, kind = %d, "
+              "chunk = %d\n", (int) cmd_code, (int) n, (int) prec,
+              (int) num_threads, (int) kind, (int) chunk);
+  return ((int) num_threads);
+}
@@ -0,0 +1,228 @@
+/*
+ * This file is part of APA.
+ *
+ *  APA is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  APA is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with APA.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mex_mpfr_interface.h"
+
+// Command tapes
+// =============
+//
+// A tape is a cell array of MPFR interface calls (command codes 1000 - 1899),
+// each a cell array of the MEX arguments `{cmd_code, arg1, arg2, ...}`.
+// `mex_mpfr_tape_run` executes all calls of a tape, optionally several
+// times, within a single MEX call.  Thus scalar recurrences do not pay the
+// Octave/Matlab function call overhead for each MPFR function.
+//
+// Tapes can be written by hand or recorded: between `mex_mpfr_tape_begin`
+// and `mex_mpfr_tape_end`, all MPFR interface calls are executed as usual and
+// appended to the tape, if they succeed.  Calls replayed by
+// `mex_mpfr_tape_run` are not recorded.  @mpfr_t objects are recorded by
+// their handles, which remain valid as long as the objects exist.
+
+static mxArray **mpfr_tape          = NULL;  // Recorded calls (persistent).
+static size_t    mpfr_tape_capacity = 0;
+static size_t    mpfr_tape_size     = 0;
+
+int mpfr_tape_recording = 0;  // Record MPFR interface calls?
+int mpfr_tape_replaying = 0;  // Within `mex_mpfr_tape_run`?
+
+
+/**
+ * Stop recording and release all recorded calls.
+ */
+void
+mex_mpfr_tape_release (void)
+{
+  for (size_t i = 0; i < mpfr_tape_size; i++)
+    mxDestroyArray (mpfr_tape[i]);
+  mxFree (mpfr_tape);
+  mpfr_tape           = NULL;
+  mpfr_tape_capacity  = 0;
+  mpfr_tape_size      = 0;
+  mpfr_tape_recording = 0;
+}
+
+
+/**
+ * Start recording MPFR interface calls, previously recorded calls are
+ * discarded.
+ */
+void
+mex_mpfr_tape_begin (void)
+{
+  mex_mpfr_tape_release ();
+  mpfr_tape_recording = 1;
+}
+
+
+/**
+ * Append a MPFR interface call to the recorded tape.
+ *
+ * @param nrhs MEX parameter.
+ * @param prhs MEX parameter, `prhs[0]` is the command code.
+ *
+ * @returns success of recording.
+ */
+int
+mex_mpfr_tape_record (int nrhs, const mxArray *prhs[])
+{
+  // Extend space if necessary.
+  if (mpfr_tape_size == mpfr_tape_capacity)
+    {
+      size_t    new_capacity = mpfr_tape_capacity + DATA_CHUNK_SIZE;
+      mxArray **new_tape     = NULL;
+      if (mpfr_tape == NULL)
+        new_tape = (mxArray **) mxMalloc (new_capacity * sizeof(mxArray *));
+      else
+        new_tape = (mxArray **) mxRealloc (mpfr_tape,
+                                           new_capacity * sizeof(mxArray *));
+      if (new_tape == NULL)
+        return (0);  // Memory allocation failed.
+
+      mexMakeMemoryPersistent (new_tape);
+      mpfr_tape          = new_tape;
+      mpfr_tape_capacity = new_capacity;
+    }
+
+  mxArray *call = mxCreateCellMatrix (1, nrhs);
+  for (int i = 0; i < nrhs; i++)
+    if (mxIsClass (prhs[i], "mpfr_t"))
+      mxSetCell (call, i, mxGetProperty (prhs[i], 0, "idx"));
+    else
+      mxSetCell (call, i, mxDuplicateArray (prhs[i]));
+  mexMakeArrayPersistent (call);
+  mpfr_tape[mpfr_tape_size++] = call;
+  return (1);
+}
+
+
+/**
+ * Stop recording MPFR interface calls.
+ *
+ * @returns the recorded tape (cell array of calls).
+ */
+mxArray *
+mex_mpfr_tape_end (void)
+{
+  mxArray *tape = mxCreateCellMatrix (mpfr_tape_size, 1);
+
+  for (size_t i = 0; i < mpfr_tape_size; i++)
+    mxSetCell (tape, i, mxDuplicateArray (mpfr_tape[i]));
+  mex_mpfr_tape_release ();
+  return (tape);
+}
+
+
+/**
+ * Check a tape.
+ *
+ * @param[in] tape MEX input array.
+ *
+ * @returns position (1-based) of the first invalid call, `0` if all calls
+ *          are valid.
+ */
+size_t
+mex_mpfr_tape_check (const mxArray *tape)
+{
+  if (! mxIsCell (tape))
+    return (1);
+
+  for (size_t i = 0; i < mxGetNumberOfElements (tape); i++)
+    {
+      const mxArray *call = mxGetCell (tape, i);
+      if ((call == NULL) || ! mxIsCell (call)
+          || (mxGetNumberOfElements (call) < 1))
+        return (i + 1);
+
+      const mxArray *argv[1] = { mxGetCell (call, 0) };
+      uint64_t       code    = 0;
+      if ((argv[0] == NULL) || ! extract_ui (0, 1, argv, &code)
+          || (code < 1000) || (code >= 1900))
+        return (i + 1);
+
+      for (size_t j = 1; j < mxGetNumberOfElements (call); j++)
+        if (mxGetCell (call, j) == NULL)
+          return (i + 1);
+    }
+  return (0);
+}
+
+
+/**
+ * Execute a valid tape (see `mex_mpfr_tape_check`).
+ *
+ * Output values of the calls, e.g. ternary values, are discarded.  Errors of
+ * a call are reported as usual and stop the execution.
+ *
+ * @param[in] tape MEX input array.
+ * @param[in] count Number of executions of the whole tape.
+ *
+ * @returns success of execution.
+ */
+int
+mex_mpfr_tape_run (const mxArray *tape, size_t count)
+{
+  size_t num_calls = mxGetNumberOfElements (tape);
+  size_t num_args  = 0;
+
+  for (size_t i = 0; i < num_calls; i++)
+    num_args += mxGetNumberOfElements (mxGetCell (tape, i));
+
+  // Arguments of all calls, extracted only once.
+  const mxArray **args  = (const mxArray **) mxMalloc (
+    (num_args + 1) * sizeof(mxArray *));
+  uint64_t       *codes = (uint64_t *) mxMalloc (
+    (num_calls + 1) * sizeof(uint64_t));
+  int            *argcs = (int *) mxMalloc ((num_calls + 1) * sizeof(int));
+  if ((args == NULL) || (codes == NULL) || (argcs == NULL))
+    return (0);  // Memory allocation failed.
+
+  num_args = 0;
+  for (size_t i = 0; i < num_calls; i++)
+    {
+      const mxArray *call = mxGetCell (tape, i);
+      argcs[i] = (int) mxGetNumberOfElements (call);
+      for (int j = 0; j < argcs[i]; j++)
+        args[num_args++] = mxGetCell (call, j);
+      codes[i] = (uint64_t) mxGetScalar (args[num_args - argcs[i]]);
+    }
+
+  // Reset by `mexFunction` if a call fails.
+  mpfr_tape_replaying = 1;
+  for (size_t k = 0; k < count; k++)
+    {
+      const mxArray **argv = args;
+      for (size_t i = 0; i < num_calls; i++)
+        {
+          mxArray *out[2] = { NULL, NULL };
+          mex_mpfr_interface (1, out, argcs[i], argv, codes[i]);
+          for (int j = 0; j < 2; j++)
+            if (out[j] != NULL)
+              mxDestroyArray (out[j]);
+          if (MEX_FCN_FAILED)  // Without error message (`VERBOSE = 0`).
+            {
+              k = count;
+              break;
+            }
+          argv += argcs[i];
+        }
+    }
+  mpfr_tape_replaying = 0;
+  mxFree (args);
+  mxFree (codes);
+  mxFree (argcs);
+  return (1);
+}
@@ -72,20 +72,504 @@ function test_apa ()
   DATA_CHUNK_SIZE = 1000;
   N = ceil (sqrt (DATA_CHUNK_SIZE));
   obj = mpfr_t (1);
-  assert (isequal (obj.idx, [1, 1]));
+  assert (diff (obj.idx) == 0);
   assert (mpfr_t.get_data_size () == 1);
   assert (mpfr_t.get_data_capacity () == DATA_CHUNK_SIZE);
+  % Index ranges never cross segments.  Thus `N^2 > DATA_CHUNK_SIZE`
+  % variables are placed in a new segment of two pages.  Handles are
+  % consecutive, independent of the placement.
+  obj_idx = obj.idx;
   obj = mpfr_t (eye (N));
-  assert (isequal (obj.idx, [2, N^2 + 1]));
-  assert (mpfr_t.get_data_size () == N^2 + 1);
-  assert (mpfr_t.get_data_capacity () == 2 * DATA_CHUNK_SIZE);
+  assert (isequal (obj.idx, obj_idx(2) + [1, N^2]));
+  assert (mpfr_t.get_data_size () == DATA_CHUNK_SIZE + N^2);
+  assert (mpfr_t.get_data_capacity () == 3 * DATA_CHUNK_SIZE);
 
   % Bad input
   apa ('verbose', 1);
   for i = {1/2, inf, -42, -1, -2, nan, 'c', eye(3)}
     assert (strcmp (check_error ('mpfr_t.allocate (i{1})'), 'apa:mexFunction'));
-    assert (mpfr_t.get_data_size () == N^2 + 1);
-    assert (mpfr_t.get_data_capacity () == 2 * DATA_CHUNK_SIZE);
+    assert (mpfr_t.get_data_size () == DATA_CHUNK_SIZE + N^2);
+    assert (mpfr_t.get_data_capacity () == 3 * DATA_CHUNK_SIZE);
+  end
+  apa ('verbose', default_verbosity_level);
+
+
+  % ================
+  % mpfr_t.mark_free
+  % ================
+
+  % Freeing the last used variables shrinks the data size.
+  clear obj;
+  assert (mpfr_t.get_data_size () == 0);
+
+  % Freed index ranges are reused without growing the data size.
+  idx = cell (1, 8);
+  for i = 1:8
+    idx{i} = mpfr_t.allocate (i);
+  end
+  data_size = mpfr_t.get_data_size ();
+  assert (data_size == sum (1:8));
+  for i = 1:2:8  % Non-neighboring ranges, no merge.
+    mpfr_t.mark_free (idx{i});
+  end
+  assert (mpfr_t.get_data_size () == data_size);
+  for i = 7:-2:1
+    idx{i} = mpfr_t.allocate (i);
+    assert (diff (idx{i}) + 1 == i);
+    assert (mpfr_t.get_data_size () == data_size);
+  end
+  for i = 1:8
+    mpfr_t.mark_free (idx{i});
+  end
+  assert (mpfr_t.get_data_size () == 0);
+
+  % Freed variables keep their precision, which is preferred on reuse.
+  % Releasing is deferred, reuse from the queue and from the pool.
+  for flush = [false, true]
+    a = mpfr_t (zeros (1, 5), 100);
+    s1 = mpfr_t (1);
+    b = mpfr_t (zeros (1, 5), 200);
+    s2 = mpfr_t (1);
+    data_size = mpfr_t.get_data_size ();
+    clear b;
+    clear a;  % Without preference, this range would be reused first.
+    if (flush)
+      mpfr_t.flush_free ();
+    end
+    idx = mpfr_t.allocate (5, 200);
+    assert (all (mpfr_get_prec (idx) == 200));
+    assert (mpfr_t.get_data_size () == data_size);
+    mpfr_t.mark_free (idx);
+    clear s1 s2;
+    assert (mpfr_t.get_data_size () == 0);
+  end
+
+  % Freed handles become invalid.
+  idx = mpfr_t.allocate (3);
+  mpfr_t.mark_free (idx);
+  apa ('verbose', 1);
+  assert (strcmp (check_error ('mpfr_get_prec (idx)'), 'apa:mexFunction'));
+  apa ('verbose', default_verbosity_level);
+
+  % Handles and @mpfr_t objects are equivalent operands.
+  a = mpfr_t (1:3, 100);
+  b = mpfr_t (4:6, 100);
+  c = mpfr_t (zeros (1, 3), 100);
+  mpfr_add (c.idx, a.idx, b, MPFR_RNDN);
+  assert (isequal (double (c), (1:3) + (4:6)));
+  mpfr_sub (c, a, b.idx(1) + [1, 1], MPFR_RNDN);
+  assert (isequal (double (c), (1:3) - 5));
+  apa ('verbose', 1);
+  for i = {-a.idx, a.idx + 0.5, [a.idx(1), nan], [a.idx(1), inf], ...
+           int32(a.idx), a.idx(1), [a.idx, 1], 'ab', {a.idx}}
+    assert (strcmp (check_error ('mpfr_add (c, i{1}, b, MPFR_RNDN)'), ...
+                    'apa:mexFunction'));
+  end
+  apa ('verbose', default_verbosity_level);
+  clear a b c;
+
+
+  % ==============
+  % mpfr_t.compact
+  % ==============
+
+  % Used variables are moved to close the gaps, trailing segments are
+  % released.  Handles remain valid.
+  a = mpfr_t (zeros (1, 10));
+  b = mpfr_t (1:3);
+  c = mpfr_t (magic (N));  % New segment.
+  b_idx = b.idx;
+  clear a c;
+  assert (mpfr_t.get_data_size () == 13);
+  mpfr_t.compact ();
+  assert (mpfr_t.get_data_size () == 3);
+  assert (mpfr_t.get_data_capacity () == DATA_CHUNK_SIZE);
+  assert (isequal (b.idx, b_idx));
+  assert (isequal (double (b), 1:3));
+  assert (double (b(2)) == 2);
+  b(3) = 4;
+  assert (isequal (double (b + b), [2, 4, 8]));
+
+  % Without used variables, all memory is released.
+  clear b;
+  mpfr_t.compact ();
+  assert (mpfr_t.get_data_capacity () == 0);
+
+
+  % =======================
+  % mpfr_t.get_memory_stats
+  % =======================
+
+  stats = mpfr_t.get_memory_stats ();
+  a = mpfr_t (zeros (1, 4), 100);
+  b = mpfr_t (1);
+  c = mpfr_t (zeros (1, 3), 200);
+  clear a;
+  new_stats = mpfr_t.get_memory_stats ();
+  assert (new_stats.allocate_calls == stats.allocate_calls + 3);
+  assert (new_stats.mark_free_calls == stats.mark_free_calls + 1);
+  assert (new_stats.data_size == 8);
+  assert (new_stats.data_size_max >= 8);
+  assert (new_stats.used_ranges == 2);
+  assert (new_stats.free_ranges == 1);
+  assert (new_stats.free_vars == 4);
+  assert (isequal (new_stats.free_histogram, [0, 0, 1]));
+  assert (new_stats.fragmentation == 0.5);
+  by_prec = new_stats.limb_bytes_by_prec;
+  assert (sum (by_prec(:,2)) == 8);
+  assert (isequal (by_prec(by_prec(:,1) == 200, 2), 3));
+  assert (new_stats.limb_bytes == sum (by_prec(:,3)));
+  clear b c;
+
+
+  % ===============
+  % mpfr_t.tape_run
+  % ===============
+
+  % Good input: recurrence of doc/examples/listing_14_1.m, recorded once and
+  % replayed, compared to the same recurrence without tape.
+  u = mpfr_t (2, 600);
+  v = mpfr_t (-4, 600);
+  x = mpfr_t (nan, 600);
+  y = mpfr_t (nan, 600);
+  z = mpfr_t (nan, 600);
+  mpfr_t.tape_begin ();
+  mpfr_ui_div (x, 1130, v, MPFR_RNDN);
+  mpfr_ui_sub (y, 111, x, MPFR_RNDN);
+  mpfr_mul (z, v, u, MPFR_RNDN);
+  mpfr_ui_div (x, 3000, z, MPFR_RNDN);
+  mpfr_set (u, v, MPFR_RNDN);
+  mpfr_add (v, y, x, MPFR_RNDN);
+  tape = mpfr_t.tape_end ();
+  assert (numel (tape) == 6);
+  mpfr_t.tape_run (tape, 49);
+  uu = mpfr_t (2, 600);
+  vv = mpfr_t (-4, 600);
+  for k = 1:50
+    mpfr_ui_div (x, 1130, vv, MPFR_RNDN);
+    mpfr_ui_sub (y, 111, x, MPFR_RNDN);
+    mpfr_mul (z, vv, uu, MPFR_RNDN);
+    mpfr_ui_div (x, 3000, z, MPFR_RNDN);
+    mpfr_set (uu, vv, MPFR_RNDN);
+    mpfr_add (vv, y, x, MPFR_RNDN);
+  end
+  assert (mpfr_cmp (u, uu) == 0);
+  assert (mpfr_cmp (v, vv) == 0);
+
+  % Hand-written tape, @mpfr_t variables are accepted as well.
+  w = mpfr_t (1);
+  mpfr_t.tape_run ({{1031, w, w, w, 1}}, 10);  % mpfr_add
+  assert (double (w) == 1024);
+  mpfr_t.tape_run ({});
+  mpfr_t.tape_run ({{1031, w, w, w, 1}}, 0);
+  assert (double (w) == 1024);
+
+  % Bad input
+  apa ('verbose', 1);
+  for i = {1, {1}, {{}}, {{1900}}, {{'c'}}, {1031}}
+    assert (strcmp (check_error ('mpfr_t.tape_run (i{1})'), ...
+                    'apa:mexFunction'));
+  end
+  w_idx = w.idx;
+  clear w;
+  assert (strcmp (check_error ( ...
+    'mpfr_t.tape_run ({{1031, w_idx, w_idx, w_idx, 1}})'), 'apa:mexFunction'));
+
+  % Failed calls are not recorded, a failed replay does not stop recording.
+  w = mpfr_t (1);
+  mpfr_t.tape_begin ();
+  mpfr_add (w, w, w, MPFR_RNDN);
+  assert (strcmp (check_error ('mpfr_add (w, w_idx, w, MPFR_RNDN)'), ...
+                  'apa:mexFunction'));
+  assert (strcmp (check_error ( ...
+    'mpfr_t.tape_run ({{1031, w_idx, w_idx, w_idx, 1}})'), 'apa:mexFunction'));
+  mpfr_mul (w, w, w, MPFR_RNDN);
+  tape = mpfr_t.tape_end ();
+  assert (numel (tape) == 2);
+  assert (tape{1}{1} == 1031);  % mpfr_add
+  assert (tape{2}{1} == 1036);  % mpfr_mul
+  assert (double (w) == 4);
+  clear w;
+  apa ('verbose', default_verbosity_level);
+  clear u v x y z uu vv;
+
+
+  % ==============
+  % mpfr_t.summary
+  % ==============
+
+  % Good input: summary `[up, down, exact]` matches all ternary values.
+  a = mpfr_t ([1, 1/3, 2/3, 4; 5, 1/7, 3, 1/5], 53);
+  b = mpfr_t ([1, 1/3, 1/3, 1/2; 6, 2/7, 1/9, 0], 53);
+  c = mpfr_t (zeros (2, 4), 10);
+  for rnd = [MPFR_RNDN, MPFR_RNDU, MPFR_RNDD]
+    ret = mpfr_add (c, a, b, rnd);
+    assert (isequal (mpfr_t.summary (1031, c, a, b, rnd), ...  % mpfr_add
+                     [sum(ret > 0), sum(ret < 0), sum(ret == 0)]));
+  end
+  ret = mpfr_t.summary (1031, c, a, b, MPFR_RNDU);  % mpfr_add
+  assert (ret(2) == 0);
+  [r, q] = mpfr_remquo (c, a, b, MPFR_RNDN);
+  assert (numel (q) == 8);
+  ret = mpfr_t.summary (1159, c, a, b, MPFR_RNDN);  % mpfr_remquo
+  assert (isequal (ret, [sum(r > 0), sum(r < 0), sum(r == 0)]));
+  clear a b c;
+
+  % Bad input
+  apa ('verbose', 1);
+  assert (strcmp (check_error ('mex_apa_interface (1911)'), 'apa:mexFunction'));
+  for i = {999, 1900, 1911, 2005, 'c', [1031, 1031]}
+    assert (strcmp (check_error ('mpfr_t.summary (i{1}, 1)'), ...
+                    'apa:mexFunction'));
+  end
+  apa ('verbose', default_verbosity_level);
+
+
+  % ===============
+  % apa (limb_pool)
+  % ===============
+
+  % Good input
+  default_limb_pool = apa ('limb_pool');
+  for i = [0, 2, 1]
+    apa ('limb_pool', i);
+    assert (apa ('limb_pool') == i);
+    assert (mpfr_t.get_data_capacity () == 0);  % All memory was released.
+    obj = mpfr_t (magic (4), 200);
+    assert (isequal (double (obj * obj), magic (4) * magic (4)));
+    clear obj;
+  end
+  apa ('limb_pool', default_limb_pool);
+
+  % Bad input (no change while variables exist)
+  obj = mpfr_t (1);
+  apa ('verbose', 1);
+  for i = {0, 2, -1, 3, 1/2, nan, 'c', eye(3)}
+    assert (strcmp (check_error ('apa (''limb_pool'', i{1})'), ...
+                    'apa:badInput'));
+    assert (apa ('limb_pool') == default_limb_pool);
+  end
+  apa ('verbose', default_verbosity_level);
+  clear obj;
+
+
+  % ======================
+  % apa (contiguous_limbs)
+  % ======================
+
+  % Good input
+  default_contiguous_limbs = apa ('contiguous_limbs');
+  N = 10;
+  A = magic (N);
+  for i = [1, N^2, N^2 + 1, 0]
+    apa ('contiguous_limbs', i);
+    assert (apa ('contiguous_limbs') == i);
+    obj = mpfr_t (A, 200);
+    assert (isequal (double (obj * obj), A * A));
+    P = mpfr_t (pascal (N), 200);
+    assert (norm (double (P \ P) - eye (N)) < 1e-20);  % Pivoting swaps.
+    mpfr_set_prec (obj, 100);  % Fits in contiguous limbs.
+    assert (all (isnan (double (obj(:)))));
+    obj(:) = A(:);
+    mpfr_prec_round (obj, 300, MPFR_RNDN);  % Exceeds contiguous limbs.
+    assert (all (prec (obj) == 300));
+    assert (isequal (double (obj), A));
+    clear obj P;
+  end
+  apa ('contiguous_limbs', default_contiguous_limbs);
+
+  % Bad input
+  apa ('verbose', 1);
+  for i = {-1, 1/2, nan, 'c', eye(3)}
+    assert (strcmp (check_error ('apa (''contiguous_limbs'', i{1})'), ...
+                    'apa:badInput'));
+    assert (apa ('contiguous_limbs') == default_contiguous_limbs);
+  end
+  apa ('verbose', default_verbosity_level);
+
+
+  % =========
+  % apa (omp)
+  % =========
+
+  % Good input, results do not depend on the schedule.
+  default_omp = apa ('omp');
+  assert (isequal (default_omp.schedule, 'cost'));
+  A = mpfr_t (magic (20), 100);
+  B = mpfr_t (linspace (0.5, 50, 400), 100);
+  B2 = mpfr_t (linspace (0.25, 25, 400), 100);
+  ref_sum = double (A + A);
+  ref_gamma = mpfr_t (zeros (1, 400), 100);
+  ref_ret = mpfr_gamma_inc (ref_gamma, B, B2, MPFR_RNDN);
+  for min_cost = [0, 1, inf]
+    for s = {'cost', 'static', 'dynamic', 'guided'}
+      apa ('omp', struct ('min_cost', min_cost, 'chunk_cost', 1, ...
+                          'schedule', s{1}));
+      assert (isequal (apa ('omp.schedule'), s{1}));
+      assert (apa ('omp.min_cost') == min_cost);
+      assert (isequal (double (A + A), ref_sum));
+      C = mpfr_t (zeros (1, 400), 100);
+      ret = mpfr_gamma_inc (C, B, B2, MPFR_RNDN);
+      assert (isequal (ret, ref_ret));
+      assert (isequal (double (C), double (ref_gamma)));
+    end
+  end
+  apa ('omp', default_omp);
+  assert (isequal (apa ('omp'), default_omp));
+  clear A B B2 C ref_gamma;
+
+  % Bad input
+  apa ('verbose', 1);
+  for i = {-1, nan, 'c', eye(3)}
+    assert (strcmp (check_error ('apa (''omp.min_cost'', i{1})'), ...
+                    'apa:badInput'));
+    assert (strcmp (check_error ('apa (''omp.chunk_cost'', i{1})'), ...
+                    'apa:badInput'));
+  end
+  for i = {'auto', 1, ''}
+    assert (strcmp (check_error ('apa (''omp.schedule'', i{1})'), ...
+                    'apa:badInput'));
+  end
+  assert (isequal (apa ('omp'), default_omp));
+  apa ('verbose', default_verbosity_level);
+
+
+  % =================
+  % apa (fixed_limbs)
+  % =================
+
+  % Good input, results and ternary values do not depend on the kernels.
+  default_fixed_limbs = apa ('fixed_limbs');
+  assert (default_fixed_limbs == 8);
+  A = rand (20) - 0.5;
+  B = rand (20) - 0.5;
+  for p = [64, 100, 128, 192, 256, 512]
+    a = mpfr_t (A, p);
+    b = mpfr_t (B, p);
+    c = mpfr_t (A .* B, p);
+    for rnd = [MPFR_RNDN, MPFR_RNDZ, MPFR_RNDU, MPFR_RNDD, MPFR_RNDA]
+      r = cell (2, 4);
+      ret = cell (2, 4);
+      for fixed_limbs = [0, 8]
+        apa ('fixed_limbs', fixed_limbs);
+        assert (apa ('fixed_limbs') == fixed_limbs);
+        k = 1 + (fixed_limbs > 0);
+        r(k,:) = {mpfr_t(zeros (20), p)};
+        ret{k,1} = mpfr_mul (r{k,1}, a, b, rnd);
+        ret{k,2} = mpfr_div (r{k,2}, a, b, rnd);
+        ret{k,3} = mpfr_fma (r{k,3}, a, b, c, rnd);
+        ret{k,4} = mpfr_fms (r{k,4}, a, b, c, rnd);
+      end
+      for j = 1:4
+        assert (all (mpfr_equal_p (r{1,j}, r{2,j})));
+        assert (isequal (sign (ret{1,j}), sign (ret{2,j})));
+      end
+    end
+    apa ('fixed_limbs', 0);
+    ab = a * b;
+    apa ('fixed_limbs', 8);
+    assert (all (mpfr_equal_p (a * b, ab)));
+  end
+  apa ('fixed_limbs', default_fixed_limbs);
+  clear a b c r ab;
+
+  % Bad input
+  apa ('verbose', 1);
+  for i = {-1, 9, 1/2, nan, 'c', eye(3)}
+    assert (strcmp (check_error ('apa (''fixed_limbs'', i{1})'), ...
+                    'apa:badInput'));
+    assert (apa ('fixed_limbs') == default_fixed_limbs);
+  end
+  apa ('verbose', default_verbosity_level);
+
+
+  % =====================
+  % apa (strassen_cutoff)
+  % =====================
+
+  % Good input, integer products are exact.
+  default_strassen_cutoff = apa ('strassen_cutoff');
+  assert (default_strassen_cutoff == 32);
+  a = reshape (mod (1:33*70, 17) - 8, 33, 70);
+  b = reshape (mod (1:70*65, 13) - 6, 70, 65);
+  A = mpfr_t (rand (40, 50) - 0.5, 113);
+  B = mpfr_t (rand (50, 60) - 0.5, 113);
+  rnd = mpfr_get_default_rounding_mode ();
+  AB = double (mtimes (A, B, rnd, 113, 8));
+  for cutoff = [1, 4, 32, 100]
+    apa ('strassen_cutoff', cutoff);
+    assert (apa ('strassen_cutoff') == cutoff);
+    assert (isequal (double (mtimes (mpfr_t (a), mpfr_t (b), rnd, 53, 9)), ...
+                     a * b));
+    assert (norm (double (mtimes (A, B, rnd, 113, 9)) - AB, inf) < 1e-30);
+  end
+  % Inf - Inf in the sums would give NaN, thus NaN or Inf use strategy 8.
+  apa ('strassen_cutoff', 4);
+  a = rand (20, 30) - 0.5;
+  b = rand (30, 25) - 0.5;
+  a(3,1) = Inf;
+  b(2,5) = -Inf;
+  b(4,7) = NaN;
+  assert (isequaln (double (mtimes (mpfr_t (a), mpfr_t (b), rnd, 53, 9)), ...
+                    double (mtimes (mpfr_t (a), mpfr_t (b), rnd, 53, 8))));
+  apa ('strassen_cutoff', default_strassen_cutoff);
+  clear A B;
+
+  % Bad input
+  apa ('verbose', 1);
+  for i = {0, -1, 1/2, nan, 'c', eye(3)}
+    assert (strcmp (check_error ('apa (''strassen_cutoff'', i{1})'), ...
+                    'apa:badInput'));
+    assert (apa ('strassen_cutoff') == default_strassen_cutoff);
+  end
+  apa ('verbose', default_verbosity_level);
+
+
+  % ===================
+  % apa (winograd_prec)
+  % ===================
+
+  % Good input, strategy 0 equals strategy 8 or 10.
+  default_winograd_prec = apa ('winograd_prec');
+  assert (default_winograd_prec == 1024);
+  for p = [113, 1024]
+    A = mpfr_t (rand (17, 30) - 0.5, p);
+    B = mpfr_t (1e100 * (rand (30, 21) - 0.5), p);
+    rnd = mpfr_get_default_rounding_mode ();
+    AB = mtimes (A, B, rnd, p, 8);
+    AB10 = mtimes (A, B, rnd, p, 10);
+    assert (norm (double (AB10 - AB), inf) < 1e100 * 2^(10 - p));
+    for winograd_prec = [0, p]
+      apa ('winograd_prec', winograd_prec);
+      assert (apa ('winograd_prec') == winograd_prec);
+      if (winograd_prec == 0)
+        assert (all (mpfr_equal_p (A * B, AB)));
+      else
+        assert (all (mpfr_equal_p (A * B, AB10)));
+      end
+    end
+  end
+  apa ('winograd_prec', default_winograd_prec);
+  % Inf - Inf in the pair products would give NaN, thus NaN or Inf use
+  % strategy 8, also when selected by strategy 0.
+  a = rand (20, 30) - 0.5;
+  b = rand (30, 25) - 0.5;
+  a(3,1) = Inf;
+  b(2,5) = -Inf;
+  b(4,7) = NaN;
+  A = mpfr_t (a, 1024);
+  B = mpfr_t (b, 1024);
+  AB = double (mtimes (A, B, rnd, 1024, 8));
+  assert (isequaln (double (A * B), AB));
+  assert (isequaln (double (mtimes (A, B, rnd, 1024, 10)), AB));
+  clear A B AB AB10;
+
+  % Bad input
+  apa ('verbose', 1);
+  for i = {-1, 1/2, nan, 'c', eye(3)}
+    assert (strcmp (check_error ('apa (''winograd_prec'', i{1})'), ...
+                    'apa:badInput'));
+    assert (apa ('winograd_prec') == default_winograd_prec);
   end
   apa ('verbose', default_verbosity_level);
 
@@ -102,6 +586,29 @@ function test_apa ()
     assert (isequaln (double (mpfr_t (i{1})), i{1}));
   end
 
+  % Good input (fill values)
+  fills = {'zeros', 'ones', 'eye', 'nan'};
+  vals = {zeros(3, 4), ones(3, 4), eye(3, 4), nan(3, 4)};
+  for i = 1:length (fills)
+    obj = mpfr_t ([3, 4], 100, [], fills{i});
+    assert (isequal (obj.dims, [3, 4]));
+    assert (isequaln (double (obj), vals{i}));
+    assert (all (prec (obj) == 100));
+  end
+  clear obj;
+
+  % Good input (strings).  `mpfr_set_str` keeps the variables and their
+  % precision, `mpfr_init_set_str` reinitializes them.
+  rnd = mpfr_get_default_rounding_mode ();
+  obj = mpfr_t (zeros (3, 1), 100);
+  mpfr_set_str (obj, {'0.5'; '1.25'; '-3'}, 10, rnd);
+  assert (isequal (double (obj), [0.5; 1.25; -3]));
+  assert (all (prec (obj) == 100));
+  mpfr_init_set_str (obj, {'2'}, 10, rnd);
+  assert (isequal (double (obj), [2; 2; 2]));
+  assert (all (prec (obj) == mpfr_get_default_prec ()));
+  clear obj;
+
   % Bad input (precision)
   apa ('verbose', 1);
   for i = {inf, -42, -2, 1/6, nan, 'c', eye(3), intmax('int64')}
@@ -116,6 +623,20 @@ function test_apa ()
   end
   apa ('verbose', default_verbosity_level);
 
+  % Bad input (fill values)
+  assert (strcmp (check_error ('mpfr_t ([3, 4], 53, [], ''rand'')'), ...
+                  'mpfr_t:mpfr_t'));
+  assert (strcmp (check_error ('mpfr_t ([3, 4, 5], 53, [], ''zeros'')'), ...
+                  'mpfr_t:mpfr_t'));
+
+  % Bad input (dimensions)
+  apa ('verbose', 1);
+  for i = {[-1, 4], [1.5, 2], [nan, 2], [inf, 2], [2^64, 1], [2^32, 2^33]}
+    assert (strcmp (check_error ('mpfr_t (i{1}, 53, [], ''zeros'')'), ...
+                    'apa:mexFunction'));
+  end
+  apa ('verbose', default_verbosity_level);
+
 
   % ==================================
   % Indexing read operations (subsref)
@@ -398,6 +919,62 @@ function test_apa ()
   end
 
 
+  % =====================================
+  % Fused element-wise expressions (fuse)
+  % =====================================
+
+  A = magic (4);
+  B = reshape (1:16, 4, 4);
+  am = mpfr_t (A, 53);
+  bm = mpfr_t (B, 53);
+  cm = mpfr_t (A', 53);
+  dm = mpfr_t (-B', 53);
+  em = mpfr_t (4, 53);
+  c = mpfr_t.fuse (@(a, b, c, d, e) a.*b + c.*d - e, am, bm, cm, dm, em);
+  assert (isa (c, 'mpfr_t'));
+  assert (isequal (double (c), A.*B + A'.*(-B') - 4));
+  assert (isequal (double (mpfr_t.fuse (@(a, b) 2*a - b.^2 + 1, am, bm)), ...
+                   2*A - B.^2 + 1));
+  assert (isequal (double (mpfr_t.fuse (@(a, b) -a ./ 4 + b.^3, am, B)), ...
+                   -A ./ 4 + B.^3));
+  assert (isequal (double (mpfr_t.fuse (@(a, e) e - a.*a, am, em)), ...
+                   4 - A.*A));
+
+  % Fused multiply-add is rounded only once.
+  S = warning ('off', 'mpfr_t:inexactOperation');
+  A = rand (5, 3);
+  am = mpfr_t (A, 53);
+  bm = mpfr_t (rand (5, 3), 53);
+  cm = mpfr_t (rand (5, 3), 53);
+  for rnd = 0:3
+    c = mpfr_t (zeros (5, 3), 53);
+    mpfr_fma (c, am, bm, cm, rnd);
+    assert (isequal (double (evaluate (mpfr_expr (am) .* bm + cm, rnd)), ...
+                     double (c)));
+    mpfr_fms (c, am, bm, cm, rnd);
+    assert (isequal (double (evaluate (mpfr_expr (am) .* bm - cm, rnd)), ...
+                     double (c)));
+  end
+  warning (S);
+  c = evaluate (mpfr_expr (am) + 1, MPFR_RNDN, 100);
+  assert (all (mpfr_get_prec (c) == 100));
+  assert (isequal (double (c), A + 1));
+
+  % Bad input
+  apa ('verbose', 1);
+  assert (strcmp (check_error ('mpfr_expr (am) + mpfr_t (1:2)'), ...
+                  'mpfr_expr:plus'));
+  assert (strcmp (check_error ('mpfr_expr (am) .^ 0.5'), 'mpfr_expr:power'));
+  assert (strcmp (check_error ('mpfr_expr (am) * am'''), 'mpfr_expr:mtimes'));
+  assert (strcmp (check_error ('mpfr_expr ({1})'), 'mpfr_expr:mpfr_expr'));
+  assert (strcmp (check_error ( ...
+    'mex_apa_interface (2005, c.idx, [2; 0], 53, 0)'), 'apa:mexFunction'));
+  assert (strcmp (check_error ( ...
+    'mex_apa_interface (2005, c.idx, [0, 0; 1, 1], 53, 0, am.idx)'), ...
+    'apa:mexFunction'));
+  apa ('verbose', default_verbosity_level);
+
+
   % =================
   % Matrix operations
   % =================
@@ -415,6 +992,68 @@ function test_apa ()
       end
     end
   end
+  a = reshape (mod (1:33*70, 17) - 8, 33, 70);
+  b = reshape (mod (1:70*65, 13) - 6, 70, 65);
+  rnd = mpfr_get_default_rounding_mode ();
+  for strategy = 0:12
+    assert (isequal (double (mtimes (mpfr_t (a), mpfr_t (b), rnd, 53, ...
+                                     strategy)), a * b));
+  end
+  % Conventional strategies accumulate in the precision of the result.
+  a = mpfr_t (rand (20, 30) - 0.5, 200);
+  b = mpfr_t (rand (30, 25) - 0.5, 200);
+  c_ref = mtimes (a, b, rnd, 1024, 8);
+  bound = 2^(-190) * mtimes (abs (a), abs (b));
+  for strategy = [1:8, 11]
+    c = mtimes (a, b, rnd, 200, strategy) - c_ref;
+    assert (all (all (abs (c) <= bound)));
+  end
+  clear c_ref bound;
+  % Strategy 10 scales each row of A and column of B on its own.
+  a = rand (20, 30) - 0.5;
+  b = rand (30, 25) - 0.5;
+  a(1,:) = 2^-600 * a(1,:);
+  b(:,2) = 2^-500 * b(:,2);
+  b(:,3) = 2^400 * b(:,3);
+  a = mpfr_t (a, 1100) ./ 3;
+  b = mpfr_t (b, 1100) ./ 7;
+  c_ref = mtimes (a, b, rnd, 2200, 8);
+  bound = 2^(-1090) * mtimes (abs (a), abs (b));
+  c = mtimes (a, b, rnd, 1100, 10) - c_ref;
+  assert (all (all (abs (c) <= bound)));
+  clear c_ref bound;
+  % Strategy 11 is correctly rounded, the exact products fit in 200 bits.
+  a = rand (20, 30);
+  b = rand (30, 25);
+  c = mtimes (mpfr_t (a), mpfr_t (b), rnd, 53, 11);
+  assert (isequal (double (c), double (mtimes (mpfr_t (a), mpfr_t (b), ...
+                                               rnd, 200, 8))));
+  % Strategy 11 falls back to strategy 8 for Inf or large exponent spread.
+  b(2,2) = 2^1000;
+  assert (isequal (double (mtimes (mpfr_t (a), mpfr_t (b), rnd, 53, 11)), ...
+                   double (mtimes (mpfr_t (a), mpfr_t (b), rnd, 53, 8))));
+  a(1,1) = Inf;
+  assert (isequal (double (mtimes (mpfr_t (a), mpfr_t (b), rnd, 53, 11)), ...
+                   double (mtimes (mpfr_t (a), mpfr_t (b), rnd, 53, 8))));
+  % Strategy 12 has a normwise error bound and falls back to strategy 8 for
+  % too high precision.
+  a = mpfr_t (rand (20, 30) - 0.5, 256);
+  b = mpfr_t (rand (30, 25) - 0.5, 256);
+  c = mtimes (a, b, rnd, 256, 12) - mtimes (a, b, rnd, 1024, 8);
+  assert (all (all (abs (c) <= 2^(-256) * mtimes (abs (a), abs (b)))));
+  a = mpfr_t (rand (20, 30) - 0.5, 2000);
+  assert (all (all (mtimes (a, b, rnd, 2000, 12) ...
+                    == mtimes (a, b, rnd, 2000, 8))));
+  % Strategy 12 reports inexact results, even if the exact product needs more
+  % bits than the slices cover and its rounding appears exact.
+  a = mpfr_t (ones (20, 30), 200) + 2^-100;
+  b = mpfr_t (ones (30, 25));
+  S = warning ('error', 'mpfr_t:inexactOperation');
+  assert (strcmp (check_error ('mtimes (a, b, rnd, 53, 12)'), ...
+                  'mpfr_t:inexactOperation'));
+  assert (isequal (double (mtimes (mpfr_t (ones (20, 30)), b, rnd, 53, 12)), ...
+                   30 * ones (20, 25)));
+  warning (S);
   
   % LU-factorization
   S = warning ('off', 'mpfr_t:inexactOperation');
@@ -427,6 +1066,189 @@ function test_apa ()
   end
   warning (S);
 
+  % ==========
+  % Reductions
+  % ==========
+
+  A = magic (6);
+  A(2,3) = -50;
+  for dim = 1:2
+    a = mpfr_t (A);
+    assert (isequal (double (sum (a, dim)), sum (A, dim)));
+    assert (isequal (double (prod (a, dim)), prod (A, dim)));
+    assert (isequal (double (mean (a, dim)), mean (A, dim)));
+    [m, i] = max (A, [], dim);
+    [b, j] = max (a, [], dim);
+    assert (isequal (double (b), m) && isequal (j, i));
+    [m, i] = min (A, [], dim);
+    [b, j] = min (a, [], dim);
+    assert (isequal (double (b), m) && isequal (j, i));
+  end
+  assert (isequal (double (sum (mpfr_t (1:5))), 15));
+  assert (isequal (double (max (mpfr_t ((1:5)'))), 5));
+  assert (isequal (double (min (a)), min (A)));
+  assert (isequal (double (min (a, 1)), min (A)));
+  assert (isequal (double (min (a, 1, 20)), min (A)));
+  assert (isequal (double (max (a, 1, 20)), max (A)));
+
+  % Sums are correctly rounded.
+  x = mpfr_t ([2^100, 1, -2^100, 2^-100], 53);
+  assert (isequal (double (sum (x)), 1 + 2^-100));
+  assert (isequal (double (sum (x')), 1 + 2^-100));
+  x = mpfr_t (repmat ([2^60; 1; -2^60], 1000, 2), 53);
+  assert (isequal (double (sum (x)), [1000, 1000]));
+
+  % NaN elements are ignored by `max` and `min`, unless all are NaN.
+  [b, i] = max (mpfr_t ([NaN, 1, 3, NaN, 3]));
+  assert (isequal (double (b), 3) && (i == 3));
+  [b, i] = min (mpfr_t ([NaN; NaN]));
+  assert (isnan (double (b)) && (i == 1));
+  assert (isnan (double (sum (mpfr_t ([1, NaN])))));
+
+  % Norms
+  v = [3, -4, 12];
+  assert (isequal (double (norm (mpfr_t (v))), 13));
+  assert (isequal (double (norm (mpfr_t (v'), 1)), 19));
+  assert (isequal (double (norm (mpfr_t (v), Inf)), 12));
+  assert (isequal (double (norm (mpfr_t (v), 'fro')), 13));
+  assert (isequal (double (norm (a, 1)), norm (A, 1)));
+  assert (isequal (double (norm (a, Inf)), norm (A, Inf)));
+  assert (isequal (double (norm (mpfr_t ([3, 4; 0, 12]))), 13));
+  clear a b x;
+
+  % Temporaries of worker threads cleared by the main thread are reused, the
+  % limb pool does not grow with repeated calls.
+  a = mpfr_t (rand (4096, 64), 200);
+  b = sum (a);
+  b = cumsum (a);
+  stats = mpfr_t.get_memory_stats ();
+  for i = 1:20
+    b = sum (a);
+    b = cumsum (a);
+  end
+  new_stats = mpfr_t.get_memory_stats ();
+  assert (new_stats.limb_pool_bytes <= stats.limb_pool_bytes);
+  clear a b;
+
+  % Bad input
+  apa ('verbose', 1);
+  assert (strcmp (check_error ('max (mpfr_t (1:3), 2, 1, 1)'), 'mpfr_t:max'));
+  assert (strcmp (check_error ('min (mpfr_t (1:3), 2, 1, 1)'), 'mpfr_t:min'));
+  assert (strcmp (check_error ('sum (mpfr_t (1:3), 3)'), 'mpfr_t:reduce'));
+  assert (strcmp (check_error ('norm (mpfr_t (ones (2)), 2)'), ...
+                  'mpfr_t:norm'));
+  assert (strcmp (check_error ('norm (mpfr_t (1:3), ''abc'')'), ...
+                  'mpfr_t:norm'));
+  assert (strcmp (check_error ( ...
+    'mex_apa_interface (2006, [1; 1], [1; 2], 1, 1, 7, 53, 0)'), ...
+    'apa:mexFunction'));
+  apa ('verbose', default_verbosity_level);
+
+  % ============
+  % Prefix scans
+  % ============
+
+  A = magic (5) - 10;
+  A(2,3) = NaN;
+  for dim = 1:2
+    a = mpfr_t (A);
+    assert (isequal (double (cumsum (a, dim)), cumsum (A, dim)));
+    assert (isequal (double (cumprod (a, dim)), cumprod (A, dim)));
+    assert (isequal (double (cummax (a, dim)), cummax (A, dim)));
+    assert (isequal (double (cummin (a, dim)), cummin (A, dim)));
+  end
+  assert (isequal (double (cumsum (mpfr_t (1:5))), cumsum (1:5)));
+  assert (isequal (double (scan (mpfr_t (1:4), 'plus', 2, 'exclusive')), ...
+                   [0, 1, 3, 6]));
+  assert (isequal (double (scan (mpfr_t ((1:4)'), 'times', [], ...
+                                 'exclusive')), [1; 1; 2; 6]));
+  assert (isequal (double (scan (mpfr_t ([2, 1, 3]), 'max', 2, ...
+                                 'exclusive')), [-Inf, 2, 2]));
+  assert (isequal (double (scan (mpfr_t ([NaN, 1, 3]), 'max', 2, ...
+                                 'exclusive')), [-Inf, -Inf, 1]));
+  assert (isequal (double (scan (mpfr_t ([NaN; 1; 3]), 'min', 1, ...
+                                 'exclusive')), [Inf; Inf; 1]));
+
+  % Long vectors are scanned in blocks.
+  x = (1:5000)';
+  assert (isequal (double (cumsum (mpfr_t (x))), cumsum (x)));
+  assert (isequal (double (cummax (mpfr_t (mod (x, 1234)))), ...
+                   cummax (mod (x, 1234))));
+  clear a x;
+
+  % Bad input
+  apa ('verbose', 1);
+  assert (strcmp (check_error ('scan (mpfr_t (1:3), ''abc'')'), ...
+                  'mpfr_t:scan'));
+  assert (strcmp (check_error ('scan (mpfr_t (1:3), ''plus'', 3)'), ...
+                  'mpfr_t:scan'));
+  assert (strcmp (check_error ('scan (mpfr_t (1:3), ''plus'', 1, ''x'')'), ...
+                  'mpfr_t:scan'));
+  apa ('verbose', default_verbosity_level);
+
+  % =====================
+  % Sorting and selection
+  % =====================
+
+  A = [3, NaN, 1, 2; -5, 2, 2, 2; 1, 1, NaN, -Inf; 1, Inf, 0, 2; 3, 2, 7, 2];
+  a = mpfr_t (A);
+  for dim = 1:2
+    for mode = {'ascend', 'descend'}
+      [b, i] = sort (a, dim, mode{1});
+      [B, I] = sort (A, dim, mode{1});
+      assert (isequaln (double (b), B) && isequal (i, I));
+    end
+    assert (isequaln (double (nth_element (a, [1, 3], dim)), ...
+                      nth_element (A, [1, 3], dim)));
+    assert (isequaln (double (median (a, dim)), median (A, dim)));
+  end
+  assert (isequaln (double (sort (mpfr_t ([NaN, 2, 1]), 'MissingPlacement', ...
+                                  'first')), [NaN, 1, 2]));
+  assert (isequaln (double (sort (mpfr_t ([NaN, 2, 1]), 'descend', ...
+                                  'MissingPlacement', 'last')), [2, 1, NaN]));
+  for c = {1, [4, -1], [-4, 3, 1]}
+    [b, i] = sortrows (a, c{1});
+    [B, I] = sortrows (A, c{1});
+    assert (isequaln (double (b), B) && isequal (i, I));
+  end
+  assert (isequal (double (nth_element (mpfr_t (10:-1:1), [3, 1, 3])), ...
+                   [3, 1, 3]));
+  assert (isequal (double (median (mpfr_t (1:4))), 2.5));
+
+  % Quantiles
+  x = [5; 1; 8; 3; 7; 2; 6; 4];
+  p = [0, 0.25, 0.5, 0.75, 1];
+  assert (isequal (double (quantile (mpfr_t (x), p)), quantile (x, p)));
+  assert (isequal (double (quantile (mpfr_t (x'), p, 2)), quantile (x', p, 2)));
+  x = [x, [NaN; x(2:end)]];
+  assert (isequal (double (quantile (mpfr_t (x), p)), ...
+                   [quantile(x(:,1), p), quantile(x(2:end,2), p)]));
+
+  % Long vectors are sorted in parallel blocks.
+  x = mod ((1:5000)' * 7919, 5003) - 2500;
+  [b, i] = sort (mpfr_t (x));
+  [B, I] = sort (x);
+  assert (isequal (double (b), B) && isequal (i, I));
+  assert (isequal (double (median (mpfr_t (x))), median (x)));
+  clear a b x;
+
+  % Bad input
+  apa ('verbose', 1);
+  assert (strcmp (check_error ('sort (mpfr_t (1:3), ''abc'')'), 'mpfr_t:sort'));
+  assert (strcmp (check_error ('sort (mpfr_t (1:3), 3)'), 'mpfr_t:sort'));
+  assert (strcmp (check_error ( ...
+    'sort (mpfr_t (1:3), ''MissingPlacement'', ''middle'')'), 'mpfr_t:sort'));
+  assert (strcmp (check_error ('sortrows (mpfr_t (ones (2)), 3)'), ...
+                  'mpfr_t:sortrows'));
+  assert (strcmp (check_error ('nth_element (mpfr_t (1:3), 4)'), ...
+                  'mpfr_t:nth_element'));
+  assert (strcmp (check_error ('quantile (mpfr_t (1:3), 2)'), ...
+                  'mpfr_t:quantile'));
+  assert (strcmp (check_error ( ...
+    'mex_apa_interface (2009, [1; 1], [1; 2], 2, 1, [2, 1], 0)'), ...
+    'apa:mexFunction'));
+  apa ('verbose', default_verbosity_level);
+
   % ====================
   % Comparison functions
   % ====================
@@ -439,6 +1261,92 @@ function test_apa ()
   end
 
 
+  % ===================
+  % ddouble and qdouble
+  % ===================
+
+  % Good input: results agree with MPFR of higher precision.
+  A = rand (15) - 0.5;
+  B = rand (15) + 0.5;
+  rnd = mpfr_get_default_rounding_mode ();
+  for k = [2, 4]
+    p = 53 * k;
+    tol = 2^(8 - p);
+    if (k == 2)
+      cls = 'ddouble';
+    else
+      cls = 'qdouble';
+    end
+    md = str2func (cls);
+    % Normwise error of `x` with respect to @mpfr_t `y`.
+    err = @(x, y) max (max (abs (double (mpfr_t (x, 4 * p) - y)))) ...
+                  / max (max (abs (double (y))));
+
+    a = mpfr_t (A, p) ./ 3;
+    b = mpfr_t (B, p) ./ 7;
+    c = mpfr_t (A, p) ./ 11;
+    am = md (a);
+    bm = md (b);
+    cm = md (c);
+    assert (isa (am, cls) && isa (am, 'mdouble'));
+    assert (isequal (size (am), [15 15]));
+    assert (isequal (size (md (1:3)), [1 3]));
+    assert (all (mpfr_equal_p (mpfr_t (am), a)));
+    assert (all (mpfr_get_prec (mpfr_t (am)) == p));
+    assert (isequal (double (am), double (a)));
+    assert (isequal (double (md (A)), A));
+    assert (err (-am, -a) == 0);
+    assert (err (am.', a.') == 0);
+
+    assert (err (am + bm, plus (a, b, rnd, 4 * p)) < tol);
+    assert (err (am - bm, minus (a, b, rnd, 4 * p)) < tol);
+    assert (err (am .* bm, times (a, b, rnd, 4 * p)) < tol);
+    assert (err (am ./ bm, rdivide (a, b, rnd, 4 * p)) < tol);
+    assert (err (am + 1, plus (a, 1, rnd, 4 * p)) < tol);
+    assert (err (2 .* am, times (a, 2, rnd, 4 * p)) < tol);
+    d = mpfr_t (zeros (15), 4 * p);
+    mpfr_fma (d, a, b, c, rnd);
+    assert (err (fma (am, bm, cm), d) < tol);
+    assert (err (dot (am, bm), mtimes (a(:)', b(:), rnd, 4 * p)) < tol);
+    assert (err (am * bm, mtimes (a, b, rnd, 4 * p)) < tol);
+    assert (err (md (a(:,1:5)) * md (b(1:5,:)), ...
+                 mtimes (a(:,1:5), b(1:5,:), rnd, 4 * p)) < tol);
+    assert (err (am * 3, times (a, 3, rnd, 4 * p)) < tol);
+
+    % LU factorization, `P * A = L * U` and `A = L * U`.
+    [L, U, P] = lu (am);
+    assert (isa (L, cls) && isa (U, cls));
+    assert (isequal (double (L), tril (double (L))));
+    assert (isequal (double (U), triu (double (U))));
+    assert (isequal (diag (double (L)), ones (15, 1)));
+    assert (err (mpfr_t (L, 4 * p) * mpfr_t (U, 4 * p), mpfr_t (P) * a) < tol);
+    [L, U] = lu (am);
+    assert (err (mpfr_t (L, 4 * p) * mpfr_t (U, 4 * p), a) < tol);
+    [L, U, P] = lu (md (A(:,1:5)));
+    assert (isequal (size (L), [15 5]) && isequal (size (U), [5 5]));
+    assert (err (mpfr_t (L, 4 * p) * mpfr_t (U, 4 * p), ...
+                 mpfr_t (P * A(:,1:5))) < tol);
+  end
+  clear a b c d L U;
+
+  % Bad input
+  apa ('verbose', 1);
+  assert (strcmp (check_error ('ddouble ()'), 'ddouble:ddouble'));
+  assert (strcmp (check_error ('qdouble ({1})'), 'mdouble:mdouble'));
+  assert (strcmp (check_error ('ddouble (1i)'), 'mdouble:mdouble'));
+  assert (strcmp (check_error ('ddouble (1) + qdouble (1)'), 'mdouble:plus'));
+  assert (strcmp (check_error ('ddouble (ones (2)) .* ddouble (ones (3))'), ...
+                  'mdouble:times'));
+  assert (strcmp (check_error ('ddouble (ones (2)) * ddouble (ones (3))'), ...
+                  'mdouble:mtimes'));
+  assert (strcmp (check_error ('dot (qdouble (1:2), qdouble (1:3))'), ...
+                  'mdouble:dot'));
+  assert (strcmp (check_error ( ...
+    'mex_apa_interface (4002, 5, ones (2), ones (2))'), 'apa:mexFunction'));
+  assert (strcmp (check_error ( ...
+    'mex_apa_interface (4004, ones (2), ones (2), 3)'), 'apa:mexFunction'));
+  apa ('verbose', default_verbosity_level);
+
   % ==========================
   % Error test helper function
   % ==========================